@@ -3,9 +3,34 @@
 # QMK Custom Firmware Build Script
 #
 # This script builds custom keyboard firmware using QMK.
-# Workflow: copy keyboard to QMK → compile → retrieve firmware → cleanup
 #
-# Usage: ./build.sh
+# Incremental mode (default):
+#   sync keyboard overlay into QMK → compile → retrieve firmware
+#   The overlay stays installed between runs and is synced with preserved
+#   timestamps, and object files live in .build/qmk/ outside the QMK tree, so
+#   only translation units whose sources changed are recompiled. Several
+#   keymaps can be compiled in parallel (one qmk compile per keymap).
+#
+# Clean mode (--clean):
+#   copy keyboard to QMK → compile from scratch → retrieve firmware → cleanup
+#
+# Usage: ./build.sh                          (interactive menus)
+#        ./build.sh -y [options]             (non-interactive)
+#
+# Options:
+#   -kb, --keyboard <path>   Keyboard path (e.g. keychron/q11/ansi_encoder)
+#   -km, --keymap <name>     Keymap to build; repeat or comma-separate for several
+#   -a,  --all-keymaps       Build every keymap of the keyboard
+#   -j,  --jobs <n>          Total compile jobs, split across keymaps (default: CPU count)
+#        --clean             One-off cold build; remove the QMK copy afterwards
+#        --uninstall         Remove the overlay from QMK (restoring any original) and exit
+#        --update-size-baseline  Accept the current flash/RAM usage as the new baseline
+#        --no-size-check     Skip the firmware size report
+#   -y,  --non-interactive   Never prompt; use options and defaults
+#   -h,  --help              Show this help
+#
+# Example (edit-compile loop for both keymaps):
+#   ./build.sh -y -kb keychron/q11/ansi_encoder -km default,j-custom
 #
 
 set -e  # Exit on error
@@ -18,6 +43,9 @@ SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 QMK_FIRMWARE_DIR="$HOME/qmk_firmware"
 QMK_KEYBOARDS_DIR="$QMK_FIRMWARE_DIR/keyboards"
 DEFAULT_KEYMAP="j-custom"
+BUILD_ROOT="$SCRIPT_DIR/.build/qmk"
+OVERLAY_MARKER=".my_qmk_backup"
+SIZE_REPORT_DIR="$SCRIPT_DIR/firmware-size"
 
 # =============================================================================
 # Colors for output
@@ -283,12 +311,21 @@ select_keymap() {
     
     # If j-custom exists, show Enter option
     if [ $default_index -gt 0 ]; then
-        printf "Enter selection [1-%d] (press Enter for %s): " "${#keymaps[@]}" "$DEFAULT_KEYMAP"
+        printf "Enter selection [1-%d, a=all] (press Enter for %s): " "${#keymaps[@]}" "$DEFAULT_KEYMAP"
     else
-        printf "Enter selection [1-%d]: " "${#keymaps[@]}"
+        printf "Enter selection [1-%d, a=all]: " "${#keymaps[@]}"
     fi
     read -r selection
     
+    # Build every keymap
+    if [ "$selection" = "a" ] || [ "$selection" = "A" ]; then
+        SELECTED_KEYMAPS=("${keymaps[@]}")
+        SELECTED_KEYMAP="${keymaps[0]}"
+        print_success "Selected keymaps: ${SELECTED_KEYMAPS[*]}"
+        echo ""
+        return
+    fi
+    
     # Handle empty input (use default)
     if [ -z "$selection" ]; then
         if [ $default_index -gt 0 ]; then
@@ -310,10 +347,55 @@ select_keymap() {
     fi
     
     SELECTED_KEYMAP="${keymaps[$((selection-1))]}"
+    SELECTED_KEYMAPS=("$SELECTED_KEYMAP")
     print_success "Selected keymap: $SELECTED_KEYMAP"
     echo ""
 }
 
+# Resolve keyboard/keymaps from command-line options and defaults (-y)
+resolve_selections() {
+    print_header "Non-interactive Selection"
+    
+    if [ -z "$SELECTED_KEYBOARD" ]; then
+        SELECTED_KEYBOARD=$(discover_keyboards | head -1)
+        if [ -z "$SELECTED_KEYBOARD" ]; then
+            print_error "No keyboards found in workspace."
+            exit 1
+        fi
+    fi
+    if [ ! -d "$SCRIPT_DIR/$SELECTED_KEYBOARD/keymaps" ]; then
+        print_error "Keyboard not found: $SELECTED_KEYBOARD"
+        exit 1
+    fi
+    print_success "Keyboard: $SELECTED_KEYBOARD"
+    check_flash_instruction "$SELECTED_KEYBOARD" || true
+    
+    if [ "$ALL_KEYMAPS" = true ]; then
+        SELECTED_KEYMAPS=()
+        local km
+        while IFS= read -r km; do
+            [ -n "$km" ] && SELECTED_KEYMAPS+=("$km")
+        done < <(discover_keymaps "$SELECTED_KEYBOARD")
+    elif [ ${#SELECTED_KEYMAPS[@]} -eq 0 ]; then
+        if [ -d "$SCRIPT_DIR/$SELECTED_KEYBOARD/keymaps/$DEFAULT_KEYMAP" ]; then
+            SELECTED_KEYMAPS=("$DEFAULT_KEYMAP")
+        else
+            SELECTED_KEYMAPS=("$(discover_keymaps "$SELECTED_KEYBOARD" | head -1)")
+        fi
+    fi
+    
+    local km
+    for km in "${SELECTED_KEYMAPS[@]}"; do
+        if [ ! -f "$SCRIPT_DIR/$SELECTED_KEYBOARD/keymaps/$km/keymap.c" ]; then
+            print_error "Keymap not found: $SELECTED_KEYBOARD/keymaps/$km/keymap.c"
+            exit 1
+        fi
+    done
+    SELECTED_KEYMAP="${SELECTED_KEYMAPS[0]}"
+    print_success "Keymaps: ${SELECTED_KEYMAPS[*]}"
+    echo ""
+}
+
 # =============================================================================
 # Build workflow functions
 # =============================================================================
@@ -338,9 +420,13 @@ copy_to_qmk() {
     # Check if target already exists in QMK
     if [ -d "$TARGET_DIR" ]; then
         # Check if it's our previous build copy
-        if [ -f "$TARGET_DIR/.my_qmk_backup" ]; then
+        if [ -f "$TARGET_DIR/$OVERLAY_MARKER" ]; then
             print_warning "Previous build files found. Cleaning up first..."
             rm -rf "$TARGET_DIR"
+            # An incremental overlay may have backed up the original QMK keyboard
+            if [ -d "${TARGET_DIR}.original_backup" ]; then
+                BACKUP_DIR="${TARGET_DIR}.original_backup"
+            fi
         else
             # This is the original QMK keyboard - back it up
             BACKUP_DIR="${TARGET_DIR}.original_backup"
@@ -361,7 +447,7 @@ copy_to_qmk() {
     cp -R "$SOURCE_DIR" "$TARGET_DIR"
     
     # Create marker file to identify our copy
-    echo "Copied by my-qmk build script on $(date)" > "$TARGET_DIR/.my_qmk_backup"
+    echo "Copied by my-qmk build script on $(date)" > "$TARGET_DIR/$OVERLAY_MARKER"
     
     print_success "Copied to: $TARGET_DIR"
 }
@@ -401,6 +487,10 @@ retrieve_firmware() {
     local fi=0
     for ext in bin uf2 hex; do
         local firmware_file="$QMK_FIRMWARE_DIR/${kb_name}_${SELECTED_KEYMAP}.${ext}"
+        # Incremental builds also leave a copy in the out-of-tree build directory
+        if [ ! -f "$firmware_file" ] && [ "$BUILD_MODE" = "incremental" ]; then
+            firmware_file="$BUILD_ROOT/${kb_name}_${SELECTED_KEYMAP}.${ext}"
+        fi
         if [ -f "$firmware_file" ]; then
             firmware_files[fi]="$firmware_file"
             ((fi++)) || true
@@ -435,18 +525,26 @@ retrieve_firmware() {
         cp "$firmware_file" "$OUTPUT_DIR/"
         print_success "Firmware saved: $OUTPUT_DIR/$filename"
         
-        # Remove from QMK directory
-        rm "$firmware_file"
+        # Remove from QMK directory (the build directory copy is harmless)
+        case "$firmware_file" in
+            "$QMK_FIRMWARE_DIR"/*) rm "$firmware_file" ;;
+        esac
     done
 }
 
 # Cleanup copied files from QMK
 cleanup_qmk() {
+    if [ "$BUILD_MODE" = "incremental" ]; then
+        print_step "5/5" "Keeping QMK overlay for incremental builds..."
+        print_info "Remove it with: ./build.sh --uninstall -kb $SELECTED_KEYBOARD"
+        return 0
+    fi
+    
     print_step "5/5" "Cleaning up QMK directory..."
     
     if [ -d "$TARGET_DIR" ]; then
         # Verify it's our copy (has marker file)
-        if [ -f "$TARGET_DIR/.my_qmk_backup" ]; then
+        if [ -f "$TARGET_DIR/$OVERLAY_MARKER" ]; then
             rm -rf "$TARGET_DIR"
             print_success "Removed build files: $TARGET_DIR"
             
@@ -471,37 +569,401 @@ cleanup_qmk() {
     fi
 }
 
+# =============================================================================
+# Incremental build functions
+# =============================================================================
+
+detect_cpu_count() {
+    getconf _NPROCESSORS_ONLN 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 2
+}
+
+# Resolve SOURCE_DIR/TARGET_DIR/BACKUP_DIR for the selected keyboard
+resolve_overlay_paths() {
+    local vendor_model=$(dirname "$SELECTED_KEYBOARD")
+    SOURCE_DIR="$SCRIPT_DIR/$vendor_model"
+    TARGET_DIR="$QMK_KEYBOARDS_DIR/$vendor_model"
+    BACKUP_DIR="${TARGET_DIR}.original_backup"
+}
+
+# Install or refresh the keyboard overlay in the QMK tree.
+# File timestamps are preserved and unchanged files are left alone, so make
+# only rebuilds objects whose sources actually changed since the last run.
+sync_overlay() {
+    print_step "2/5" "Syncing keyboard overlay into QMK..."
+    
+    resolve_overlay_paths
+    
+    if [ -d "$TARGET_DIR" ] && [ ! -f "$TARGET_DIR/$OVERLAY_MARKER" ]; then
+        # This is the original QMK keyboard - back it up until --uninstall
+        if [ -d "$BACKUP_DIR" ]; then
+            rm -rf "$BACKUP_DIR"
+        fi
+        print_info "Backing up original QMK keyboard..."
+        mv "$TARGET_DIR" "$BACKUP_DIR"
+        print_success "Original backed up to: $BACKUP_DIR"
+    fi
+    
+    mkdir -p "$TARGET_DIR"
+    if command -v rsync &> /dev/null; then
+        local changed
+        changed=$(rsync -a --delete --itemize-changes \
+            --exclude "$OVERLAY_MARKER" --exclude "*.bin" --exclude "*.uf2" --exclude "*.hex" \
+            "$SOURCE_DIR/" "$TARGET_DIR/" | grep -c '^>f' || true)
+        print_success "Overlay up to date: $TARGET_DIR ($changed file(s) changed)"
+    else
+        # No rsync: full copy, but with preserved timestamps so objects stay valid
+        rm -rf "$TARGET_DIR"
+        cp -Rp "$SOURCE_DIR" "$TARGET_DIR"
+        print_success "Overlay copied: $TARGET_DIR"
+    fi
+    
+    echo "Overlay installed by my-qmk build script on $(date)" > "$TARGET_DIR/$OVERLAY_MARKER"
+}
+
+# Remove the overlay from QMK and restore the original keyboard if backed up
+uninstall_overlay() {
+    print_header "Remove QMK Overlay"
+    
+    resolve_overlay_paths
+    
+    if [ -d "$TARGET_DIR" ]; then
+        if [ ! -f "$TARGET_DIR/$OVERLAY_MARKER" ]; then
+            print_warning "Skipping - $TARGET_DIR is not a my-qmk overlay"
+            return 0
+        fi
+        rm -rf "$TARGET_DIR"
+        print_success "Removed overlay: $TARGET_DIR"
+    else
+        print_info "No overlay installed at: $TARGET_DIR"
+    fi
+    
+    if [ -d "$BACKUP_DIR" ]; then
+        mv "$BACKUP_DIR" "$TARGET_DIR"
+        print_success "Restored original QMK keyboard"
+    fi
+    
+    local kb_name=$(echo "$SELECTED_KEYBOARD" | tr '/' '_')
+    rm -rf "$BUILD_ROOT"/obj_"${kb_name}"_*
+    print_success "Removed cached objects for $SELECTED_KEYBOARD"
+}
+
+# Compile one keymap into the shared out-of-tree build directory
+# Usage: compile_keymap_job <keymap> <make_jobs> <log_file>
+compile_keymap_job() {
+    local keymap="$1"
+    local make_jobs="$2"
+    local log_file="$3"
+    local start=$SECONDS
+    
+    if qmk compile -kb "$SELECTED_KEYBOARD" -km "$keymap" -j "$make_jobs" \
+        -e BUILD_DIR="$BUILD_ROOT" > "$log_file" 2>&1; then
+        echo "$((SECONDS - start))" > "$log_file.ok"
+        return 0
+    fi
+    return 1
+}
+
+# Compile all selected keymaps, in parallel when there is more than one
+compile_keymaps() {
+    print_step "3/5" "Compiling ${#SELECTED_KEYMAPS[@]} keymap(s) incrementally..."
+    echo ""
+    
+    mkdir -p "$BUILD_ROOT/logs"
+    
+    # Single keymap: stream compiler output as before
+    if [ ${#SELECTED_KEYMAPS[@]} -eq 1 ]; then
+        print_info "Running: qmk compile -kb $SELECTED_KEYBOARD -km $SELECTED_KEYMAP -j $BUILD_JOBS -e BUILD_DIR=$BUILD_ROOT"
+        echo ""
+        local start=$SECONDS
+        if ! qmk compile -kb "$SELECTED_KEYBOARD" -km "$SELECTED_KEYMAP" -j "$BUILD_JOBS" \
+            -e BUILD_DIR="$BUILD_ROOT"; then
+            print_error "Compilation failed!"
+            exit 1
+        fi
+        echo ""
+        print_success "Compilation successful! ($((SECONDS - start))s)"
+        return 0
+    fi
+    
+    # Several keymaps: one qmk compile per keymap, make jobs split between them
+    local per_job=$((BUILD_JOBS / ${#SELECTED_KEYMAPS[@]}))
+    [ "$per_job" -lt 1 ] && per_job=1
+    
+    local pids=()
+    local keymap
+    for keymap in "${SELECTED_KEYMAPS[@]}"; do
+        local log_file="$BUILD_ROOT/logs/$keymap.log"
+        rm -f "$log_file.ok"
+        print_info "Compiling $keymap (-j $per_job, log: ${log_file#$SCRIPT_DIR/})"
+        compile_keymap_job "$keymap" "$per_job" "$log_file" &
+        pids+=($!)
+    done
+    
+    local failures=0
+    local i=0
+    echo ""
+    for keymap in "${SELECTED_KEYMAPS[@]}"; do
+        local log_file="$BUILD_ROOT/logs/$keymap.log"
+        if wait "${pids[i]}"; then
+            print_success "$keymap compiled ($(cat "$log_file.ok")s)"
+        else
+            print_error "$keymap failed to compile:"
+            tail -n 20 "$log_file" | sed 's/^/    /'
+            failures=$((failures + 1))
+        fi
+        ((i++)) || true
+    done
+    echo ""
+    
+    if [ $failures -gt 0 ]; then
+        print_error "Compilation failed for $failures keymap(s)!"
+        exit 1
+    fi
+    print_success "Compilation successful!"
+}
+
+# =============================================================================
+# Firmware size functions
+# =============================================================================
+
+# Break flash/RAM down per feature and symbol from the linker map and compare
+# against the stored baseline (firmware-size/<keyboard>/<keymap>/baseline.json)
+# Usage: report_firmware_size <keymap>
+report_firmware_size() {
+    local keymap="$1"
+    local kb_name=$(echo "$SELECTED_KEYBOARD" | tr '/' '_')
+    local build_dir="$QMK_FIRMWARE_DIR/.build"
+    if [ "$BUILD_MODE" = "incremental" ]; then
+        build_dir="$BUILD_ROOT"
+    fi
+    local map_file="$build_dir/${kb_name}_${keymap}.map"
+    local report_dir="$SIZE_REPORT_DIR/$SELECTED_KEYBOARD/$keymap"
+    
+    if [ ! -f "$map_file" ]; then
+        print_warning "No linker map for $keymap ($map_file), skipping size report"
+        return 0
+    fi
+    
+    local args=("$map_file" --output "$report_dir/report.json" --baseline "$report_dir/baseline.json" --quiet)
+    if [ "$UPDATE_SIZE_BASELINE" = true ]; then
+        args+=(--update-baseline)
+    fi
+    
+    local status=0
+    node "$SCRIPT_DIR/scripts/firmware-size-report.js" "${args[@]}" || status=$?
+    if [ $status -eq 2 ]; then
+        print_error "Firmware size regression in $keymap!"
+        print_info "Details: node scripts/firmware-size-report.js $map_file --baseline ${report_dir#$SCRIPT_DIR/}/baseline.json"
+        print_info "Accept the new size with: ./build.sh --update-size-baseline"
+        return 1
+    elif [ $status -ne 0 ]; then
+        print_warning "Size report failed for $keymap (non-critical)"
+        return 0
+    fi
+    print_success "Size report: ${report_dir#$SCRIPT_DIR/}/report.json"
+}
+
+# Run the size report for every built keymap; exits on regression
+check_firmware_sizes() {
+    if [ "$SIZE_CHECK" != true ]; then
+        return 0
+    fi
+    if ! command -v node &> /dev/null; then
+        print_warning "Node.js not found, skipping firmware size report"
+        return 0
+    fi
+    
+    print_header "Firmware Size"
+    local failures=0
+    local km
+    for km in "${SELECTED_KEYMAPS[@]}"; do
+        report_firmware_size "$km" || failures=$((failures + 1))
+    done
+    echo ""
+    
+    if [ $failures -gt 0 ]; then
+        print_error "Firmware size budget exceeded for $failures keymap(s) (firmware was still saved)"
+        exit 2
+    fi
+}
+
+# Generated tables must match their sources; a stale sparse table would
+# silently flash the old layers, a stale trie the old launchers, stale
+# CURSOR_LAYER macros the old chords
+check_generated_tables() {
+    local km generated table spec generator
+    for km in "${SELECTED_KEYMAPS[@]}"; do
+        local keymap_dir="$SCRIPT_DIR/$SELECTED_KEYBOARD/keymaps/$km"
+        for generated in "sparse_keymap_table.h:keymap.c:generate-sparse-keymap.js" \
+                         "app_leader_trie.h:app_leader.json:generate-app-leader.js" \
+                         "cursor_layer_macros.h:cursor_layer.json:generate-cursor-layer.js"; do
+            IFS=: read -r table spec generator <<< "$generated"
+            if [ ! -f "$keymap_dir/$table" ]; then
+                continue
+            fi
+            if ! command -v node &> /dev/null; then
+                print_warning "Node.js not found, cannot check $km/$table against $spec"
+                continue
+            fi
+            if ! node "$SCRIPT_DIR/scripts/$generator" "$keymap_dir" --check > /dev/null 2>&1; then
+                print_error "$km: $table is out of date with $spec"
+                print_info "Run: node scripts/$generator ${keymap_dir#$SCRIPT_DIR/}"
+                exit 1
+            fi
+        done
+    done
+}
+
+# =============================================================================
+# Command-line options
+# =============================================================================
+
+# Print the usage block from the header of this script
+usage() {
+    awk '/^# Usage:/ { p = 1 } p && !/^#/ { exit } p' "$SCRIPT_DIR/build.sh" | sed -E 's/^# ?//'
+}
+
+# Require a value for options that take one
+require_option_value() {
+    if [ -z "$2" ]; then
+        print_error "Option $1 requires a value"
+        exit 1
+    fi
+}
+
+parse_args() {
+    while [ $# -gt 0 ]; do
+        case "$1" in
+            -kb|--keyboard)
+                require_option_value "$1" "$2"
+                SELECTED_KEYBOARD="${2%/}"
+                shift 2
+                ;;
+            -km|--keymap)
+                require_option_value "$1" "$2"
+                local km
+                for km in $(echo "$2" | tr ',' ' '); do
+                    SELECTED_KEYMAPS+=("$km")
+                done
+                shift 2
+                ;;
+            -a|--all-keymaps)
+                ALL_KEYMAPS=true
+                shift
+                ;;
+            -j|--jobs)
+                require_option_value "$1" "$2"
+                if ! echo "$2" | grep -qE '^[1-9][0-9]*$'; then
+                    print_error "Invalid job count: $2"
+                    exit 1
+                fi
+                BUILD_JOBS="$2"
+                shift 2
+                ;;
+            --clean)
+                BUILD_MODE="clean"
+                shift
+                ;;
+            --uninstall)
+                UNINSTALL=true
+                shift
+                ;;
+            --update-size-baseline)
+                UPDATE_SIZE_BASELINE=true
+                shift
+                ;;
+            --no-size-check)
+                SIZE_CHECK=false
+                shift
+                ;;
+            -y|--non-interactive)
+                NON_INTERACTIVE=true
+                shift
+                ;;
+            -h|--help)
+                usage
+                exit 0
+                ;;
+            *)
+                print_error "Unknown option: $1"
+                usage
+                exit 1
+                ;;
+        esac
+    done
+}
+
 # =============================================================================
 # Main
 # =============================================================================
 
 main() {
-    print_header "QMK Custom Firmware Builder"
-    
     # Initialize global variables
     keyboards=()
     BACKUP_DIR=""
     FLASH_INSTRUCTION_FILE=""
+    SELECTED_KEYBOARD=""
+    SELECTED_KEYMAP=""
+    SELECTED_KEYMAPS=()
+    ALL_KEYMAPS=false
+    BUILD_MODE="incremental"
+    BUILD_JOBS=$(detect_cpu_count)
+    UNINSTALL=false
+    NON_INTERACTIVE=false
+    SIZE_CHECK=true
+    UPDATE_SIZE_BASELINE=false
+    
+    parse_args "$@"
+    
+    print_header "QMK Custom Firmware Builder"
+    
+    if [ "$UNINSTALL" = true ]; then
+        if [ -z "$SELECTED_KEYBOARD" ]; then
+            select_keyboard
+        fi
+        uninstall_overlay
+        exit 0
+    fi
     
     # Run build workflow
     check_prerequisites
-    select_keyboard
-    select_keymap
-    copy_to_qmk
-    compile_firmware
-    retrieve_firmware
+    if [ "$NON_INTERACTIVE" = true ] || [ -n "$SELECTED_KEYBOARD" ]; then
+        resolve_selections
+    else
+        select_keyboard
+        select_keymap
+    fi
+    check_generated_tables
+    
+    if [ "$BUILD_MODE" = "clean" ]; then
+        if [ ${#SELECTED_KEYMAPS[@]} -gt 1 ]; then
+            print_error "--clean builds a single keymap; drop --clean to build several in parallel"
+            exit 1
+        fi
+        copy_to_qmk
+        compile_firmware
+        retrieve_firmware
+    else
+        sync_overlay
+        compile_keymaps
+        for SELECTED_KEYMAP in "${SELECTED_KEYMAPS[@]}"; do
+            retrieve_firmware
+        done
+        SELECTED_KEYMAP="${SELECTED_KEYMAPS[0]}"
+    fi
     cleanup_qmk
+    check_firmware_sizes
     
     # Final summary
     print_header "Build Complete!"
     echo -e "  Keyboard: ${CYAN}$SELECTED_KEYBOARD${NC}"
-    echo -e "  Keymap:   ${CYAN}$SELECTED_KEYMAP${NC}"
+    echo -e "  Keymap:   ${CYAN}${SELECTED_KEYMAPS[*]}${NC}"
+    echo -e "  Mode:     ${CYAN}$BUILD_MODE${NC}"
     echo -e "  Output:   ${GREEN}$OUTPUT_DIR/${NC}"
     echo ""
     
     # Construct the firmware filename (keyboard path with / replaced by _)
     local kb_name=$(echo "$SELECTED_KEYBOARD" | tr '/' '_')
-    local firmware_file="${OUTPUT_DIR}/${kb_name}_${SELECTED_KEYMAP}.bin"
     
     # Display flash instructions from FLASH_INSTRUCTION.md first (if available)
     display_flash_instructions
@@ -509,7 +971,10 @@ main() {
     # Show copy-pasteable flash command
     print_info "To flash your keyboard, run:"
     echo ""
-    echo -e "  ${GREEN}qmk flash ${firmware_file}${NC}"
+    local km
+    for km in "${SELECTED_KEYMAPS[@]}"; do
+        echo -e "  ${GREEN}qmk flash ${OUTPUT_DIR}/${kb_name}_${km}.bin${NC}"
+    done
     echo ""
 }
 
@@ -0,0 +1,107 @@
+/* App leader - see app_leader.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "app_leader.h"
+#include "timer_wheel.h"
+
+#define SLOTS      (MATRIX_ROWS * MATRIX_COLS)
+#define MASK_WORDS ((SLOTS + 31) / 32)
+
+static bool    active = false;
+static uint8_t state  = 0;
+
+// Drops an incomplete sequence APP_LEADER_TIMEOUT after the last key
+static uint32_t            timed_out(void);
+static timer_wheel_timer_t timeout = TIMER_WHEEL_TIMER(timed_out);
+
+// Keys pressed while reading: their releases are not passed on either
+static uint32_t swallowed[MASK_WORDS];
+
+// ============================================
+// Trie
+// ============================================
+
+// One table step: 0 when no sequence continues with keycode
+static uint8_t step(uint8_t from, uint16_t keycode) {
+    if (keycode >= APP_LEADER_KEYCODES) {
+        return 0;
+    }
+    uint8_t column = pgm_read_byte(&app_leader_column[keycode]);
+    if (column == 0) {
+        return 0;
+    }
+    return pgm_read_byte(&app_leader_next[from * pgm_read_byte(&app_leader_columns) + column]);
+}
+
+// ============================================
+// Events
+// ============================================
+
+void app_leader_start(void) {
+    active = true;
+    state  = 0;
+    timer_wheel_schedule(&timeout, APP_LEADER_TIMEOUT);
+}
+
+static void stop(void) {
+    active = false;
+    timer_wheel_cancel(&timeout);
+}
+
+bool app_leader_active(void) {
+    return active;
+}
+
+static bool swallow_release(keypos_t key) {
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return false;
+    }
+    uint8_t  slot = key.row * MATRIX_COLS + key.col;
+    uint32_t bit  = 1UL << (slot % 32);
+    bool     was  = swallowed[slot / 32] & bit;
+    swallowed[slot / 32] &= ~bit;
+    return was;
+}
+
+static void swallow(keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        uint8_t slot = key.row * MATRIX_COLS + key.col;
+        swallowed[slot / 32] |= 1UL << (slot % 32);
+    }
+}
+
+bool app_leader_process(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return !swallow_release(record->event.key);
+    }
+    if (!active) {
+        return true;
+    }
+    swallow(record->event.key);
+
+    uint8_t next = step(state, keymap_key_to_keycode(APP_LEADER_LAYER, record->event.key));
+    if (next == 0) {
+        // Esc or a key that continues no sequence: cancel
+        stop();
+        return false;
+    }
+    uint16_t action = pgm_read_word(&app_leader_action[next]);
+    if (action != KC_NO) {
+        stop();
+        tap_code16(action);
+        return false;
+    }
+    state = next;
+    timer_wheel_schedule(&timeout, APP_LEADER_TIMEOUT);
+    return false;
+}
+
+static uint32_t timed_out(void) {
+    active = false;
+    return 0;
+}
@@ -0,0 +1,52 @@
+/* App leader: K+L, then a short key sequence, launches an app
+ *
+ * Replaces RGUI tap → F → letter for the KC_APP_* launchers with a leader
+ * sequence ("ai" → ChatGPT, "sl" → Slack, ...). The sequences live in
+ * app_leader.json; scripts/generate-app-leader.js compiles them into a trie
+ * stored in flash (app_leader_trie.h):
+ *   - each basic keycode maps to a column (0 = in no sequence),
+ *   - next state = app_leader_next[state * columns + column],
+ * so every key is one table step, whatever the number of sequences.
+ *
+ * No sequence is a prefix of another (the generator rejects it), so a
+ * launcher fires on the last key of its sequence, without a timeout. The
+ * timeout only abandons a sequence left incomplete. Esc, or any key that
+ * continues no sequence, cancels; keys read by the leader are not typed.
+ *
+ * Keys are looked up by position on APP_LEADER_LAYER, so the sequence is
+ * the same whatever layer is active. RAM: the current state, a timer_wheel.h
+ * timer and a mask of the keys whose release is swallowed; more launchers
+ * only grow the flash tables.
+ *
+ * Edit app_leader.json, then: node scripts/generate-app-leader.js
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef APP_LEADER_TIMEOUT
+#    define APP_LEADER_TIMEOUT 1000  // ms without a key before an incomplete sequence is dropped
+#endif
+
+#ifndef APP_LEADER_LAYER
+#    define APP_LEADER_LAYER 0  // Layer the sequence keys are read from
+#endif
+
+// Basic keycodes a sequence may use (letters through KC_SLASH)
+#define APP_LEADER_KEYCODES (KC_SLASH + 1)
+
+// Trie tables (app_leader_trie.h, included once by keymap.c)
+extern const uint8_t  app_leader_columns;
+extern const uint8_t  app_leader_column[APP_LEADER_KEYCODES];
+extern const uint8_t  app_leader_next[];
+extern const uint16_t app_leader_action[];
+
+// Start reading a sequence (K+L chord or KC_APP_LEADER press)
+void app_leader_start(void);
+
+// True while a sequence is being read
+bool app_leader_active(void);
+
+// Call first in process_record_user; false = the key was read by the leader
+bool app_leader_process(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,85 @@
+/* Generated by scripts/generate-app-leader.js from app_leader.json - do not edit.
+ * Regenerate: node scripts/generate-app-leader.js
+ * inputs: 2405d74c85ec27c77f9991e08961454a9a2fdbfa
+ * 17 sequences, 28 states x 18 columns: 588 bytes of flash
+ */
+#pragma once
+
+#define APP_LEADER_STATES  28
+#define APP_LEADER_COLUMNS 18
+
+const uint8_t PROGMEM app_leader_columns = APP_LEADER_COLUMNS;
+
+// Column of each basic keycode (0 = in no sequence)
+const uint8_t PROGMEM app_leader_column[APP_LEADER_KEYCODES] = {
+    [KC_A] = 1,
+    [KC_B] = 2,
+    [KC_C] = 3,
+    [KC_F] = 4,
+    [KC_G] = 5,
+    [KC_I] = 6,
+    [KC_L] = 7,
+    [KC_M] = 8,
+    [KC_N] = 9,
+    [KC_O] = 10,
+    [KC_P] = 11,
+    [KC_R] = 12,
+    [KC_S] = 13,
+    [KC_T] = 14,
+    [KC_U] = 15,
+    [KC_V] = 16,
+    [KC_W] = 17,
+};
+
+// Next state at [state * APP_LEADER_COLUMNS + column] (0 = no sequence continues this way)
+const uint8_t PROGMEM app_leader_next[APP_LEADER_STATES * APP_LEADER_COLUMNS] = {
+    0, 1, 20, 5, 27, 0, 0, 0, 8, 22, 24, 0, 0, 11, 18, 0, 3, 15,  // 0: ""
+    0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 1: "a"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 2: "ai"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 26, 0, 4, 0, 0, 0, 0,  // 3: "v"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 4: "vs"
+    0, 6, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 5: "c"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 6: "ca"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 7: "cc"
+    0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 10, 0, 0,  // 8: "m"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 9: "ml"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 10: "mu"
+    0, 0, 0, 0, 0, 13, 0, 12, 0, 0, 0, 0, 14, 0, 0, 0, 0, 0,  // 11: "s"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 12: "sl"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 13: "sg"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 14: "sr"
+    0, 16, 0, 17, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 15: "w"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 16: "wa"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 17: "wc"
+    0, 0, 0, 0, 0, 19, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 18: "t"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 19: "tg"
+    0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 20: "b"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 21: "bg"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 23, 0, 0, 0, 0, 0, 0, 0,  // 22: "n"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 23: "no"
+    0, 0, 25, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 24: "o"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 25: "ob"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 26: "vp"
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 27: "f"
+};
+
+// Keycode tapped on reaching a state (KC_NO = read another key)
+const uint16_t PROGMEM app_leader_action[APP_LEADER_STATES] = {
+    [2] = KC_APP_CHATGPT,  // "ai": ChatGPT
+    [4] = KC_APP_VSCODE,  // "vs": VS Code
+    [6] = KC_APP_CAL,  // "ca": Calendar
+    [7] = KC_APP_CALC,  // "cc": Calculator
+    [9] = KC_APP_MAIL,  // "ml": Mail
+    [10] = KC_APP_MUSIC,  // "mu": NetEase Music
+    [12] = KC_APP_SLACK,  // "sl": Slack
+    [13] = KC_APP_SIGNAL,  // "sg": Signal
+    [14] = KC_APP_SHADOWROCKET_OPEN,  // "sr": Shadowrocket
+    [16] = KC_APP_WHATSAPP,  // "wa": WhatsApp
+    [17] = KC_APP_WECHAT,  // "wc": WeChat
+    [19] = KC_APP_TELEGRAM,  // "tg": Telegram
+    [21] = KC_APP_BGA,  // "bg": BGA
+    [23] = KC_APP_NOTION,  // "no": Notion
+    [25] = KC_APP_OBSIDIAN,  // "ob": Obsidian
+    [26] = KC_APP_VPN_SHADOWROCKET,  // "vp": Shadowrocket VPN toggle
+    [27] = KC_APP_FINDER,  // "f": Finder
+};
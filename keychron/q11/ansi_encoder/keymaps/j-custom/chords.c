@@ -0,0 +1,278 @@
+/* Chords - see chords.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "chords.h"
+#include "timer_wheel.h"
+
+#define SLOTS      (MATRIX_ROWS * MATRIX_COLS)
+#define MASK_WORDS ((SLOTS + 31) / 32)
+
+_Static_assert(SLOTS < CHORD_NONE, "chord slots are uint8_t");
+_Static_assert(CHORDS_MAX < CHORD_NONE, "chord indices are uint8_t");
+
+static const chord_t *chords      = NULL;
+static uint8_t        chord_count = 0;
+
+// Per-position index: chords containing slot s are refs[first[s] .. first[s + 1])
+static uint16_t first[SLOTS + 1];
+static uint8_t  refs[CHORDS_MAX * CHORD_MAX_KEYS];
+
+// Held-back presses, in order
+static keyevent_t pending[CHORD_MAX_KEYS];
+static uint8_t    pending_count = 0;
+static uint32_t   pending_mask[MASK_WORDS];
+
+// Fired chord: releases of its keys are swallowed, the first one releases the action
+static uint32_t consumed_mask[MASK_WORDS];
+static uint8_t  active = CHORD_NONE;
+
+static uint16_t last_press = 0;
+static bool     pressed_once = false;
+static bool     replaying    = false;
+
+// Replays the held-back keys CHORD_TERM after the first one
+static uint32_t            term_expired(void);
+static timer_wheel_timer_t term_timer = TIMER_WHEEL_TIMER(term_expired);
+
+// ============================================
+// Helpers
+// ============================================
+
+static inline bool mask_test(const uint32_t *mask, uint8_t slot) {
+    return mask[slot / 32] & (1UL << (slot % 32));
+}
+
+static inline void mask_set(uint32_t *mask, uint8_t slot) {
+    mask[slot / 32] |= 1UL << (slot % 32);
+}
+
+static inline void mask_clear(uint32_t *mask, uint8_t slot) {
+    mask[slot / 32] &= ~(1UL << (slot % 32));
+}
+
+static uint8_t slot_of(keypos_t key) {
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return CHORD_NONE;
+    }
+    return key.row * MATRIX_COLS + key.col;
+}
+
+static void read_chord(uint8_t index, chord_t *chord) {
+    memcpy_P(chord, &chords[index], sizeof(chord_t));
+}
+
+static bool on_layer(const chord_t *chord) {
+    return chord->layers & (1U << get_highest_layer(layer_state | default_layer_state));
+}
+
+// ============================================
+// Index
+// ============================================
+
+void chords_init(const chord_t *table, uint8_t count) {
+    chords      = table;
+    chord_count = count > CHORDS_MAX ? CHORDS_MAX : count;
+    memset(first, 0, sizeof(first));
+
+    // Count per slot into first[slot + 1], prefix sum, then fill
+    chord_t chord;
+    for (uint8_t i = 0; i < chord_count; i++) {
+        read_chord(i, &chord);
+        for (uint8_t k = 0; k < CHORD_MAX_KEYS; k++) {
+            if (chord.keys[k] < SLOTS) {
+                first[chord.keys[k] + 1]++;
+            }
+        }
+    }
+    for (uint16_t s = 0; s < SLOTS; s++) {
+        first[s + 1] += first[s];
+    }
+    uint16_t fill[SLOTS];
+    memcpy(fill, first, sizeof(fill));
+    for (uint8_t i = 0; i < chord_count; i++) {
+        read_chord(i, &chord);
+        for (uint8_t k = 0; k < CHORD_MAX_KEYS; k++) {
+            if (chord.keys[k] < SLOTS) {
+                refs[fill[chord.keys[k]]++] = i;
+            }
+        }
+    }
+}
+
+// ============================================
+// Matching
+// ============================================
+
+enum { MATCH_NONE, MATCH_PARTIAL, MATCH_COMPLETE };
+
+// Chord against the held-back keys: every one of them must be in the chord
+static uint8_t match(const chord_t *chord) {
+    uint8_t size = 0;
+    uint8_t held = 0;
+    for (uint8_t k = 0; k < CHORD_MAX_KEYS; k++) {
+        if (chord->keys[k] >= SLOTS) {
+            continue;
+        }
+        size++;
+        if (mask_test(pending_mask, chord->keys[k])) {
+            held++;
+        }
+    }
+    if (held < pending_count) {
+        return MATCH_NONE;
+    }
+    return held == size ? MATCH_COMPLETE : MATCH_PARTIAL;
+}
+
+// Best chord among those of slot (the key just pressed); *index set when complete
+static uint8_t match_slot(uint8_t slot, uint8_t *index) {
+    uint8_t best = MATCH_NONE;
+    chord_t chord;
+    for (uint16_t r = first[slot]; r < first[slot + 1]; r++) {
+        read_chord(refs[r], &chord);
+        if (!on_layer(&chord)) {
+            continue;
+        }
+        uint8_t m = match(&chord);
+        if (m == MATCH_COMPLETE) {
+            *index = refs[r];
+            return m;
+        }
+        if (m > best) {
+            best = m;
+        }
+    }
+    return best;
+}
+
+static bool starts_chord(uint8_t slot) {
+    chord_t chord;
+    for (uint16_t r = first[slot]; r < first[slot + 1]; r++) {
+        read_chord(refs[r], &chord);
+        if (on_layer(&chord)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================
+// Events
+// ============================================
+
+__attribute__((weak)) bool process_chord_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+static void run_action(uint8_t index, keyevent_t event) {
+    chord_t chord;
+    read_chord(index, &chord);
+    keyrecord_t record = {.event = event};
+    if (process_chord_user(chord.keycode, &record)) {
+        process_action(&record, action_for_keycode(chord.keycode));
+    }
+}
+
+// Hand the held-back presses to QMK as if they had just arrived
+static void flush(void) {
+    keyevent_t replay[CHORD_MAX_KEYS];
+    uint8_t    count = pending_count;
+    memcpy(replay, pending, sizeof(keyevent_t) * count);
+    pending_count = 0;
+    memset(pending_mask, 0, sizeof(pending_mask));
+    timer_wheel_cancel(&term_timer);
+
+    replaying = true;
+    for (uint8_t i = 0; i < count; i++) {
+        action_exec(replay[i]);
+    }
+    replaying = false;
+}
+
+static void hold_back(uint8_t slot, keyevent_t event) {
+    if (pending_count == 0) {
+        timer_wheel_schedule(&term_timer, CHORD_TERM);
+    }
+    pending[pending_count++] = event;
+    mask_set(pending_mask, slot);
+}
+
+static bool press(uint8_t slot, keyevent_t event) {
+    bool idle    = !pressed_once || TIMER_DIFF_16(event.time, last_press) >= CHORD_IDLE_MS;
+    last_press   = event.time;
+    pressed_once = true;
+
+    if (pending_count > 0) {
+        if (pending_count < CHORD_MAX_KEYS && first[slot] != first[slot + 1]) {
+            hold_back(slot, event);
+            uint8_t index = CHORD_NONE;
+            uint8_t m     = match_slot(slot, &index);
+            if (m == MATCH_COMPLETE) {
+                memcpy(consumed_mask, pending_mask, sizeof(consumed_mask));
+                pending_count = 0;
+                memset(pending_mask, 0, sizeof(pending_mask));
+                timer_wheel_cancel(&term_timer);
+                active = index;
+                run_action(index, event);
+                return false;
+            }
+            if (m == MATCH_PARTIAL) {
+                return false;
+            }
+            pending_count--;
+            mask_clear(pending_mask, slot);
+        }
+        // Cannot be part of the chord in progress: type what was held back, then this key
+        flush();
+        return true;
+    }
+
+    if (idle && starts_chord(slot)) {
+        hold_back(slot, event);
+        return false;
+    }
+    return true;
+}
+
+// A release of a held-back key means it was a normal tap; any other release
+// came after the held-back presses too, so they go first either way
+static bool release(uint8_t slot, keyevent_t event) {
+    if (pending_count > 0) {
+        flush();
+    }
+    if (mask_test(consumed_mask, slot)) {
+        mask_clear(consumed_mask, slot);
+        if (active != CHORD_NONE) {
+            run_action(active, event);
+            active = CHORD_NONE;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool chords_process(keyrecord_t *record) {
+    if (replaying || chord_count == 0 || IS_NOEVENT(record->event)) {
+        return true;
+    }
+    uint8_t slot = record->event.type == KEY_EVENT ? slot_of(record->event.key) : CHORD_NONE;
+    if (slot == CHORD_NONE) {
+        // Encoder turns, combos...: keep them behind the held-back presses
+        if (pending_count > 0) {
+            flush();
+        }
+        return true;
+    }
+    return record->event.pressed ? press(slot, record->event) : release(slot, record->event);
+}
+
+static uint32_t term_expired(void) {
+    flush();
+    return 0;
+}
@@ -0,0 +1,71 @@
+/* Chords: matrix positions pressed together as one action
+ *
+ * A chord is 2..CHORD_MAX_KEYS keys pressed within CHORD_TERM ms of the first
+ * one, all still held when the last goes down (F+J → CURSOR_LAYER instead of
+ * RGUI tap, J). Presses of chord keys are held back until the chord
+ * completes or can no longer complete; then they are replayed unchanged, so a
+ * chord key typed on its own behaves as before, only up to CHORD_TERM later.
+ * Keys in no chord are never delayed: any other event (a press elsewhere, a
+ * release such as Shift let go early, an encoder turn) replays the held-back
+ * presses first, so QMK sees every event in the order it happened.
+ *
+ * Matching cost does not grow with the number of chords:
+ *   - chords_init() builds a per-position index (the chords each matrix slot
+ *     belongs to), so a key in no chord costs one table read;
+ *   - held-back keys are a bitmask over matrix slots, and a press checks only
+ *     the chords of its own slot against it (CHORD_MAX_KEYS bit tests each).
+ *
+ * Misfires: a chord only starts when no key was pressed in the last
+ * CHORD_IDLE_MS, so rollover inside a word ("fj", "df") types normally.
+ * Each chord also lists the layers it works on (highest active layer).
+ *
+ * Held-back keys are replayed by a timer_wheel.h timer, not polled.
+ *
+ * Actions are keycodes: process_chord_user() sees them first (custom
+ * keycodes), anything it leaves goes through QMK's action_for_keycode()
+ * (basic keys, modifiers, TO/TG/MO...). The action is held until the first
+ * chord key is released.
+ *
+ * Host benchmark (latency, misfire rate on typing traces):
+ *   node scripts/chords/chord-bench.js
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef CHORD_MAX_KEYS
+#    define CHORD_MAX_KEYS 4
+#endif
+
+#ifndef CHORDS_MAX
+#    define CHORDS_MAX 32  // Chords the index has room for
+#endif
+
+#ifndef CHORD_TERM
+#    define CHORD_TERM 40  // ms from the first key to the last
+#endif
+
+#ifndef CHORD_IDLE_MS
+#    define CHORD_IDLE_MS 150  // Quiet time before a chord may start
+#endif
+
+#define CHORD_NONE 0xFF
+
+// Matrix slot of a key, as used in chord_t.keys
+#define CHORD_KEY(row, col) ((row) * MATRIX_COLS + (col))
+
+typedef struct {
+    uint8_t  keys[CHORD_MAX_KEYS];  // Matrix slots; unused entries CHORD_NONE
+    uint16_t layers;                // Bit per layer (highest active) the chord works on
+    uint16_t keycode;
+} chord_t;
+
+// Build the per-position index (table in PROGMEM; call from keyboard_post_init_user)
+void chords_init(const chord_t *table, uint8_t count);
+
+// Call from pre_process_record_user; false = held back or consumed by a chord
+bool chords_process(keyrecord_t *record);
+
+// Chord action hook (weak); return false when the keycode was handled
+bool process_chord_user(uint16_t keycode, keyrecord_t *record);
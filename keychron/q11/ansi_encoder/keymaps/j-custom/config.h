@@ -0,0 +1,52 @@
+/* Keymap config for Keychron Q11 ANSI Encoder (j-custom)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#pragma once
+
+#if defined(SPLIT_SYNC_ENABLE) || defined(SPLIT_LINK_ENABLE) || defined(SPLIT_HEALTH_ENABLE) || defined(SPLIT_HITS_ENABLE)
+// Batched master → slave state (split_sync.c), link rate negotiation (split_link.c),
+// slave health polls (split_health.c) and key hits for reactive RGB (split_hits.c)
+#    define SPLIT_TRANSACTION_IDS_USER RPC_ID_USER_SPLIT_SYNC, RPC_ID_USER_SPLIT_LINK, RPC_ID_USER_SPLIT_HEALTH, RPC_ID_USER_SPLIT_HITS
+#endif
+
+#ifdef SPLIT_LINK_ENABLE
+// Boot and fallback rate, the first entry of split_link.c's rate table
+#    define SERIAL_USART_SPEED 460800
+
+// Full duplex needs a second wire (A10 RX on the left half). The stock Q11
+// cable link only routes A9, so this stays half duplex unless the halves are
+// rewired; the right half would also need SERIAL_USART_PIN_SWAP if D+/D- land
+// the other way round.
+// #define SPLIT_LINK_FULL_DUPLEX
+#    ifdef SPLIT_LINK_FULL_DUPLEX
+#        define SERIAL_USART_FULL_DUPLEX
+#        define SERIAL_USART_TX_PIN A9
+#        define SERIAL_USART_RX_PIN A10
+#    endif
+#endif
+
+// EEPROM user datablock: key_stats' counters, then tap_tune's terms
+#ifdef KEY_STATS_ENABLE
+// sizeof(store_t) in key_stats.c
+// (12 + 2 * MATRIX_ROWS * MATRIX_COLS + 4 * KEY_STATS_LAYERS + 4 * KEY_STATS_KEYCODES)
+#    define KEY_STATS_DATA_SIZE 548
+#else
+#    define KEY_STATS_DATA_SIZE 0
+#endif
+
+#ifdef TAP_TUNE_ENABLE
+// sizeof(store_t) in tap_tune.c (4 + 4 * TAP_TUNE_KEYS)
+#    define TAP_TUNE_DATA_SIZE 36
+// Tap dance timeouts and the Spotlight double tap ask tap_tune.c (get_tapping_term in keymap.c)
+#    define TAPPING_TERM_PER_KEY
+#else
+#    define TAP_TUNE_DATA_SIZE 0
+#endif
+
+#if KEY_STATS_DATA_SIZE + TAP_TUNE_DATA_SIZE > 0
+#    define EECONFIG_USER_DATA_SIZE (KEY_STATS_DATA_SIZE + TAP_TUNE_DATA_SIZE)
+#endif
@@ -0,0 +1,21 @@
+/* Generated by scripts/generate-cursor-layer.js from cursor_layer.json - do not edit.
+ * Regenerate: node scripts/generate-cursor-layer.js
+ * inputs: 010f72f32fa47008b6170a0edea6ec0b905b61c7
+ */
+#pragma once
+
+#define CURSOR_MACRO_FIRST      KC_CURSOR_FOCUS_EDITOR
+#define CURSOR_MACRO_LAST       KC_CURSOR_APPLY_IN_EDITOR
+#define CURSOR_MACRO_MAX_CHORDS 1
+
+// Chords tapped in order for each CURSOR_LAYER action (KC_NO = end)
+static const uint16_t PROGMEM cursor_macro_chords[][CURSOR_MACRO_MAX_CHORDS] = {
+    // H: Focus editor - workbench.action.focusFirstEditorGroup (cmd+1)
+    [KC_CURSOR_FOCUS_EDITOR - CURSOR_MACRO_FIRST] = { LGUI(KC_1) },
+    // J: Previous change - workbench.action.editor.previousChange (shift+alt+f5)
+    [KC_CURSOR_PREV_CHANGE - CURSOR_MACRO_FIRST] = { LSFT(LALT(KC_F5)) },
+    // K: Next change - workbench.action.editor.nextChange (alt+f5)
+    [KC_CURSOR_NEXT_CHANGE - CURSOR_MACRO_FIRST] = { LALT(KC_F5) },
+    // L: Apply in editor - editor.action.inlineDiffs.acceptAll (cmd+enter)
+    [KC_CURSOR_APPLY_IN_EDITOR - CURSOR_MACRO_FIRST] = { LGUI(KC_ENT) },
+};
@@ -0,0 +1,168 @@
+/* Fast USB suspend/resume - see fast_resume.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include <hal.h>  // CMSIS DWT / CoreDebug, STM32_SYSCLK
+#include "fast_resume.h"
+#ifdef SPLIT_SYNC_ENABLE
+#    include "split_sync.h"
+#endif
+
+#ifdef RGB_MATRIX_SLEEP
+#    error "FAST_RESUME_ENABLE replaces rgb_matrix.sleep: post_config.h should have dropped RGB_MATRIX_SLEEP"
+#endif
+
+#define TICKS_PER_US (STM32_SYSCLK / 1000000)
+
+static fast_resume_stats_t stats;
+static bool                suspended      = false;  // Master: drivers off, resume not finished
+static bool                report_pending = false;  // Master: first report after the suspend not seen yet
+static bool                print_pending  = false;
+static uint32_t            suspend_time   = 0;      // timer_read32() at suspend entry
+static uint32_t            loop_ticks     = 0;      // CYCCNT at the last pass of the suspend loop
+static uint32_t            loop_time      = 0;      // timer_read32() at the same pass
+static volatile uint8_t    slave_leds_off = 0;      // Synced to the slave (FAST_RESUME_SYNC_ITEM), written by the RPC handler
+static uint8_t             slave_applied  = 0;      // Slave: state the drivers were last set to
+
+static inline uint32_t ticks(void) {
+    return DWT->CYCCNT;
+}
+
+// ============================================
+// LED drivers
+// ============================================
+
+// Registers are kept in shutdown: no PWM or LED control writes on either side
+static void leds_off(void) {
+    for (uint8_t i = 0; i < SNLED27351_DRIVER_COUNT; i++) {
+        snled27351_sw_shutdown(i);
+    }
+}
+
+static void leds_on(void) {
+    for (uint8_t i = 0; i < SNLED27351_DRIVER_COUNT; i++) {
+        snled27351_sw_return_normal(i);
+    }
+}
+
+// Slave main loop: the sync item only latches the flag, as the RPC handler
+// runs on the transport thread and the drivers share the I2C bus with rgb_matrix
+static void slave_task(void) {
+    uint8_t off = slave_leds_off;
+    if (off == slave_applied) {
+        return;
+    }
+    slave_applied = off;
+    if (off) {
+        leds_off();
+    } else {
+        leds_on();
+    }
+}
+
+// ============================================
+// Suspend / resume
+// ============================================
+
+void fast_resume_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;  // Cycle counter, left running if the profiler started it
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#ifdef SPLIT_SYNC_ENABLE
+    split_sync_register(FAST_RESUME_SYNC_ITEM, (void *)&slave_leds_off, sizeof(slave_leds_off), NULL);
+#endif
+}
+
+void fast_resume_suspend(void) {
+    if (!is_keyboard_master()) {
+        return;
+    }
+    loop_ticks = ticks();
+    loop_time  = timer_read32();
+    if (!suspended) {
+        suspended      = true;
+        report_pending = true;
+        suspend_time   = timer_read32();
+        slave_leds_off = 1;
+        leds_off();
+    }
+#ifdef SPLIT_SYNC_ENABLE
+    split_sync_task();  // Housekeeping does not run in the suspend loop: send the slave's item from here
+#endif
+}
+
+// First housekeeping pass after the suspend loop: the matrix has been scanned and reported.
+// Layers are left as they are: suspend does not touch them, and the key that
+// woke the board (an MO() held down) has already been processed
+void fast_resume_task(void) {
+    if (!is_keyboard_master()) {
+        slave_task();
+        return;
+    }
+    if (suspended) {
+        uint32_t start = ticks();
+        leds_on();
+        stats.restore_us = (ticks() - start) / TICKS_PER_US;
+        stats.slept_ms   = TIMER_DIFF_32(timer_read32(), suspend_time);
+        stats.resumes++;
+        suspended      = false;
+        slave_leds_off = 0;  // Goes out with this pass's split_sync_task
+        print_pending  = true;
+    }
+    if (report_pending && !suspended && TIMER_DIFF_32(timer_read32(), loop_time) >= FAST_RESUME_REPORT_WINDOW_MS) {
+        report_pending        = false;  // Woken by the host, or no key within the window
+        stats.first_report_us = FAST_RESUME_NO_REPORT;
+    }
+    if (print_pending && !report_pending) {
+        print_pending = false;
+#ifdef CONSOLE_ENABLE
+        if (stats.first_report_us == FAST_RESUME_NO_REPORT) {
+            uprintf("FAST_RESUME: slept %lums, no report, LEDs back %luus\n", (unsigned long)stats.slept_ms, (unsigned long)stats.restore_us);
+        } else {
+            uprintf("FAST_RESUME: slept %lums, first report %luus, LEDs back %luus\n", (unsigned long)stats.slept_ms, (unsigned long)stats.first_report_us,
+                    (unsigned long)stats.restore_us);
+        }
+#endif
+    }
+}
+
+const fast_resume_stats_t *fast_resume_stats(void) {
+    return &stats;
+}
+
+// ============================================
+// First report (-Wl,--wrap in rules.mk)
+// ============================================
+
+// CYCCNT wraps every 2^32 cycles (~54 s at 80 MHz): only a report inside the
+// window after the suspend loop is timed with it
+static void report_sent(void) {
+    if (report_pending && is_keyboard_master()) {
+        report_pending = false;
+        if (TIMER_DIFF_32(timer_read32(), loop_time) >= FAST_RESUME_REPORT_WINDOW_MS) {
+            stats.first_report_us = FAST_RESUME_NO_REPORT;
+            return;
+        }
+        stats.first_report_us = (ticks() - loop_ticks) / TICKS_PER_US;
+        if (stats.first_report_us > stats.max_first_report_us) {
+            stats.max_first_report_us = stats.first_report_us;
+        }
+    }
+}
+
+void __real_host_keyboard_send(report_keyboard_t *report);
+void __wrap_host_keyboard_send(report_keyboard_t *report) {
+    __real_host_keyboard_send(report);
+    report_sent();
+}
+
+#ifdef NKRO_ENABLE
+void __real_host_nkro_send(report_nkro_t *report);
+void __wrap_host_nkro_send(report_nkro_t *report) {
+    __real_host_nkro_send(report);
+    report_sent();
+}
+#endif
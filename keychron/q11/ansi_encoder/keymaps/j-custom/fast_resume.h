@@ -0,0 +1,61 @@
+/* Fast USB suspend/resume
+ *
+ * With rgb_matrix.sleep QMK blanks the LEDs on suspend by rendering the "off"
+ * effect and flushing it; on resume the effect sees a mode change and starts
+ * from its init state (rain and reactive effects come back empty, the heatmap
+ * is cleared), and every PWM register is written again. Here instead:
+ *   - suspend: the time is kept in RAM and each SNLED27351 goes into
+ *     software shutdown. The chip keeps its PWM and LED control registers,
+ *     and the RGB task is left as it was (it does not run while the master
+ *     loops in QMK's suspend path), so nothing is re-rendered;
+ *   - resume: the keyboard task scans and reports first; the next housekeeping
+ *     pass brings each driver back with the shutdown register alone. Layers
+ *     are not touched: the wakeup key (an MO() held) is already applied;
+ *   - the slave half follows through a split_sync.h item (SPLIT_SYNC_ENABLE),
+ *     applied from the slave's housekeeping, not the transport thread.
+ * post_config.h drops RGB_MATRIX_SLEEP so QMK's own blanking stays out of it.
+ * The effects keep their state but not their phase: they run on the split
+ * sync timer, which counts through the suspend.
+ *
+ * Per resume (console and fast_resume_stats()): how long the host slept, the
+ * time from the last pass of the suspend loop (which waits 1 ms per pass) to
+ * the first keyboard report (seen by wrapping host_keyboard_send /
+ * host_nkro_send with -Wl,--wrap, see rules.mk) and the time the LED drivers
+ * took to come back. A resume with no report within
+ * FAST_RESUME_REPORT_WINDOW_MS (host wakeup, no key pressed) records
+ * FAST_RESUME_NO_REPORT rather than timing a later, unrelated report.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef FAST_RESUME_SYNC_ITEM
+#    define FAST_RESUME_SYNC_ITEM SPLIT_SYNC_USER  // split_sync.h item carrying the suspend flag
+#endif
+
+#ifndef FAST_RESUME_REPORT_WINDOW_MS
+#    define FAST_RESUME_REPORT_WINDOW_MS 1000  // First report timed only this soon after the suspend loop (well inside a CYCCNT wrap)
+#endif
+
+#define FAST_RESUME_NO_REPORT UINT32_MAX  // first_report_us when no report came within the window
+
+typedef struct {
+    uint32_t resumes;
+    uint32_t slept_ms;          // Last suspend, from entry to wakeup
+    uint32_t first_report_us;   // Last resume: suspend loop exit → first keyboard report, or FAST_RESUME_NO_REPORT
+    uint32_t restore_us;        // Last resume: LED drivers back to normal mode
+    uint32_t max_first_report_us;
+} fast_resume_stats_t;
+
+// Register the slave item (call from keyboard_post_init_user, both halves, after split_sync_init)
+void fast_resume_init(void);
+
+// Call from suspend_power_down_user (every pass of QMK's suspend loop)
+void fast_resume_suspend(void);
+
+// Call from housekeeping_task_user, both halves: finishes a resume on the first pass after it
+// (master), switches the drivers to the synced state (slave)
+void fast_resume_task(void);
+
+const fast_resume_stats_t *fast_resume_stats(void);
@@ -0,0 +1,146 @@
+/* Host context channel (raw HID) - see host_context.h for the protocol
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "raw_hid.h"
+#include "host_context.h"
+#include "timer_wheel.h"
+
+static uint16_t active_app      = HC_APP_NONE;
+static uint32_t active_layers   = 0;
+static uint8_t  active_helper   = HOST_CONTEXT_NO_LAYER;
+static uint32_t managed_mask    = 0;      // Union of all overlay masks in the table
+static bool     managed_ready   = false;
+
+// Clears the context HOST_CONTEXT_TIMEOUT after the last message
+static uint32_t            daemon_silent(void);
+static timer_wheel_timer_t expiry = TIMER_WHEEL_TIMER(daemon_silent);
+
+static uint32_t table_managed_mask(void) {
+    if (!managed_ready) {
+        for (uint8_t i = 0; i < host_context_table_size; i++) {
+            managed_mask |= pgm_read_dword(&host_context_table[i].layers);
+        }
+        managed_ready = true;
+    }
+    return managed_mask;
+}
+
+// Replace the managed overlay bits in one commit; user-selected layers are untouched
+static void apply_layers(uint32_t layers) {
+    layer_state_t state = (layer_state & ~(layer_state_t)table_managed_mask()) | (layer_state_t)layers;
+    active_layers       = layers;
+    if (state != layer_state) {
+        layer_state_set(state);
+    }
+}
+
+__attribute__((weak)) void host_context_changed_user(uint16_t app_id) {}
+
+static bool set_context(uint16_t app_id) {
+    uint16_t previous = active_app;
+    bool     found    = false;
+    active_app        = HC_APP_NONE;
+    active_helper     = HOST_CONTEXT_NO_LAYER;
+    uint32_t layers   = 0;
+    for (uint8_t i = 0; i < host_context_table_size; i++) {
+        if (pgm_read_word(&host_context_table[i].app_id) == app_id) {
+            active_app    = app_id;
+            active_helper = pgm_read_byte(&host_context_table[i].helper_layer);
+            layers        = pgm_read_dword(&host_context_table[i].layers);
+            found         = true;
+            break;
+        }
+    }
+    apply_layers(layers);
+    if (active_app != previous) {
+        host_context_changed_user(active_app);
+    }
+    return found;
+}
+
+bool host_context_receive(uint8_t *data, uint8_t length) {
+    if (length < 11 || data[0] != HOST_CONTEXT_CHANNEL) {
+        return false;
+    }
+
+    uint8_t opcode = data[1];
+    uint8_t status = HOST_CONTEXT_OK;
+#ifdef CONSOLE_ENABLE
+    uint16_t previous_app    = active_app;
+    uint32_t previous_layers = active_layers;
+#endif
+    timer_wheel_schedule(&expiry, HOST_CONTEXT_TIMEOUT);
+
+    switch (opcode) {
+        case HOST_CONTEXT_OP_SET:
+            if (!set_context(data[3] | (data[4] << 8))) {
+                status = HOST_CONTEXT_UNKNOWN_APP;
+            }
+            break;
+        case HOST_CONTEXT_OP_CLEAR:
+            set_context(HC_APP_NONE);
+            break;
+        case HOST_CONTEXT_OP_PING:
+        case HOST_CONTEXT_OP_QUERY:
+            break;
+        default:
+            status = HOST_CONTEXT_BAD_REQUEST;
+            break;
+    }
+
+    // Reply in place: seq (data[2]) is echoed unchanged
+    uint32_t state = (uint32_t)layer_state;
+    memset(data + 3, 0, length - 3);
+    data[1]  = opcode | HOST_CONTEXT_REPLY;
+    data[3]  = status;
+    data[4]  = active_app & 0xFF;
+    data[5]  = active_app >> 8;
+    data[6]  = state & 0xFF;
+    data[7]  = (state >> 8) & 0xFF;
+    data[8]  = (state >> 16) & 0xFF;
+    data[9]  = (state >> 24) & 0xFF;
+    data[10] = active_helper;
+    raw_hid_send(data, length);
+
+#ifdef CONSOLE_ENABLE
+    // Changes and errors only, not every heartbeat PING
+    if (active_app != previous_app || active_layers != previous_layers || status != HOST_CONTEXT_OK) {
+        uprintf("HOST_CONTEXT: op=%u app=%u layers=0x%08lX status=%u\n", opcode, active_app, (unsigned long)active_layers, status);
+    }
+#endif
+    return true;
+}
+
+static uint32_t daemon_silent(void) {
+    if (active_app != HC_APP_NONE) {
+#ifdef CONSOLE_ENABLE
+        uprintf("HOST_CONTEXT: daemon silent for %ums, clearing context\n", HOST_CONTEXT_TIMEOUT);
+#endif
+        set_context(HC_APP_NONE);
+    }
+    return 0;
+}
+
+uint32_t host_context_layers(void) {
+    return active_layers;
+}
+
+uint16_t host_context_app(void) {
+    return active_app;
+}
+
+uint8_t host_context_helper_layer(uint8_t fallback) {
+    return active_helper == HOST_CONTEXT_NO_LAYER ? fallback : active_helper;
+}
+
+void host_context_restore(void) {
+    if (active_layers) {
+        apply_layers(active_layers);
+    }
+}
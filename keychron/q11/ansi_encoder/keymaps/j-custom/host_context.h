@@ -0,0 +1,84 @@
+/* Host context channel (raw HID)
+ *
+ * A host daemon (scripts/host-context/host-context-daemon.js) pushes the ID of
+ * the focused application. The keymap maps it through a flash table to:
+ *   - layers:       overlay layers applied immediately while the app is focused
+ *                   (e.g. NUMPAD in a spreadsheet)
+ *   - helper_layer: layer opened by the RGUI tap instead of NAV_LAYER
+ *                   (e.g. CURSOR_LAYER in Cursor: RGUI, action instead of RGUI, J, action)
+ * Overlay changes are applied with a single layer_state_set() commit, and
+ * host_context_changed_user() is told when the focused app changes.
+ *
+ * Report layout (RAW_EPSIZE bytes, little-endian):
+ *   Request: [0] HOST_CONTEXT_CHANNEL  [1] opcode  [2] seq  [3..4] app id (SET)
+ *   Reply:   [0] HOST_CONTEXT_CHANNEL  [1] opcode | HOST_CONTEXT_REPLY  [2] seq  [3] status
+ *            [4..5] active app id  [6..9] layer_state  [10] helper layer
+ *
+ * The daemon sends HOST_CONTEXT_OP_PING as a heartbeat; without any message for
+ * HOST_CONTEXT_TIMEOUT ms the context is cleared so a dead daemon cannot leave
+ * overlay layers behind (a timer_wheel.h timer, re-armed by every message).
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HOST_CONTEXT_CHANNEL 0x43  // 'C': first byte of every host context report
+#define HOST_CONTEXT_REPLY   0x80  // OR'ed into the opcode of replies
+
+#ifndef HOST_CONTEXT_TIMEOUT
+#    define HOST_CONTEXT_TIMEOUT 5000  // ms without a message before the context is cleared
+#endif
+
+#define HOST_CONTEXT_NO_LAYER 0xFF
+
+enum host_context_opcode {
+    HOST_CONTEXT_OP_SET   = 0x01,  // Focused app changed: [3..4] app id
+    HOST_CONTEXT_OP_CLEAR = 0x02,  // No known app focused
+    HOST_CONTEXT_OP_PING  = 0x03,  // Heartbeat / latency probe
+    HOST_CONTEXT_OP_QUERY = 0x04,  // Report current state only
+};
+
+enum host_context_status {
+    HOST_CONTEXT_OK          = 0x00,
+    HOST_CONTEXT_UNKNOWN_APP = 0x01,  // Not in the table: context cleared
+    HOST_CONTEXT_BAD_REQUEST = 0x02,
+};
+
+// Application IDs shared with the host daemon (it reads this enum by name)
+enum host_context_app {
+    HC_APP_NONE           = 0,
+    HC_APP_CURSOR         = 1,
+    HC_APP_VSCODE         = 2,
+    HC_APP_TERMINAL       = 3,
+    HC_APP_BROWSER        = 4,
+    HC_APP_REMOTE_DESKTOP = 5,
+};
+
+typedef struct {
+    uint16_t app_id;
+    uint32_t layers;        // Overlay layer mask applied while focused
+    uint8_t  helper_layer;  // RGUI tap target, HOST_CONTEXT_NO_LAYER for NAV_LAYER
+} host_context_entry_t;
+
+// Defined by the keymap (PROGMEM)
+extern const host_context_entry_t host_context_table[];
+extern const uint8_t              host_context_table_size;
+
+// Handle a host context report; returns false if data is not for this channel
+bool host_context_receive(uint8_t *data, uint8_t length);
+
+// Overlay layers currently applied by the host context
+uint32_t host_context_layers(void);
+
+// Focused app from the table, HC_APP_NONE if none
+uint16_t host_context_app(void);
+
+// Called when the focused app changes (weak, for the keymap)
+void host_context_changed_user(uint16_t app_id);
+
+// Helper layer for the focused app, or fallback if none
+uint8_t host_context_helper_layer(uint8_t fallback);
+
+// Re-apply the overlay after the keymap reset the layer state (return to base)
+void host_context_restore(void);
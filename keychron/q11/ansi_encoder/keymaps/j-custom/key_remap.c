@@ -0,0 +1,102 @@
+/* Key remap - see key_remap.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "keymap_introspection.h"
+#include "key_remap.h"
+
+#define MODS_SIDE  0x10  // In 5-bit mods: right-hand modifiers
+#define MODS_KINDS 0x0F  // In 5-bit mods: Ctrl, Shift, Alt, GUI
+
+static const key_remap_profile_t *profile = NULL;
+static uint8_t                    mod_map[16];  // 4-bit mods → remapped, from profile->mods
+
+// ============================================
+// Modifiers
+// ============================================
+
+static uint8_t map_mods(uint8_t mods) {
+    return (mods & MODS_SIDE) | mod_map[mods & MODS_KINDS];
+}
+
+static uint16_t map_keycode_mods(uint16_t keycode) {
+    if (IS_MODIFIER_KEYCODE(keycode)) {
+        uint8_t index = keycode - KC_LEFT_CTRL;  // Left Ctrl..GUI, then right
+        uint8_t kind  = __builtin_ctz(mod_map[1 << (index & 3)]);
+        return KC_LEFT_CTRL + (index & 4) + kind;
+    }
+    if (IS_QK_MODS(keycode) || IS_QK_MOD_TAP(keycode)) {
+        return (keycode & ~0x1F00) | (map_mods((keycode >> 8) & 0x1F) << 8);
+    }
+    if (IS_QK_ONE_SHOT_MOD(keycode) || IS_QK_LAYER_MOD(keycode)) {
+        return (keycode & ~0x1F) | map_mods(keycode & 0x1F);
+    }
+    return keycode;
+}
+
+// ============================================
+// API
+// ============================================
+
+void key_remap_set(const key_remap_profile_t *new_profile) {
+    if (new_profile == profile) {
+        return;
+    }
+    clear_keyboard();  // Held keys would release a different keycode than they pressed
+    profile = new_profile;
+    for (uint8_t mods = 0; mods < 16; mods++) {
+        uint8_t mapped = 0;
+        for (uint8_t kind = 0; kind < 4; kind++) {
+            if (mods & (1 << kind)) {
+                mapped |= 1 << (profile ? profile->mods[kind] : kind);
+            }
+        }
+        mod_map[mods] = mapped;
+    }
+#ifdef CONSOLE_ENABLE
+    uprintf("KEY_REMAP: %s\n", profile ? "profile set" : "off");
+#endif
+}
+
+const key_remap_profile_t *key_remap_get(void) {
+    return profile;
+}
+
+uint16_t key_remap_keycode(uint8_t layer, uint16_t keycode, bool key) {
+    if (!profile || keycode == KC_NO || keycode == KC_TRNS) {
+        return keycode;
+    }
+    if (key) {
+        for (uint8_t i = 0; i < profile->key_count; i++) {
+            key_remap_key_t entry;
+            memcpy_P(&entry, &profile->keys[i], sizeof(entry));
+            if (entry.from == keycode && (entry.layer == KEY_REMAP_ANY_LAYER || entry.layer == layer)) {
+                return entry.to;
+            }
+        }
+    }
+    return map_keycode_mods(keycode);
+}
+
+// ============================================
+// Keymap lookup (weak in QMK's keymap_common.c)
+// ============================================
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        return key_remap_keycode(layer, keycode_at_keymap_location(layer, key.row, key.col), true);
+    }
+#if defined(ENCODER_ENABLE) && defined(ENCODER_MAP_ENABLE)
+    if (key.row == KEYLOC_ENCODER_CW && key.col < NUM_ENCODERS) {
+        return key_remap_keycode(layer, keycode_at_encodermap_location(layer, key.col, true), false);
+    }
+    if (key.row == KEYLOC_ENCODER_CCW && key.col < NUM_ENCODERS) {
+        return key_remap_keycode(layer, keycode_at_encodermap_location(layer, key.col, false), false);
+    }
+#endif
+    return KC_NO;
+}
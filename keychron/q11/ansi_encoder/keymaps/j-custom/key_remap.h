@@ -0,0 +1,55 @@
+/* Key remap: per-OS profile translation of the resolved keycodes
+ *
+ * Instead of a full copy of each layer per OS, a profile holds only the
+ * difference and is applied to every keycode the keymap lookup returns
+ * (keymap_key_to_keycode, so the action layer and process_record agree):
+ *   - mods: Ctrl, Shift, Alt and GUI each mapped to another modifier, in
+ *     modifier keys (KC_LGUI → KC_LCTL), modded keys (LGUI(KC_C) →
+ *     LCTL(KC_C)), mod-taps, one-shot mods and LM();
+ *   - keys: exact replacements, for one layer (the layer the key resolved
+ *     on) or any, taken as is without the modifier mapping. Switch positions
+ *     only: encoder turns get the modifier mapping alone.
+ * Transparent keys stay transparent, so layer resolution is unchanged.
+ *
+ * Switching profiles is one pointer store. Keys held across a switch are
+ * released first, since their release would look up a different keycode.
+ * Encoder maps and sparse_keymap.h work underneath it; DIP_SWITCH_MAP_ENABLE
+ * overrides the same lookup and cannot be combined with it.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(DIP_SWITCH_MAP_ENABLE)
+#    error "KEY_REMAP_ENABLE replaces keymap_key_to_keycode, which DIP_SWITCH_MAP_ENABLE needs; enable only one"
+#endif
+
+#define KEY_REMAP_ANY_LAYER 0xFF
+
+// Modifiers, in QMK's mod bit order
+enum key_remap_mod {
+    KEY_REMAP_CTRL,
+    KEY_REMAP_SHIFT,
+    KEY_REMAP_ALT,
+    KEY_REMAP_GUI,
+};
+
+typedef struct {
+    uint8_t  layer;  // Layer the key resolved on, or KEY_REMAP_ANY_LAYER
+    uint16_t from;
+    uint16_t to;
+} key_remap_key_t;
+
+typedef struct {
+    uint8_t                mods[4];  // Replacement of Ctrl, Shift, Alt, GUI (key_remap_mod)
+    const key_remap_key_t *keys;     // PROGMEM, first match wins
+    uint8_t                key_count;
+} key_remap_profile_t;
+
+// Profile in use, NULL for none (the layers as they are)
+void                       key_remap_set(const key_remap_profile_t *profile);
+const key_remap_profile_t *key_remap_get(void);
+
+// Keycode of a switch (key = true) or encoder turn on layer, after the profile
+uint16_t key_remap_keycode(uint8_t layer, uint16_t keycode, bool key);
@@ -0,0 +1,330 @@
+/* Key usage statistics - see key_stats.h for the report layout
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "raw_hid.h"
+#include "key_stats.h"
+#include "timer_wheel.h"
+
+#define STORE_MAGIC 0x55535431  // "UST1"
+#define KEY_SLOTS   (MATRIX_ROWS * MATRIX_COLS)
+#define HEADER_LEN  5
+
+typedef struct {
+    uint16_t keycode;
+    uint16_t presses;
+} keycode_count_t;
+
+// Saved as-is in the EEPROM user datablock
+typedef struct {
+    uint32_t        magic;
+    uint16_t        epochs;    // Halvings so far
+    uint16_t        peak_wpm;
+    uint16_t        overflow;  // Presses of keycodes that found the table full
+    uint16_t        used;      // Keycode table slots in use
+    uint16_t        keys[KEY_SLOTS];
+    uint32_t        dwell_s[KEY_STATS_LAYERS];
+    keycode_count_t keycodes[KEY_STATS_KEYCODES];
+} store_t;
+
+_Static_assert(sizeof(store_t) <= KEY_STATS_DATA_SIZE, "KEY_STATS_DATA_SIZE too small for key_stats (see config.h)");
+
+static store_t  store;
+static bool     dirty = false;
+static uint16_t saves = 0;
+
+// Layer dwell
+static uint8_t  dwell_layer = 0;
+static uint32_t dwell_since = 0;
+static uint16_t dwell_ms[KEY_STATS_LAYERS];  // Sub-second remainders
+
+// Rolling WPM
+static uint8_t  wpm_chars[KEY_STATS_WPM_BUCKETS];
+static uint8_t  wpm_bucket = 0;
+static uint32_t wpm_since  = 0;
+
+// Periodic work (timer_wheel.h): dwell every second, WPM buckets, EEPROM save
+static uint32_t            dwell_tick(void);
+static uint32_t            wpm_tick(void);
+static uint32_t            save_tick(void);
+static timer_wheel_timer_t dwell_timer = TIMER_WHEEL_TIMER(dwell_tick);
+static timer_wheel_timer_t wpm_timer   = TIMER_WHEEL_TIMER(wpm_tick);
+static timer_wheel_timer_t save_timer  = TIMER_WHEEL_TIMER(save_tick);
+
+// ============================================
+// Counters
+// ============================================
+
+// Halve every press count
+static void decay(void) {
+    for (uint16_t i = 0; i < KEY_SLOTS; i++) {
+        store.keys[i] >>= 1;
+    }
+    for (uint16_t i = 0; i < store.used; i++) {
+        store.keycodes[i].presses >>= 1;
+    }
+    store.overflow >>= 1;
+    store.epochs++;
+}
+
+// Free the slots of keycodes that decayed to zero
+static void compact(void) {
+    uint16_t kept = 0;
+    for (uint16_t i = 0; i < store.used; i++) {
+        if (store.keycodes[i].presses > 0) {
+            store.keycodes[kept++] = store.keycodes[i];
+        }
+    }
+    store.used = kept;
+}
+
+static void bump(uint16_t *count) {
+    if (*count == UINT16_MAX) {
+        decay();
+    }
+    (*count)++;
+}
+
+static void count_keycode(uint16_t keycode) {
+    for (uint16_t i = 0; i < store.used; i++) {
+        if (store.keycodes[i].keycode == keycode) {
+            bump(&store.keycodes[i].presses);
+            return;
+        }
+    }
+    if (store.used == KEY_STATS_KEYCODES) {
+        compact();
+    }
+    if (store.used < KEY_STATS_KEYCODES) {
+        store.keycodes[store.used++] = (keycode_count_t){keycode, 1};
+    } else if (store.overflow < UINT16_MAX) {
+        store.overflow++;
+    }
+}
+
+// Letters, digits, space and punctuation; tap-hold keys count when tapped
+static bool is_typing(uint16_t keycode, keyrecord_t *record) {
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        if (record->tap.count == 0) {
+            return false;
+        }
+        keycode &= 0xFF;
+    }
+    return (keycode >= KC_A && keycode <= KC_0) || (keycode >= KC_SPACE && keycode <= KC_SLASH);
+}
+
+void key_stats_record(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return;
+    }
+    uint8_t row = record->event.key.row;
+    uint8_t col = record->event.key.col;
+    if (row < MATRIX_ROWS && col < MATRIX_COLS) {
+        bump(&store.keys[row * MATRIX_COLS + col]);
+    }
+    if (keycode > QK_BASIC_MAX) {
+        count_keycode(keycode);
+    }
+    if (is_typing(keycode, record) && wpm_chars[wpm_bucket] < UINT8_MAX) {
+        wpm_chars[wpm_bucket]++;
+    }
+    dirty = true;
+}
+
+static uint16_t current_wpm(void) {
+    uint16_t chars = 0;
+    for (uint8_t i = 0; i < KEY_STATS_WPM_BUCKETS; i++) {
+        chars += wpm_chars[i];
+    }
+    return chars / 5;  // Window is one minute, a word is five characters
+}
+
+// ============================================
+// EEPROM
+// ============================================
+
+static void reset_store(void) {
+    memset(&store, 0, sizeof(store));
+    store.magic = STORE_MAGIC;
+}
+
+static void save(void) {
+    eeconfig_update_user_datablock(&store, 0, sizeof(store));
+    dirty = false;
+    saves++;
+    timer_wheel_schedule(&save_timer, KEY_STATS_SAVE_MS);
+}
+
+void key_stats_eeconfig_init(void) {
+    reset_store();
+    eeconfig_update_user_datablock(&store, 0, sizeof(store));
+}
+
+void key_stats_init(void) {
+    eeconfig_read_user_datablock(&store, 0, sizeof(store));
+    if (store.magic != STORE_MAGIC || store.used > KEY_STATS_KEYCODES) {
+        reset_store();
+    }
+    dwell_since = timer_read32();
+    wpm_since   = dwell_since;
+    if (is_keyboard_master()) {
+        timer_wheel_schedule(&dwell_timer, 1000);
+        timer_wheel_schedule(&wpm_timer, KEY_STATS_WPM_BUCKET_MS);
+        timer_wheel_schedule(&save_timer, KEY_STATS_SAVE_MS);
+    }
+}
+
+// ============================================
+// Task
+// ============================================
+
+static void credit_dwell(uint8_t layer, uint32_t ms) {
+    if (layer >= KEY_STATS_LAYERS) {
+        return;
+    }
+    ms += dwell_ms[layer];
+    dwell_ms[layer] = ms % 1000;
+    if (ms >= 1000) {
+        store.dwell_s[layer] += ms / 1000;
+        dirty = true;
+    }
+}
+
+// Credit the time since the last settle to the layer it was spent on
+static void settle_dwell(uint8_t layer) {
+    if (last_input_activity_elapsed() < KEY_STATS_IDLE_MS) {
+        credit_dwell(dwell_layer, timer_elapsed32(dwell_since));
+    }
+    dwell_layer = layer;
+    dwell_since = timer_read32();
+}
+
+static uint32_t dwell_tick(void) {
+    settle_dwell(dwell_layer);
+    return 1000;
+}
+
+// Advance the WPM window, clearing buckets that passed while the timer was late
+static uint32_t wpm_tick(void) {
+    while (timer_elapsed32(wpm_since) >= KEY_STATS_WPM_BUCKET_MS) {
+        wpm_since += KEY_STATS_WPM_BUCKET_MS;
+        wpm_bucket = (wpm_bucket + 1) % KEY_STATS_WPM_BUCKETS;
+        wpm_chars[wpm_bucket] = 0;
+        uint16_t wpm = current_wpm();
+        if (wpm > store.peak_wpm) {
+            store.peak_wpm = wpm;
+            dirty          = true;
+        }
+    }
+    return KEY_STATS_WPM_BUCKET_MS - timer_elapsed32(wpm_since);
+}
+
+static uint32_t save_tick(void) {
+    if (dirty) {
+        save();  // Re-arms save_timer
+        return 0;
+    }
+    return KEY_STATS_SAVE_MS;
+}
+
+// Layer changes end a dwell interval; everything timed runs on the timer wheel
+void key_stats_task(void) {
+    if (!is_keyboard_master()) {
+        return;
+    }
+    uint8_t layer = get_highest_layer(layer_state | default_layer_state);
+    if (layer != dwell_layer) {
+        settle_dwell(layer);
+    }
+}
+
+// ============================================
+// Raw HID
+// ============================================
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+    return put16(put16(p, v & 0xFFFF), v >> 16);
+}
+
+// Entries of the section starting at first that fit in one reply
+static uint8_t window(uint16_t total, uint8_t first, uint8_t entry_size, uint8_t length) {
+    uint8_t fit = (length - HEADER_LEN) / entry_size;
+    if (first >= total) {
+        return 0;
+    }
+    return total - first < fit ? total - first : fit;
+}
+
+bool key_stats_receive(uint8_t *data, uint8_t length) {
+    if (length < 32 || data[0] != KEY_STATS_CHANNEL) {
+        return false;
+    }
+
+    uint8_t opcode  = data[1];
+    uint8_t section = data[2];
+    uint8_t first   = data[3];
+    uint8_t count   = 0;
+    if (opcode == KEY_STATS_OP_RESET) {
+        reset_store();
+        memset(wpm_chars, 0, sizeof(wpm_chars));
+        save();
+    } else if (opcode == KEY_STATS_OP_SAVE && dirty) {
+        save();
+    }
+
+    memset(data + 4, 0, length - 4);
+    data[1]    = opcode | KEY_STATS_REPLY;
+    uint8_t *p = data + HEADER_LEN;
+    switch (section) {
+        case KEY_STATS_SECTION_SUMMARY:
+            count = 1;
+            p[0]  = KEY_SLOTS;
+            p[1]  = KEY_STATS_LAYERS;
+            p[2]  = store.used;
+            p[3]  = KEY_STATS_KEYCODES;
+            p     = put16(p + 4, store.epochs);
+            p     = put16(p, current_wpm());
+            p     = put16(p, store.peak_wpm);
+            p     = put16(p, SAFE_RANGE);
+            p     = put16(p, store.overflow);
+            p     = put16(p, saves);
+            p     = put32(p, timer_read32() / 1000);
+            break;
+        case KEY_STATS_SECTION_KEYS:
+            count = window(KEY_SLOTS, first, 2, length);
+            for (uint8_t i = 0; i < count; i++) {
+                p = put16(p, store.keys[first + i]);
+            }
+            break;
+        case KEY_STATS_SECTION_LAYERS:
+            count = window(KEY_STATS_LAYERS, first, 4, length);
+            for (uint8_t i = 0; i < count; i++) {
+                p = put32(p, store.dwell_s[first + i]);
+            }
+            break;
+        case KEY_STATS_SECTION_KEYCODES:
+            count = window(store.used, first, 4, length);
+            for (uint8_t i = 0; i < count; i++) {
+                p = put16(p, store.keycodes[first + i].keycode);
+                p = put16(p, store.keycodes[first + i].presses);
+            }
+            break;
+        default:
+            data[1] = 0xFF;  // Unknown section
+            break;
+    }
+    data[4] = count;
+    raw_hid_send(data, length);
+    return true;
+}
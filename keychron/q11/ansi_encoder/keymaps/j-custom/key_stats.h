@@ -0,0 +1,86 @@
+/* Key usage statistics (raw HID export)
+ *
+ * Fixed-memory counters on the master half, to see which layers, launchers
+ * and window shortcuts are actually used:
+ *   - presses per matrix position (u16, saturating): when one would overflow,
+ *     every press count (positions and keycodes) is halved, so old usage decays
+ *     and the ratios stay comparable; epochs counts the halvings
+ *   - dwell time per layer (highest active layer, seconds), not counting time
+ *     with no input for KEY_STATS_IDLE_MS
+ *   - presses per keycode above the basic range (custom keycodes, tap dances,
+ *     modifier macros such as the LAG() launchers, layer keys) in a table of
+ *     KEY_STATS_KEYCODES entries; keycodes beyond that land in "overflow"
+ *   - rolling WPM over the last minute (characters / 5) and its peak
+ * The counters are saved to the EEPROM user datablock every KEY_STATS_SAVE_MS
+ * when they changed (wear leveling rewrites only the changed bytes), so a
+ * plug-out loses at most that much. Each half that can be master keeps its own
+ * copy: counts follow the half the USB cable is plugged into.
+ *
+ * Host export: scripts/key-stats/key-stats.js (CSV or JSON).
+ *
+ * Raw HID request: [0] KEY_STATS_CHANNEL  [1] opcode  [2] section  [3] first index
+ * Reply:           [0] KEY_STATS_CHANNEL  [1] opcode | KEY_STATS_REPLY  [2] section
+ *                  [3] first index  [4] entries in this reply  [5..] entries (LE)
+ *   SUMMARY:  one entry: key slots, layers, keycode slots used, keycode slots
+ *             (u8 each), epochs, current WPM, peak WPM, SAFE_RANGE, overflow,
+ *             saves since boot (u16 each), uptime s (u32)
+ *   KEYS:     press counts (u16) from matrix slot row * MATRIX_COLS + col
+ *   LAYERS:   dwell seconds (u32) from layer index
+ *   KEYCODES: keycode, presses (u16 each) from table slot
+ * A reply carries as many entries as fit; the host asks again from
+ * first index + entries until it has all of them.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define KEY_STATS_CHANNEL 0x55  // 'U': first byte of every usage report
+#define KEY_STATS_REPLY   0x80
+
+#ifndef KEY_STATS_LAYERS
+#    define KEY_STATS_LAYERS 16
+#endif
+
+#ifndef KEY_STATS_KEYCODES
+#    define KEY_STATS_KEYCODES 64
+#endif
+
+#ifndef KEY_STATS_SAVE_MS
+#    define KEY_STATS_SAVE_MS 1800000  // 30 min between EEPROM saves (only when changed)
+#endif
+
+#ifndef KEY_STATS_IDLE_MS
+#    define KEY_STATS_IDLE_MS 60000  // No input for this long: layer dwell stops counting
+#endif
+
+#define KEY_STATS_WPM_BUCKETS   12  // Rolling WPM window: 12 x 5 s
+#define KEY_STATS_WPM_BUCKET_MS 5000
+
+enum key_stats_opcode {
+    KEY_STATS_OP_READ  = 0x01,  // [2] section  [3] first index
+    KEY_STATS_OP_RESET = 0x02,  // Zero all counters (and the saved copy)
+    KEY_STATS_OP_SAVE  = 0x03,  // Save now if changed
+};
+
+enum key_stats_section {
+    KEY_STATS_SECTION_SUMMARY  = 0,
+    KEY_STATS_SECTION_KEYS     = 1,
+    KEY_STATS_SECTION_LAYERS   = 2,
+    KEY_STATS_SECTION_KEYCODES = 3,
+};
+
+// Load the saved counters (call from keyboard_post_init_user)
+void key_stats_init(void);
+
+// Zero the saved counters (call from eeconfig_init_user)
+void key_stats_eeconfig_init(void);
+
+// Count a key event (call first in process_record_user)
+void key_stats_record(uint16_t keycode, keyrecord_t *record);
+
+// Layer change check (call every scan from housekeeping_task_user); dwell, WPM and saves run on timer_wheel.h
+void key_stats_task(void);
+
+// Handle a raw HID report; returns false if data is not for this channel
+bool key_stats_receive(uint8_t *data, uint8_t length);
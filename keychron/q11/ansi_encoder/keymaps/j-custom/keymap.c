@@ -9,22 +9,98 @@
  *   Layer 4: APP_LAYER     - Application launchers (NAV + F)
  *   Layer 5: WIN_LAYER     - Window management (NAV + G)
  *   Layer 6: MAC_FN        - Function keys (existing)
- *   Layer 7: WIN_BASE      - Normal typing (Windows)
- *   Layer 8: WIN_FN        - Function keys (Windows)
- *   Layer 9: LIGHTING_LAYER - RGB lighting controls (NAV + L)
- *   Layer 10: NUMPAD_LAYER  - Number pad (NAV + H)
+ *   Layer 7: LIGHTING_LAYER - RGB lighting controls (NAV + L)
+ *   Layer 8: NUMPAD_LAYER  - Number pad (NAV + H)
+ *   Windows uses the same layers through a key remap profile (see Key Remap below).
  *
  * Activation Flow:
  *   BASE → RGUI tap → NAV_LAYER
  *     NAV + F → APP_LAYER, NAV + G → WIN_LAYER, NAV + J → CURSOR_LAYER, NAV + L → LIGHTING_LAYER
  *     NAV + H → NUMPAD_LAYER (toggle)
- *     NAV + Q/W/E/R → Toggle WIN_LAYER, MAC_FN, WIN_BASE, WIN_FN
+ *     NAV + Q/W → Toggle WIN_LAYER, MAC_FN
  *   Any non-BASE layer → RGUI tap → return to MAC_BASE
  *   Left/Right space = normal KC_SPC on all layers except NUMPAD left (tap = space, double-tap = exit).
  *   Base LGUI: tap = Cmd, double-tap = Spotlight (Cmd+Space).
  *   Bottom pos 1: tap = open Shadowrocket (⌃⌥⌘S), double-tap = toggle VPN (⌃⌥⌘Z).
+ *
+ * Host Context (HOST_CONTEXT_ENABLE, raw HID):
+ *   The host daemon reports the focused app. Cursor/VS Code: RGUI tap opens CURSOR_LAYER
+ *   directly (RGUI tap again → NAV_LAYER). Remote desktop: Windows key remap while focused.
  *   SYM backticks (H): ``` + Shift+Enter + ``` (cursor before closing backticks; newline without chat submit).
  *
+ * OS Base (OS_BASE_ENABLE, see os_base.h):
+ *   USB enumeration fingerprint picks the host class: macOS/iOS → Mac, Windows/Linux → Windows
+ *   (MAC_BASE stays the default layer, Windows selects the key remap profile).
+ *   Last host is remembered across power cycles. NAV + T (or MAC_FN + B) cycles AUTO → MAC → WIN;
+ *   flipping the Mac/Win DIP switch pins MAC or WIN.
+ *
+ * Key Remap (KEY_REMAP_ENABLE, see key_remap.h):
+ *   Windows profile over the Mac layers: Cmd ↔ Ctrl everywhere (modifiers and shortcuts), row 0
+ *   F1-F12 with the media keys on MAC_FN, IME key = Win+Space, Spotlight key = plain Ctrl.
+ *   Applied after layer resolution; switching OS is a profile pointer swap, no layer change.
+ *
+ * Key Stats (KEY_STATS_ENABLE, see key_stats.h):
+ *   Per-key presses, layer dwell, custom keycode/tap dance/macro use and WPM, saved to EEPROM.
+ *   Export: node scripts/key-stats/key-stats.js --format csv
+ *   Press cost per action and a proposed re-layout: node scripts/layout-cost/layout-cost.js <export.json>
+ *
+ * Split Hits (SPLIT_HITS_ENABLE, see split_hits.h):
+ *   Presses on the master's half reach the slave's reactive RGB effects (splash, heatmap...)
+ *   as 2-byte hits, instead of mirroring the whole matrix.
+ *
+ * Sparse Keymap (SPARSE_KEYMAP_ENABLE, see sparse_keymap.h):
+ *   Layers below are stored as a bitmap of non-transparent keys plus packed keycodes.
+ *   After editing a layer: node scripts/generate-sparse-keymap.js (build.sh checks it).
+ *
+ * Chords (CHORDS_ENABLE, see chords.h):
+ *   D+F → APP_LAYER, F+J → CURSOR_LAYER, J+K → WIN_LAYER pressed together on MAC_BASE/NAV
+ *   (after a short pause in typing). RGUI tap returns to MAC_BASE as usual.
+ *
+ * App Leader (APP_LEADER_ENABLE, see app_leader.h):
+ *   K+L, then a sequence from app_leader.json launches an app ("ai" ChatGPT, "sl" Slack, "f" Finder...).
+ *   Fires on the last key of the sequence; Esc or any other key cancels.
+ *   After editing app_leader.json: node scripts/generate-app-leader.js (build.sh checks it).
+ *
+ * Kinetic Mouse (KINETIC_MOUSE_ENABLE, see kinetic_mouse.h):
+ *   On NUMPAD, = [ ] \ move the pointer, - / Bksp = left / right click. Speed ramps up along a curve
+ *   and glides out on release; profile per layer in mouse_profiles[] below.
+ *   Motion curves: node scripts/kinetic-mouse/simulate.js
+ *
+ * Timer Wheel (TIMER_WHEEL_ENABLE, see timer_wheel.h):
+ *   Chord term, leader and host context timeouts, key stats saves and split polls/heartbeats
+ *   share one scheduler run from housekeeping; enabled by the modules that use it.
+ *
+ * Profiler (PROFILER_ENABLE, off by default, see profiler.h):
+ *   Cycles per main-loop pass for matrix scan, debounce, split transport, process_record, RGB,
+ *   SNLED flush, console, USB and housekeeping, with the slowest pass as a trace.
+ *   Read: node scripts/profiler/profiler.js
+ *
+ * Fast Resume (FAST_RESUME_ENABLE, see fast_resume.h):
+ *   On USB suspend the LED drivers go into software shutdown with their registers and the RGB
+ *   effect state kept (instead of rgb_matrix.sleep's black frame and effect restart); on resume
+ *   keys are scanned and reported first, then one register write per driver lights them again.
+ *   Console: sleep time, suspend → first report and LED restore times per resume.
+ *
+ * LED Limit (LED_LIMIT_ENABLE, see led_limit.h):
+ *   Each half estimates its LED current from what the effects and indicators ask for and dims
+ *   all its LEDs together above LED_LIMIT_BUDGET_MA (fast drop, ~1 s climb back).
+ *   Console: estimate, peak and scale while limiting.
+ *
+ * Tap Tune (TAP_TUNE_ENABLE, see tap_tune.h):
+ *   The Spotlight key and the tap dances each learn their own tapping term from how fast they are
+ *   tapped and double-tapped: the shortest term that still separates double taps from separate
+ *   taps, one 10 ms step at a time, saved to EEPROM at most hourly. Console: each term change.
+ *   Check learned terms against traces: node scripts/tap-tune/tap-tune.js
+ *
+ * RGB Preview (host only):
+ *   The enabled rgb_matrix effects rendered on this LED layout (both halves) to GIF, PNG or video,
+ *   with per-frame effect timings, without flashing: node scripts/rgb-preview/rgb-preview.js
+ *
+ * Emulator (host only):
+ *   Both halves of this keymap and its modules on Linux, split link and USB host emulated, input
+ *   events decoded or through uinput: key-to-event latency per stage, and typing, app launcher and
+ *   encoder stress runs checked against what comes out: node scripts/emulator/emulate.js
+ *
  * Universal Return to Base:
  *   Double-click left encoder (top left) → Returns to MAC_BASE from any layer
  *
@@ -46,8 +122,6 @@ enum layers {
     APP_LAYER,
     WIN_LAYER,
     MAC_FN,
-    WIN_BASE,
-    WIN_FN,
     LIGHTING_LAYER,
     NUMPAD_LAYER,
 };
@@ -74,12 +148,431 @@ enum custom_keycodes {
     KC_RETURN_TO_BASE,               // Custom keycode to return to MAC_BASE from any layer
     KC_LGUI_SPOTLIGHT,               // Base pos 5: hold = Cmd (copy/paste), tap = Cmd, double-tap = Spotlight
     KC_RGUI_NAV,                     // RGUI position: tap = NAV_LAYER (on base) / return to MAC_BASE (any other layer)
-    // Cursor IDE actions (CURSOR_LAYER) - placeholders until implemented
-    KC_CURSOR_FOCUS_EDITOR,          // H: Focus editor (TBD: Cursor command)
-    KC_CURSOR_PREV_CHANGE,           // J: Previous change (TBD: Cursor command)
-    KC_CURSOR_NEXT_CHANGE,           // K: Next change (TBD: Cursor command)
-    KC_CURSOR_APPLY_IN_EDITOR,       // L: Apply in editor (TBD: Cursor command)
+    KC_OS_BASE,                      // Cycle base layer selection: AUTO (detected) → MAC → WIN
+    // Cursor IDE actions (CURSOR_LAYER) - chords generated into cursor_layer_macros.h
+    // Keep contiguous and in cursor_layer.json order (table is indexed by offset)
+    KC_CURSOR_FOCUS_EDITOR,          // H: Focus editor (Cmd+1)
+    KC_CURSOR_PREV_CHANGE,           // J: Previous change (⇧⌥F5)
+    KC_CURSOR_NEXT_CHANGE,           // K: Next change (⌥F5)
+    KC_CURSOR_APPLY_IN_EDITOR,       // L: Apply in editor (Cmd+Enter)
+    KC_APP_LEADER,                   // Start an app launcher sequence (K+L chord, see app_leader.h)
+};
+
+// Generated by scripts/generate-cursor-layer.js from cursor_layer.json
+#include "cursor_layer_macros.h"
+#ifdef SPARSE_KEYMAP_ENABLE
+#    include "sparse_keymap.h"
+#endif
+
+// ============================================
+// Timer Wheel (deferred work of the modules below, see timer_wheel.h)
+// ============================================
+#ifdef TIMER_WHEEL_ENABLE
+#    include "timer_wheel.h"
+#endif
+
+// ============================================
+// Host Context (focused app → layers, see host_context.h)
+// ============================================
+#ifdef HOST_CONTEXT_ENABLE
+#    include "host_context.h"
+
+const host_context_entry_t PROGMEM host_context_table[] = {
+    { HC_APP_CURSOR,         0,                    CURSOR_LAYER          },  // RGUI tap → CURSOR_LAYER
+    { HC_APP_VSCODE,         0,                    CURSOR_LAYER          },  // Same chords as Cursor
+    { HC_APP_REMOTE_DESKTOP, 0,                    HOST_CONTEXT_NO_LAYER },  // Windows key remap while focused
+};
+const uint8_t host_context_table_size = sizeof(host_context_table) / sizeof(host_context_table[0]);
+#endif
+
+// ============================================
+// OS Base (detected host → default layer, see os_base.h)
+// ============================================
+#ifdef OS_BASE_ENABLE
+#    include "os_base.h"
+
+bool process_detected_host_os_user(os_variant_t detected_os) {
+    os_base_detected(detected_os);
+    return true;
+}
+
+#    ifdef DIP_SWITCH_ENABLE
+// Mac/Win switch pins the base layer (q11.c would select layer 2, which is SYM_LAYER here)
+bool dip_switch_update_user(uint8_t index, bool active) {
+    if (index == 0) {
+        os_base_dip(active);
+        return false;
+    }
+    return true;
+}
+#    endif
+#endif
+
+// ============================================
+// Key Remap (Windows profile over the Mac layers, see key_remap.h)
+// ============================================
+#ifdef KEY_REMAP_ENABLE
+#    include "key_remap.h"
+
+#    define KC_TASK LGUI(KC_TAB)  // Task view
+#    define KC_FLXP LGUI(KC_E)    // File Explorer
+
+static const key_remap_key_t PROGMEM win_keys[] = {
+    // MAC_BASE row 0: Mac media keys → F1-F12
+    { MAC_BASE,            KC_BRID,           KC_F1   },
+    { MAC_BASE,            KC_BRIU,           KC_F2   },
+    { MAC_BASE,            KC_MCTL,           KC_F3   },
+    { MAC_BASE,            KC_LPAD,           KC_F4   },
+    { MAC_BASE,            RM_VALD,           KC_F5   },
+    { MAC_BASE,            RM_VALU,           KC_F6   },
+    { MAC_BASE,            KC_MPRV,           KC_F7   },
+    { MAC_BASE,            KC_MPLY,           KC_F8   },
+    { MAC_BASE,            KC_MNXT,           KC_F9   },
+    { MAC_BASE,            KC_MUTE,           KC_F10  },
+    { MAC_BASE,            KC_VOLD,           KC_F11  },
+    { MAC_BASE,            KC_VOLU,           KC_F12  },
+    // MAC_FN row 0: F1-F12 → media keys, Mission Control / Launchpad → Task view / Explorer
+    { MAC_FN,              KC_F1,             KC_BRID },
+    { MAC_FN,              KC_F2,             KC_BRIU },
+    { MAC_FN,              KC_F3,             KC_TASK },
+    { MAC_FN,              KC_F4,             KC_FLXP },
+    { MAC_FN,              KC_F5,             RM_VALD },
+    { MAC_FN,              KC_F6,             RM_VALU },
+    { MAC_FN,              KC_F7,             KC_MPRV },
+    { MAC_FN,              KC_F8,             KC_MPLY },
+    { MAC_FN,              KC_F9,             KC_MNXT },
+    { MAC_FN,              KC_F10,            KC_MUTE },
+    { MAC_FN,              KC_F11,            KC_VOLD },
+    { MAC_FN,              KC_F12,            KC_VOLU },
+    // Custom keys with a Mac-only action
+    { KEY_REMAP_ANY_LAYER, KC_IME_NEXT,       LGUI(KC_SPC) },  // Input method: Win+Space
+    { KEY_REMAP_ANY_LAYER, KC_LGUI_SPOTLIGHT, KC_LCTL },       // Cmd position → Ctrl, no Spotlight
+};
+
+// Cmd ↔ Ctrl: the Cmd position sends Ctrl, Ctrl positions send Win
+static const key_remap_profile_t win_profile = {
+    .mods      = { [KEY_REMAP_CTRL] = KEY_REMAP_GUI, [KEY_REMAP_SHIFT] = KEY_REMAP_SHIFT, [KEY_REMAP_ALT] = KEY_REMAP_ALT, [KEY_REMAP_GUI] = KEY_REMAP_CTRL },
+    .keys      = win_keys,
+    .key_count = sizeof(win_keys) / sizeof(win_keys[0]),
+};
+
+// Windows host (OS base) or a Windows remote desktop focused (host context)
+static void update_key_remap(void) {
+    bool windows = false;
+#    ifdef OS_BASE_ENABLE
+    windows = os_base_host() == OS_BASE_WIN;
+#    endif
+#    ifdef HOST_CONTEXT_ENABLE
+    windows = windows || host_context_app() == HC_APP_REMOTE_DESKTOP;
+#    endif
+    key_remap_set(windows ? &win_profile : NULL);
+}
+
+#    ifdef OS_BASE_ENABLE
+void os_base_changed_user(os_base_mode_t host) {
+    update_key_remap();
+}
+#    endif
+
+#    ifdef HOST_CONTEXT_ENABLE
+void host_context_changed_user(uint16_t app_id) {
+    update_key_remap();
+}
+#    endif
+#endif
+
+// ============================================
+// Split Sync (batched master → slave state, see split_sync.h)
+// ============================================
+#ifdef SPLIT_SYNC_ENABLE
+#    include "split_sync.h"
+#endif
+#ifdef SPLIT_LINK_ENABLE
+#    include "split_link.h"
+#endif
+#ifdef SPLIT_HEALTH_ENABLE
+#    include "split_health.h"
+#endif
+#ifdef SPLIT_HITS_ENABLE
+#    include "split_hits.h"
+#endif
+
+// ============================================
+// Tap Dance Keycodes (callbacks and actions in Tap Dance below)
+// ============================================
+enum {
+    TD_ENC_L = 0,  // Left encoder: single = Mute, double = Return to base
+    TD_ENC_R = 1,  // Right encoder: single = Zoom reset, double = Lock screen
+    TD_NUMPAD_SPACE = 2,  // NUMPAD_LAYER left space: single = space, double = toggle off NUMPAD_LAYER
+    TD_SHADOWROCKET = 3,  // Bottom pos 1: single = open Shadowrocket (LCAG+S), double = toggle VPN (LCAG+Z)
+};
+
+// ============================================
+// Key Stats (usage counters over raw HID, see key_stats.h)
+// ============================================
+#ifdef KEY_STATS_ENABLE
+#    include "key_stats.h"
+#endif
+
+// ============================================
+// Chords (keys pressed together, see chords.h)
+// ============================================
+#ifdef CHORDS_ENABLE
+#    include "chords.h"
+
+// Shortcuts for the NAV selectors: one two-key press instead of RGUI tap + selector
+#    define CHORD_BASE_LAYERS ((1U << MAC_BASE) | (1U << NAV_LAYER))
+
+static const chord_t PROGMEM chords[] = {
+    { { CHORD_KEY(3, 4), CHORD_KEY(3, 5), CHORD_NONE, CHORD_NONE }, CHORD_BASE_LAYERS, KC_NAV_APP    },  // D+F → APP_LAYER
+    { { CHORD_KEY(3, 5), CHORD_KEY(9, 1), CHORD_NONE, CHORD_NONE }, CHORD_BASE_LAYERS, KC_NAV_CURSOR },  // F+J → CURSOR_LAYER
+    { { CHORD_KEY(9, 1), CHORD_KEY(9, 2), CHORD_NONE, CHORD_NONE }, CHORD_BASE_LAYERS, KC_NAV_WIN    },  // J+K → WIN_LAYER
+#    ifdef APP_LEADER_ENABLE
+    { { CHORD_KEY(9, 2), CHORD_KEY(9, 3), CHORD_NONE, CHORD_NONE }, CHORD_BASE_LAYERS, KC_APP_LEADER },  // K+L → app leader
+#    endif
 };
+_Static_assert(ARRAY_SIZE(chords) <= CHORDS_MAX, "raise CHORDS_MAX");
+
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return chords_process(record);
+}
+#endif
+
+// ============================================
+// App Leader (K+L, then a sequence, see app_leader.h)
+// ============================================
+#ifdef APP_LEADER_ENABLE
+#    ifndef CHORDS_ENABLE
+#        error "APP_LEADER_ENABLE is started by the K+L chord: enable CHORDS_ENABLE"
+#    endif
+#    include "app_leader.h"
+#endif
+
+// ============================================
+// Kinetic Mouse (smooth mouse keys, see kinetic_mouse.h)
+// ============================================
+#ifdef KINETIC_MOUSE_ENABLE
+#    include "kinetic_mouse.h"
+
+// Layers not listed use KINETIC_MOUSE_DEFAULT_*
+static const kinetic_mouse_layer_t PROGMEM mouse_profiles[] = {
+    // NUMPAD pointer keys: slow start for cells and handles, cubic ramp to cross the screen, short glide
+    { NUMPAD_LAYER, { .start = 60, .max = 2400, .ramp = 900, .curve = 3, .glide = 60 } },
+};
+#endif
+
+// ============================================
+// Profiler (cycles per main-loop pass, see profiler.h)
+// ============================================
+#ifdef PROFILER_ENABLE
+#    include "profiler.h"
+#endif
+
+// ============================================
+// LED Limit (LED current budget, see led_limit.h)
+// ============================================
+#ifdef LED_LIMIT_ENABLE
+#    include "led_limit.h"
+#endif
+
+// ============================================
+// Fast Resume (LED drivers off over USB suspend, see fast_resume.h)
+// ============================================
+#ifdef FAST_RESUME_ENABLE
+#    include "fast_resume.h"
+
+// Every pass of QMK's suspend loop (the main loop and housekeeping do not run)
+void suspend_power_down_user(void) {
+    fast_resume_suspend();
+}
+#endif
+
+// ============================================
+// Tap Tune (per-key tapping terms, see tap_tune.h)
+// ============================================
+#ifdef TAP_TUNE_ENABLE
+#    include "tap_tune.h"
+
+// Tap dances time from their last press, the Spotlight double tap from the Cmd release
+static const tap_tune_key_t tap_tune_keys[] = {
+    { KC_LGUI_SPOTLIGHT,   TAP_TUNE_FROM_RELEASE },  // Thumb
+    { TD(TD_ENC_L),        TAP_TUNE_FROM_PRESS   },  // Encoder clicks: stiff, slow double taps
+    { TD(TD_ENC_R),        TAP_TUNE_FROM_PRESS   },
+    { TD(TD_NUMPAD_SPACE), TAP_TUNE_FROM_PRESS   },  // Thumb, between digits
+    { TD(TD_SHADOWROCKET), TAP_TUNE_FROM_PRESS   },  // Pinky
+};
+_Static_assert(ARRAY_SIZE(tap_tune_keys) <= TAP_TUNE_KEYS, "raise TAP_TUNE_KEYS");
+
+// TAPPING_TERM_PER_KEY (config.h): QMK's tap dance timeout
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return tap_tune_term(keycode);
+}
+#endif
+
+// ============================================
+// Init / Housekeeping
+// ============================================
+
+#if defined(OS_BASE_ENABLE) || defined(KEY_STATS_ENABLE) || defined(TAP_TUNE_ENABLE)
+// EEPROM reset (first boot or eeconfig layout change)
+void eeconfig_init_user(void) {
+#    ifdef OS_BASE_ENABLE
+    os_base_eeconfig_init();
+#    endif
+#    ifdef KEY_STATS_ENABLE
+    key_stats_eeconfig_init();
+#    endif
+#    ifdef TAP_TUNE_ENABLE
+    tap_tune_eeconfig_init();
+#    endif
+}
+#endif
+
+// Runs before the main loop: the persisted OS base is in place before the first report
+void keyboard_post_init_user(void) {
+#ifdef OS_BASE_ENABLE
+    os_base_init(MAC_BASE, MAC_BASE);  // One base for both: Windows is the key remap profile
+#endif
+#ifdef SPLIT_SYNC_ENABLE
+    split_sync_init();
+#endif
+#ifdef SPLIT_LINK_ENABLE
+    split_link_init();
+#endif
+#ifdef SPLIT_HEALTH_ENABLE
+    split_health_init();
+#endif
+#ifdef SPLIT_HITS_ENABLE
+    split_hits_init();
+#endif
+#ifdef KEY_STATS_ENABLE
+    key_stats_init();
+#endif
+#ifdef TAP_TUNE_ENABLE
+    tap_tune_init(tap_tune_keys, ARRAY_SIZE(tap_tune_keys));
+#endif
+#ifdef CHORDS_ENABLE
+    chords_init(chords, ARRAY_SIZE(chords));
+#endif
+#ifdef KINETIC_MOUSE_ENABLE
+    kinetic_mouse_init(mouse_profiles, ARRAY_SIZE(mouse_profiles));
+#endif
+#ifdef LED_LIMIT_ENABLE
+    led_limit_init();
+#endif
+#ifdef FAST_RESUME_ENABLE
+    fast_resume_init();  // After split_sync_init: registers the slave's item
+#endif
+#ifdef PROFILER_ENABLE
+    profiler_init();
+#endif
+}
+
+// Once per scan, after the matrix has been processed
+void housekeeping_task_user(void) {
+#ifdef PROFILER_ENABLE
+    profiler_begin(PROFILER_HOUSEKEEPING);
+#endif
+#ifdef TIMER_WHEEL_ENABLE
+    timer_wheel_task();
+#endif
+#ifdef FAST_RESUME_ENABLE
+    fast_resume_task();  // Before split_sync_task: the slave's LEDs come back in the same frame
+#endif
+#ifdef SPLIT_SYNC_ENABLE
+    split_sync_task();
+#endif
+#ifdef SPLIT_LINK_ENABLE
+    split_link_task();
+#endif
+#ifdef SPLIT_HEALTH_ENABLE
+    split_health_task();
+#endif
+#ifdef SPLIT_HITS_ENABLE
+    split_hits_task();
+#endif
+#ifdef KEY_STATS_ENABLE
+    key_stats_task();
+#endif
+#ifdef PROFILER_ENABLE
+    profiler_end();
+    profiler_pass();  // Housekeeping ends keyboard_task; the USB tasks after it count in the next pass
+#endif
+}
+
+#if defined(HOST_CONTEXT_ENABLE) || defined(SPLIT_HEALTH_ENABLE) || defined(KEY_STATS_ENABLE) || defined(PROFILER_ENABLE)
+// Raw HID reports are routed by their first byte (channel)
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+#    ifdef HOST_CONTEXT_ENABLE
+    if (host_context_receive(data, length)) {
+        return;
+    }
+#    endif
+#    ifdef SPLIT_HEALTH_ENABLE
+    if (split_health_receive(data, length)) {
+        return;
+    }
+#    endif
+#    ifdef KEY_STATS_ENABLE
+    if (key_stats_receive(data, length)) {
+        return;
+    }
+#    endif
+#    ifdef PROFILER_ENABLE
+    if (profiler_receive(data, length)) {
+        return;
+    }
+#    endif
+}
+#endif
+
+// MAC_BASE (plus any host context overlay) is the only active layer
+static bool on_base_layer(void) {
+#ifdef HOST_CONTEXT_ENABLE
+    return (layer_state & ~(layer_state_t)host_context_layers()) == 1;
+#else
+    return layer_state == 1;
+#endif
+}
+
+// Re-apply host context overlay layers after a return to MAC_BASE
+static void restore_host_context(void) {
+#ifdef HOST_CONTEXT_ENABLE
+    host_context_restore();
+#endif
+}
+
+// NAV selector result: the target layer replaces NAV_LAYER
+static void nav_select(uint8_t layer) {
+    layer_off(NAV_LAYER);
+    layer_on(layer);
+}
+
+#ifdef CHORDS_ENABLE
+// Selector chords work from the base layer too (no RGUI tap first)
+bool process_chord_user(uint16_t keycode, keyrecord_t *record) {
+    uint8_t layer = keycode == KC_NAV_APP      ? APP_LAYER
+                  : keycode == KC_NAV_WIN      ? WIN_LAYER
+                  : keycode == KC_NAV_CURSOR   ? CURSOR_LAYER
+                  : keycode == KC_NAV_LIGHTING ? LIGHTING_LAYER
+                                               : 0;
+#    ifdef APP_LEADER_ENABLE
+    if (keycode == KC_APP_LEADER) {
+        if (record->event.pressed) {
+            app_leader_start();
+        }
+        return false;
+    }
+#    endif
+    if (layer == 0) {
+        return true;
+    }
+    if (record->event.pressed) {
+        nav_select(layer);
+    }
+    return false;
+}
+#endif
 
 // ============================================
 // App Launcher Macros (⌥⌘ combinations)
@@ -104,6 +597,11 @@ enum custom_keycodes {
 #define KC_APP_VPN_SHADOWROCKET LCAG(KC_Z)      // ⌃⌥⌘Z - Toggle Shadowrocket VPN (Left Control + Left Alt + Left GUI)
 #define KC_APP_SHADOWROCKET_OPEN LCAG(KC_S)     // ⌃⌥⌘S - Open Shadowrocket app
 
+#ifdef APP_LEADER_ENABLE
+// Generated by scripts/generate-app-leader.js from app_leader.json (uses the macros above)
+#    include "app_leader_trie.h"
+#endif
+
 // ============================================
 // Window Management Macros (modifier combinations)
 // Using QMK macros for proper modifier release
@@ -138,15 +636,8 @@ enum custom_keycodes {
 #define KC_LOCK_SCREEN   LCG(KC_Q)              // Ctrl+Cmd+Q (lock screen) - Left Control + Left GUI
 
 // ============================================
-// Tap Dance
+// Tap Dance (keycodes TD_* above)
 // ============================================
-enum {
-    TD_ENC_L = 0,  // Left encoder: single = Mute, double = Return to base
-    TD_ENC_R = 1,  // Right encoder: single = Zoom reset, double = Lock screen
-    TD_NUMPAD_SPACE = 2,  // NUMPAD_LAYER left space: single = space, double = toggle off NUMPAD_LAYER
-    TD_SHADOWROCKET = 3,  // Bottom pos 1: single = open Shadowrocket (LCAG+S), double = toggle VPN (LCAG+Z)
-};
-
 // Tap dance callback functions for debugging
 void td_enc_l_finished(tap_dance_state_t *state, void *user_data) {
 #ifdef CONSOLE_ENABLE
@@ -162,7 +653,7 @@ void td_enc_l_finished(tap_dance_state_t *state, void *user_data) {
         uprintf("DEBUG: TD_ENC_L double tap - executing return to base\n");
         uprintf("DEBUG: Current layer state before: 0x%04X\n", layer_state);
         uprintf("DEBUG: Active layers before: ");
-        for (uint8_t i = 0; i < 11; i++) {
+        for (uint8_t i = 0; i < 9; i++) {
             if (layer_state_is(i)) {
                 uprintf("L%d ", i);
             }
@@ -173,8 +664,6 @@ void td_enc_l_finished(tap_dance_state_t *state, void *user_data) {
         // Turn off all toggle layers explicitly
         layer_off(WIN_LAYER);
         layer_off(MAC_FN);
-        layer_off(WIN_BASE);
-        layer_off(WIN_FN);
         layer_off(NUMPAD_LAYER);
         
         // Turn off all momentary/custom layers
@@ -186,11 +675,12 @@ void td_enc_l_finished(tap_dance_state_t *state, void *user_data) {
         
         // Switch to MAC_BASE
         layer_move(MAC_BASE);
+        restore_host_context();
         
 #ifdef CONSOLE_ENABLE
         uprintf("DEBUG: After layer_move, layer state: 0x%04X\n", layer_state);
         uprintf("DEBUG: Active layers after: ");
-        for (uint8_t i = 0; i < 11; i++) {
+        for (uint8_t i = 0; i < 9; i++) {
             if (layer_state_is(i)) {
                 uprintf("L%d ", i);
             }
@@ -249,14 +739,15 @@ tap_dance_action_t tap_dance_actions[] = {
     [TD_SHADOWROCKET] = ACTION_TAP_DANCE_FN_ADVANCED(NULL, td_shadowrocket_finished, td_shadowrocket_reset),  // Bottom pos 1: single = open Shadowrocket, double = toggle VPN
 };
 
-// Windows-specific shortcuts (for WIN_BASE/WIN_FN layers)
-#define KC_TASK LGUI(KC_TAB)
-#define KC_FLXP LGUI(KC_E)
-
 // ============================================
 // Keymaps
 // ============================================
+#ifdef SPARSE_KEYMAP_ENABLE
+// Source of sparse_keymap_table.h only: unreferenced, so not linked (see sparse_keymap.h)
+static const uint16_t keymaps_source[][MATRIX_ROWS][MATRIX_COLS] __attribute__((unused)) = {
+#else
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+#endif
 
     // ============================================
     // Layer 0: MAC_BASE - Normal typing (macOS)
@@ -297,8 +788,8 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,
         // Row 1: Transparent
         _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,            _______,
-        // Row 2: Toggle selectors for L5-L8
-        _______,  _______,  TG(WIN_LAYER),  TG(MAC_FN),  TG(WIN_BASE),  TG(WIN_FN),  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,            _______,
+        // Row 2: Toggle selectors for L5-L6, T: cycle OS base selection (AUTO/MAC/WIN)
+        _______,  _______,  TG(WIN_LAYER),  TG(MAC_FN),  _______,  _______,  KC_OS_BASE,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,            _______,
         // Row 3: Selectors F/G/J/L (custom layer switching), A/S/D transparent. Must be 15 keys (same as MAC_BASE row 3).
         //        A/S/D: transparent; F: APP_LAYER, G: WIN_LAYER, H: NUMPAD (toggle), J: CURSOR_LAYER, L: LIGHTING_LAYER
         _______,  _______,  _______,  _______,  _______,  KC_NAV_APP,  KC_NAV_WIN,  TG(NUMPAD_LAYER),  KC_NAV_CURSOR,  _______,  KC_NAV_LIGHTING,  _______,  _______,  _______,  _______,
@@ -345,10 +836,10 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         //        ]: Submit no codebase (TBD)
         _______,  _______,  _______,  _______,  _______,  _______,  _______,  LGUI(KC_B),  LGUI(KC_T),  LGUI(KC_I),  LGUI(KC_DOT),  _______,  _______,  _______,  _______,            _______,
         // Row 3: Home row - Cursor actions on H/J/K/L (positions 7-10)
-        //        H: Focus editor (TBD: Cursor command)
-        //        J: Previous change (TBD: Cursor command)
-        //        K: Next change (TBD: Cursor command)
-        //        L: Apply in editor (TBD: Cursor command)
+        //        H: Focus editor (Cmd+1)
+        //        J: Previous change (⇧⌥F5)
+        //        K: Next change (⌥F5)
+        //        L: Apply in editor (Cmd+Enter)
         _______,  _______,  _______,  _______,  _______,  _______,  _______,  KC_CURSOR_FOCUS_EDITOR,  KC_CURSOR_PREV_CHANGE,  KC_CURSOR_NEXT_CHANGE,  KC_CURSOR_APPLY_IN_EDITOR,  _______,  _______,            _______,            _______,
         // Row 4: Transparent
         _______,  _______,            _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,              _______,  _______,
@@ -444,33 +935,11 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         _______,  _______,  _______,  _______,  _______,  _______,  _______,   _______,  _______,  _______,  _______,  _______,  _______,    _______,  _______,            _______,
         _______,  RM_TOGG,  RM_NEXT,  RM_VALU,  RM_HUEU,  RM_SATU,  RM_SPDU,   _______,  _______,  _______,  _______,  _______,  _______,    _______,  _______,            _______,
         _______,  _______,  RM_PREV,  RM_VALD,  RM_HUED,  RM_SATD,  RM_SPDD,   _______,  _______,  _______,  _______,  _______,  _______,              _______,            _______,
-        _______,  _______,            _______,  _______,  _______,  _______,   _______,  NK_TOGG,  _______,  _______,  _______,  _______,              _______,  _______,
+        _______,  _______,            _______,  _______,  _______,  _______,   KC_OS_BASE, NK_TOGG,  _______,  _______,  _______,  _______,              _______,  _______,
         _______,  _______,  _______,  _______,  _______,            KC_SPC,                 KC_SPC,            _______,  _______,    _______,  _______,  _______,  _______),
 
     // ============================================
-    // Layer 7: WIN_BASE - Normal typing (Windows)
-    // ============================================
-    [WIN_BASE] = LAYOUT_91_ansi(
-        TD(TD_ENC_L),  KC_ESC,   KC_F1,    KC_F2,    KC_F3,    KC_F4,    KC_F5,     KC_F6,    KC_F7,    KC_F8,    KC_F9,    KC_F10,   KC_F11,     KC_F12,   KC_INS,   KC_DEL,   TD(TD_ENC_R),
-        _______,  KC_GRV,   KC_1,     KC_2,     KC_3,     KC_4,     KC_5,      KC_6,     KC_7,     KC_8,     KC_9,     KC_0,     KC_MINS,    KC_EQL,   KC_BSPC,            KC_PGUP,
-        _______,  KC_TAB,   KC_Q,     KC_W,     KC_E,     KC_R,     KC_T,      KC_Y,     KC_U,     KC_I,     KC_O,     KC_P,     KC_LBRC,    KC_RBRC,  KC_BSLS,            KC_PGDN,
-        _______,  KC_CAPS,  KC_A,     KC_S,     KC_D,     KC_F,     KC_G,      KC_H,     KC_J,     KC_K,     KC_L,     KC_SCLN,  KC_QUOT,              KC_ENT,             KC_HOME,
-        _______,  KC_LSFT,            KC_Z,     KC_X,     KC_C,     KC_V,      KC_B,     KC_N,     KC_M,     KC_COMM,  KC_DOT,   KC_SLSH,              KC_RSFT,  KC_UP,
-        _______,  KC_LCTL,  KC_LWIN,  KC_LALT,  MO(WIN_FN),         KC_SPC,                 KC_SPC,            KC_RALT,  MO(WIN_FN), KC_RCTL,  KC_LEFT,  KC_DOWN,  KC_RGHT),
-
-    // ============================================
-    // Layer 8: WIN_FN - Function keys (Windows)
-    // ============================================
-    [WIN_FN] = LAYOUT_91_ansi(
-        TD(TD_ENC_L),  _______,  KC_BRID,  KC_BRIU,  KC_TASK,  KC_FLXP,  RM_VALD,   RM_VALU,  KC_MPRV,  KC_MPLY,  KC_MNXT,  KC_MUTE,  KC_VOLD,    KC_VOLU,  _______,  _______,  TD(TD_ENC_R),
-        _______,  _______,  _______,  _______,  _______,  _______,  _______,   _______,  _______,  _______,  _______,  _______,  _______,    _______,  _______,            _______,
-        _______,  RM_TOGG,  RM_NEXT,  RM_VALU,  RM_HUEU,  RM_SATU,  RM_SPDU,   _______,  _______,  _______,  _______,  _______,  _______,    _______,  _______,            _______,
-        _______,  _______,  RM_PREV,  RM_VALD,  RM_HUED,  RM_SATD,  RM_SPDD,   _______,  _______,  _______,  _______,  _______,  _______,              _______,            _______,
-        _______,  _______,            _______,  _______,  _______,  _______,   _______,  NK_TOGG,  _______,  _______,  _______,  _______,              _______,  _______,
-        _______,  _______,  _______,  _______,  _______,            KC_SPC,                 KC_SPC,            _______,  _______,    _______,  _______,  _______,  _______),
-
-    // ============================================
-    // Layer 9: LIGHTING_LAYER - RGB lighting controls (NAV + L)
+    // Layer 7: LIGHTING_LAYER - RGB lighting controls (NAV + L)
     // ============================================
     [LIGHTING_LAYER] = LAYOUT_91_ansi(
         // Row 0: Transparent
@@ -487,7 +956,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         _______,  _______,  _______,  _______,  _______,            KC_SPC,                 KC_SPC,            _______,  _______,  _______,  _______,  _______,  _______),
 
     // ============================================
-    // Layer 10: NUMPAD_LAYER - Number pad (NAV + H)
+    // Layer 8: NUMPAD_LAYER - Number pad (NAV + H)
     // Left-hand keys (columns 0-6) mirror MAC_BASE for modifier combinations (cmd+c, cmd+v, cmd+a)
     // Left space: single tap = space, double tap = toggle off NUMPAD_LAYER
     // ============================================
@@ -495,9 +964,11 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         // Row 0: Left-hand keys from MAC_BASE, right-hand numpad
         TD(TD_ENC_L),  KC_ESC,   KC_BRID,  KC_BRIU,  KC_MCTL,  KC_LPAD,  RM_VALD,   _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  TD(TD_ENC_R),
         // Row 1: Left-hand keys from MAC_BASE, right-hand numpad top row (7, 8, 9, /)
-        KC_APP_WHATSAPP,  KC_GRV,   KC_1,     KC_2,     KC_3,     KC_4,     KC_5,      _______,  KC_KP_7,  KC_KP_8,  KC_KP_9,  KC_KP_SLASH,  _______,  _______,  _______,            _______,
+        //        -/=/Bksp → left click / pointer up / right click (kinetic_mouse.h)
+        KC_APP_WHATSAPP,  KC_GRV,   KC_1,     KC_2,     KC_3,     KC_4,     KC_5,      _______,  KC_KP_7,  KC_KP_8,  KC_KP_9,  KC_KP_SLASH,  KC_BTN1,  KC_MS_U,  KC_BTN2,            _______,
         // Row 2: Left-hand keys from MAC_BASE, right-hand numpad second row (4, 5, 6, *)
-        KC_APP_WECHAT,  KC_TAB,   KC_Q,     KC_W,     KC_E,     KC_R,     KC_T,      _______,  KC_KP_4,  KC_KP_5,  KC_KP_6,  KC_KP_ASTERISK,  _______,  _______,  _______,            _______,
+        //        [/]/\ → pointer left / down / right
+        KC_APP_WECHAT,  KC_TAB,   KC_Q,     KC_W,     KC_E,     KC_R,     KC_T,      _______,  KC_KP_4,  KC_KP_5,  KC_KP_6,  KC_KP_ASTERISK,  KC_MS_L,  KC_MS_D,  KC_MS_R,            _______,
         // Row 3: Left-hand keys from MAC_BASE, right-hand numpad third row (1, 2, 3, -)
         KC_APP_SLACK_6,  KC_CAPS,  KC_A,     KC_S,     KC_D,     KC_F,     KC_G,      _______,  KC_KP_1,  KC_KP_2,  KC_KP_3,  KC_KP_MINUS,              _______,            _______,            _______,
         // Row 4: Left-hand keys from MAC_BASE, right-hand numpad bottom row (0, ., +)
@@ -516,7 +987,11 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 //   - Double press: Lock screen (Ctrl+Cmd+Q)
 // ============================================
 #if defined(ENCODER_MAP_ENABLE)
+#    ifdef SPARSE_KEYMAP_ENABLE
+static const uint16_t encoder_map_source[][NUM_ENCODERS][NUM_DIRECTIONS] __attribute__((unused)) = {
+#    else
 const uint16_t PROGMEM encoder_map[][NUM_ENCODERS][NUM_DIRECTIONS] = {
+#    endif
     [MAC_BASE]       = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
     [NAV_LAYER]      = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
     [SYM_LAYER]      = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
@@ -524,13 +999,21 @@ const uint16_t PROGMEM encoder_map[][NUM_ENCODERS][NUM_DIRECTIONS] = {
     [APP_LAYER]      = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
     [WIN_LAYER]      = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
     [MAC_FN]         = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
-    [WIN_BASE]       = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
-    [WIN_FN]         = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
     [LIGHTING_LAYER] = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
     [NUMPAD_LAYER]   = { ENCODER_CCW_CW(KC_VOLD, KC_VOLU),      ENCODER_CCW_CW(KC_ZOOM_OUT, KC_ZOOM_IN) },
 };
 #endif // ENCODER_MAP_ENABLE
 
+#ifdef SPARSE_KEYMAP_ENABLE
+// Lookups go through sparse_keymap.c; QMK's introspection still expects the arrays
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {};
+#    if defined(ENCODER_MAP_ENABLE)
+const uint16_t PROGMEM encoder_map[][NUM_ENCODERS][NUM_DIRECTIONS] = {};
+#    endif
+#    include "sparse_keymap_table.h"
+_Static_assert(ARRAY_SIZE(keymaps_source) == SPARSE_KEYMAP_LAYERS, "sparse_keymap_table.h is out of date: node scripts/generate-sparse-keymap.js");
+#endif
+
 // ============================================
 // Custom Key State
 // ============================================
@@ -542,6 +1025,22 @@ static bool     lgui_spotlight_pending_spotlight = false;
 // SEND_STRING macros must be called from here, not from keymap directly
 // ============================================
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+#ifdef KEY_STATS_ENABLE
+    key_stats_record(keycode, record);
+#endif
+#ifdef TAP_TUNE_ENABLE
+    tap_tune_record(keycode, record);
+#endif
+#ifdef APP_LEADER_ENABLE
+    if (!app_leader_process(keycode, record)) {
+        return false;
+    }
+#endif
+#ifdef KINETIC_MOUSE_ENABLE
+    if (!kinetic_mouse_process(keycode, record)) {
+        return false;
+    }
+#endif
 #ifdef CONSOLE_ENABLE
     // Enhanced debug output: Print ALL key presses with keycode, matrix position, and press state
     // This helps debug keymap issues and verify key assignments
@@ -556,8 +1055,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                                  (layer == CURSOR_LAYER) ? "CURSOR_LAYER" :
                                  (layer == APP_LAYER) ? "APP_LAYER" :
                                  (layer == WIN_LAYER) ? "WIN_LAYER" :
-                                 (layer == WIN_BASE) ? "WIN_BASE" :
-                                 (layer == WIN_FN) ? "WIN_FN" :
                                  (layer == LIGHTING_LAYER) ? "LIGHTING_LAYER" :
                                  (layer == NUMPAD_LAYER) ? "NUMPAD_LAYER" : "UNKNOWN";
         const char* tap_name = (tap_key == KC_GLOBE_CUSTOM) ? "KC_GLOBE_CUSTOM" :
@@ -696,7 +1193,14 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         case KC_LGUI_SPOTLIGHT:
             if (record->event.pressed) {
                 register_code(KC_LGUI);  // Hold = Cmd so Cmd+C, Cmd+V work
-                if (TIMER_DIFF_16(record->event.time, lgui_spotlight_last_release) < TAPPING_TERM) {
+#ifdef TAP_TUNE_ENABLE
+                // Learned term; a Cmd used as a modifier or a key in between does not start a double tap
+                bool second_tap = tap_tune_tapped(KC_LGUI_SPOTLIGHT) &&
+                                  TIMER_DIFF_16(record->event.time, lgui_spotlight_last_release) < tap_tune_term(KC_LGUI_SPOTLIGHT);
+#else
+                bool second_tap = TIMER_DIFF_16(record->event.time, lgui_spotlight_last_release) < TAPPING_TERM;
+#endif
+                if (second_tap) {
                     lgui_spotlight_pending_spotlight = true;  // Second tap within term = double-tap
                 }
             } else {
@@ -711,17 +1215,24 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
             return false;
 
         // RGUI position: tap = NAV_LAYER (on MAC_BASE) / return to MAC_BASE (any other layer)
+        // With a host context helper: base → helper layer → NAV_LAYER → MAC_BASE
         case KC_RGUI_NAV:
             if (record->event.pressed) {
-                if (layer_state == 1) {
-                    // Only MAC_BASE (layer 0) active → enable NAV_LAYER
+                uint8_t helper = NAV_LAYER;
+#ifdef HOST_CONTEXT_ENABLE
+                helper = host_context_helper_layer(NAV_LAYER);
+#endif
+                if (on_base_layer()) {
+                    // Only MAC_BASE (layer 0) active → enable NAV_LAYER (or the app's helper layer)
+                    layer_on(helper);
+                } else if (helper != NAV_LAYER && layer_state_is(helper) && !layer_state_is(NAV_LAYER)) {
+                    // Helper opened by host context → NAV_LAYER keeps the selectors reachable
+                    layer_off(helper);
                     layer_on(NAV_LAYER);
                 } else {
                     // Any other layer active → return to MAC_BASE
                     layer_off(WIN_LAYER);
                     layer_off(MAC_FN);
-                    layer_off(WIN_BASE);
-                    layer_off(WIN_FN);
                     layer_off(NUMPAD_LAYER);
                     layer_off(NAV_LAYER);
                     layer_off(SYM_LAYER);
@@ -729,18 +1240,36 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                     layer_off(APP_LAYER);
                     layer_off(LIGHTING_LAYER);
                     layer_move(MAC_BASE);
+                    restore_host_context();
                 }
             }
             return false;
 
+        // OS selection: AUTO (follow OS detection) → Mac → Windows (key remap profile)
+        case KC_OS_BASE:
+#ifdef OS_BASE_ENABLE
+            if (record->event.pressed) {
+                os_base_cycle_mode();
+            }
+#endif
+            return false;
+
+        // App launcher sequence (normally from the K+L chord)
+        case KC_APP_LEADER:
+#ifdef APP_LEADER_ENABLE
+            if (record->event.pressed) {
+                app_leader_start();
+            }
+#endif
+            return false;
+
         // Custom layer switching - Selector keys
         // These keys switch from NAV_LAYER to target layer
         // Only work when NAV_LAYER is currently active
         case KC_NAV_APP:  // F key - Switch to APP_LAYER
             if (record->event.pressed) {
                 if (layer_state_is(NAV_LAYER)) {
-                    layer_off(NAV_LAYER);
-                    layer_on(APP_LAYER);
+                    nav_select(APP_LAYER);
                 }
             }
             return false;
@@ -748,8 +1277,7 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         case KC_NAV_WIN:  // G key - Switch to WIN_LAYER
             if (record->event.pressed) {
                 if (layer_state_is(NAV_LAYER)) {
-                    layer_off(NAV_LAYER);
-                    layer_on(WIN_LAYER);
+                    nav_select(WIN_LAYER);
                 }
             }
             return false;
@@ -757,8 +1285,7 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         case KC_NAV_CURSOR:  // J key - Switch to CURSOR_LAYER
             if (record->event.pressed) {
                 if (layer_state_is(NAV_LAYER)) {
-                    layer_off(NAV_LAYER);
-                    layer_on(CURSOR_LAYER);
+                    nav_select(CURSOR_LAYER);
                 }
             }
             return false;
@@ -766,24 +1293,22 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         case KC_NAV_LIGHTING:  // L key - Switch to LIGHTING_LAYER
             if (record->event.pressed) {
                 if (layer_state_is(NAV_LAYER)) {
-                    layer_off(NAV_LAYER);
-                    layer_on(LIGHTING_LAYER);
+                    nav_select(LIGHTING_LAYER);
                 }
             }
             return false;
 
-        // Cursor IDE actions - placeholders (TBD: implement actual Cursor commands)
-        case KC_CURSOR_FOCUS_EDITOR:
-            // TODO: Implement Focus editor command
-            return false;
-        case KC_CURSOR_PREV_CHANGE:
-            // TODO: Implement Previous change command
-            return false;
-        case KC_CURSOR_NEXT_CHANGE:
-            // TODO: Implement Next change command
-            return false;
-        case KC_CURSOR_APPLY_IN_EDITOR:
-            // TODO: Implement Apply in editor command
+        // Cursor IDE actions - tap the generated chord sequence for this keycode
+        case CURSOR_MACRO_FIRST ... CURSOR_MACRO_LAST:
+            if (record->event.pressed) {
+                for (uint8_t i = 0; i < CURSOR_MACRO_MAX_CHORDS; i++) {
+                    uint16_t chord = pgm_read_word(&cursor_macro_chords[keycode - CURSOR_MACRO_FIRST][i]);
+                    if (chord == KC_NO) {
+                        break;
+                    }
+                    tap_code16(chord);
+                }
+            }
             return false;
 
         // Return to base - explicitly turn off all layers and return to MAC_BASE
@@ -793,7 +1318,7 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 #ifdef CONSOLE_ENABLE
                 uprintf("DEBUG: KC_RETURN_TO_BASE triggered! Current layer state: 0x%04X\n", layer_state);
                 uprintf("DEBUG: Active layers before: ");
-                for (uint8_t i = 0; i < 11; i++) {
+                for (uint8_t i = 0; i < 9; i++) {
                     if (layer_state_is(i)) {
                         uprintf("L%d ", i);
                     }
@@ -803,8 +1328,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                 // Turn off all toggle layers explicitly
                 layer_off(WIN_LAYER);
                 layer_off(MAC_FN);
-                layer_off(WIN_BASE);
-                layer_off(WIN_FN);
                 layer_off(NUMPAD_LAYER);
                 
                 // Turn off all momentary/custom layers
@@ -816,11 +1339,12 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                 
                 // Switch to MAC_BASE
                 layer_move(MAC_BASE);
+                restore_host_context();
                 
 #ifdef CONSOLE_ENABLE
                 uprintf("DEBUG: After layer_move, layer state: 0x%04X\n", layer_state);
                 uprintf("DEBUG: Active layers after: ");
-                for (uint8_t i = 0; i < 11; i++) {
+                for (uint8_t i = 0; i < 9; i++) {
                     if (layer_state_is(i)) {
                         uprintf("L%d ", i);
                     }
@@ -0,0 +1,216 @@
+/* Kinetic mouse keys - see kinetic_mouse.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "kinetic_mouse.h"
+#include "timer_wheel.h"
+
+#define ONE_PX   65536  // Q16.16
+#define HALF_PX  (ONE_PX / 2)
+#define DIAGONAL 46341  // 1/sqrt(2) in Q16
+
+enum { AXIS_X, AXIS_Y };
+
+enum {
+    HELD_UP    = 1 << 0,
+    HELD_DOWN  = 1 << 1,
+    HELD_LEFT  = 1 << 2,
+    HELD_RIGHT = 1 << 3,
+};
+
+// Profile in engine units (Q16.16 px per ms)
+typedef struct {
+    int32_t  start;
+    int32_t  max;
+    int32_t  decel;  // Speed lost per ms while gliding
+    uint16_t ramp;
+    uint8_t  curve;
+} curve_t;
+
+static const kinetic_mouse_layer_t *profiles      = NULL;
+static uint8_t                      profile_count = 0;
+
+static uint8_t  held     = 0;
+static uint16_t hold_ms  = 0;  // Since a cursor key went down with none held
+static int32_t  velocity[2];   // Q16.16 px per ms
+static int32_t  position[2];   // Sub-pixel motion not reported yet
+static uint32_t last     = 0;
+
+static uint32_t tick(void);
+
+static timer_wheel_timer_t timer = TIMER_WHEEL_TIMER(tick);
+
+// ============================================
+// Curve
+// ============================================
+
+static int32_t px_per_ms(uint16_t px_per_s) {
+    return (int32_t)((uint32_t)px_per_s * ONE_PX / 1000);
+}
+
+static void load_curve(curve_t *curve) {
+    kinetic_mouse_profile_t profile = {
+        .start = KINETIC_MOUSE_DEFAULT_START,
+        .max   = KINETIC_MOUSE_DEFAULT_MAX,
+        .ramp  = KINETIC_MOUSE_DEFAULT_RAMP,
+        .curve = KINETIC_MOUSE_DEFAULT_CURVE,
+        .glide = KINETIC_MOUSE_DEFAULT_GLIDE,
+    };
+    uint8_t layer = get_highest_layer(layer_state | default_layer_state);
+    for (uint8_t i = 0; i < profile_count; i++) {
+        kinetic_mouse_layer_t entry;
+        memcpy_P(&entry, &profiles[i], sizeof(entry));
+        if (entry.layer == layer) {
+            profile = entry.profile;
+            break;
+        }
+    }
+    curve->start = px_per_ms(profile.start);
+    curve->max   = px_per_ms(profile.max);
+    curve->decel = profile.glide ? curve->max / profile.glide : curve->max;
+    curve->ramp  = profile.ramp;
+    curve->curve = profile.curve;
+}
+
+// Speed after ms of holding: start + (max - start) * (ms / ramp) ^ curve
+static int32_t speed(const curve_t *curve, uint16_t ms) {
+    if (ms >= curve->ramp) {
+        return curve->max;
+    }
+    uint32_t fraction = ((uint32_t)ms << 16) / curve->ramp;
+    uint32_t shaped   = fraction;
+    for (uint8_t i = 1; i < curve->curve; i++) {
+        shaped = (uint32_t)(((uint64_t)shaped * fraction) >> 16);
+    }
+    return curve->start + (int32_t)(((int64_t)(curve->max - curve->start) * shaped) >> 16);
+}
+
+// ============================================
+// Motion
+// ============================================
+
+static int8_t direction(uint8_t negative, uint8_t positive) {
+    return ((held & positive) ? 1 : 0) - ((held & negative) ? 1 : 0);
+}
+
+// One ms of motion
+static void step(const curve_t *curve) {
+    int8_t dir[2] = { direction(HELD_LEFT, HELD_RIGHT), direction(HELD_UP, HELD_DOWN) };
+    if (dir[AXIS_X] || dir[AXIS_Y]) {
+        if (hold_ms < UINT16_MAX) {
+            hold_ms++;
+        }
+    } else {
+        hold_ms = 0;
+    }
+    int32_t target = speed(curve, hold_ms);
+    if (dir[AXIS_X] && dir[AXIS_Y]) {
+        target = (int32_t)(((int64_t)target * DIAGONAL) >> 16);
+    }
+
+    for (uint8_t axis = AXIS_X; axis <= AXIS_Y; axis++) {
+        int32_t *v = &velocity[axis];
+        if (dir[axis] > 0) {
+            *v = *v > target ? *v : target;  // Faster from a glide: keep the momentum
+        } else if (dir[axis] < 0) {
+            *v = *v < -target ? *v : -target;
+        } else if (*v > 0) {
+            *v = *v > curve->decel ? *v - curve->decel : 0;
+        } else if (*v < 0) {
+            *v = *v < -curve->decel ? *v + curve->decel : 0;
+        }
+        position[axis] += *v;
+    }
+}
+
+// Whole pixels of an axis, the fraction stays for the next report
+static int8_t take(uint8_t axis) {
+    int32_t px = position[axis] / ONE_PX;
+    if (px > 127) {
+        px = 127;
+    } else if (px < -127) {
+        px = -127;
+    }
+    position[axis] -= px * ONE_PX;
+    return (int8_t)px;
+}
+
+static uint32_t tick(void) {
+    uint32_t now     = timer_read32();
+    uint32_t elapsed = now - last;
+    last             = now;
+    if (elapsed > KINETIC_MOUSE_MAX_STEP) {
+        elapsed = KINETIC_MOUSE_MAX_STEP;
+    }
+
+    curve_t curve;
+    load_curve(&curve);
+    while (elapsed--) {
+        step(&curve);
+    }
+
+    report_mouse_t report = mousekey_get_report();  // Buttons held through mousekey
+    report.x              = take(AXIS_X);
+    report.y              = take(AXIS_Y);
+    report.v              = 0;
+    report.h              = 0;
+    if (report.x || report.y) {
+        host_mouse_send(&report);
+    }
+
+    if (!held && !velocity[AXIS_X] && !velocity[AXIS_Y]) {
+        position[AXIS_X] = 0;
+        position[AXIS_Y] = 0;
+        return 0;  // At rest: the timer stops until the next press
+    }
+    return KINETIC_MOUSE_INTERVAL;
+}
+
+// ============================================
+// API
+// ============================================
+
+void kinetic_mouse_init(const kinetic_mouse_layer_t *table, uint8_t count) {
+    profiles      = table;
+    profile_count = count;
+}
+
+bool kinetic_mouse_process(uint16_t keycode, keyrecord_t *record) {
+    uint8_t bit;
+    int8_t  sign;
+    uint8_t axis;
+    switch (keycode) {
+        case KC_MS_U:
+            bit = HELD_UP, sign = -1, axis = AXIS_Y;
+            break;
+        case KC_MS_D:
+            bit = HELD_DOWN, sign = 1, axis = AXIS_Y;
+            break;
+        case KC_MS_L:
+            bit = HELD_LEFT, sign = -1, axis = AXIS_X;
+            break;
+        case KC_MS_R:
+            bit = HELD_RIGHT, sign = 1, axis = AXIS_X;
+            break;
+        default:
+            return true;
+    }
+
+    if (!record->event.pressed) {
+        held &= ~bit;
+        return false;
+    }
+    if (velocity[axis] == 0) {
+        position[axis] = sign * HALF_PX;  // From rest the first pixel comes after half a pixel of travel
+    }
+    held |= bit;
+    if (!timer_wheel_pending(&timer)) {
+        last = timer_read32();
+        timer_wheel_schedule(&timer, KINETIC_MOUSE_INTERVAL);
+    }
+    return false;
+}
@@ -0,0 +1,69 @@
+/* Kinetic mouse keys: smooth pointer motion at the USB polling rate
+ *
+ * Takes over the cursor keys (KC_MS_U/D/L/R) from QMK's mousekey, whose
+ * fixed steps every MOUSEKEY_INTERVAL make the pointer jump. Buttons and the
+ * wheel stay with mousekey.
+ *   - velocity is fixed point (Q16.16 px per ms) and follows a curve of the
+ *     hold time: start speed, then up to max speed over ramp ms, shaped by
+ *     curve (1 linear, 2 quadratic, 3 cubic: slow and precise at first);
+ *   - motion is integrated every ms into a sub-pixel accumulator, and a
+ *     report goes out every KINETIC_MOUSE_INTERVAL ms with the whole pixels
+ *     (the fraction carries over, so slow speeds still move evenly);
+ *   - released keys glide to a stop over glide ms at most, and pressing
+ *     again the same way keeps the momentum; diagonals are scaled by 1/sqrt(2);
+ *   - the profile follows the highest active layer (kinetic_mouse_init's
+ *     table), with KINETIC_MOUSE_DEFAULT_* for layers not in it.
+ *
+ * Driven by a timer_wheel.h timer that only runs while the pointer moves.
+ *
+ * Host simulation (motion curves of the keymap's profiles as SVG):
+ *   node scripts/kinetic-mouse/simulate.js
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef KINETIC_MOUSE_INTERVAL
+#    define KINETIC_MOUSE_INTERVAL 1  // ms between reports (USB polling interval)
+#endif
+
+#ifndef KINETIC_MOUSE_MAX_STEP
+#    define KINETIC_MOUSE_MAX_STEP 20  // ms of motion integrated at most per report, after a stall
+#endif
+
+// Profile for layers without an entry in the table
+#ifndef KINETIC_MOUSE_DEFAULT_START
+#    define KINETIC_MOUSE_DEFAULT_START 100  // px/s on press
+#endif
+#ifndef KINETIC_MOUSE_DEFAULT_MAX
+#    define KINETIC_MOUSE_DEFAULT_MAX 1800  // px/s
+#endif
+#ifndef KINETIC_MOUSE_DEFAULT_RAMP
+#    define KINETIC_MOUSE_DEFAULT_RAMP 700  // ms from start to max speed
+#endif
+#ifndef KINETIC_MOUSE_DEFAULT_CURVE
+#    define KINETIC_MOUSE_DEFAULT_CURVE 2
+#endif
+#ifndef KINETIC_MOUSE_DEFAULT_GLIDE
+#    define KINETIC_MOUSE_DEFAULT_GLIDE 120  // ms to stop from max speed once released
+#endif
+
+typedef struct {
+    uint16_t start;  // px/s on press
+    uint16_t max;    // px/s
+    uint16_t ramp;   // ms from start to max speed
+    uint8_t  curve;  // Exponent of the ramp, 1..3
+    uint16_t glide;  // ms to stop from max speed once released (0 = stop at once)
+} kinetic_mouse_profile_t;
+
+typedef struct {
+    uint8_t                 layer;
+    kinetic_mouse_profile_t profile;
+} kinetic_mouse_layer_t;
+
+// Profiles by highest active layer (table in PROGMEM; call from keyboard_post_init_user)
+void kinetic_mouse_init(const kinetic_mouse_layer_t *table, uint8_t count);
+
+// Call from process_record_user; false = a cursor key, handled here
+bool kinetic_mouse_process(uint16_t keycode, keyrecord_t *record);
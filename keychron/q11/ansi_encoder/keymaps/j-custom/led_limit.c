@@ -0,0 +1,138 @@
+/* LED current limiter - see led_limit.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "led_limit.h"
+#include "timer_wheel.h"
+
+#ifndef SNLED27351_CURRENT_TUNE
+#    define SNLED27351_CURRENT_TUNE { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }
+#endif
+
+#define SCALE_FULL   256
+#define CHANNEL_FULL (255UL * 255UL)  // Load of one channel at PWM 255, tune 0xFF
+// LED_LIMIT_BUDGET_MA in load units (sum of PWM x tune)
+#define BUDGET_LOAD  ((uint32_t)((uint64_t)LED_LIMIT_BUDGET_MA * 1000 * CHANNEL_FULL / LED_LIMIT_CHANNEL_UA))
+
+_Static_assert((uint64_t)SNLED27351_LED_COUNT * 3 * CHANNEL_FULL <= UINT32_MAX, "load of all LEDs must fit 32 bits");
+
+typedef struct {
+    uint8_t r, g, b;
+} color_t;
+
+static const uint8_t tune[12] = SNLED27351_CURRENT_TUNE;  // Per CB line: CBn_CAm addresses are (n - 1) * 16 + m - 1
+
+static color_t           requested[SNLED27351_LED_COUNT];  // Colours as asked for, before scaling
+static uint32_t          load       = 0;                   // Sum of requested PWM x tune
+static uint32_t          load_limit = BUDGET_LOAD;         // Highest load that fits at the current scale
+static led_limit_stats_t stats      = { .scale = SCALE_FULL };
+
+static uint16_t to_ma(uint32_t units) {
+    return (uint64_t)units * LED_LIMIT_CHANNEL_UA / CHANNEL_FULL / 1000;
+}
+
+// Largest scale at which load stays in budget
+static uint16_t fitting_scale(void) {
+    if (load <= BUDGET_LOAD) {
+        return SCALE_FULL;
+    }
+    return (uint64_t)BUDGET_LOAD * SCALE_FULL / load;
+}
+
+static void set_scale(uint16_t scale) {
+    stats.scale = scale;
+    load_limit  = scale >= SCALE_FULL ? BUDGET_LOAD : (uint32_t)((uint64_t)BUDGET_LOAD * SCALE_FULL / (scale ? scale : 1));
+}
+
+static inline uint8_t scaled(uint8_t value) {
+    return (value * stats.scale) >> 8;
+}
+
+// ============================================
+// Driver hooks (-Wl,--wrap in rules.mk)
+// ============================================
+
+void __real_snled27351_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+void __wrap_snled27351_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index < 0 || index >= SNLED27351_LED_COUNT) {
+        return;
+    }
+    color_t *was = &requested[index];
+    if (was->r != red || was->g != green || was->b != blue) {
+        snled27351_led_t led;
+        memcpy_P(&led, &g_snled27351_leds[index], sizeof(led));
+        load += (int32_t)(red - was->r) * tune[led.r >> 4] + (int32_t)(green - was->g) * tune[led.g >> 4] + (int32_t)(blue - was->b) * tune[led.b >> 4];
+        *was = (color_t){ red, green, blue };
+        if (load > load_limit) {
+            set_scale(fitting_scale());  // Attack: down at once, before this colour is written
+            stats.drops++;
+        }
+    }
+    if (stats.scale >= SCALE_FULL) {
+        __real_snled27351_set_color(index, red, green, blue);
+    } else {
+        __real_snled27351_set_color(index, scaled(red), scaled(green), scaled(blue));
+    }
+}
+
+// The driver's own loop stays inside its file, out of reach of the wrap
+void __wrap_snled27351_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (int i = 0; i < SNLED27351_LED_COUNT; i++) {
+        __wrap_snled27351_set_color(i, red, green, blue);
+    }
+}
+
+// ============================================
+// Release and stats
+// ============================================
+
+static uint32_t release(void) {
+    uint16_t load_ma = to_ma(load);
+    stats.load_ma    = load_ma;
+    if (load_ma > stats.peak_ma) {
+        stats.peak_ma = load_ma;
+    }
+    if (stats.scale < SCALE_FULL) {
+        uint16_t next = stats.scale + LED_LIMIT_RELEASE_STEP;
+        uint16_t fit  = fitting_scale();
+        if (next > fit) {
+            next = fit;
+        }
+        if (next > stats.scale) {
+            set_scale(next);
+        }
+    }
+    return LED_LIMIT_RELEASE_MS;
+}
+
+static timer_wheel_timer_t release_timer = TIMER_WHEEL_TIMER(release);
+
+#ifdef CONSOLE_ENABLE
+static uint32_t report_stats(void) {
+    static uint32_t reported_drops = 0;
+    if (stats.drops != reported_drops || stats.scale < SCALE_FULL) {
+        reported_drops = stats.drops;
+        uprintf("LED_LIMIT: load=%umA peak=%umA budget=%umA scale=%u/256 drops=%lu\n", stats.load_ma, stats.peak_ma, LED_LIMIT_BUDGET_MA, stats.scale,
+                (unsigned long)stats.drops);
+    }
+    return LED_LIMIT_STATS_INTERVAL;
+}
+
+static timer_wheel_timer_t report_timer = TIMER_WHEEL_TIMER(report_stats);
+#endif
+
+void led_limit_init(void) {
+    set_scale(SCALE_FULL);
+    timer_wheel_schedule(&release_timer, LED_LIMIT_RELEASE_MS);
+#ifdef CONSOLE_ENABLE
+    timer_wheel_schedule(&report_timer, LED_LIMIT_STATS_INTERVAL);
+#endif
+}
+
+const led_limit_stats_t *led_limit_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,57 @@
+/* LED current limiter
+ *
+ * Each half estimates the current its SNLED27351 draws and dims all its LEDs
+ * together when the estimate goes over LED_LIMIT_BUDGET_MA, so full-white
+ * effects and indicators stay inside the USB budget the two halves share:
+ *   - the estimate is a running sum of PWM x current tune (SNLED27351_CURRENT_TUNE,
+ *     per CB line: red runs at half current on the Q11) over the colours the
+ *     RGB code asked for; each write adds only its difference to the colour it
+ *     replaces, so there is no pass over all LEDs per frame;
+ *   - colours reach the driver scaled by a common factor: over budget it drops
+ *     at once to the factor that fits, then climbs back by LED_LIMIT_RELEASE_STEP
+ *     every LED_LIMIT_RELEASE_MS (a timer_wheel.h timer) while it still fits.
+ *     Effects repaint every LED each frame, so the new factor is on all of them
+ *     within a frame;
+ *   - the driver calls are hooked with -Wl,--wrap (see rules.mk), so
+ *     rgb_matrix, indicators and the driver stay untouched.
+ *
+ * mA = sum x LED_LIMIT_CHANNEL_UA / (255 x 255 x 1000): LED_LIMIT_CHANNEL_UA
+ * is one channel at full PWM and tune 0xFF (the default puts a full-white
+ * half near the 300 mA noted in config.h). Measure and adjust for a board.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef LED_LIMIT_BUDGET_MA
+#    define LED_LIMIT_BUDGET_MA 200  // Per half: both halves and MCUs share the master's 500 mA
+#endif
+
+#ifndef LED_LIMIT_CHANNEL_UA
+#    define LED_LIMIT_CHANNEL_UA 2500  // One LED channel at PWM 255, current tune 0xFF
+#endif
+
+#ifndef LED_LIMIT_RELEASE_MS
+#    define LED_LIMIT_RELEASE_MS 20  // Interval of the brightness climb after a drop
+#endif
+
+#ifndef LED_LIMIT_RELEASE_STEP
+#    define LED_LIMIT_RELEASE_STEP 4  // Scale steps (of 256) per interval: full recovery in ~1.3 s
+#endif
+
+#ifndef LED_LIMIT_STATS_INTERVAL
+#    define LED_LIMIT_STATS_INTERVAL 10000  // ms between console reports while limiting (CONSOLE_ENABLE)
+#endif
+
+typedef struct {
+    uint16_t scale;     // Brightness factor in use, 256 = unscaled
+    uint16_t load_ma;   // Current estimate of the requested colours, before scaling
+    uint16_t peak_ma;   // Highest load_ma since init
+    uint32_t drops;     // Times the factor was lowered
+} led_limit_stats_t;
+
+// Start the release timer (call from keyboard_post_init_user, both halves)
+void led_limit_init(void);
+
+const led_limit_stats_t *led_limit_stats(void);
@@ -0,0 +1,109 @@
+/* OS base layer selection - see os_base.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "os_base.h"
+
+// EEPROM user word: bits 0-1 mode, bits 2-3 last detected host (OS_BASE_MAC / OS_BASE_WIN, 0 = never)
+#define OS_BASE_MODE_MASK  0x03UL
+#define OS_BASE_HOST_SHIFT 2
+#define OS_BASE_HOST_MASK  (0x03UL << OS_BASE_HOST_SHIFT)
+
+static uint8_t        mac_base     = 0;
+static uint8_t        win_base     = 0;
+static os_base_mode_t mode         = OS_BASE_AUTO;
+static os_base_mode_t last_host    = OS_BASE_MAC;  // Host class used while AUTO
+static bool           initialized  = false;
+
+static void save(void) {
+    uint32_t raw = eeconfig_read_user();
+    uint32_t new = (raw & ~(OS_BASE_MODE_MASK | OS_BASE_HOST_MASK)) | (uint32_t)mode | ((uint32_t)last_host << OS_BASE_HOST_SHIFT);
+    if (new != raw) {
+        eeconfig_update_user(new);  // Only on change: detection runs on every plug-in
+    }
+}
+
+__attribute__((weak)) void os_base_changed_user(os_base_mode_t host) {}
+
+static void apply(void) {
+    layer_state_t base = (layer_state_t)1 << os_base_layer();
+    if (default_layer_state != base) {
+        default_layer_set(base);
+    }
+#ifdef CONSOLE_ENABLE
+    uprintf("OS_BASE: mode=%u host=%u default layer=%u\n", mode, last_host, os_base_layer());
+#endif
+    os_base_changed_user(os_base_host());
+}
+
+void os_base_init(uint8_t mac_layer, uint8_t win_layer) {
+    uint32_t raw = eeconfig_read_user();
+    mac_base     = mac_layer;
+    win_base     = win_layer;
+    mode         = (os_base_mode_t)(raw & OS_BASE_MODE_MASK);
+    last_host    = (os_base_mode_t)((raw & OS_BASE_HOST_MASK) >> OS_BASE_HOST_SHIFT);
+    if (mode > OS_BASE_WIN) {
+        mode = OS_BASE_AUTO;
+    }
+    if (last_host != OS_BASE_WIN) {
+        last_host = OS_BASE_MAC;
+    }
+    initialized = true;
+    apply();
+}
+
+void os_base_eeconfig_init(void) {
+    eeconfig_update_user(eeconfig_read_user() & ~(OS_BASE_MODE_MASK | OS_BASE_HOST_MASK));
+}
+
+void os_base_detected(os_variant_t os) {
+    switch (os) {
+        case OS_MACOS:
+        case OS_IOS:
+            last_host = OS_BASE_MAC;
+            break;
+        case OS_WINDOWS:
+        case OS_LINUX:
+            last_host = OS_BASE_WIN;
+            break;
+        default:
+            return;  // Unsure: keep the persisted guess
+    }
+    if (initialized) {
+        save();
+        apply();
+    }
+}
+
+void os_base_dip(bool mac) {
+    if (initialized) {
+        os_base_set_mode(mac ? OS_BASE_MAC : OS_BASE_WIN);
+    }
+}
+
+void os_base_set_mode(os_base_mode_t new_mode) {
+    mode = new_mode;
+    save();
+    apply();
+}
+
+os_base_mode_t os_base_cycle_mode(void) {
+    os_base_set_mode(mode == OS_BASE_WIN ? OS_BASE_AUTO : (os_base_mode_t)(mode + 1));
+    return mode;
+}
+
+os_base_mode_t os_base_mode(void) {
+    return mode;
+}
+
+os_base_mode_t os_base_host(void) {
+    return mode == OS_BASE_AUTO ? last_host : mode;
+}
+
+uint8_t os_base_layer(void) {
+    return os_base_host() == OS_BASE_WIN ? win_base : mac_base;
+}
@@ -0,0 +1,53 @@
+/* OS base layer selection
+ *
+ * QMK's OS detection (OS_DETECTION_ENABLE) fingerprints the host from the
+ * descriptor requests it makes while enumerating the keyboard. This module
+ * turns that into the default layer:
+ *   - macOS / iOS → mac layer, Windows / Linux → win layer
+ *   - the last detected host class is persisted in the EEPROM user word and
+ *     applied in keyboard_post_init, before the first report, so plugging back
+ *     into the same machine never starts on the wrong base
+ *   - a manual override (AUTO / MAC / WIN, persisted) pins the base layer;
+ *     flipping the Mac/Win DIP switch sets MAC or WIN, the cycle key returns
+ *     to AUTO
+ * The base is a default layer, so return-to-base (layer_move) keeps it.
+ * os_base_changed_user() is told the host class after every change, for state
+ * that follows the host beyond the base layer (key_remap.h profiles).
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "os_detection.h"
+
+typedef enum {
+    OS_BASE_AUTO = 0,  // Follow OS detection
+    OS_BASE_MAC  = 1,  // Pinned to the mac layer
+    OS_BASE_WIN  = 2,  // Pinned to the win layer
+} os_base_mode_t;
+
+// Load persisted state and set the default layer (call from keyboard_post_init_user)
+void os_base_init(uint8_t mac_layer, uint8_t win_layer);
+
+// Reset the persisted state (call from eeconfig_init_user)
+void os_base_eeconfig_init(void);
+
+// Detection result from process_detected_host_os_user
+void os_base_detected(os_variant_t os);
+
+// DIP switch position (active = Mac); the power-on read is ignored so AUTO survives reboots
+void os_base_dip(bool mac);
+
+// Override control
+void           os_base_set_mode(os_base_mode_t mode);
+os_base_mode_t os_base_cycle_mode(void);  // AUTO → MAC → WIN → AUTO
+os_base_mode_t os_base_mode(void);
+
+// Host class in effect: the pinned mode, or the detected host while AUTO
+os_base_mode_t os_base_host(void);
+
+// Layer currently used as the default layer
+uint8_t os_base_layer(void);
+
+// Called with the host class in effect after init and every change (weak, for the keymap)
+void os_base_changed_user(os_base_mode_t host);
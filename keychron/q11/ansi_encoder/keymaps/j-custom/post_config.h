@@ -0,0 +1,22 @@
+/* Keymap post-config for Keychron Q11 ANSI Encoder (j-custom)
+ *
+ * Read after info.json's settings, so it can take them back.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#pragma once
+
+#ifdef SPLIT_HITS_ENABLE
+// split.transport.sync.matrix_state: the slave gets the master's hits from
+// split_hits.c; mirroring the matrix as well would feed them twice
+#    undef SPLIT_TRANSPORT_MIRROR
+#endif
+
+#ifdef FAST_RESUME_ENABLE
+// rgb_matrix.sleep: fast_resume.c shuts the LED drivers down instead of
+// rendering black, so the effect is not restarted on resume
+#    undef RGB_MATRIX_SLEEP
+#endif
@@ -0,0 +1,260 @@
+/* Main-loop cycle profiler - see profiler.h for the report layout
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "raw_hid.h"
+#include "profiler.h"
+
+#define HEADER_LEN 5
+
+_Static_assert(PROFILER_SECTIONS <= 16, "sections that ran in a pass are a uint16_t mask");
+
+// ============================================
+// Clock
+// ============================================
+
+#ifdef PROFILER_WALL_CLOCK
+#    include <time.h>
+#    define TICKS_PER_US 1000  // Nanoseconds
+
+static inline uint32_t ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+static void clock_start(void) {}
+#else
+#    include <hal.h>  // CMSIS DWT / CoreDebug, STM32_SYSCLK
+#    define TICKS_PER_US (STM32_SYSCLK / 1000000)
+
+static inline uint32_t ticks(void) {
+    return DWT->CYCCNT;
+}
+
+static void clock_start(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+#endif
+
+// ============================================
+// State
+// ============================================
+
+typedef struct {
+    uint32_t passes;  // Passes the section ran in
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} stat_t;
+
+typedef struct {
+    uint8_t  section;
+    uint32_t start;  // Ticks from the start of the pass
+    uint32_t ticks;  // Exclusive
+} trace_event_t;
+
+typedef struct {
+    uint8_t  section;
+    uint8_t  event;  // Trace slot, PROFILER_TRACE_LEN if the trace was full
+    uint32_t start;
+    uint32_t nested;  // Ticks of the sections nested in this one
+} frame_t;
+
+static stat_t sections[PROFILER_SECTIONS];
+static stat_t passes;
+
+// Open sections
+static frame_t stack[PROFILER_DEPTH];
+static uint8_t depth    = 0;
+static uint8_t overflow = 0;  // Opened beyond PROFILER_DEPTH, not tracked
+
+// Current pass
+static uint32_t      pass_start = 0;
+static uint32_t      pass_ticks[PROFILER_SECTIONS];
+static uint16_t      pass_ran = 0;
+static trace_event_t trace[PROFILER_TRACE_LEN];
+static uint8_t       trace_len = 0;
+
+// Slowest pass since the last reset
+static uint32_t      worst_ticks[PROFILER_SECTIONS];
+static trace_event_t worst[PROFILER_TRACE_LEN];
+static uint8_t       worst_len = 0;
+
+static void stat_add(stat_t *stat, uint32_t value) {
+    if (stat->passes == 0 || value < stat->min) {
+        stat->min = value;
+    }
+    if (value > stat->max) {
+        stat->max = value;
+    }
+    stat->sum += value;
+    stat->passes++;
+}
+
+static uint32_t stat_mean(const stat_t *stat) {
+    return stat->passes ? (uint32_t)(stat->sum / stat->passes) : 0;
+}
+
+static void reset(void) {
+    memset(sections, 0, sizeof(sections));
+    memset(&passes, 0, sizeof(passes));
+    memset(worst_ticks, 0, sizeof(worst_ticks));
+    worst_len = 0;
+}
+
+// ============================================
+// Sections
+// ============================================
+
+void profiler_init(void) {
+    clock_start();
+    reset();
+    pass_start = ticks();
+}
+
+void profiler_begin(uint8_t section) {
+    if (depth == PROFILER_DEPTH || section >= PROFILER_SECTIONS) {
+        overflow++;
+        return;
+    }
+    uint32_t now   = ticks();
+    uint8_t  event = PROFILER_TRACE_LEN;
+    if (trace_len < PROFILER_TRACE_LEN) {
+        event        = trace_len++;
+        trace[event] = (trace_event_t){ .section = section, .start = now - pass_start, .ticks = 0 };
+    }
+    stack[depth++] = (frame_t){ .section = section, .event = event, .start = now, .nested = 0 };
+}
+
+void profiler_end(void) {
+    uint32_t now = ticks();
+    if (overflow) {
+        overflow--;
+        return;
+    }
+    if (depth == 0) {
+        return;
+    }
+    depth--;
+    uint32_t total     = now - stack[depth].start;
+    uint32_t exclusive = total - stack[depth].nested;
+    if (depth > 0) {
+        stack[depth - 1].nested += total;
+    }
+    pass_ticks[stack[depth].section] += exclusive;
+    pass_ran |= 1U << stack[depth].section;
+    if (stack[depth].event < PROFILER_TRACE_LEN) {
+        trace[stack[depth].event].ticks = exclusive;
+    }
+}
+
+void profiler_pass(void) {
+    uint32_t now   = ticks();
+    uint32_t total = now - pass_start;
+    if (depth > 0) {
+        return;  // Called inside a section: the pass is not over
+    }
+
+    for (uint8_t s = 0; s < PROFILER_SECTIONS; s++) {
+        if (pass_ran & (1U << s)) {
+            stat_add(&sections[s], pass_ticks[s]);
+        }
+    }
+    if (total > passes.max || passes.passes == 0) {
+        memcpy(worst_ticks, pass_ticks, sizeof(worst_ticks));
+        memcpy(worst, trace, sizeof(trace_event_t) * trace_len);
+        worst_len = trace_len;
+    }
+    stat_add(&passes, total);
+
+    memset(pass_ticks, 0, sizeof(pass_ticks));
+    pass_ran   = 0;
+    trace_len  = 0;
+    pass_start = ticks();  // The bookkeeping above belongs to no pass
+}
+
+// ============================================
+// Raw HID
+// ============================================
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+    return put16(put16(p, v & 0xFFFF), v >> 16);
+}
+
+// Entries of the page starting at first that fit in one reply
+static uint8_t window(uint16_t total, uint8_t first, uint8_t entry_size, uint8_t length) {
+    uint8_t fit = (length - HEADER_LEN) / entry_size;
+    if (first >= total) {
+        return 0;
+    }
+    return total - first < fit ? total - first : fit;
+}
+
+bool profiler_receive(uint8_t *data, uint8_t length) {
+    if (length < 32 || data[0] != PROFILER_CHANNEL) {
+        return false;
+    }
+
+    uint8_t opcode = data[1];
+    uint8_t page   = data[2];
+    uint8_t first  = data[3];
+    uint8_t count  = 0;
+    if (opcode == PROFILER_OP_RESET) {
+        reset();
+    }
+
+    memset(data + 4, 0, length - 4);
+    data[1]    = opcode | PROFILER_REPLY;
+    uint8_t *p = data + HEADER_LEN;
+    switch (page) {
+        case PROFILER_PAGE_SUMMARY:
+            count = 1;
+            p     = put16(p, TICKS_PER_US);
+            p[0]  = PROFILER_SECTIONS;
+            p[1]  = worst_len;
+            p     = put32(p + 2, passes.passes);
+            p     = put32(p, passes.min);
+            p     = put32(p, stat_mean(&passes));
+            p     = put32(p, passes.max);
+            break;
+        case PROFILER_PAGE_SECTIONS:
+            count = window(PROFILER_SECTIONS, first, 20, length);
+            for (uint8_t i = 0; i < count; i++) {
+                const stat_t *stat = &sections[first + i];
+                p                  = put32(p, stat->passes);
+                p                  = put32(p, stat->min);
+                p                  = put32(p, stat_mean(stat));
+                p                  = put32(p, stat->max);
+                p                  = put32(p, worst_ticks[first + i]);
+            }
+            break;
+        case PROFILER_PAGE_TRACE:
+            count = window(worst_len, first, 9, length);
+            for (uint8_t i = 0; i < count; i++) {
+                p[0] = worst[first + i].section;
+                p    = put32(p + 1, worst[first + i].start);
+                p    = put32(p, worst[first + i].ticks);
+            }
+            break;
+        default:
+            data[1] = 0xFF;  // Unknown page
+            break;
+    }
+    data[4] = count;
+    raw_hid_send(data, length);
+    return true;
+}
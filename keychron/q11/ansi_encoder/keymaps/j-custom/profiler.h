@@ -0,0 +1,90 @@
+/* Main-loop cycle profiler (raw HID export)
+ *
+ * Counts the CPU cycles (DWT CYCCNT, 80 per us on the STM32L432) each
+ * subsystem takes per main-loop pass, to see what eats the scan-rate budget:
+ *   - matrix scan, debounce, split transport (matrix exchange and user RPCs),
+ *     process_record chain (action_exec), RGB render, SNLED flush, console,
+ *     USB (event queue and raw HID), and the keymap's own housekeeping;
+ *   - time is exclusive: a section nested in another (debounce inside the
+ *     matrix scan, SNLED flush inside the RGB task) is not counted twice;
+ *   - per section min / mean / max over the passes it ran in, plus the same
+ *     for the whole pass; "other" in the viewer is what no section covers;
+ *   - the slowest pass since the last reset is kept as a trace: every section
+ *     that ran, in order, with its start offset and cycles.
+ *
+ * QMK's functions are hooked with linker wrapping (--wrap, see rules.mk and
+ * profiler_hooks.c), so QMK itself is untouched; a section whose feature is
+ * off (console without CONSOLE_ENABLE) stays empty. Wrapping does not see
+ * calls inlined by LTO, so LTO_ENABLE is refused.
+ *
+ * The keymap modules can open sections of their own with profiler_begin() /
+ * profiler_end(). Built with PROFILER_WALL_CLOCK the same code runs on the
+ * host with a nanosecond clock instead of CYCCNT (scripts/profiler/loopback).
+ *
+ * Viewer: node scripts/profiler/profiler.js
+ *
+ * Raw HID request: [0] PROFILER_CHANNEL  [1] opcode  [2] page  [3] first index
+ * Reply:           [0] PROFILER_CHANNEL  [1] opcode | PROFILER_REPLY  [2] page
+ *                  [3] first index  [4] entries in this reply  [5..] entries (LE)
+ *   SUMMARY:  one entry: ticks per us (u16), sections, trace events (u8 each),
+ *             passes, pass min, pass mean, pass max (u32 each)
+ *   SECTIONS: per section from first: passes it ran in, min, mean, max,
+ *             ticks in the slowest pass (u32 each)
+ *   TRACE:    slowest pass events from first: section (u8), start offset,
+ *             ticks (u32 each)
+ * A reply carries as many entries as fit; the host asks again from
+ * first index + entries until it has all of them.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PROFILER_CHANNEL 0x50  // 'P': first byte of every profiler report
+#define PROFILER_REPLY   0x80
+
+#ifndef PROFILER_DEPTH
+#    define PROFILER_DEPTH 6  // Nested sections tracked at once
+#endif
+
+#ifndef PROFILER_TRACE_LEN
+#    define PROFILER_TRACE_LEN 32  // Section runs kept for the slowest pass
+#endif
+
+enum profiler_opcode {
+    PROFILER_OP_READ  = 0x01,  // [2] page  [3] first index
+    PROFILER_OP_RESET = 0x02,  // Zero the statistics and the trace
+};
+
+enum profiler_page {
+    PROFILER_PAGE_SUMMARY  = 0,
+    PROFILER_PAGE_SECTIONS = 1,
+    PROFILER_PAGE_TRACE    = 2,
+};
+
+// Keep in step with SECTION_NAMES in scripts/profiler/profiler.js
+enum profiler_section {
+    PROFILER_MATRIX = 0,
+    PROFILER_DEBOUNCE,
+    PROFILER_TRANSPORT,
+    PROFILER_PROCESS_RECORD,
+    PROFILER_RGB,
+    PROFILER_SNLED,
+    PROFILER_CONSOLE,
+    PROFILER_USB,
+    PROFILER_HOUSEKEEPING,
+    PROFILER_SECTIONS,
+};
+
+// Start the cycle counter (call from keyboard_post_init_user)
+void profiler_init(void);
+
+// Open / close a section; sections nest, time in a nested one is not counted in its parent
+void profiler_begin(uint8_t section);
+void profiler_end(void);
+
+// End of a main-loop pass (call last in housekeeping_task_user)
+void profiler_pass(void);
+
+// Handle a raw HID report; returns false if data is not for this channel
+bool profiler_receive(uint8_t *data, uint8_t length);
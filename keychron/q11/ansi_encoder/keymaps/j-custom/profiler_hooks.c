@@ -0,0 +1,86 @@
+/* Profiler sections around QMK's main-loop functions - see profiler.h
+ *
+ * Each function is renamed by the linker (-Wl,--wrap=name in rules.mk):
+ * callers reach __wrap_name, which times __real_name. Only calls from
+ * another translation unit are redirected, so process_record (called inside
+ * action.c) is timed through action_exec, its caller in keyboard.c.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "profiler.h"
+#ifdef SPLIT_HEALTH_ENABLE
+#    include "split_health.h"
+#endif
+
+// Declares __real_name and defines __wrap_name timing it as section
+#define PROFILE_VOID(name, section) \
+    void __real_##name(void);       \
+    void __wrap_##name(void) {      \
+        profiler_begin(section);    \
+        __real_##name();            \
+        profiler_end();             \
+    }
+
+PROFILE_VOID(rgb_matrix_task, PROFILER_RGB)
+PROFILE_VOID(snled27351_flush, PROFILER_SNLED)
+#ifdef CONSOLE_ENABLE
+PROFILE_VOID(console_task, PROFILER_CONSOLE)
+#endif
+PROFILE_VOID(usb_event_queue_task, PROFILER_USB)
+PROFILE_VOID(raw_hid_task, PROFILER_USB)
+
+uint8_t __real_matrix_scan(void);
+uint8_t __wrap_matrix_scan(void) {
+    profiler_begin(PROFILER_MATRIX);
+    uint8_t changed = __real_matrix_scan();
+    profiler_end();
+    return changed;
+}
+
+bool __real_debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+bool __wrap_debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    profiler_begin(PROFILER_DEBOUNCE);
+    bool cooked_changed = __real_debounce(raw, cooked, num_rows, changed);
+    profiler_end();
+    return cooked_changed;
+}
+
+// Split health times the same exchange: one --wrap hook, so it is called from here
+bool __real_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+bool __wrap_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    profiler_begin(PROFILER_TRANSPORT);
+#ifdef SPLIT_HEALTH_ENABLE
+    bool ok = split_health_transport_master(master_matrix, slave_matrix);
+#else
+    bool ok = __real_transport_master(master_matrix, slave_matrix);
+#endif
+    profiler_end();
+    return ok;
+}
+
+void __real_transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+void __wrap_transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    profiler_begin(PROFILER_TRANSPORT);
+    __real_transport_slave(master_matrix, slave_matrix);
+    profiler_end();
+}
+
+// User RPCs (split_sync, split_link, split_health) sent outside transport_master
+bool __real_transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+bool __wrap_transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    profiler_begin(PROFILER_TRANSPORT);
+    bool ok = __real_transaction_rpc_exec(transaction_id, initiator2target_buffer_size, initiator2target_buffer, target2initiator_buffer_size, target2initiator_buffer);
+    profiler_end();
+    return ok;
+}
+
+void __real_action_exec(keyevent_t event);
+void __wrap_action_exec(keyevent_t event) {
+    profiler_begin(PROFILER_PROCESS_RECORD);
+    __real_action_exec(event);
+    profiler_end();
+}
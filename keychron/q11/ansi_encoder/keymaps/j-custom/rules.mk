@@ -1,3 +1,176 @@
 ENCODER_MAP_ENABLE = yes
 TAP_DANCE_ENABLE = yes
 CONSOLE_ENABLE = yes
+
+# Host context channel: focused app (raw HID) selects layers, see host_context.h
+HOST_CONTEXT_ENABLE = yes
+
+ifeq ($(strip $(HOST_CONTEXT_ENABLE)), yes)
+    RAW_ENABLE = yes
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DHOST_CONTEXT_ENABLE
+    SRC += host_context.c
+endif
+
+# OS base: USB enumeration fingerprint selects the Mac or Windows host class, see os_base.h
+OS_BASE_ENABLE = yes
+
+ifeq ($(strip $(OS_BASE_ENABLE)), yes)
+    OS_DETECTION_ENABLE = yes
+    OPT_DEFS += -DOS_BASE_ENABLE
+    SRC += os_base.c
+endif
+
+# Key remap: Windows profile (Cmd/Ctrl swap, F-row delta) over the Mac layers, see key_remap.h
+KEY_REMAP_ENABLE = yes
+
+ifeq ($(strip $(KEY_REMAP_ENABLE)), yes)
+    OPT_DEFS += -DKEY_REMAP_ENABLE
+    SRC += key_remap.c
+endif
+
+# Split sync: layer/default layer/LED state batched into one RPC frame per scan, see split_sync.h
+SPLIT_SYNC_ENABLE = yes
+
+ifeq ($(strip $(SPLIT_SYNC_ENABLE)), yes)
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DSPLIT_SYNC_ENABLE
+    SRC += split_sync.c
+endif
+
+# Split link: negotiate the fastest reliable USART rate, fall back on errors, see split_link.h
+SPLIT_LINK_ENABLE = yes
+
+ifeq ($(strip $(SPLIT_LINK_ENABLE)), yes)
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DSPLIT_LINK_ENABLE
+    SRC += split_link.c
+endif
+
+# Split health: link counters and RTT histogram over raw HID and console, see split_health.h
+SPLIT_HEALTH_ENABLE = yes
+
+ifeq ($(strip $(SPLIT_HEALTH_ENABLE)), yes)
+    RAW_ENABLE = yes
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DSPLIT_HEALTH_ENABLE
+    SRC += split_health.c
+    EXTRALDFLAGS += -Wl,--wrap=transport_master
+endif
+
+# Split hits: the master's key hits sent to the slave for reactive RGB, replaces the matrix mirror, see split_hits.h
+SPLIT_HITS_ENABLE = yes
+
+ifeq ($(strip $(SPLIT_HITS_ENABLE)), yes)
+    OPT_DEFS += -DSPLIT_HITS_ENABLE
+    SRC += split_hits.c
+endif
+
+# Sparse keymap: layers stored as a bitmap plus packed keycodes, see sparse_keymap.h
+# (regenerate sparse_keymap_table.h after editing layers: node scripts/generate-sparse-keymap.js)
+SPARSE_KEYMAP_ENABLE = yes
+
+ifeq ($(strip $(SPARSE_KEYMAP_ENABLE)), yes)
+    OPT_DEFS += -DSPARSE_KEYMAP_ENABLE
+    SRC += sparse_keymap.c
+endif
+
+# Key stats: per-key/layer/keycode usage and WPM over raw HID, see key_stats.h
+KEY_STATS_ENABLE = yes
+
+ifeq ($(strip $(KEY_STATS_ENABLE)), yes)
+    RAW_ENABLE = yes
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DKEY_STATS_ENABLE
+    SRC += key_stats.c
+endif
+
+# Chords: keys pressed together (D+F, F+J, J+K → NAV selector layers), per-position index, see chords.h
+CHORDS_ENABLE = yes
+
+ifeq ($(strip $(CHORDS_ENABLE)), yes)
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DCHORDS_ENABLE
+    SRC += chords.c
+endif
+
+# App leader: K+L, then a key sequence → KC_APP_* launcher, trie in flash, see app_leader.h
+# (regenerate app_leader_trie.h after editing app_leader.json: node scripts/generate-app-leader.js)
+APP_LEADER_ENABLE = yes
+
+ifeq ($(strip $(APP_LEADER_ENABLE)), yes)
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DAPP_LEADER_ENABLE
+    SRC += app_leader.c
+endif
+
+# Kinetic mouse: NUMPAD pointer keys move the pointer with fixed-point velocity curves, a report per ms, see kinetic_mouse.h
+KINETIC_MOUSE_ENABLE = yes
+
+ifeq ($(strip $(KINETIC_MOUSE_ENABLE)), yes)
+    MOUSEKEY_ENABLE = yes
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DKINETIC_MOUSE_ENABLE
+    SRC += kinetic_mouse.c
+endif
+
+# Fast resume: LED drivers in software shutdown over USB suspend, RGB state kept, resume latency, see fast_resume.h
+FAST_RESUME_ENABLE = yes
+
+ifeq ($(strip $(FAST_RESUME_ENABLE)), yes)
+    OPT_DEFS += -DFAST_RESUME_ENABLE
+    SRC += fast_resume.c
+    FAST_RESUME_WRAP = host_keyboard_send
+    ifeq ($(strip $(NKRO_ENABLE)), yes)
+        FAST_RESUME_WRAP += host_nkro_send
+    endif
+    EXTRALDFLAGS += $(foreach f,$(FAST_RESUME_WRAP),-Wl,--wrap=$(f))
+endif
+
+# LED limit: current estimate from PWM x current tune, all LEDs dimmed together over budget, see led_limit.h
+LED_LIMIT_ENABLE = yes
+
+ifeq ($(strip $(LED_LIMIT_ENABLE)), yes)
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DLED_LIMIT_ENABLE
+    SRC += led_limit.c
+    EXTRALDFLAGS += -Wl,--wrap=snled27351_set_color -Wl,--wrap=snled27351_set_color_all
+endif
+
+# Tap tune: per-key tapping terms learned from tap/hold/gap histograms, saved to EEPROM, see tap_tune.h
+# (check tuned terms against traces: node scripts/tap-tune/tap-tune.js)
+TAP_TUNE_ENABLE = yes
+
+ifeq ($(strip $(TAP_TUNE_ENABLE)), yes)
+    TIMER_WHEEL_ENABLE = yes
+    OPT_DEFS += -DTAP_TUNE_ENABLE
+    SRC += tap_tune.c
+endif
+
+# Profiler: cycles per main-loop pass for each subsystem, slowest pass trace over raw HID, see profiler.h
+# (a diagnostic: set to yes to measure, then read it with node scripts/profiler/profiler.js)
+PROFILER_ENABLE = no
+
+ifeq ($(strip $(PROFILER_ENABLE)), yes)
+    RAW_ENABLE = yes
+    OPT_DEFS += -DPROFILER_ENABLE
+    SRC += profiler.c profiler_hooks.c
+    PROFILER_WRAP = matrix_scan debounce transport_master transport_slave transaction_rpc_exec \
+                    action_exec rgb_matrix_task snled27351_flush console_task usb_event_queue_task raw_hid_task
+    EXTRALDFLAGS += $(foreach f,$(PROFILER_WRAP),-Wl,--wrap=$(f))
+endif
+
+# The profiler, fast resume, LED limit and split health hook QMK with -Wl,--wrap,
+# which only sees calls between object files: LTO would inline them past the hooks
+ifneq ($(findstring --wrap,$(EXTRALDFLAGS)),)
+    ifeq ($(strip $(LTO_ENABLE)), yes)
+        $(error -Wl,--wrap hooks (PROFILER/FAST_RESUME/LED_LIMIT/SPLIT_HEALTH_ENABLE) do not see calls inlined by LTO: disable LTO_ENABLE)
+    endif
+endif
+
+# Timer wheel: one scheduler for the timeouts and periodic work of the modules above, see timer_wheel.h
+# (set by the modules that use it, so this block stays last)
+ifeq ($(strip $(TIMER_WHEEL_ENABLE)), yes)
+    OPT_DEFS += -DTIMER_WHEEL_ENABLE
+    SRC += timer_wheel.c
+endif
@@ -0,0 +1,54 @@
+/* Sparse keymap storage - see sparse_keymap.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "keymap_introspection.h"
+#include "sparse_keymap.h"
+
+static uint16_t sparse_lookup(uint8_t layer, uint16_t slot) {
+    if (layer >= sparse_keymap_layer_count || slot >= SPARSE_KEYMAP_SLOTS) {
+        return KC_TRNS;
+    }
+    const sparse_layer_t *entry = &sparse_keymap_layers[layer];
+    uint8_t               word  = slot / 32;
+    uint32_t              bits  = pgm_read_dword(&entry->bits[word]);
+    uint32_t              bit   = 1UL << (slot % 32);
+    if (!(bits & bit)) {
+        return KC_TRNS;
+    }
+    uint16_t index = pgm_read_word(&entry->base) + pgm_read_byte(&entry->rank[word]) + __builtin_popcount(bits & (bit - 1));
+    return pgm_read_word(&sparse_keymap_keys[index]);
+}
+
+// ============================================
+// Keymap introspection overrides (weak in QMK)
+// ============================================
+
+uint8_t keymap_layer_count(void) {
+    return sparse_keymap_layer_count;
+}
+
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    if (row >= MATRIX_ROWS || column >= MATRIX_COLS) {
+        return KC_TRNS;
+    }
+    return sparse_lookup(layer_num, row * MATRIX_COLS + column);
+}
+
+#if defined(ENCODER_MAP_ENABLE)
+uint8_t encodermap_layer_count(void) {
+    return sparse_keymap_layer_count;
+}
+
+// Same slot order as encoder_map[layer][encoder][ENCODER_CCW_CW]: clockwise first
+uint16_t keycode_at_encodermap_location(uint8_t layer_num, uint8_t encoder_idx, bool clockwise) {
+    if (encoder_idx >= NUM_ENCODERS) {
+        return KC_TRNS;
+    }
+    return sparse_lookup(layer_num, SPARSE_KEYMAP_MATRIX_SLOTS + encoder_idx * NUM_DIRECTIONS + (clockwise ? 0 : 1));
+}
+#endif
@@ -0,0 +1,51 @@
+/* Sparse keymap storage
+ *
+ * Most overlay layers (NAV, SYM, CURSOR, WIN, LIGHTING, ...) are almost all
+ * _______, yet keymaps[] stores every matrix position of every layer. With
+ * SPARSE_KEYMAP_ENABLE each layer is stored as
+ *   - a bitmap over its slots (matrix positions row * MATRIX_COLS + col, then
+ *     the encoder_map entries): bit set = keycode stored, clear = KC_TRNS
+ *   - the stored keycodes packed in slot order in one shared array
+ *   - per bitmap word, the number of keycodes stored before it
+ * so a lookup is one bitmap word, one popcount of the bits below the slot and
+ * one keycode read: O(1) without scanning the layer.
+ *
+ * The tables (sparse_keymap_table.h) are generated from the LAYOUT_* blocks in
+ * keymap.c, which stay the place to edit layers:
+ *   node scripts/generate-sparse-keymap.js
+ * build.sh refuses to build when the table is older than keymap.c.
+ *
+ * Matrix positions no LAYOUT_* key maps to read as KC_TRNS instead of KC_NO;
+ * they have no switch, so nothing changes. This keymap has no dynamic
+ * (VIA/EEPROM) keymap; dynamic_keymap.c replaces the same lookup, so the two
+ * cannot be combined.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(DYNAMIC_KEYMAP_ENABLE)
+#    error "SPARSE_KEYMAP_ENABLE replaces the keymap lookup that DYNAMIC_KEYMAP_ENABLE provides; enable only one"
+#endif
+
+#if defined(ENCODER_MAP_ENABLE)
+#    define SPARSE_KEYMAP_ENCODER_SLOTS (NUM_ENCODERS * NUM_DIRECTIONS)
+#else
+#    define SPARSE_KEYMAP_ENCODER_SLOTS 0
+#endif
+
+#define SPARSE_KEYMAP_MATRIX_SLOTS (MATRIX_ROWS * MATRIX_COLS)
+#define SPARSE_KEYMAP_SLOTS        (SPARSE_KEYMAP_MATRIX_SLOTS + SPARSE_KEYMAP_ENCODER_SLOTS)
+#define SPARSE_KEYMAP_WORDS        ((SPARSE_KEYMAP_SLOTS + 31) / 32)
+
+typedef struct {
+    uint32_t bits[SPARSE_KEYMAP_WORDS];  // Bit set = slot stored in sparse_keymap_keys
+    uint16_t base;                       // Index of the layer's first stored keycode
+    uint8_t  rank[SPARSE_KEYMAP_WORDS];  // Keycodes stored in the layer before each word
+} sparse_layer_t;
+
+// Generated tables (sparse_keymap_table.h, included by keymap.c)
+extern const sparse_layer_t sparse_keymap_layers[];
+extern const uint16_t       sparse_keymap_keys[];
+extern const uint8_t        sparse_keymap_layer_count;
@@ -0,0 +1,95 @@
+/* Generated by scripts/generate-sparse-keymap.js from keymap.c - do not edit.
+ * Regenerate: node scripts/generate-sparse-keymap.js
+ * inputs: d0b835bd060354b8e174f8de360e717cfc04cf53
+ * 9 layers, 312 of 1008 slots stored: 841 bytes (dense: 2016)
+ */
+#pragma once
+
+_Static_assert(MATRIX_ROWS == 12 && MATRIX_COLS == 9, "sparse_keymap_table.h: generated for a 12x9 matrix");
+_Static_assert(SPARSE_KEYMAP_ENCODER_SLOTS == 4, "sparse_keymap_table.h: generated for 4 encoder_map slots");
+
+#define SPARSE_KEYMAP_LAYERS 9
+
+const uint8_t PROGMEM sparse_keymap_layer_count = SPARSE_KEYMAP_LAYERS;
+
+const sparse_layer_t PROGMEM sparse_keymap_layers[] = {
+    [MAC_BASE] = { .bits = { 0xFB7DFEFF, 0xFFCBEFD3, 0xFF7FFFBF, 0x0000FEF2 }, .base = 0, .rank = { 0, 28, 53, 83 } },  // 95 stored
+    [NAV_LAYER] = { .bits = { 0x02300000, 0x00080003, 0x00160000, 0x0000F010 }, .base = 95, .rank = { 0, 3, 6, 9 } },  // 14 stored
+    [SYM_LAYER] = { .bits = { 0x0001F800, 0x80080001, 0x707EE01F, 0x0000F010 }, .base = 109, .rank = { 0, 6, 9, 26 } },  // 31 stored
+    [CURSOR_LAYER] = { .bits = { 0x00000000, 0x00080000, 0x001E0F00, 0x0000F010 }, .base = 140, .rank = { 0, 0, 1, 9 } },  // 14 stored
+    [APP_LAYER] = { .bits = { 0x40400402, 0x00080E80, 0x043C0800, 0x0000F010 }, .base = 154, .rank = { 0, 4, 9, 15 } },  // 20 stored
+    [WIN_LAYER] = { .bits = { 0x60300000, 0x00080181, 0x00180000, 0x0000FE02 }, .base = 174, .rank = { 0, 4, 8, 10 } },  // 18 stored
+    [MAC_FN] = { .bits = { 0xE37800FD, 0x4FC80803, 0x04000000, 0x0000F010 }, .base = 192, .rank = { 0, 16, 27, 28 } },  // 33 stored
+    [LIGHTING_LAYER] = { .bits = { 0xE0700000, 0x00080F81, 0x04000000, 0x0000F010 }, .base = 225, .rank = { 0, 6, 13, 14 } },  // 19 stored
+    [NUMPAD_LAYER] = { .bits = { 0xFB7CFE7F, 0xC00BEFD3, 0x583CFE3F, 0x0000F010 }, .base = 244, .rank = { 0, 26, 43, 63 } },  // 68 stored
+};
+
+// Stored keycodes per layer in slot order: matrix row by row, then encoder_map
+const uint16_t PROGMEM sparse_keymap_keys[] = {
+    // MAC_BASE
+    TD(TD_ENC_L), KC_ESC, KC_BRID, KC_BRIU, KC_MCTL, KC_LPAD,
+    RM_VALD, RM_VALU, KC_APP_WHATSAPP, KC_GRV, KC_1, KC_2,
+    KC_3, KC_4, KC_5, KC_6, KC_APP_WECHAT, KC_TAB,
+    KC_Q, KC_W, KC_E, KC_R, KC_T, KC_APP_SLACK_6,
+    KC_CAPS, KC_A, KC_S, KC_D, KC_F, KC_G,
+    KC_APP_CHATGPT, KC_LSFT, KC_Z, KC_X, KC_C, KC_V,
+    KC_B, TD(TD_SHADOWROCKET), KC_IME_NEXT, KC_LCTL, KC_LALT, KC_LGUI_SPOTLIGHT,
+    KC_SPC, KC_MPRV, KC_MPLY, KC_MNXT, KC_MUTE, KC_VOLD,
+    KC_VOLU, KC_INS, KC_DEL, TD(TD_ENC_R), KC_7, KC_8,
+    KC_9, KC_0, KC_MINS, KC_EQL, KC_BSPC, KC_PGUP,
+    KC_Y, KC_U, KC_I, KC_O, KC_P, KC_LBRC,
+    KC_RBRC, KC_BSLS, KC_PGDN, KC_H, KC_J, KC_K,
+    KC_L, KC_SCLN, KC_QUOT, KC_ENT, KC_HOME, KC_N,
+    KC_M, KC_COMM, KC_DOT, KC_SLSH, KC_RSFT, KC_UP,
+    KC_SPC, KC_RGUI_NAV, KC_RCTL, MO(MAC_FN), KC_LEFT, KC_DOWN,
+    KC_RGHT, KC_VOLU, KC_VOLD, KC_ZOOM_IN, KC_ZOOM_OUT,
+    // NAV_LAYER
+    TG(WIN_LAYER), TG(MAC_FN), KC_OS_BASE, KC_NAV_APP, KC_NAV_WIN, KC_SPC,
+    TG(NUMPAD_LAYER), KC_NAV_CURSOR, KC_NAV_LIGHTING, KC_SPC, KC_VOLU, KC_VOLD,
+    KC_ZOOM_IN, KC_ZOOM_OUT,
+    // SYM_LAYER
+    KC_EXLM, KC_AT, KC_HASH, KC_DLR, KC_PERC, KC_CIRC,
+    KC_SYM_TILDE_SLASH, KC_SPC, KC_AMPR, KC_ASTR, KC_LPRN, KC_RPRN,
+    KC_UNDS, KC_PLUS, KC_LCBR, KC_RCBR, KC_PIPE, KC_SYM_BACKTICKS,
+    KC_SYM_PARENTHESES, KC_SYM_CURLY_BRACES, KC_SYM_SQUARE_BRACKETS, KC_COLN, KC_DQUO, KC_LT,
+    KC_GT, KC_QUES, KC_SPC, KC_VOLU, KC_VOLD, KC_ZOOM_IN,
+    KC_ZOOM_OUT,
+    // CURSOR_LAYER
+    KC_SPC, LGUI(KC_B), LGUI(KC_T), LGUI(KC_I), LGUI(KC_DOT), KC_CURSOR_FOCUS_EDITOR,
+    KC_CURSOR_PREV_CHANGE, KC_CURSOR_NEXT_CHANGE, KC_CURSOR_APPLY_IN_EDITOR, KC_SPC, KC_VOLU, KC_VOLD,
+    KC_ZOOM_IN, KC_ZOOM_OUT,
+    // APP_LAYER
+    KC_APP_CALC, KC_APP_MUSIC, KC_APP_MAIL, KC_APP_SLACK, KC_APP_CHATGPT, KC_APP_CAL,
+    KC_APP_VSCODE, KC_APP_BGA, KC_SPC, KC_APP_OBSIDIAN, KC_APP_WHATSAPP, KC_APP_SIGNAL,
+    KC_APP_WECHAT, KC_APP_TELEGRAM, KC_APP_NOTION, KC_SPC, KC_VOLU, KC_VOLD,
+    KC_ZOOM_IN, KC_ZOOM_OUT,
+    // WIN_LAYER
+    KC_WIN_TL, KC_WIN_TR, KC_WIN_BL, KC_WIN_BR, KC_WIN_MAX, KC_WIN_SV_L,
+    KC_WIN_SV_R, KC_SPC, KC_WIN_SWIPE_L, KC_WIN_SWIPE_R, KC_WIN_TOP, KC_WIN_LEFT,
+    KC_WIN_BOTTOM, KC_WIN_RIGHT, KC_VOLU, KC_VOLD, KC_ZOOM_IN, KC_ZOOM_OUT,
+    // MAC_FN
+    TD(TD_ENC_L), KC_F1, KC_F2, KC_F3, KC_F4, KC_F5,
+    KC_F6, RM_TOGG, RM_NEXT, RM_VALU, RM_HUEU, RM_SATU,
+    RM_SPDU, RM_PREV, RM_VALD, RM_HUED, RM_SATD, RM_SPDD,
+    KC_OS_BASE, KC_SPC, KC_F7, KC_F8, KC_F9, KC_F10,
+    KC_F11, KC_F12, TD(TD_ENC_R), NK_TOGG, KC_SPC, KC_VOLU,
+    KC_VOLD, KC_ZOOM_IN, KC_ZOOM_OUT,
+    // LIGHTING_LAYER
+    RM_TOGG, RM_NEXT, RM_PREV, RM_VALU, RM_VALD, RM_HUEU,
+    RM_HUED, RM_SATU, RM_SATD, RM_SPDU, RM_SPDD, RM_FLGN,
+    KC_SPC, RM_FLGP, KC_SPC, KC_VOLU, KC_VOLD, KC_ZOOM_IN,
+    KC_ZOOM_OUT,
+    // NUMPAD_LAYER
+    TD(TD_ENC_L), KC_ESC, KC_BRID, KC_BRIU, KC_MCTL, KC_LPAD,
+    RM_VALD, KC_APP_WHATSAPP, KC_GRV, KC_1, KC_2, KC_3,
+    KC_4, KC_5, KC_APP_WECHAT, KC_TAB, KC_Q, KC_W,
+    KC_E, KC_R, KC_T, KC_APP_SLACK_6, KC_CAPS, KC_A,
+    KC_S, KC_D, KC_F, KC_G, KC_APP_CHATGPT, KC_LSFT,
+    KC_Z, KC_X, KC_C, KC_V, KC_B, TD(TD_SHADOWROCKET),
+    KC_IME_NEXT, KC_LCTL, KC_LALT, KC_LGUI, TD(TD_NUMPAD_SPACE), TD(TD_ENC_R),
+    KC_KP_7, KC_KP_8, KC_KP_9, KC_KP_SLASH, KC_BTN1, KC_MS_U,
+    KC_BTN2, KC_KP_4, KC_KP_5, KC_KP_6, KC_KP_ASTERISK, KC_MS_L,
+    KC_MS_D, KC_MS_R, KC_KP_1, KC_KP_2, KC_KP_3, KC_KP_MINUS,
+    KC_KP_0, KC_KP_DOT, KC_KP_PLUS, KC_SPC, KC_VOLU, KC_VOLD,
+    KC_ZOOM_IN, KC_ZOOM_OUT,
+};
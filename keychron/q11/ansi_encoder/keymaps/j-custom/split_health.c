@@ -0,0 +1,309 @@
+/* Split link health telemetry - see split_health.h for the report layout
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "raw_hid.h"
+#include "transactions.h"
+#include "transport.h"
+#include "serial_usart.h"
+#include "split_health.h"
+#include "timer_wheel.h"
+#ifdef SPLIT_LINK_ENABLE
+#    include "split_link.h"
+#endif
+
+// ChibiOS keeps .ram0 out of the startup clear: survives the split watchdog's reset
+#ifndef SPLIT_HEALTH_NOINIT_SECTION
+#    define SPLIT_HEALTH_NOINIT_SECTION ".ram0"
+#endif
+
+#define RETAINED_MAGIC 0x4C4E4B31  // "LNK1"
+#define ROLE_UNKNOWN   0xFF
+
+#define USART_ERROR_FLAGS (SD_PARITY_ERROR | SD_FRAMING_ERROR | SD_OVERRUN_ERROR | SD_NOISE_ERROR)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t boots;
+    uint16_t resets;        // Software (split watchdog) and watchdog resets
+    uint16_t role_changes;  // Booted as master after slave or the other way round
+    uint8_t  last_role;
+} retained_t;
+
+// Per-half counters, also the slave's RPC reply
+typedef struct __attribute__((packed)) {
+    uint16_t boots;
+    uint16_t resets;
+    uint16_t role_changes;
+    uint32_t usart_errors;
+    uint32_t polls;
+    uint32_t uptime_s;
+} half_counters_t;
+
+static retained_t retained __attribute__((section(SPLIT_HEALTH_NOINIT_SECTION)));
+
+static struct {
+    uint32_t transactions;
+    uint32_t timeouts;
+    uint32_t bad_replies;
+    uint32_t usart_errors;
+    uint32_t retries;
+    uint32_t disconnects;
+    uint16_t fallbacks;
+    uint32_t rtt[SPLIT_HEALTH_RTT_BUCKETS];
+    uint16_t rtt_max_us;
+} link;
+
+static half_counters_t  self;
+static half_counters_t  slave;  // Last poll reply (master)
+static event_listener_t usart_listener;
+static bool             was_connected = false;
+
+// Master: slave counter poll and console summary (timer_wheel.h)
+static uint32_t            poll_slave(void);
+static timer_wheel_timer_t poll_timer = TIMER_WHEEL_TIMER(poll_slave);
+#ifdef CONSOLE_ENABLE
+static uint32_t            report(void);
+static timer_wheel_timer_t report_timer = TIMER_WHEEL_TIMER(report);
+#endif
+
+// ============================================
+// Counters
+// ============================================
+
+static void record_rtt(uint32_t us) {
+    uint8_t  bucket = 0;
+    uint32_t limit  = SPLIT_HEALTH_RTT_FIRST;
+    while (bucket < SPLIT_HEALTH_RTT_BUCKETS - 1 && us >= limit) {
+        bucket++;
+        limit <<= 1;
+    }
+    link.rtt[bucket]++;
+    if (us > link.rtt_max_us) {
+        link.rtt_max_us = us > UINT16_MAX ? UINT16_MAX : us;
+    }
+}
+
+// One exchange with the slave that began at start
+static bool count(bool ok, rtcnt_t start) {
+    link.transactions++;
+    if (!ok) {
+        link.timeouts++;
+        return false;
+    }
+    record_rtt((chSysGetRealtimeCounterX() - start) / (STM32_SYSCLK / 1000000U));
+    return true;
+}
+
+bool split_health_exec(int8_t id, uint8_t in_len, const void *in_data, uint8_t out_len, void *out_data) {
+    rtcnt_t start = chSysGetRealtimeCounterX();
+    return count(transaction_rpc_exec(id, in_len, in_data, out_len, out_data), start);
+}
+
+// QMK's per-scan exchange (matrix, then the synced state), renamed by the
+// linker (-Wl,--wrap=transport_master in rules.mk)
+bool __real_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+bool split_health_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    rtcnt_t start = chSysGetRealtimeCounterX();
+    return count(__real_transport_master(master_matrix, slave_matrix), start);
+}
+
+#ifndef PROFILER_ENABLE
+// With the profiler on, its own wrapper calls split_health_transport_master (profiler_hooks.c)
+bool __wrap_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    return split_health_transport_master(master_matrix, slave_matrix);
+}
+#endif
+
+void split_health_bad_reply(void) {
+    link.bad_replies++;
+}
+
+void split_health_retry(uint8_t count) {
+    link.retries += count;
+}
+
+void split_health_fallback(void) {
+    link.fallbacks++;
+}
+
+static void fill_self(void) {
+    self.boots        = retained.boots;
+    self.resets       = retained.resets;
+    self.role_changes = retained.role_changes;
+    self.uptime_s     = timer_read32() / 1000;
+}
+
+// ============================================
+// Slave
+// ============================================
+
+static void split_health_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    if (out_buflen < sizeof(half_counters_t)) {
+        return;
+    }
+    self.polls++;
+    fill_self();
+    memcpy(out_data, &self, sizeof(self));
+}
+
+// ============================================
+// Init / Task
+// ============================================
+
+void split_health_init(void) {
+    uint8_t role = is_keyboard_master() ? 1 : 0;
+    if (retained.magic != RETAINED_MAGIC) {
+        memset(&retained, 0, sizeof(retained));
+        retained.magic     = RETAINED_MAGIC;
+        retained.last_role = ROLE_UNKNOWN;
+    }
+    retained.boots++;
+    if (RCC->CSR & (RCC_CSR_SFTRSTF | RCC_CSR_IWDGRSTF | RCC_CSR_WWDGRSTF)) {
+        retained.resets++;
+    }
+    RCC->CSR |= RCC_CSR_RMVF;
+    if (retained.last_role != ROLE_UNKNOWN && retained.last_role != role) {
+        retained.role_changes++;
+    }
+    retained.last_role = role;
+
+    chEvtRegisterMaskWithFlags(chnGetEventSource(&SERIAL_USART_DRIVER), &usart_listener, EVENT_MASK(1), USART_ERROR_FLAGS);
+    if (!role) {
+        transaction_register_rpc(RPC_ID_USER_SPLIT_HEALTH, split_health_slave_handler);
+        return;
+    }
+    timer_wheel_schedule(&poll_timer, SPLIT_HEALTH_POLL_MS);
+#ifdef CONSOLE_ENABLE
+    timer_wheel_schedule(&report_timer, SPLIT_HEALTH_REPORT_MS);
+#endif
+}
+
+static uint32_t poll_slave(void) {
+    uint8_t         request = 0;
+    half_counters_t reply;
+    if (is_transport_connected() && split_health_exec(RPC_ID_USER_SPLIT_HEALTH, sizeof(request), &request, sizeof(reply), &reply)) {
+        slave = reply;
+    }
+    return SPLIT_HEALTH_POLL_MS;
+}
+
+#ifdef CONSOLE_ENABLE
+static uint32_t report(void) {
+    split_health_print();
+    return SPLIT_HEALTH_REPORT_MS;
+}
+#endif
+
+void split_health_task(void) {
+    if (chEvtGetAndClearFlags(&usart_listener) & USART_ERROR_FLAGS) {
+        self.usart_errors++;
+        link.usart_errors++;
+    }
+    if (!is_keyboard_master()) {
+        return;
+    }
+
+    bool connected = is_transport_connected();
+    if (was_connected && !connected) {
+        link.disconnects++;
+    }
+    was_connected = connected;
+}
+
+// ============================================
+// Raw HID
+// ============================================
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+    return put16(put16(p, v & 0xFFFF), v >> 16);
+}
+
+static uint32_t link_baud(void) {
+#ifdef SPLIT_LINK_ENABLE
+    return split_link_baud();
+#else
+    return SERIAL_USART_SPEED;
+#endif
+}
+
+bool split_health_receive(uint8_t *data, uint8_t length) {
+    if (length < 32 || data[0] != SPLIT_HEALTH_CHANNEL) {
+        return false;
+    }
+
+    uint8_t opcode = data[1];
+    uint8_t page   = data[2];
+    if (opcode == SPLIT_HEALTH_OP_RESET) {
+        memset(&link, 0, sizeof(link));
+    }
+
+    memset(data + 3, 0, length - 3);
+    data[1]    = opcode | SPLIT_HEALTH_REPLY;
+    uint8_t *p = data + 3;
+    fill_self();
+    switch (page) {
+        case SPLIT_HEALTH_PAGE_LINK:
+            p = put32(p, link.transactions);
+            p = put32(p, link.timeouts);
+            p = put32(p, link.bad_replies);
+            p = put32(p, link.usart_errors);
+            p = put32(p, link.retries);
+            p = put32(p, link.disconnects);
+            p = put16(p, link.fallbacks);
+            p = put16(p, link_baud() / 100);
+            break;
+        case SPLIT_HEALTH_PAGE_RTT:
+            for (uint8_t i = 0; i < SPLIT_HEALTH_RTT_BUCKETS; i++) {
+                p = put32(p, link.rtt[i]);
+            }
+            p = put16(p, link.rtt_max_us);
+            break;
+        case SPLIT_HEALTH_PAGE_HALVES:
+            p = put16(p, self.boots);
+            p = put16(p, self.resets);
+            p = put16(p, self.role_changes);
+            p = put16(p, slave.boots);
+            p = put16(p, slave.resets);
+            p = put16(p, slave.role_changes);
+            p = put32(p, slave.usart_errors);
+            p = put32(p, slave.polls);
+            p = put32(p, slave.uptime_s);
+            p = put32(p, self.uptime_s);
+            break;
+        default:
+            data[1] = 0xFF;  // Unknown page
+            break;
+    }
+    raw_hid_send(data, length);
+    return true;
+}
+
+// ============================================
+// Console
+// ============================================
+
+void split_health_print(void) {
+#ifdef CONSOLE_ENABLE
+    fill_self();
+    uprintf("SPLIT_HEALTH: tx=%lu timeout=%lu bad=%lu usart=%lu retry=%lu disc=%lu fallback=%u baud=%lu\n", (unsigned long)link.transactions, (unsigned long)link.timeouts, (unsigned long)link.bad_replies, (unsigned long)link.usart_errors, (unsigned long)link.retries, (unsigned long)link.disconnects, link.fallbacks, (unsigned long)link_baud());
+    uprintf("SPLIT_HEALTH: rtt");
+    for (uint8_t i = 0; i < SPLIT_HEALTH_RTT_BUCKETS; i++) {
+        uprintf(" %lu", (unsigned long)link.rtt[i]);
+    }
+    uprintf(" (<%u us doubling) max=%uus\n", SPLIT_HEALTH_RTT_FIRST, link.rtt_max_us);
+    uprintf("SPLIT_HEALTH: master boots=%u resets=%u roles=%u | slave boots=%u resets=%u roles=%u usart=%lu polls=%lu up=%lus\n", self.boots, self.resets, self.role_changes, slave.boots, slave.resets, slave.role_changes, (unsigned long)slave.usart_errors, (unsigned long)slave.polls, (unsigned long)slave.uptime_s);
+#endif
+}
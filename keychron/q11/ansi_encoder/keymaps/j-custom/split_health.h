@@ -0,0 +1,88 @@
+/* Split link health telemetry
+ *
+ * Counts what the link does so right-half lag can be traced to a cause:
+ *   - transactions / timeouts / bad replies, with a round-trip time
+ *     histogram, for every exchange with the slave: QMK's per-scan
+ *     transport_master (matrix and synced state, timed as one exchange,
+ *     hooked with -Wl,--wrap) and every user RPC (split_sync, split_link,
+ *     this module)
+ *   - USART error flags (parity, framing, overrun, noise) on both halves;
+ *     this transport has no CRC, so parity/framing errors are the corruption signal
+ *   - retries (split_sync items resent after a failed frame), transport
+ *     disconnects, rate fallbacks (split_link)
+ *   - boots, watchdog/software resets and role changes per half, kept in
+ *     RAM that survives a reset
+ * Rising parity/framing errors with normal RTTs point at the cable; timeouts,
+ * long RTT tails and watchdog resets point at a stalled half.
+ *
+ * The master polls the slave's counters every SPLIT_HEALTH_POLL_MS. Both
+ * halves' numbers are readable over raw HID (channel SPLIT_HEALTH_CHANNEL,
+ * viewer: scripts/split-health/split-health.js) and printed to the console
+ * every SPLIT_HEALTH_REPORT_MS.
+ *
+ * Raw HID request: [0] SPLIT_HEALTH_CHANNEL  [1] opcode  [2] page
+ * Reply:           [0] SPLIT_HEALTH_CHANNEL  [1] opcode | SPLIT_HEALTH_REPLY  [2] page  [3..] page data (LE)
+ *   Page 0 (link):   transactions, timeouts, bad replies, usart errors, retries,
+ *                    disconnects (u32 each), fallbacks, baud / 100 (u16 each)
+ *   Page 1 (RTT):    SPLIT_HEALTH_RTT_BUCKETS counts (u32), max RTT us (u16)
+ *   Page 2 (halves): master boots, resets, role changes, then the same for the
+ *                    slave (u16 each), slave usart errors, slave polls answered,
+ *                    slave uptime s, master uptime s (u32 each)
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SPLIT_HEALTH_CHANNEL 0x4C  // 'L': first byte of every link health report
+#define SPLIT_HEALTH_REPLY   0x80
+
+#ifndef SPLIT_HEALTH_POLL_MS
+#    define SPLIT_HEALTH_POLL_MS 1000
+#endif
+
+#ifndef SPLIT_HEALTH_REPORT_MS
+#    define SPLIT_HEALTH_REPORT_MS 10000  // Console summary interval (CONSOLE_ENABLE)
+#endif
+
+// RTT buckets: < 250, 500, 1000, 2000, 4000 us, and the rest
+#define SPLIT_HEALTH_RTT_BUCKETS 6
+#define SPLIT_HEALTH_RTT_FIRST   250
+
+enum split_health_opcode {
+    SPLIT_HEALTH_OP_READ  = 0x01,  // [2] page
+    SPLIT_HEALTH_OP_RESET = 0x02,  // Zero the link and RTT counters (boot/reset/role counts are kept)
+};
+
+enum split_health_page {
+    SPLIT_HEALTH_PAGE_LINK   = 0,
+    SPLIT_HEALTH_PAGE_RTT    = 1,
+    SPLIT_HEALTH_PAGE_HALVES = 2,
+};
+
+// Record reset cause and role, register the slave RPC (call from keyboard_post_init_user, both halves)
+void split_health_init(void);
+
+// Track disconnects and USART errors (call every scan from housekeeping_task_user); the slave poll runs on timer_wheel.h
+void split_health_task(void);
+
+// transaction_rpc_exec with counting and RTT timing; modules call this instead when enabled
+bool split_health_exec(int8_t id, uint8_t in_len, const void *in_data, uint8_t out_len, void *out_data);
+
+// Timed transport_master: the --wrap hook, or called by the profiler's (profiler_hooks.c)
+bool split_health_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+// A reply arrived but was malformed (wrong seq, echo mismatch)
+void split_health_bad_reply(void);
+
+// Items or frames that had to be sent again
+void split_health_retry(uint8_t count);
+
+// A negotiated rate was abandoned (split_link)
+void split_health_fallback(void);
+
+// Handle a raw HID report; returns false if data is not for this channel
+bool split_health_receive(uint8_t *data, uint8_t length);
+
+// Print both halves' counters to the console
+void split_health_print(void);
@@ -0,0 +1,203 @@
+/* Cross-half key hits - see split_hits.h for the frame format
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "transactions.h"
+#include "split_hits.h"
+
+#ifndef RGB_MATRIX_ENABLE
+#    error "SPLIT_HITS_ENABLE feeds the slave's reactive RGB effects: enable RGB_MATRIX_ENABLE"
+#endif
+
+#ifdef SPLIT_HEALTH_ENABLE
+#    include "split_health.h"
+#    define rpc_exec split_health_exec
+#else
+#    define rpc_exec transaction_rpc_exec
+#endif
+
+#define HALF_ROWS      (MATRIX_ROWS / 2)
+#define HIT_SIZE       2  // row << 4 | col, pressed << 7 | age
+#define HIT_PRESSED    0x80
+#define HIT_AGE_MASK   0x7F
+#define HITS_PER_FRAME ((RPC_M2S_BUFFER_SIZE - 2) / HIT_SIZE)
+#define QUEUE_MASK     (SPLIT_HITS_QUEUE - 1)
+#define FRAME_SYNC     0x80  // In the count byte: the master (re)started, take its sequence as is
+#define FRAME_COUNT    0x7F
+
+_Static_assert((SPLIT_HITS_QUEUE & QUEUE_MASK) == 0 && SPLIT_HITS_QUEUE <= 64, "SPLIT_HITS_QUEUE: power of two, at most 64");
+_Static_assert(SPLIT_HITS_MAX_AGE <= HIT_AGE_MASK, "hit age is 7 bits");
+_Static_assert(MATRIX_ROWS <= 16 && MATRIX_COLS <= 16, "a hit packs row and col in one byte");
+
+typedef struct {
+    uint8_t  pos;  // row << 4 | col
+    bool     pressed;
+    uint16_t time;  // Master: when the matrix changed; slave: when the frame arrived
+    uint8_t  age;   // Slave: age when the frame was sent
+} hit_t;
+
+// Master: hits not yet acknowledged, seq of queue[head] is head (mod 256)
+// Slave: hits received from its RPC handler, applied by the main loop
+static hit_t              queue[SPLIT_HITS_QUEUE];
+static volatile uint8_t   head = 0;
+static volatile uint8_t   tail = 0;
+static split_hits_stats_t stats;
+
+static uint8_t queued(void) {
+    return (uint8_t)(tail - head);
+}
+
+// ============================================
+// Slave: take hits in the RPC handler, draw them from the main loop
+// ============================================
+
+static uint8_t expected  = 0;  // Sequence of the next hit from the master
+static bool    synced    = false;
+static bool    sync_seen = false;  // Last frame had FRAME_SYNC: another one is a resend, not a restart
+
+static void split_hits_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    const uint8_t *in    = (const uint8_t *)in_data;
+    uint8_t       *out   = (uint8_t *)out_data;
+    uint8_t        count = in_buflen >= 2 ? in[1] & FRAME_COUNT : 0;
+    if (in_buflen < 2 || out_buflen < 1 || 2 + count * HIT_SIZE > in_buflen) {
+        return;
+    }
+
+    if ((in[1] & FRAME_SYNC) && !sync_seen) {
+        synced = false;
+    }
+    sync_seen = in[1] & FRAME_SYNC;
+    uint16_t now = timer_read();
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t seq = in[0] + i;
+        if (synced && (int8_t)(seq - expected) < 0) {
+            continue;  // Resend of a hit already taken
+        }
+        expected = seq + 1;
+        synced   = true;
+        stats.queued++;
+        if (queued() == SPLIT_HITS_QUEUE) {
+            stats.dropped++;  // Main loop behind: head belongs to it, drop the newest
+            continue;
+        }
+        const uint8_t *h         = in + 2 + i * HIT_SIZE;
+        queue[tail & QUEUE_MASK] = (hit_t){ .pos = h[0], .pressed = h[1] & HIT_PRESSED, .time = now, .age = h[1] & HIT_AGE_MASK };
+        tail++;
+    }
+    out[0] = expected;
+}
+
+static void slave_task(void) {
+    while (queued() > 0) {
+        hit_t   *hit = &queue[head & QUEUE_MASK];
+        uint16_t age = hit->age + TIMER_DIFF_16(timer_read(), hit->time);
+        if (age > SPLIT_HITS_MAX_AGE) {
+            stats.dropped++;
+        } else {
+            process_rgb_matrix(hit->pos >> 4, hit->pos & 0x0F, hit->pressed);
+        }
+        head++;
+    }
+}
+
+// ============================================
+// Master: diff its own rows, one frame per scan
+// ============================================
+
+static matrix_row_t previous[HALF_ROWS];
+static uint8_t      first_row = 0;
+static bool         announced = false;  // The slave has taken a FRAME_SYNC frame
+
+static void push(hit_t hit) {
+    if (queued() == SPLIT_HITS_QUEUE) {
+        head++;  // Full: drop the oldest
+        stats.dropped++;
+    }
+    queue[tail & QUEUE_MASK] = hit;
+    tail++;
+    stats.queued++;
+}
+
+static void master_task(void) {
+    uint16_t now = timer_read();
+    for (uint8_t r = 0; r < HALF_ROWS; r++) {
+        matrix_row_t row     = matrix_get_row(first_row + r);
+        matrix_row_t changed = row ^ previous[r];
+        previous[r]          = row;
+        for (uint8_t col = 0; changed; col++, changed >>= 1) {
+            if (changed & 1) {
+                push((hit_t){ .pos = (first_row + r) << 4 | col, .pressed = (row >> col) & 1, .time = now });
+            }
+        }
+    }
+
+    // Too old to be worth drawing
+    while (queued() > 0 && TIMER_DIFF_16(now, queue[head & QUEUE_MASK].time) > SPLIT_HITS_MAX_AGE) {
+        head++;
+        stats.dropped++;
+    }
+    if (queued() == 0) {
+        return;
+    }
+
+    uint8_t frame[2 + HITS_PER_FRAME * HIT_SIZE];
+    uint8_t count = queued() < HITS_PER_FRAME ? queued() : HITS_PER_FRAME;
+    frame[0]      = head;
+    frame[1]      = count | (announced ? 0 : FRAME_SYNC);
+    for (uint8_t i = 0; i < count; i++) {
+        const hit_t *hit            = &queue[(uint8_t)(head + i) & QUEUE_MASK];
+        frame[2 + i * HIT_SIZE]     = hit->pos;
+        frame[2 + i * HIT_SIZE + 1] = (hit->pressed ? HIT_PRESSED : 0) | TIMER_DIFF_16(now, hit->time);
+    }
+
+    uint8_t reply;
+    stats.frames++;
+    if (!rpc_exec(RPC_ID_USER_SPLIT_HITS, 2 + count * HIT_SIZE, frame, sizeof(reply), &reply)) {
+        stats.failed++;
+#ifdef SPLIT_HEALTH_ENABLE
+        split_health_retry(count);
+#endif
+        return;  // Hits stay queued for the next scan
+    }
+    uint8_t acked = reply - head;
+    if (acked > count) {
+#ifdef SPLIT_HEALTH_ENABLE
+        split_health_bad_reply();
+#endif
+        return;
+    }
+    head += acked;
+    announced = true;
+}
+
+// ============================================
+// API
+// ============================================
+
+void split_hits_init(void) {
+    if (!is_keyboard_master()) {
+        transaction_register_rpc(RPC_ID_USER_SPLIT_HITS, split_hits_slave_handler);
+        return;
+    }
+    first_row = is_keyboard_left() ? 0 : HALF_ROWS;
+    for (uint8_t r = 0; r < HALF_ROWS; r++) {
+        previous[r] = matrix_get_row(first_row + r);
+    }
+}
+
+void split_hits_task(void) {
+    if (is_keyboard_master()) {
+        master_task();
+    } else {
+        slave_task();
+    }
+}
+
+const split_hits_stats_t *split_hits_stats(void) {
+    return &stats;
+}
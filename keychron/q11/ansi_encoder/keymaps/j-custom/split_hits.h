@@ -0,0 +1,56 @@
+/* Cross-half key hits for reactive RGB effects
+ *
+ * Reactive effects (typing_heatmap, splash, solid_splash, solid_reactive_*)
+ * are fed by process_rgb_matrix() in each half's own matrix task. The master
+ * sees every key (the slave's rows arrive with the matrix transaction), but
+ * the slave only sees its own, so the master's presses light nothing on the
+ * slave's LEDs. Instead of mirroring the whole matrix to the slave every
+ * change (SPLIT_TRANSPORT_MIRROR, turned off in post_config.h), the master
+ * sends just the hits on its own rows:
+ *   - the master diffs its half of the matrix once per scan, queueing a hit
+ *     (row, col, pressed, time) for each change, as switch_events() sees it;
+ *   - queued hits go out in one SPLIT_TRANSACTION_IDS_USER frame per scan,
+ *     each with its age (ms since the matrix changed);
+ *   - the slave hands them to process_rgb_matrix() from its own main loop
+ *     (the RPC handler runs in the serial thread), so press/release filtering
+ *     and the heatmap behave as for its own keys.
+ *
+ * Frame (master → slave):  [0] sequence of the first hit
+ *                          [1] count, bit 7 set until the slave took one frame
+ *                              (the master restarted: resync on its sequence)
+ *                          then per hit: row << 4 | col, pressed << 7 | age
+ * Reply (slave → master):  [0] sequence of the next hit it expects
+ *
+ * Hits stay queued until the slave acknowledges them, so a failed frame is
+ * resent on the next scan; a hit older than SPLIT_HITS_MAX_AGE (counting the
+ * wait on the slave) is dropped instead of drawn late. Latency is one scan
+ * plus one transaction, bounded by SPLIT_HITS_MAX_AGE while the link fails.
+ * 2 bytes per hit, nothing at all while no key changes.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SPLIT_HITS_QUEUE
+#    define SPLIT_HITS_QUEUE 16  // Hits waiting for the slave (power of two); the oldest is dropped when full
+#endif
+
+#ifndef SPLIT_HITS_MAX_AGE
+#    define SPLIT_HITS_MAX_AGE 100  // ms after which a hit is dropped instead of drawn (at most 127)
+#endif
+
+typedef struct {
+    uint32_t queued;   // Master: hits on its own rows; slave: hits received
+    uint32_t frames;   // Master: frames sent
+    uint32_t failed;   // Master: frames that got no reply
+    uint32_t dropped;  // Hits lost to a full queue or SPLIT_HITS_MAX_AGE
+} split_hits_stats_t;
+
+// Register the RPC handler (call from keyboard_post_init_user, both halves)
+void split_hits_init(void);
+
+// Master: queue and send this scan's hits; slave: apply received hits (call every scan from housekeeping_task_user)
+void split_hits_task(void);
+
+const split_hits_stats_t *split_hits_stats(void);
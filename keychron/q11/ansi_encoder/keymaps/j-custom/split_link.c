@@ -0,0 +1,365 @@
+/* Split link rate negotiation - see split_link.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "transactions.h"
+#include "transport.h"
+#include "serial_usart.h"
+#include "split_link.h"
+#include "timer_wheel.h"
+
+#ifdef SPLIT_HEALTH_ENABLE
+#    include "split_health.h"
+#    define rpc_exec split_health_exec
+#else
+#    define rpc_exec transaction_rpc_exec
+#endif
+
+// Frame: [0] op  [1] rate index  [2..] echo payload
+// Reply: [0] op | LINK_REPLY  [1] slave's committed rate index  [2..] payload inverted (ECHO)
+enum link_op {
+    LINK_OP_PROPOSE   = 0x01,
+    LINK_OP_ECHO      = 0x02,
+    LINK_OP_CONFIRM   = 0x03,
+    LINK_OP_HEARTBEAT = 0x04,
+};
+#define LINK_REPLY     0x80
+#define LINK_FRAME_LEN RPC_M2S_BUFFER_SIZE
+#define LINK_NONE      0xFF
+
+#define LINK_ERROR_FLAGS (SD_PARITY_ERROR | SD_FRAMING_ERROR | SD_OVERRUN_ERROR | SD_NOISE_ERROR)
+
+static const uint32_t rates[] = { SERIAL_USART_SPEED, SPLIT_LINK_FAST_RATES };  // Boot rate first
+#define RATE_COUNT ((uint8_t)(sizeof(rates) / sizeof(rates[0])))
+
+static split_link_stats_t stats;
+static event_listener_t   error_listener;
+static uint8_t            active    = 0;  // Rate the USART runs at
+static uint8_t            committed = 0;  // Rate both halves agreed on
+
+// Master (phases, probe steps, heartbeat and error window run on timer_wheel.h)
+static enum { LINK_SETTLE, LINK_PROBE, LINK_RUN } phase = LINK_SETTLE;
+static enum { PROBE_SWITCH, PROBE_ECHO, PROBE_REVERT } step;
+static uint8_t candidate     = 0;           // Rate under probe
+static uint8_t echoes        = 0;           // ECHO frames passed at candidate
+static uint8_t ceiling       = RATE_COUNT;  // First rate not to probe
+static uint8_t limit         = RATE_COUNT;  // First rate given up on (SPLIT_LINK_MAX_FAILS)
+static uint8_t failures[RATE_COUNT];        // Consecutive failures per rate
+static uint8_t window_errors = 0;
+static uint8_t missed        = 0;
+
+static uint32_t            settle(void);
+static uint32_t            probe_step(void);
+static uint32_t            heartbeat(void);
+static uint32_t            window_end(void);
+static uint32_t            retry(void);
+static timer_wheel_timer_t settle_timer    = TIMER_WHEEL_TIMER(settle);
+static timer_wheel_timer_t probe_timer     = TIMER_WHEEL_TIMER(probe_step);
+static timer_wheel_timer_t heartbeat_timer = TIMER_WHEEL_TIMER(heartbeat);
+static timer_wheel_timer_t window_timer    = TIMER_WHEEL_TIMER(window_end);
+static timer_wheel_timer_t retry_timer     = TIMER_WHEEL_TIMER(retry);
+
+// Slave (pending is written from the split transport thread)
+static volatile uint8_t  pending     = LINK_NONE;
+static volatile uint32_t pending_at  = 0;
+static volatile uint32_t last_heard  = 0;
+static volatile bool     trial       = false;
+static uint32_t          trial_start = 0;
+
+static void set_rate(uint8_t index) {
+    static SerialConfig config = {
+        .cr1 = SERIAL_USART_CR1,
+#if defined(SERIAL_USART_PIN_SWAP)
+        .cr2 = SERIAL_USART_CR2 | USART_CR2_SWAP,
+#else
+        .cr2 = SERIAL_USART_CR2,
+#endif
+#if defined(SERIAL_USART_FULL_DUPLEX)
+        .cr3 = SERIAL_USART_CR3,
+#else
+        .cr3 = SERIAL_USART_CR3 | USART_CR3_HDSEL,
+#endif
+    };
+    config.speed = rates[index];
+    sdStop(&SERIAL_USART_DRIVER);
+    sdStart(&SERIAL_USART_DRIVER, &config);
+    chEvtGetAndClearFlags(&error_listener);  // Flags from the restart itself do not count
+    active = index;
+#ifdef CONSOLE_ENABLE
+    uprintf("SPLIT_LINK: %lu baud\n", (unsigned long)rates[index]);
+#endif
+}
+
+static bool usart_errors(void) {
+    return (chEvtGetAndClearFlags(&error_listener) & LINK_ERROR_FLAGS) != 0;
+}
+
+// ============================================
+// Slave
+// ============================================
+
+static void split_link_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    const uint8_t *in  = (const uint8_t *)in_data;
+    uint8_t       *out = (uint8_t *)out_data;
+    if (in_buflen < 2 || out_buflen < 2) {
+        return;
+    }
+
+    last_heard = timer_read32();
+    switch (in[0]) {
+        case LINK_OP_PROPOSE:
+            if (in[1] < RATE_COUNT) {
+                pending    = in[1];
+                pending_at = last_heard;
+            }
+            break;
+        case LINK_OP_ECHO:
+            for (uint8_t i = 2; i < in_buflen && i < out_buflen; i++) {
+                out[i] = ~in[i];
+            }
+            break;
+        case LINK_OP_CONFIRM:
+            if (trial && in[1] == active) {
+                committed = active;
+                trial     = false;
+            }
+            break;
+        default:
+            break;
+    }
+    out[0] = in[0] | LINK_REPLY;
+    out[1] = committed;
+}
+
+static void slave_task(void) {
+    uint8_t next = pending;
+    if (next != LINK_NONE && timer_elapsed32(pending_at) >= SPLIT_LINK_SWITCH_DELAY_MS) {
+        pending = LINK_NONE;
+        set_rate(next);
+        trial       = true;
+        trial_start = timer_read32();
+        last_heard  = trial_start;
+    } else if (trial && timer_elapsed32(trial_start) > SPLIT_LINK_TRIAL_MS) {
+        trial = false;
+        set_rate(committed);
+    } else if (!trial && active != 0 && timer_elapsed32(last_heard) > SPLIT_LINK_DEAD_MS) {
+        stats.fallbacks++;
+        committed = 0;
+        set_rate(0);
+    }
+    if (usart_errors()) {
+        stats.errors++;
+    }
+}
+
+// ============================================
+// Master
+// ============================================
+
+static bool link_exec(uint8_t op, uint8_t rate, uint8_t *reply) {
+    uint8_t frame[LINK_FRAME_LEN] = { op, rate };
+    if (op == LINK_OP_ECHO) {
+        for (uint8_t i = 2; i < sizeof(frame); i++) {
+            frame[i] = (uint8_t)(timer_read32() * 31 + i * 0x5B);  // Varying bit patterns per frame
+        }
+    }
+    if (!rpc_exec(RPC_ID_USER_SPLIT_LINK, sizeof(frame), frame, LINK_FRAME_LEN, reply)) {
+        return false;
+    }
+    bool ok = reply[0] == (op | LINK_REPLY);
+    if (ok && op == LINK_OP_ECHO) {
+        for (uint8_t i = 2; i < sizeof(frame); i++) {
+            ok = ok && (uint8_t)~reply[i] == frame[i];
+        }
+    }
+#ifdef SPLIT_HEALTH_ENABLE
+    if (!ok) {
+        split_health_bad_reply();
+    }
+#endif
+    return ok;
+}
+
+// A rate that keeps failing is not probed again until the next boot
+static void count_failure(uint8_t index) {
+    if (failures[index] < UINT8_MAX && ++failures[index] >= SPLIT_LINK_MAX_FAILS && index < limit) {
+        limit = index;
+#ifdef CONSOLE_ENABLE
+        uprintf("SPLIT_LINK: %lu baud given up after %u failures\n", (unsigned long)rates[index], failures[index]);
+#endif
+    }
+}
+
+static void run(void) {
+    phase         = LINK_RUN;
+    window_errors = 0;
+    missed        = 0;
+    timer_wheel_schedule(&heartbeat_timer, SPLIT_LINK_HEARTBEAT_MS);
+    timer_wheel_schedule(&window_timer, SPLIT_LINK_ERROR_WINDOW_MS);
+    if (ceiling < limit) {
+        timer_wheel_schedule(&retry_timer, SPLIT_LINK_RETRY_MS);
+    }
+}
+
+// PROPOSE the next rate at the committed one; the switch and echo test follow on probe_timer
+static uint32_t probe_next(void) {
+    uint8_t reply[LINK_FRAME_LEN];
+    uint8_t top = ceiling < limit ? ceiling : limit;
+    if (committed + 1 >= top) {
+        run();
+        return 0;
+    }
+    candidate = committed + 1;
+    stats.probes++;
+    if (!link_exec(LINK_OP_PROPOSE, candidate, reply)) {
+        stats.probe_fails++;
+        count_failure(candidate);
+        ceiling = candidate;
+        run();
+        return 0;
+    }
+    phase = LINK_PROBE;
+    step  = PROBE_SWITCH;
+    return SPLIT_LINK_SWITCH_DELAY_MS + 2;  // The slave switches after draining the reply
+}
+
+// One step per timer pass, so matrix scans and USB reports go on in between
+static uint32_t probe_step(void) {
+    uint8_t reply[LINK_FRAME_LEN];
+    switch (step) {
+        case PROBE_SWITCH:
+            set_rate(candidate);
+            echoes = 0;
+            step   = PROBE_ECHO;
+            return 1;
+        case PROBE_ECHO:
+            if (link_exec(LINK_OP_ECHO, candidate, reply) && !usart_errors()) {
+                if (++echoes < SPLIT_LINK_PROBE_FRAMES) {
+                    return 1;
+                }
+                if (link_exec(LINK_OP_CONFIRM, candidate, reply) && reply[1] == candidate) {
+                    committed           = candidate;
+                    failures[candidate] = 0;
+                    return probe_next();
+                }
+            }
+            // Slave reverts by itself after SPLIT_LINK_TRIAL_MS
+            stats.probe_fails++;
+            count_failure(candidate);
+            set_rate(committed);
+            step = PROBE_REVERT;
+            return SPLIT_LINK_TRIAL_MS + 10;
+        case PROBE_REVERT:
+        default:
+            ceiling = candidate;  // Stay below the rate that failed
+            run();
+            return 0;
+    }
+}
+
+static void fall_back(void) {
+    stats.fallbacks++;
+#ifdef SPLIT_HEALTH_ENABLE
+    split_health_fallback();
+#endif
+    count_failure(committed);
+    ceiling   = committed;  // Do not retry the failing rate until SPLIT_LINK_RETRY_MS
+    committed = 0;
+    set_rate(0);
+    phase = LINK_SETTLE;
+    timer_wheel_cancel(&heartbeat_timer);
+    timer_wheel_cancel(&window_timer);
+    timer_wheel_cancel(&retry_timer);
+    timer_wheel_schedule(&settle_timer, SPLIT_LINK_SETTLE_MS);
+}
+
+// Settled: probe the faster rates, then run with heartbeats
+static uint32_t settle(void) {
+    if (!is_transport_connected()) {
+        return SPLIT_LINK_SETTLE_MS;
+    }
+    uint32_t delay = probe_next();
+    if (delay != 0) {
+        timer_wheel_schedule(&probe_timer, delay);
+    }
+    return 0;
+}
+
+static uint32_t heartbeat(void) {
+    uint8_t reply[LINK_FRAME_LEN];
+    if (committed == 0) {
+        return SPLIT_LINK_HEARTBEAT_MS;
+    }
+    if (link_exec(LINK_OP_HEARTBEAT, committed, reply) && reply[1] == committed) {
+        missed = 0;
+    } else {
+        stats.errors++;
+        window_errors++;
+        missed++;
+    }
+    return SPLIT_LINK_HEARTBEAT_MS;
+}
+
+static uint32_t window_end(void) {
+    window_errors = 0;
+    return SPLIT_LINK_ERROR_WINDOW_MS;
+}
+
+// Clean long enough: try faster rates again, up to the first one given up on
+static uint32_t retry(void) {
+    ceiling = limit;
+    phase   = LINK_SETTLE;
+    timer_wheel_cancel(&heartbeat_timer);
+    timer_wheel_cancel(&window_timer);
+    timer_wheel_schedule(&settle_timer, SPLIT_LINK_SETTLE_MS);
+    return 0;
+}
+
+// Error flags arrive between heartbeats; the fallback decision is made on every scan
+static void master_task(void) {
+    if (phase != LINK_RUN) {
+        return;
+    }
+    if (usart_errors()) {
+        stats.errors++;
+        window_errors++;
+    }
+    if (committed != 0 && (window_errors >= SPLIT_LINK_MAX_ERRORS || missed >= 3)) {
+        missed = 0;
+        fall_back();
+    }
+}
+
+// ============================================
+// API
+// ============================================
+
+void split_link_init(void) {
+    chEvtRegisterMaskWithFlags(chnGetEventSource(&SERIAL_USART_DRIVER), &error_listener, EVENT_MASK(0), LINK_ERROR_FLAGS);
+    if (!is_keyboard_master()) {
+        transaction_register_rpc(RPC_ID_USER_SPLIT_LINK, split_link_slave_handler);
+        return;
+    }
+    timer_wheel_schedule(&settle_timer, SPLIT_LINK_SETTLE_MS);
+}
+
+void split_link_task(void) {
+    if (is_keyboard_master()) {
+        master_task();
+    } else {
+        slave_task();
+    }
+}
+
+uint32_t split_link_baud(void) {
+    return rates[active];
+}
+
+const split_link_stats_t *split_link_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,90 @@
+/* Split link rate negotiation
+ *
+ * Both halves boot at SERIAL_USART_SPEED, followed in the rate table by
+ * SPLIT_LINK_FAST_RATES. Once the link is up the master probes each faster rate:
+ *   PROPOSE (old rate) → both halves restart the USART at the new rate →
+ *   SPLIT_LINK_PROBE_FRAMES ECHO frames must come back intact with no
+ *   parity/framing/overrun/noise flags → CONFIRM commits the rate.
+ * A failed probe reverts both halves (the slave on its own after
+ * SPLIT_LINK_TRIAL_MS without CONFIRM) and caps negotiation below that rate.
+ * The probe runs as timer_wheel.h steps (switch, one ECHO per pass, the
+ * trial wait), so the master keeps scanning and reporting throughout.
+ *
+ * While running, the master sends a heartbeat every SPLIT_LINK_HEARTBEAT_MS.
+ * Too many errors in a window (or missed heartbeats) drop both halves back to
+ * SERIAL_USART_SPEED: the master switches at once, the slave after
+ * SPLIT_LINK_DEAD_MS without a heartbeat. Negotiation then restarts below the
+ * failed rate; the cap is lifted after SPLIT_LINK_RETRY_MS of clean running.
+ * A rate that fails SPLIT_LINK_MAX_FAILS times in a row (probes and
+ * fallbacks) is given up on until the next boot.
+ *
+ * The USART is restarted in place (sdStop/sdStart) under QMK's split
+ * transport, so matrix and RPC transactions keep using the same driver.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SPLIT_LINK_FAST_RATES
+#    define SPLIT_LINK_FAST_RATES 921600, 1500000, 2000000  // Ascending, all above SERIAL_USART_SPEED
+#endif
+
+#ifndef SPLIT_LINK_PROBE_FRAMES
+#    define SPLIT_LINK_PROBE_FRAMES 32
+#endif
+
+#ifndef SPLIT_LINK_SETTLE_MS
+#    define SPLIT_LINK_SETTLE_MS 1000  // Link up (or fallback) → next probe
+#endif
+
+#ifndef SPLIT_LINK_SWITCH_DELAY_MS
+#    define SPLIT_LINK_SWITCH_DELAY_MS 3  // PROPOSE reply drained before the slave restarts its USART
+#endif
+
+#ifndef SPLIT_LINK_TRIAL_MS
+#    define SPLIT_LINK_TRIAL_MS 250  // Slave reverts a proposed rate without CONFIRM
+#endif
+
+#ifndef SPLIT_LINK_HEARTBEAT_MS
+#    define SPLIT_LINK_HEARTBEAT_MS 100
+#endif
+
+#ifndef SPLIT_LINK_DEAD_MS
+#    define SPLIT_LINK_DEAD_MS 400  // Slave falls back without a heartbeat
+#endif
+
+#ifndef SPLIT_LINK_ERROR_WINDOW_MS
+#    define SPLIT_LINK_ERROR_WINDOW_MS 1000
+#endif
+
+#ifndef SPLIT_LINK_MAX_ERRORS
+#    define SPLIT_LINK_MAX_ERRORS 4  // Errors per window before falling back
+#endif
+
+#ifndef SPLIT_LINK_RETRY_MS
+#    define SPLIT_LINK_RETRY_MS 60000  // Clean running before a failed rate is tried again
+#endif
+
+#ifndef SPLIT_LINK_MAX_FAILS
+#    define SPLIT_LINK_MAX_FAILS 3  // Consecutive failures before a rate is no longer probed
+#endif
+
+typedef struct {
+    uint32_t probes;       // Rates tried
+    uint32_t probe_fails;  // Rates rejected by the echo test
+    uint32_t fallbacks;    // Drops back to SERIAL_USART_SPEED while running
+    uint32_t errors;       // USART error flags plus failed link frames
+} split_link_stats_t;
+
+// Register the RPC handler and error listener (call from keyboard_post_init_user, both halves)
+void split_link_init(void);
+
+// Error counting and fallback (call every scan from housekeeping_task_user, both halves);
+// master negotiation and heartbeats run on timer_wheel.h, the slave's timestamps are set by the RPC handler
+void split_link_task(void);
+
+// Current USART rate in baud
+uint32_t split_link_baud(void);
+
+const split_link_stats_t *split_link_stats(void);
@@ -0,0 +1,232 @@
+/* Batched split sync - see split_sync.h for the frame format
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "transactions.h"
+#include "split_sync.h"
+#include "timer_wheel.h"
+
+#ifdef SPLIT_HEALTH_ENABLE
+#    include "split_health.h"
+#    define rpc_exec split_health_exec
+#else
+#    define rpc_exec transaction_rpc_exec
+#endif
+
+#define ITEM_HEADER_SIZE 3  // id, version, len
+
+#ifndef SPLIT_SYNC_SHADOW_SIZE
+#    define SPLIT_SYNC_SHADOW_SIZE 64  // Last-sent copies of all items (master)
+#endif
+
+typedef struct {
+    void *data;
+    void (*apply)(void);
+    uint8_t size;
+    uint8_t shadow;   // Offset of the last-sent copy in shadow_pool
+    uint8_t version;  // Master: current version (0 = unregistered); slave: last applied
+    uint8_t acked;    // Master: version the slave reported
+} item_t;
+
+static item_t                  items[SPLIT_SYNC_MAX_ITEMS];
+static split_sync_item_stats_t item_stats[SPLIT_SYNC_MAX_ITEMS];
+static split_sync_stats_t      stats;
+static uint8_t                 shadow_pool[SPLIT_SYNC_SHADOW_SIZE];
+static uint8_t                 shadow_used = 0;
+static uint8_t                 next_item   = 0;  // Round-robin start when the frame overflows
+static uint8_t                 seq         = 0;
+static uint32_t                last_frame  = 0;
+static uint8_t                 led_state   = 0;
+
+static void next_version(item_t *item) {
+    if (++item->version == 0) {
+        item->version = 1;  // 0 means "never received" on the slave
+    }
+}
+
+// ============================================
+// Slave: apply items, acknowledge all versions at once
+// ============================================
+
+static void split_sync_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    const uint8_t *in  = (const uint8_t *)in_data;
+    uint8_t       *out = (uint8_t *)out_data;
+    if (in_buflen < 2 || out_buflen < 1 + SPLIT_SYNC_MAX_ITEMS) {
+        return;
+    }
+
+    uint8_t pos = 2;
+    for (uint8_t n = in[1]; n > 0 && pos + ITEM_HEADER_SIZE <= in_buflen; n--) {
+        uint8_t id = in[pos], version = in[pos + 1], len = in[pos + 2];
+        if (pos + ITEM_HEADER_SIZE + len > in_buflen) {
+            break;
+        }
+        if (id < SPLIT_SYNC_MAX_ITEMS && items[id].data && items[id].size == len && items[id].version != version) {
+            memcpy(items[id].data, in + pos + ITEM_HEADER_SIZE, len);
+            items[id].version = version;
+            if (items[id].apply) {
+                items[id].apply();
+            }
+        }
+        pos += ITEM_HEADER_SIZE + len;
+    }
+
+    out[0] = in[0];
+    for (uint8_t i = 0; i < SPLIT_SYNC_MAX_ITEMS; i++) {
+        out[1 + i] = items[i].version;
+    }
+}
+
+static void apply_led_state(void) {
+    set_split_host_keyboard_leds(led_state);
+}
+
+// ============================================
+// Registration
+// ============================================
+
+bool split_sync_register(uint8_t id, void *data, uint8_t size, void (*apply)(void)) {
+    if (id >= SPLIT_SYNC_MAX_ITEMS || items[id].data || size == 0 || shadow_used + size > SPLIT_SYNC_SHADOW_SIZE ||
+        2 + ITEM_HEADER_SIZE + size > RPC_M2S_BUFFER_SIZE) {
+        return false;
+    }
+    item_t *item = &items[id];
+    item->data   = data;
+    item->apply  = apply;
+    item->size   = size;
+    item->shadow = shadow_used;
+    shadow_used += size;
+    if (is_keyboard_master()) {
+        // Version 1 with a zeroed ack: the first scan sends the initial value
+        memcpy(&shadow_pool[item->shadow], data, size);
+        item->version = 1;
+        item->acked   = 0;
+    }
+    return true;
+}
+
+#ifdef CONSOLE_ENABLE
+static uint32_t report_stats(void) {
+    split_sync_print_stats();
+    return SPLIT_SYNC_STATS_INTERVAL;
+}
+
+static timer_wheel_timer_t report_timer = TIMER_WHEEL_TIMER(report_stats);
+#endif
+
+void split_sync_init(void) {
+    split_sync_register(SPLIT_SYNC_LAYER_STATE, &layer_state, sizeof(layer_state), NULL);
+    split_sync_register(SPLIT_SYNC_DEFAULT_LAYER, &default_layer_state, sizeof(default_layer_state), NULL);
+    split_sync_register(SPLIT_SYNC_LED_STATE, &led_state, sizeof(led_state), apply_led_state);
+    if (!is_keyboard_master()) {
+        transaction_register_rpc(RPC_ID_USER_SPLIT_SYNC, split_sync_slave_handler);
+        return;
+    }
+#ifdef CONSOLE_ENABLE
+    timer_wheel_schedule(&report_timer, SPLIT_SYNC_STATS_INTERVAL);
+#endif
+}
+
+void split_sync_mark_dirty(uint8_t id) {
+    if (id < SPLIT_SYNC_MAX_ITEMS && items[id].data && is_keyboard_master()) {
+        next_version(&items[id]);
+        item_stats[id].changes++;
+    }
+}
+
+// ============================================
+// Master: one frame per scan
+// ============================================
+
+void split_sync_task(void) {
+    if (!is_keyboard_master()) {
+        return;
+    }
+    led_state = host_keyboard_leds();
+
+    // Version bump for every item whose bytes changed since they were last queued
+    for (uint8_t i = 0; i < SPLIT_SYNC_MAX_ITEMS; i++) {
+        item_t *item = &items[i];
+        if (item->data && memcmp(&shadow_pool[item->shadow], item->data, item->size) != 0) {
+            memcpy(&shadow_pool[item->shadow], item->data, item->size);
+            next_version(item);
+            item_stats[i].changes++;
+        }
+    }
+
+    uint8_t frame[RPC_M2S_BUFFER_SIZE];
+    uint8_t pos   = 2;
+    uint8_t count = 0;
+    uint8_t sent[SPLIT_SYNC_MAX_ITEMS];
+    for (uint8_t n = 0; n < SPLIT_SYNC_MAX_ITEMS; n++) {
+        uint8_t id   = (next_item + n) % SPLIT_SYNC_MAX_ITEMS;
+        item_t *item = &items[id];
+        if (!item->data || item->version == item->acked) {
+            continue;
+        }
+        if (pos + ITEM_HEADER_SIZE + item->size > RPC_M2S_BUFFER_SIZE) {
+            stats.deferred++;
+            continue;
+        }
+        frame[pos]     = id;
+        frame[pos + 1] = item->version;
+        frame[pos + 2] = item->size;
+        memcpy(&frame[pos + ITEM_HEADER_SIZE], &shadow_pool[item->shadow], item->size);
+        pos += ITEM_HEADER_SIZE + item->size;
+        sent[count++] = id;
+    }
+
+    if (count == 0 && timer_elapsed32(last_frame) < SPLIT_SYNC_RESYNC_MS) {
+        return;
+    }
+    frame[0]   = ++seq;
+    frame[1]   = count;
+    next_item  = (next_item + 1) % SPLIT_SYNC_MAX_ITEMS;
+    last_frame = timer_read32();
+
+    uint8_t reply[1 + SPLIT_SYNC_MAX_ITEMS];
+    stats.frames++;
+    stats.bytes += pos;
+    for (uint8_t n = 0; n < count; n++) {
+        item_stats[sent[n]].transactions++;
+        item_stats[sent[n]].bytes += ITEM_HEADER_SIZE + items[sent[n]].size;
+    }
+    if (!rpc_exec(RPC_ID_USER_SPLIT_SYNC, pos, frame, sizeof(reply), reply) || reply[0] != frame[0]) {
+        stats.failed++;
+#ifdef SPLIT_HEALTH_ENABLE
+        split_health_retry(count);
+#endif
+        return;  // Items stay dirty and go out with the next frame
+    }
+    for (uint8_t i = 0; i < SPLIT_SYNC_MAX_ITEMS; i++) {
+        items[i].acked = reply[1 + i];
+    }
+}
+
+// ============================================
+// Stats
+// ============================================
+
+const split_sync_stats_t *split_sync_stats(void) {
+    return &stats;
+}
+
+const split_sync_item_stats_t *split_sync_item_stats(uint8_t id) {
+    return id < SPLIT_SYNC_MAX_ITEMS ? &item_stats[id] : NULL;
+}
+
+void split_sync_print_stats(void) {
+#ifdef CONSOLE_ENABLE
+    uprintf("SPLIT_SYNC: frames=%lu failed=%lu bytes=%lu deferred=%lu\n", (unsigned long)stats.frames, (unsigned long)stats.failed, (unsigned long)stats.bytes, (unsigned long)stats.deferred);
+    for (uint8_t i = 0; i < SPLIT_SYNC_MAX_ITEMS; i++) {
+        if (items[i].data) {
+            uprintf("SPLIT_SYNC:   item %u v%u changes=%lu tx=%lu bytes=%lu\n", i, items[i].version, (unsigned long)item_stats[i].changes, (unsigned long)item_stats[i].transactions, (unsigned long)item_stats[i].bytes);
+        }
+    }
+#endif
+}
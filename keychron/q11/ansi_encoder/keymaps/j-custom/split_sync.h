@@ -0,0 +1,74 @@
+/* Batched split sync (one RPC frame per scan)
+ *
+ * Master-to-slave state (layer state, default layer, host LEDs and any user
+ * item) is gathered into a single SPLIT_TRANSACTION_IDS_USER frame instead of
+ * one USART transaction per item. Each item carries a version counter that is
+ * bumped when its bytes change; only changed items are sent.
+ *
+ * Frame (master → slave):  [0] seq  [1] count  then per item: id, version, len, payload
+ * Reply (slave → master):  [0] seq  [1..SPLIT_SYNC_MAX_ITEMS] version of every item held
+ *
+ * The reply acknowledges all items at once: an item stays dirty until the
+ * slave reports its version, so a failed or truncated frame is simply resent
+ * on the next scan. With nothing dirty an empty frame is sent every
+ * SPLIT_SYNC_RESYNC_MS so a slave that restarted is detected and refilled.
+ *
+ * RGB matrix config/timer keep using QMK's own transaction: RGB_MATRIX_SPLIT
+ * also defines the LED split and cannot be dropped from the keymap.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SPLIT_SYNC_MAX_ITEMS
+#    define SPLIT_SYNC_MAX_ITEMS 8
+#endif
+
+#ifndef SPLIT_SYNC_RESYNC_MS
+#    define SPLIT_SYNC_RESYNC_MS 500
+#endif
+
+#ifndef SPLIT_SYNC_STATS_INTERVAL
+#    define SPLIT_SYNC_STATS_INTERVAL 10000  // ms between console stats reports (CONSOLE_ENABLE)
+#endif
+
+// Built-in items; user items use SPLIT_SYNC_USER and up
+enum split_sync_item {
+    SPLIT_SYNC_LAYER_STATE = 0,
+    SPLIT_SYNC_DEFAULT_LAYER,
+    SPLIT_SYNC_LED_STATE,
+    SPLIT_SYNC_USER,
+};
+
+typedef struct {
+    uint32_t changes;       // Version bumps on the master
+    uint32_t transactions;  // Frames that carried the item
+    uint32_t bytes;         // Header + payload bytes sent for the item
+} split_sync_item_stats_t;
+
+typedef struct {
+    uint32_t frames;        // RPC frames sent (including resync frames)
+    uint32_t failed;        // Frames that got no reply
+    uint32_t bytes;         // Total frame bytes sent
+    uint32_t deferred;      // Times a dirty item did not fit and waited a scan
+} split_sync_stats_t;
+
+// Register the RPC handler and built-in items (call from keyboard_post_init_user, both halves)
+void split_sync_init(void);
+
+// Add a user item. data is read on the master and written on the slave, then
+// apply (optional) runs on the slave. Returns false if id or size is invalid.
+bool split_sync_register(uint8_t id, void *data, uint8_t size, void (*apply)(void));
+
+// Send dirty items (call every scan from housekeeping_task_user; no-op on the slave)
+void split_sync_task(void);
+
+// Force an item to be resent even if its bytes did not change
+void split_sync_mark_dirty(uint8_t id);
+
+const split_sync_stats_t      *split_sync_stats(void);
+const split_sync_item_stats_t *split_sync_item_stats(uint8_t id);
+
+// Print per-item counts to the console
+void split_sync_print_stats(void);
@@ -0,0 +1,302 @@
+/* Tap tune: per-key tapping terms - see tap_tune.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include <string.h>
+#include QMK_KEYBOARD_H
+#include "tap_tune.h"
+#include "timer_wheel.h"
+
+#define STORE_MAGIC 0x54545431  // "TTT1"
+#define ONE         256         // 1.0 in a histogram bin (u8.8)
+#define LAST_BIN    (TAP_TUNE_BINS - 1)
+#define GUARD_BINS  (TAP_TUNE_GUARD_MS / TAP_TUNE_BIN_MS)
+
+// Steady state of a bin that takes every sample: ONE << TAP_TUNE_DECAY_SHIFT, plus rounding
+_Static_assert((ONE << TAP_TUNE_DECAY_SHIFT) + ONE <= UINT16_MAX, "TAP_TUNE_DECAY_SHIFT too large for u16 bins");
+_Static_assert(TAP_TUNE_MIN_MS >= TAP_TUNE_GUARD_MS, "TAP_TUNE_MIN_MS must leave room for the band below it");
+
+typedef struct {
+    uint16_t tap[TAP_TUNE_BINS];
+    uint16_t hold[TAP_TUNE_BINS];
+    uint16_t gap[TAP_TUNE_BINS];
+} histograms_t;
+
+typedef struct {
+    uint32_t         pressed_at;
+    uint32_t         released_at;
+    bool             down;
+    bool             solo;    // No other key pressed since this press
+    bool             tapped;  // Last press was a tap, no other key pressed since
+    uint8_t          pending;  // Gaps since the last retune
+    tap_tune_stats_t stats;
+    histograms_t     hist;
+} slot_t;
+
+typedef struct {
+    uint16_t keycode;
+    uint16_t term;
+} saved_term_t;
+
+// Saved as-is in the EEPROM user datablock, after key_stats' region
+typedef struct {
+    uint32_t     magic;
+    saved_term_t terms[TAP_TUNE_KEYS];
+} store_t;
+
+_Static_assert(sizeof(store_t) <= TAP_TUNE_DATA_SIZE, "TAP_TUNE_DATA_SIZE too small for tap_tune (see config.h)");
+
+static const tap_tune_key_t *keys  = NULL;
+static uint8_t               count = 0;
+static slot_t                slots[TAP_TUNE_KEYS];
+static store_t               store;
+static bool                  dirty = false;
+
+// EEPROM save, rate limited (timer_wheel.h)
+static uint32_t            save_tick(void);
+static timer_wheel_timer_t save_timer = TIMER_WHEEL_TIMER(save_tick);
+
+static slot_t *find(uint16_t keycode) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (keys[i].keycode == keycode) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+// ============================================
+// Histograms
+// ============================================
+
+// Age every bin by 1/2^TAP_TUNE_DECAY_SHIFT (rounded), then add one sample
+static void add(uint16_t *hist, uint32_t ms) {
+    uint8_t bin = ms >= (uint32_t)LAST_BIN * TAP_TUNE_BIN_MS ? LAST_BIN : ms / TAP_TUNE_BIN_MS;
+    for (uint8_t i = 0; i < TAP_TUNE_BINS; i++) {
+        hist[i] -= (hist[i] + (1U << (TAP_TUNE_DECAY_SHIFT - 1))) >> TAP_TUNE_DECAY_SHIFT;
+    }
+    hist[bin] += ONE;
+}
+
+static uint32_t sum(const uint16_t *hist, uint8_t first, uint8_t end) {
+    uint32_t total = 0;
+    for (uint8_t i = first; i < end; i++) {
+        total += hist[i];
+    }
+    return total;
+}
+
+// Upper edge of the bin where percent of the weight is reached (0 when empty)
+static uint16_t percentile(const uint16_t *hist, uint8_t percent) {
+    uint32_t total = sum(hist, 0, TAP_TUNE_BINS);
+    uint32_t want  = (total * percent + 99) / 100;
+    uint32_t seen  = 0;
+    if (total == 0) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < TAP_TUNE_BINS; i++) {
+        seen += hist[i];
+        if (seen >= want) {
+            return (i + 1) * TAP_TUNE_BIN_MS;
+        }
+    }
+    return TAP_TUNE_BINS * TAP_TUNE_BIN_MS;
+}
+
+// ============================================
+// Tuning
+// ============================================
+
+// Shortest safe term for the slot's gaps, 0 when there is none yet (see tap_tune.h)
+static uint16_t target(const slot_t *slot, tap_tune_from_t from) {
+    const uint16_t *gap      = slot->hist.gap;
+    uint32_t        in_range = sum(gap, 0, LAST_BIN);
+    uint8_t         first    = (TAP_TUNE_MIN_MS + TAP_TUNE_BIN_MS - 1) / TAP_TUNE_BIN_MS;
+    if (slot->stats.gaps < TAP_TUNE_MIN_SAMPLES || in_range == 0) {
+        return 0;
+    }
+    if (from == TAP_TUNE_FROM_PRESS) {
+        uint16_t floor_ms = percentile(slot->hist.tap, 98) + TAP_TUNE_GUARD_MS;
+        uint8_t  floor    = (floor_ms + TAP_TUNE_BIN_MS - 1) / TAP_TUNE_BIN_MS;
+        first             = floor > first ? floor : first;
+    }
+    uint32_t below = sum(gap, 0, first);
+    for (uint8_t edge = first; edge <= TAP_TUNE_MAX_MS / TAP_TUNE_BIN_MS; edge++) {
+        if (below * TAP_TUNE_CLUSTER >= in_range && sum(gap, edge - GUARD_BINS, edge + GUARD_BINS) * TAP_TUNE_VALLEY <= in_range) {
+            return edge * TAP_TUNE_BIN_MS;
+        }
+        below += gap[edge];
+    }
+    return 0;
+}
+
+// One step toward the target
+static void retune(uint8_t index) {
+    slot_t  *slot = &slots[index];
+    uint16_t want = target(slot, keys[index].from);
+    uint16_t term = slot->stats.term;
+    if (want == 0 || want == term) {
+        return;
+    }
+    if (want > term) {
+        term = want - term > TAP_TUNE_STEP_MS ? term + TAP_TUNE_STEP_MS : want;
+    } else {
+        term = term - want > TAP_TUNE_STEP_MS ? term - TAP_TUNE_STEP_MS : want;
+    }
+#ifdef CONSOLE_ENABLE
+    uprintf("TAP_TUNE: %04X term %u -> %u ms (target %u, %u gaps)\n", keys[index].keycode, slot->stats.term, term, want, slot->stats.gaps);
+#endif
+    slot->stats.term = term;
+    dirty            = true;
+}
+
+// ============================================
+// Events
+// ============================================
+
+static void bump(uint16_t *counter) {
+    if (*counter < UINT16_MAX) {
+        (*counter)++;
+    }
+}
+
+static void on_press(uint8_t index, uint32_t now) {
+    slot_t *slot = &slots[index];
+    if (slot->tapped && !slot->down) {
+        uint32_t gap = now - (keys[index].from == TAP_TUNE_FROM_PRESS ? slot->pressed_at : slot->released_at);
+        add(slot->hist.gap, gap);
+        if (gap < (uint32_t)LAST_BIN * TAP_TUNE_BIN_MS) {
+            bump(&slot->stats.gaps);
+        }
+        if (++slot->pending >= TAP_TUNE_RETUNE) {
+            slot->pending = 0;
+            retune(index);
+        }
+    }
+    slot->pressed_at = now;
+    slot->down       = true;
+    slot->solo       = true;
+}
+
+static void on_release(slot_t *slot, uint32_t now) {
+    if (!slot->down) {
+        return;
+    }
+    uint32_t held = now - slot->pressed_at;
+    if (slot->solo) {
+        add(slot->hist.tap, held);
+        bump(&slot->stats.taps);
+    } else {
+        add(slot->hist.hold, held);
+        bump(&slot->stats.holds);
+    }
+    slot->tapped      = slot->solo;
+    slot->released_at = now;
+    slot->down        = false;
+}
+
+void tap_tune_record(uint16_t keycode, keyrecord_t *record) {
+    if (!is_keyboard_master() || IS_NOEVENT(record->event)) {
+        return;
+    }
+    uint32_t now  = timer_read32();  // As QMK's tap dance timer: when the event is processed
+    slot_t  *slot = find(keycode);
+#ifdef TAP_TUNE_TRACE
+    if (slot || record->event.pressed) {
+        uprintf("TT %lu %d %u\n", (unsigned long)now, slot ? (int)(slot - slots) : -1, record->event.pressed);
+    }
+#endif
+    if (record->event.pressed) {
+        // Any other key breaks taps in progress and a double tap to come
+        for (uint8_t i = 0; i < count; i++) {
+            if (&slots[i] != slot) {
+                slots[i].solo   = false;
+                slots[i].tapped = false;
+            }
+        }
+        if (slot) {
+            on_press(slot - slots, now);
+        }
+    } else if (slot) {
+        on_release(slot, now);
+    }
+}
+
+uint16_t tap_tune_term(uint16_t keycode) {
+    slot_t *slot = find(keycode);
+    return slot ? slot->stats.term : TAPPING_TERM;
+}
+
+bool tap_tune_tapped(uint16_t keycode) {
+    slot_t *slot = find(keycode);
+    return slot && slot->tapped;
+}
+
+const tap_tune_stats_t *tap_tune_stats(uint8_t index) {
+    if (index >= count) {
+        return NULL;
+    }
+    slot_t *slot         = &slots[index];
+    slot->stats.tap_p50  = percentile(slot->hist.tap, 50);
+    slot->stats.tap_p98  = percentile(slot->hist.tap, 98);
+    slot->stats.hold_p50 = percentile(slot->hist.hold, 50);
+    slot->stats.gap_p50  = percentile(slot->hist.gap, 50);
+    slot->stats.gap_p98  = percentile(slot->hist.gap, 98);
+    return &slot->stats;
+}
+
+// ============================================
+// EEPROM
+// ============================================
+
+static void reset_store(void) {
+    memset(&store, 0, sizeof(store));
+    store.magic = STORE_MAGIC;
+}
+
+static void save(void) {
+    reset_store();
+    for (uint8_t i = 0; i < count; i++) {
+        store.terms[i] = (saved_term_t){ keys[i].keycode, slots[i].stats.term };
+    }
+    eeconfig_update_user_datablock(&store, KEY_STATS_DATA_SIZE, sizeof(store));
+    dirty = false;
+}
+
+static uint32_t save_tick(void) {
+    if (dirty) {
+        save();
+    }
+    return TAP_TUNE_SAVE_MS;
+}
+
+void tap_tune_eeconfig_init(void) {
+    reset_store();
+    eeconfig_update_user_datablock(&store, KEY_STATS_DATA_SIZE, sizeof(store));
+}
+
+void tap_tune_init(const tap_tune_key_t *table, uint8_t size) {
+    keys  = table;
+    count = size < TAP_TUNE_KEYS ? size : TAP_TUNE_KEYS;
+    memset(slots, 0, sizeof(slots));
+    eeconfig_read_user_datablock(&store, KEY_STATS_DATA_SIZE, sizeof(store));
+    if (store.magic != STORE_MAGIC) {
+        reset_store();
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        slots[i].stats.term = TAPPING_TERM;
+        for (uint8_t j = 0; j < TAP_TUNE_KEYS; j++) {
+            uint16_t term = store.terms[j].term;
+            if (store.terms[j].keycode == keys[i].keycode && term >= TAP_TUNE_MIN_MS && term <= TAP_TUNE_MAX_MS) {
+                slots[i].stats.term = term;
+                break;
+            }
+        }
+    }
+    if (is_keyboard_master()) {
+        timer_wheel_schedule(&save_timer, TAP_TUNE_SAVE_MS);
+    }
+}
@@ -0,0 +1,136 @@
+/* Tap tune: per-key tapping terms learned from press timing
+ *
+ * TAPPING_TERM is one value for keys pressed by different fingers at very
+ * different speeds: a thumb double-taps Cmd in ~100 ms, a stiff encoder click
+ * may need more than 200. For each key of the table given to tap_tune_init()
+ * (keymap.c: the Spotlight key and the tap dances) the master half learns:
+ *   - tap:  how long the key is down when pressed alone
+ *   - hold: how long it is down when another key was pressed meanwhile
+ *           (Cmd used as a modifier); such a press never starts a double tap
+ *   - gap:  from a tap to the next press of the same key, timed as the key's
+ *           term is: from the tap's press (TAP_TUNE_FROM_PRESS, QMK's tap
+ *           dance timer) or from its release (TAP_TUNE_FROM_RELEASE)
+ * each a histogram of TAP_TUNE_BINS bins of TAP_TUNE_BIN_MS (the last bin
+ * takes everything longer). Bins are u8.8 fixed point: a sample adds 1.0 and
+ * first takes 1/2^TAP_TUNE_DECAY_SHIFT off every bin, so a histogram weighs
+ * about the last 2^TAP_TUNE_DECAY_SHIFT samples and follows a changing habit.
+ *
+ * Every TAP_TUNE_RETUNE gaps, the key's term moves one TAP_TUNE_STEP_MS
+ * toward the shortest safe term: the smallest bin edge in
+ * [TAP_TUNE_MIN_MS, TAP_TUNE_MAX_MS] with at least 1/TAP_TUNE_CLUSTER of the
+ * gaps below it (the double taps, quicker than separate taps) and at most
+ * 1/TAP_TUNE_VALLEY of them within TAP_TUNE_GUARD_MS either side (the valley
+ * after them). TAP_TUNE_FROM_PRESS
+ * terms also stay TAP_TUNE_GUARD_MS over the longest taps (98th percentile):
+ * a dance that times out while its key is still down cannot become a double.
+ * Nothing moves before TAP_TUNE_MIN_SAMPLES gaps, or when no edge qualifies.
+ *
+ * The terms (not the histograms) are saved to the EEPROM user datablock after
+ * key_stats' region, at most every TAP_TUNE_SAVE_MS and only when one changed;
+ * a saved term is matched to its key by keycode, so the table can be edited.
+ *
+ * Console (CONSOLE_ENABLE): each term change. With TAP_TUNE_TRACE defined,
+ * also "TT <ms> <key> <pressed>" for each press and release of a table key
+ * (key: its table index) and each press of any other key (key -1), a
+ * recording for the host simulation:
+ * node scripts/tap-tune/tap-tune.js --trace <console log>
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef TAP_TUNE_KEYS
+#    define TAP_TUNE_KEYS 8  // Table entries, and saved terms
+#endif
+
+#ifndef TAP_TUNE_BINS
+#    define TAP_TUNE_BINS 32
+#endif
+
+#ifndef TAP_TUNE_BIN_MS
+#    define TAP_TUNE_BIN_MS 10  // 0-310 ms in range, the last bin is "longer"
+#endif
+
+#ifndef TAP_TUNE_DECAY_SHIFT
+#    define TAP_TUNE_DECAY_SHIFT 6  // Histograms weigh the last ~64 samples
+#endif
+
+#ifndef TAP_TUNE_MIN_MS
+#    define TAP_TUNE_MIN_MS 100
+#endif
+
+#ifndef TAP_TUNE_MAX_MS
+#    define TAP_TUNE_MAX_MS 280
+#endif
+
+#ifndef TAP_TUNE_GUARD_MS
+#    define TAP_TUNE_GUARD_MS 20  // Clear band either side of a term
+#endif
+
+#ifndef TAP_TUNE_CLUSTER
+#    define TAP_TUNE_CLUSTER 8  // At least 1/8 of the gaps below a term
+#endif
+
+#ifndef TAP_TUNE_VALLEY
+#    define TAP_TUNE_VALLEY 16  // At most 1/16 of the gaps in the band
+#endif
+
+#ifndef TAP_TUNE_STEP_MS
+#    define TAP_TUNE_STEP_MS 10  // Largest term change per retune
+#endif
+
+#ifndef TAP_TUNE_RETUNE
+#    define TAP_TUNE_RETUNE 8  // Gaps between retunes
+#endif
+
+#ifndef TAP_TUNE_MIN_SAMPLES
+#    define TAP_TUNE_MIN_SAMPLES 16  // Gaps in range before the first retune
+#endif
+
+#ifndef TAP_TUNE_SAVE_MS
+#    define TAP_TUNE_SAVE_MS 3600000  // 1 h between EEPROM saves (only when a term changed)
+#endif
+
+_Static_assert((TAP_TUNE_MAX_MS + TAP_TUNE_GUARD_MS) / TAP_TUNE_BIN_MS < TAP_TUNE_BINS, "TAP_TUNE_MAX_MS band must end before the last bin");
+
+// What a key's term is timed from
+typedef enum {
+    TAP_TUNE_FROM_PRESS,    // Tap dances: QMK times the dance from the last press
+    TAP_TUNE_FROM_RELEASE,  // Double tap checked against the previous release
+} tap_tune_from_t;
+
+typedef struct {
+    uint16_t        keycode;
+    tap_tune_from_t from;
+} tap_tune_key_t;
+
+typedef struct {
+    uint16_t term;     // ms, in use
+    uint16_t taps;     // Presses with no other key, since boot (saturating)
+    uint16_t holds;    // Presses with another key meanwhile
+    uint16_t gaps;     // Gaps within range (double tap candidates)
+    uint16_t tap_p50;  // ms, from the histograms
+    uint16_t tap_p98;
+    uint16_t hold_p50;
+    uint16_t gap_p50;
+    uint16_t gap_p98;
+} tap_tune_stats_t;
+
+// Load the saved terms (call from keyboard_post_init_user); the table stays in use
+void tap_tune_init(const tap_tune_key_t *keys, uint8_t count);
+
+// Drop the saved terms (call from eeconfig_init_user)
+void tap_tune_eeconfig_init(void);
+
+// Time a key event (call in process_record_user, before it can return)
+void tap_tune_record(uint16_t keycode, keyrecord_t *record);
+
+// Term of a keycode: tuned for table keys, TAPPING_TERM for the others
+uint16_t tap_tune_term(uint16_t keycode);
+
+// The keycode's last press was a tap (no other key pressed meanwhile)
+bool tap_tune_tapped(uint16_t keycode);
+
+// Learned state of a table entry (NULL past the table)
+const tap_tune_stats_t *tap_tune_stats(uint8_t index);
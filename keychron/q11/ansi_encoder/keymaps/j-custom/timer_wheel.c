@@ -0,0 +1,185 @@
+/* Timer wheel - see timer_wheel.h
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#include QMK_KEYBOARD_H
+#include "timer_wheel.h"
+
+#define SLOTS     (1U << TIMER_WHEEL_BITS)
+#define SLOT_MASK (SLOTS - 1)
+#define SPAN(l)   (1UL << (TIMER_WHEEL_BITS * (l)))  // Ticks covered by one slot of level l
+#define ALL_SLOTS ((uint32_t)((1ULL << SLOTS) - 1))
+
+_Static_assert(TIMER_WHEEL_BITS <= 5, "occupied slot bitmaps are uint32_t");
+_Static_assert(TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS < 32, "wheel range must fit the 32-bit clock");
+
+static timer_wheel_timer_t *slots[TIMER_WHEEL_LEVELS][SLOTS];
+static uint32_t             occupied[TIMER_WHEEL_LEVELS];
+static uint16_t             scheduled = 0;
+
+// Next tick to process: every timer due before it has run
+static uint32_t tick = 0;
+
+// Timers of the slot being run (callbacks may cancel them)
+static timer_wheel_timer_t *expiring = NULL;
+
+// ============================================
+// Lists
+// ============================================
+
+static void list_add(timer_wheel_timer_t **head, timer_wheel_timer_t *timer) {
+    timer->next = *head;
+    if (*head) {
+        (*head)->pprev = &timer->next;
+    }
+    *head        = timer;
+    timer->pprev = head;
+}
+
+static void list_remove(timer_wheel_timer_t *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next  = NULL;
+    timer->pprev = NULL;
+}
+
+// Slot for the timer's due tick, relative to the next tick to process
+static void place(timer_wheel_timer_t *timer) {
+    int32_t  delta = (int32_t)(timer->due - tick);
+    uint8_t  level = 0;
+    uint32_t at    = timer->due;
+    if (delta < 0) {
+        at = tick;  // Overdue: run on the next tick
+    } else {
+        while (level < TIMER_WHEEL_LEVELS - 1 && (uint32_t)delta >= SPAN(level + 1)) {
+            level++;
+        }
+        if ((uint32_t)delta >= SPAN(TIMER_WHEEL_LEVELS)) {
+            at = tick + SPAN(TIMER_WHEEL_LEVELS) - 1;  // Beyond the wheel: farthest slot, re-filed from there
+        }
+    }
+    uint8_t slot = (at >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK;
+    list_add(&slots[level][slot], timer);
+    occupied[level] |= 1UL << slot;
+}
+
+// Move the timers of an upper-level slot down as its range begins
+static void cascade(uint8_t level) {
+    uint8_t slot = (tick >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK;
+    if (!(occupied[level] & (1UL << slot))) {
+        return;
+    }
+    timer_wheel_timer_t *list = slots[level][slot];
+    slots[level][slot]        = NULL;
+    occupied[level] &= ~(1UL << slot);
+    while (list) {
+        timer_wheel_timer_t *timer = list;
+        list                       = timer->next;
+        place(timer);
+    }
+}
+
+// Occupied slots of a level, rotated so that bit 0 is slot `from`
+static uint32_t from_slot(uint32_t bits, uint8_t from) {
+    if (from) {
+        bits = (bits >> from) | (bits << (SLOTS - from));
+    }
+    return bits & ALL_SLOTS;
+}
+
+// Ticks from `tick` to the next one with work: a level-0 slot to run or an
+// occupied upper slot to move down. UINT32_MAX when the wheel is empty.
+static uint32_t idle_ticks(void) {
+    uint32_t idle = UINT32_MAX;
+    uint32_t bits = from_slot(occupied[0], tick & SLOT_MASK);
+    if (bits) {
+        idle = __builtin_ctz(bits);
+    }
+    for (uint8_t level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        uint32_t span = SPAN(level);
+        uint32_t edge = (span - (tick & (span - 1))) & (span - 1);  // 0 on a slot boundary
+        bits          = from_slot(occupied[level], ((tick + edge) >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK);
+        if (bits && edge + __builtin_ctz(bits) * span < idle) {
+            idle = edge + __builtin_ctz(bits) * span;
+        }
+    }
+    return idle;
+}
+
+// ============================================
+// API
+// ============================================
+
+void timer_wheel_schedule(timer_wheel_timer_t *timer, uint32_t delay_ms) {
+    uint32_t now = timer_read32();
+    if (scheduled == 0) {
+        tick = now;  // Empty wheel: nothing to catch up on
+    }
+    if (timer->pprev) {
+        list_remove(timer);
+    } else {
+        scheduled++;
+    }
+    timer->due = now + delay_ms;
+    place(timer);
+}
+
+void timer_wheel_cancel(timer_wheel_timer_t *timer) {
+    if (timer->pprev) {
+        list_remove(timer);
+        scheduled--;
+    }
+}
+
+bool timer_wheel_pending(const timer_wheel_timer_t *timer) {
+    return timer->pprev != NULL;
+}
+
+void timer_wheel_task(void) {
+    uint32_t now = timer_read32();
+    while (scheduled > 0 && (int32_t)(now - tick) >= 0) {
+        // Jump over ticks with nothing to run or move down (a long suspend is
+        // caught up in a few steps, not one per millisecond)
+        uint32_t idle = idle_ticks();
+        if (idle > now - tick) {
+            break;
+        }
+        tick += idle;
+
+        // Upper levels come down when the level below wraps
+        for (uint8_t level = 1; level < TIMER_WHEEL_LEVELS && (tick & (SPAN(level) - 1)) == 0; level++) {
+            cascade(level);
+        }
+
+        uint8_t slot = tick & SLOT_MASK;
+        // Step past the slot before running it: a timer the callbacks schedule
+        // for now (or earlier) lands on the next tick, not back in this slot
+        tick++;
+        if (occupied[0] & (1UL << slot)) {
+            // Bit may outlive the slot's last timer when it was cancelled
+            occupied[0] &= ~(1UL << slot);
+            expiring       = slots[0][slot];
+            slots[0][slot] = NULL;
+            if (expiring) {
+                expiring->pprev = &expiring;
+            }
+            while (expiring) {
+                timer_wheel_timer_t *timer = expiring;
+                list_remove(timer);
+                scheduled--;
+                uint32_t again = timer->callback();
+                if (again && !timer->pprev) {
+                    timer_wheel_schedule(timer, again);
+                }
+            }
+        }
+    }
+    if (scheduled == 0 || (int32_t)(now - tick) >= 0) {
+        tick = now + 1;  // Nothing left due up to now
+    }
+}
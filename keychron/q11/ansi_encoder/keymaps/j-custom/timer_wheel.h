@@ -0,0 +1,63 @@
+/* Timer wheel: one scheduler for the keymap's deferred work
+ *
+ * Timeouts and periodic jobs (chord term, leader timeout, host context
+ * expiry, key stats save, split health poll, console reports...) register a
+ * timer here instead of each module comparing its own timestamps on every
+ * scan. timer_wheel_task() runs the callbacks that are due.
+ *
+ * Hierarchical wheel, TIMER_WHEEL_LEVELS levels of 2^TIMER_WHEEL_BITS slots
+ * with a 1 ms tick: level 0 holds timers due within 32 ms, level 1 within
+ * ~1 s, level 2 within ~32 s; a slot of an upper level is moved down when
+ * the wheel below wraps. Longer delays wait in the farthest slot and are
+ * re-filed each time it comes around. Each level keeps a bitmap of occupied
+ * slots, so the task jumps straight to the next tick with a slot to run or
+ * move down: catching up after a long suspend takes a few steps, not one per
+ * millisecond, and a task call with no timer pending returns at once.
+ *
+ * Timers are caller-owned (static) and linked into the wheel: schedule,
+ * reschedule and cancel are O(1), nothing is allocated, and the cost per
+ * tick does not depend on how many timers exist.
+ *
+ * A callback returns the delay until it should run again, or 0 to stop; it
+ * may schedule or cancel any timer, itself included (its own schedule call
+ * then wins over the return value). A timer scheduled for now from a
+ * callback runs on the next tick.
+ *
+ * Tap dance timeouts stay with QMK's own tap dance code; the LGUI double-tap
+ * window is checked on the next press and never polled.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef TIMER_WHEEL_BITS
+#    define TIMER_WHEEL_BITS 5  // 32 slots per level (bitmaps are uint32_t)
+#endif
+
+#ifndef TIMER_WHEEL_LEVELS
+#    define TIMER_WHEEL_LEVELS 3
+#endif
+
+typedef uint32_t (*timer_wheel_callback_t)(void);
+
+typedef struct timer_wheel_timer {
+    struct timer_wheel_timer  *next;
+    struct timer_wheel_timer **pprev;  // Link pointing at this timer; NULL when not scheduled
+    uint32_t                   due;
+    timer_wheel_callback_t     callback;
+} timer_wheel_timer_t;
+
+// Static initializer: static timer_wheel_timer_t t = TIMER_WHEEL_TIMER(callback);
+#define TIMER_WHEEL_TIMER(cb) { .next = NULL, .pprev = NULL, .due = 0, .callback = (cb) }
+
+// Run the callback delay_ms from now (moves the timer if it was already scheduled)
+void timer_wheel_schedule(timer_wheel_timer_t *timer, uint32_t delay_ms);
+
+// Drop a scheduled timer (no-op if it is not scheduled)
+void timer_wheel_cancel(timer_wheel_timer_t *timer);
+
+bool timer_wheel_pending(const timer_wheel_timer_t *timer);
+
+// Run due callbacks (call first in housekeeping_task_user)
+void timer_wheel_task(void);
@@ -0,0 +1,263 @@
+/* Benchmark harness for the chord engine
+ *
+ * Links the keymap's chords.c on the host and replays a key trace from
+ * stdin, one command per line:
+ *   chord <id> <slot> <slot> [<slot> [<slot>]]   Chord on MAC_BASE (slot = row * MATRIX_COLS + col)
+ *   event <ms> <row> <col> <0|1>                 Key release / press at an absolute time
+ *   encoder <ms>                                 Encoder turn (not a key event)
+ * Output:
+ *   fire <ms> <id>            A chord fired
+ *   order <ms>                An event reached QMK after a later one
+ *   summary key=value ...     Totals and timing (see chord-bench.js)
+ *
+ * The replay steps a virtual 1 ms clock and runs timer_wheel_task() every
+ * tick, as housekeeping does once per scan (held-back keys are replayed by
+ * the chord term timer), and checks that events reach QMK (passed through
+ * or replayed) in trace order. It then times chords_process() alone over
+ * the same events, and a linear scan of every chord per press (what an engine
+ * without the per-position index does) for comparison.
+ *
+ * Usage: chords_bench [runs]
+ * Build: cc -I<this dir> -DQMK_KEYBOARD_H='"qmk_stubs.h"' chords_bench.c .../j-custom/chords.c \
+ *           .../j-custom/timer_wheel.c
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdlib.h>
+#include <time.h>
+
+#include "qmk_stubs.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/chords.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/timer_wheel.h"
+
+#define MAX_EVENTS 200000
+
+layer_state_t layer_state         = 1;
+layer_state_t default_layer_state = 1;
+
+static uint32_t now_ms = 0;
+
+// Replay accounting
+static bool     quiet       = false;
+static unsigned replayed    = 0;
+static unsigned delay_total = 0;
+static unsigned delay_max   = 0;
+
+// Order check: trace index of the latest event QMK has seen
+static void     delivered(keyevent_t event);
+static long     newest    = -1;
+static unsigned reordered = 0;
+
+// ============================================
+// QMK stubs
+// ============================================
+
+uint8_t get_highest_layer(layer_state_t state) {
+    for (int i = 31; i > 0; i--) {
+        if (state & (1UL << i)) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+uint16_t timer_read(void) {
+    return (uint16_t)now_ms;
+}
+
+uint32_t timer_read32(void) {
+    return now_ms;
+}
+
+void action_exec(keyevent_t event) {
+    delivered(event);
+    if (event.pressed) {
+        unsigned delay = (uint16_t)(timer_read() - event.time);
+        replayed++;
+        delay_total += delay;
+        if (delay > delay_max) {
+            delay_max = delay;
+        }
+    }
+}
+
+action_t action_for_keycode(uint16_t keycode) {
+    return keycode;
+}
+
+void process_action(keyrecord_t *record, action_t action) {}
+
+// Chord ids are the keycodes of the table entries
+bool process_chord_user(uint16_t keycode, keyrecord_t *record) {
+    if (record->event.pressed) {
+        if (!quiet) {
+            printf("fire %u %u\n", (unsigned)now_ms, keycode);
+        }
+    }
+    return false;
+}
+
+// ============================================
+// Replay
+// ============================================
+
+static chord_t    table[CHORDS_MAX];
+static uint8_t    table_size = 0;
+static keyevent_t events[MAX_EVENTS];
+static uint32_t   event_ms[MAX_EVENTS];
+static unsigned   event_count = 0;
+static long       current     = -1;  // Event being processed
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void read_input(void) {
+    char line[128];
+    while (fgets(line, sizeof(line), stdin)) {
+        unsigned a[6];
+        int      n;
+        if ((n = sscanf(line, "chord %u %u %u %u %u", &a[0], &a[1], &a[2], &a[3], &a[4])) >= 3) {
+            if (table_size == CHORDS_MAX) {
+                fprintf(stderr, "chords_bench: more than CHORDS_MAX (%d) chords\n", CHORDS_MAX);
+                exit(2);
+            }
+            chord_t *c = &table[table_size++];
+            memset(c->keys, CHORD_NONE, sizeof(c->keys));
+            for (int k = 1; k < n && k <= CHORD_MAX_KEYS; k++) {
+                c->keys[k - 1] = a[k];
+            }
+            c->layers  = 1;
+            c->keycode = a[0];
+        } else if (sscanf(line, "event %u %u %u %u", &a[0], &a[1], &a[2], &a[3]) == 4) {
+            if (event_count == MAX_EVENTS) {
+                fprintf(stderr, "chords_bench: trace longer than %d events\n", MAX_EVENTS);
+                exit(2);
+            }
+            event_ms[event_count] = a[0];
+            events[event_count++] = (keyevent_t){.key = {.col = a[2], .row = a[1]}, .time = (uint16_t)a[0] | 1, .type = KEY_EVENT, .pressed = a[3] != 0};
+        } else if (sscanf(line, "encoder %u", &a[0]) == 1) {
+            if (event_count == MAX_EVENTS) {
+                fprintf(stderr, "chords_bench: trace longer than %d events\n", MAX_EVENTS);
+                exit(2);
+            }
+            event_ms[event_count] = a[0];
+            events[event_count++] = (keyevent_t){.key = {.col = 0, .row = 0xFF}, .time = (uint16_t)a[0] | 1, .type = ENCODER_CW_EVENT, .pressed = true};
+        } else if (line[0] != '\n' && line[0] != '#') {
+            fprintf(stderr, "chords_bench: bad line: %s", line);
+            exit(2);
+        }
+    }
+}
+
+// Replays carry the original event: find it among those already read
+static void delivered(keyevent_t event) {
+    if (quiet) {
+        return;
+    }
+    for (long i = current; i >= 0; i--) {
+        keyevent_t e = events[i];
+        if (e.time == event.time && e.type == event.type && e.pressed == event.pressed && e.key.row == event.key.row && e.key.col == event.key.col) {
+            if (i < newest) {
+                reordered++;
+                printf("order %u\n", event_ms[i]);
+            } else {
+                newest = i;
+            }
+            return;
+        }
+    }
+}
+
+// Tick past the end of the trace so held-back keys are replayed
+static void drain(void) {
+    for (unsigned t = 0; t <= CHORD_TERM; t++) {
+        now_ms++;
+        timer_wheel_task();
+    }
+}
+
+// Linear scan: every chord checked for the pressed slot
+static volatile unsigned scan_hits = 0;
+
+static void linear_scan(uint8_t slot) {
+    chord_t chord;
+    for (uint8_t i = 0; i < table_size; i++) {
+        memcpy_P(&chord, &table[i], sizeof(chord));
+        for (uint8_t k = 0; k < CHORD_MAX_KEYS; k++) {
+            if (chord.keys[k] == slot) {
+                scan_hits++;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int runs = argc > 1 ? atoi(argv[1]) : 20;
+    read_input();
+    chords_init(table, table_size);
+
+    // Behaviour: 1 ms ticks between events
+    for (unsigned i = 0; i < event_count; i++) {
+        while (now_ms < event_ms[i]) {
+            now_ms++;
+            timer_wheel_task();
+        }
+        keyrecord_t record = {.event = events[i]};
+        current            = i;
+        if (chords_process(&record)) {
+            delivered(record.event);
+        }
+    }
+    drain();
+    unsigned held = replayed, delay_sum = delay_total, delay_worst = delay_max;
+    unsigned presses = 0;
+    for (unsigned i = 0; i < event_count; i++) {
+        presses += events[i].pressed;
+    }
+
+    // Timing: chords_process() plus the wheel, best of runs (the clock keeps running forward)
+    quiet            = true;
+    double best      = 0;
+    double best_scan = 0;
+    for (int r = 0; r < runs; r++) {
+        chords_init(table, table_size);
+        uint32_t base  = now_ms;
+        double   start = now_ns();
+        for (unsigned i = 0; i < event_count; i++) {
+            now_ms             = base + event_ms[i];
+            keyrecord_t record = {.event = events[i]};
+            record.event.time  = (uint16_t)now_ms | 1;
+            timer_wheel_task();
+            chords_process(&record);
+        }
+        double took = now_ns() - start;
+        drain();
+        best = (r == 0 || took < best) ? took : best;
+
+        start = now_ns();
+        for (unsigned i = 0; i < event_count; i++) {
+            if (events[i].pressed) {
+                linear_scan(events[i].key.row * MATRIX_COLS + events[i].key.col);
+            }
+        }
+        took      = now_ns() - start;
+        best_scan = (r == 0 || took < best_scan) ? took : best_scan;
+    }
+
+    // Longest per-position candidate list
+    unsigned refs[MATRIX_ROWS * MATRIX_COLS] = {0};
+    unsigned max_refs                        = 0;
+    for (uint8_t i = 0; i < table_size; i++) {
+        for (uint8_t k = 0; k < CHORD_MAX_KEYS; k++) {
+            if (table[i].keys[k] < MATRIX_ROWS * MATRIX_COLS && ++refs[table[i].keys[k]] > max_refs) {
+                max_refs = refs[table[i].keys[k]];
+            }
+        }
+    }
+    printf("summary chords=%u events=%u presses=%u held=%u delay_total=%u delay_max=%u reordered=%u max_refs=%u ns_event=%.1f ns_scan=%.1f\n",
+           table_size, event_count, presses, held, delay_sum, delay_worst, reordered, max_refs,
+           event_count ? best / event_count : 0.0, presses ? best_scan / presses : 0.0);
+    return 0;
+}
@@ -0,0 +1,53 @@
+/* Minimal QMK environment for building chords.c on the host
+ *
+ * Provides just enough of quantum.h (key events, actions, layers, timer)
+ * for the chord benchmark (chords.c and timer_wheel.c); the clock is virtual and advanced by the harness.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define memcpy_P(dst, src, n) memcpy(dst, src, n)
+
+// Keychron Q11: 6 rows per half, 9 columns
+#define MATRIX_ROWS 12
+#define MATRIX_COLS 9
+
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+
+typedef uint32_t layer_state_t;
+typedef uint16_t action_t;
+
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef enum { TICK_EVENT = 0, KEY_EVENT = 1, ENCODER_CW_EVENT = 2, ENCODER_CCW_EVENT = 3, COMBO_EVENT = 4 } keyevent_type_t;
+
+typedef struct {
+    keypos_t        key;
+    uint16_t        time;
+    keyevent_type_t type;
+    bool            pressed;
+} keyevent_t;
+
+typedef struct {
+    keyevent_t event;
+} keyrecord_t;
+
+#define IS_NOEVENT(event) ((event).type == TICK_EVENT)
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+uint8_t  get_highest_layer(layer_state_t state);
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+void     action_exec(keyevent_t event);
+action_t action_for_keycode(uint16_t keycode);
+void     process_action(keyrecord_t *record, action_t action);
@@ -0,0 +1,372 @@
+#!/usr/bin/env node
+
+//
+// Chord engine benchmark (j-custom/chords.c)
+//
+// Compiles chords.c for the host (bench/ harness) and replays typing traces
+// through it with the chords defined in keymap.c:
+//   - misfires: chords fired while typing (per 1000 presses), with and
+//     without the CHORD_IDLE_MS guard
+//   - hits: deliberate chords mixed into the trace that were recognized
+//   - delay: how long chord keys typed on their own were held back
+//   - order: events that reached QMK after a later one (the trace, and
+//     scripted cases: a modifier released or an encoder turned while a chord
+//     key is held back); exits with 1 if any did
+//   - latency: chords_process() time per event with the keymap's chords and
+//     with filler chords added, next to a linear scan of every chord per press
+//
+// Usage: node scripts/chords/chord-bench.js [options]
+//
+// Options:
+//   --trace <file>     qmk console log of real typing (CONSOLE_ENABLE build; the
+//                      "kc: ..., col:, row:, pressed:, time:" lines); repeatable.
+//                      Without a trace, typing is simulated from --text.
+//   --text <file>      Text to simulate typing (default: the repo's *.md files)
+//   --words <n>        Words of text to type (default: 5000)
+//   --wpm <n>          Simulated typing speed (default: 70)
+//   --inject <n>       Deliberate chords per 100 words (default: 2)
+//   --sizes <list>     Chord table sizes for the latency runs (default: 3,32,250)
+//   --runs <n>         Timing runs, best is reported (default: 20)
+//   --seed <n>         Simulation seed (default: 1)
+//
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const { readKeymap, geometry } = require('../generate-sparse-keymap');
+
+const REPO_DIR = path.resolve(__dirname, '..', '..');
+const BENCH_DIR = path.join(__dirname, 'bench');
+const BUILD_DIR = path.join(REPO_DIR, '.build');
+const KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const INFO_JSON = path.join(REPO_DIR, 'keychron/q11/info.json');
+const CHORDS_MAX = 250;
+
+// ============================================
+// Keymap
+// ============================================
+
+// Chords from keymap.c (CHORD_KEY(row, col) entries of chords[]) and MAC_BASE key positions
+function readSetup() {
+  const keymap = readKeymap(KEYMAP_DIR);
+  const info = JSON.parse(fs.readFileSync(INFO_JSON, 'utf8'));
+  const geo = geometry(info, keymap.layers[0].macro);
+  const table = keymap.source.match(/chords\s*\[\s*\]\s*=\s*\{([\s\S]*?)\n\};/);
+  if (!table) throw new Error('no chords[] table in keymap.c');
+  const chords = [];
+  for (const entry of table[1].split('\n').filter(l => l.includes('CHORD_KEY'))) {
+    const keys = [...entry.matchAll(/CHORD_KEY\(\s*(\d+)\s*,\s*(\d+)\s*\)/g)].map(m => Number(m[1]) * geo.cols + Number(m[2]));
+    const action = (entry.match(/,\s*(\w+)\s*\}\s*,?\s*$/) || [])[1] || `chord${chords.length}`;
+    chords.push({ id: chords.length + 1, keys, action });
+  }
+  const base = keymap.layers.find(l => keymap.layerEnum[l.name] === 0);
+  const slotOf = {};
+  geo.keys.forEach(([r, c], i) => { slotOf[base.keys[i]] = { row: r, col: c, slot: r * geo.cols + c }; });
+  return { geo, chords, slotOf };
+}
+
+// Keys a character is typed with on MAC_BASE (shifted symbols use KC_LSFT)
+const SHIFTED = { '!': '1', '@': '2', '#': '3', $: '4', '%': '5', '^': '6', '&': '7', '*': '8', '(': '9', ')': '0',
+  _: '-', '+': '=', '{': '[', '}': ']', '|': '\\', ':': ';', '"': "'", '<': ',', '>': '.', '?': '/', '~': '`' };
+const PUNCT = { '-': 'KC_MINS', '=': 'KC_EQL', '[': 'KC_LBRC', ']': 'KC_RBRC', '\\': 'KC_BSLS', ';': 'KC_SCLN',
+  "'": 'KC_QUOT', ',': 'KC_COMM', '.': 'KC_DOT', '/': 'KC_SLSH', '`': 'KC_GRV', ' ': 'KC_SPC', '\n': 'KC_ENT' };
+
+function keysFor(ch) {
+  if (/[a-z0-9]/.test(ch)) return [`KC_${ch.toUpperCase()}`];
+  if (/[A-Z]/.test(ch)) return ['KC_LSFT', `KC_${ch}`];
+  if (SHIFTED[ch]) return ['KC_LSFT', ...keysFor(SHIFTED[ch])];
+  return PUNCT[ch] ? [PUNCT[ch]] : [];
+}
+
+// ============================================
+// Traces
+// ============================================
+
+// qmk console log → events (the 16-bit time field is unwrapped)
+function readConsoleLog(file, offset) {
+  const events = [];
+  let last = null;
+  let base = offset;
+  for (const m of fs.readFileSync(file, 'utf8').matchAll(/col:\s*(\d+),\s*row:\s*(\d+),\s*pressed:\s*(\d),\s*time:\s*(\d+)/g)) {
+    const t = Number(m[4]);
+    if (last !== null && t < last) base += 0x10000;
+    last = t;
+    events.push({ t: base + t, row: Number(m[2]), col: Number(m[1]), pressed: m[3] === '1' });
+  }
+  if (!events.length) throw new Error(`${file}: no "col:, row:, pressed:, time:" lines (qmk console with CONSOLE_ENABLE)`);
+  return events;
+}
+
+function random(seed) {
+  let a = seed >>> 0;
+  return () => {
+    a = (a + 0x6D2B79F5) >>> 0;
+    let t = a;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+// Typing model: press-to-press interval around 60000 / (wpm * 5) ms, holds of
+// 70-140 ms (so fast bigrams overlap, as real rollover does), longer pauses
+// after words and lines. Deliberate chords follow a pause, keys 0-25 ms apart.
+function simulate(text, setup, options) {
+  const rand = random(options.seed);
+  const gauss = () => (rand() + rand() + rand() - 1.5) / 1.5;
+  const interval = 60000 / (options.wpm * 5);
+  const events = [];
+  const injected = [];
+  let t = 1000;
+  const tap = (key, at, hold) => {
+    const pos = setup.slotOf[key];
+    if (!pos) return;
+    events.push({ t: Math.round(at), row: pos.row, col: pos.col, pressed: true });
+    events.push({ t: Math.round(at + hold), row: pos.row, col: pos.col, pressed: false });
+  };
+  const words = text.split(/\s+/).filter(Boolean).slice(0, options.words);
+  words.forEach((word, w) => {
+    if (setup.chords.length && rand() < options.inject / 100) {
+      const chord = setup.chords[Math.floor(rand() * setup.chords.length)];
+      t += 300 + rand() * 300;
+      const start = t;
+      chord.keys.forEach(slot => {
+        const row = Math.floor(slot / setup.geo.cols);
+        const col = slot % setup.geo.cols;
+        const at = start + rand() * 25;
+        const hold = 100 + rand() * 60;
+        events.push({ t: Math.round(at), row, col, pressed: true }, { t: Math.round(at + hold), row, col, pressed: false });
+      });
+      injected.push({ t: Math.round(start), id: chord.id });
+      t += 250;
+    }
+    for (const ch of `${word} `) {
+      const keys = keysFor(ch);
+      if (!keys.length) continue;
+      const hold = 70 + rand() * 70;
+      if (keys.length === 2) {
+        // Shift leads, and mostly outlasts the key; sometimes it is let go first
+        tap(keys[0], t - 40, rand() < 0.3 ? 45 + rand() * 25 : hold + 60);
+      }
+      tap(keys[keys.length - 1], t, hold);
+      t += Math.max(25, interval * (1 + 0.45 * gauss()));
+    }
+    if (w % 12 === 11) t += 400 + rand() * 600;  // End of a sentence or line
+  });
+  events.sort((a, b) => a.t - b.t || a.pressed - b.pressed);
+  return { events, injected };
+}
+
+// ============================================
+// Harness
+// ============================================
+
+function build(idleMs) {
+  const binary = path.join(BUILD_DIR, `chords_bench_idle${idleMs}`);
+  fs.mkdirSync(BUILD_DIR, { recursive: true });
+  const args = ['-O2', '-std=gnu11', '-Wall', `-I${BENCH_DIR}`, '-DQMK_KEYBOARD_H="qmk_stubs.h"',
+    `-DCHORDS_MAX=${CHORDS_MAX}`];
+  if (idleMs !== null) args.push(`-DCHORD_IDLE_MS=${idleMs}`);
+  execFileSync(process.env.CC || 'cc', [...args, '-o', binary, path.join(BENCH_DIR, 'chords_bench.c'),
+    path.join(KEYMAP_DIR, 'chords.c'), path.join(KEYMAP_DIR, 'timer_wheel.c')], { stdio: ['ignore', 'inherit', 'pipe'] });
+  return binary;
+}
+
+function run(binary, chords, events, runs) {
+  const lines = [
+    ...chords.map(c => `chord ${c.id} ${c.keys.join(' ')}`),
+    ...events.map(e => (e.encoder ? `encoder ${e.t}` : `event ${e.t} ${e.row} ${e.col} ${e.pressed ? 1 : 0}`)),
+  ];
+  const output = execFileSync(binary, [String(runs)], { input: `${lines.join('\n')}\n`, maxBuffer: 64 << 20 })
+    .toString().trim().split('\n');
+  const fires = output.filter(l => l.startsWith('fire ')).map(l => {
+    const [, t, id] = l.split(' ');
+    return { t: Number(t), id: Number(id) };
+  });
+  const summary = Object.fromEntries(output.find(l => l.startsWith('summary ')).split(' ').slice(1).map(kv => {
+    const [k, v] = kv.split('=');
+    return [k, Number(v)];
+  }));
+  return { fires, summary };
+}
+
+// A fire within a deliberate chord's press window counts as a hit, anything else misfired
+function classify(fires, injected) {
+  const open = [...injected];
+  let hits = 0;
+  let misfires = 0;
+  for (const fire of fires) {
+    const i = open.findIndex(c => c.id === fire.id && fire.t >= c.t && fire.t - c.t <= 60);
+    if (i >= 0) {
+      hits++;
+      open.splice(i, 1);
+    } else {
+      misfires++;
+    }
+  }
+  return { hits, misfires };
+}
+
+// A chord key pressed alone after a quiet spell (so it is held back), with
+// another event arriving before it resolves
+function orderCases(setup) {
+  const chordSlots = new Set(setup.chords.flatMap(c => c.keys));
+  const key = ['KC_F', 'KC_J', 'KC_D'].map(k => setup.slotOf[k]).find(p => p && chordSlots.has(p.slot));
+  if (!key) return [];
+  const at = (t, pos, pressed) => ({ t, row: pos.row, col: pos.col, pressed });
+  const cases = [];
+  for (const [mod, label] of [['KC_LGUI_SPOTLIGHT', 'Cmd'], ['KC_LSFT', 'Shift']]) {
+    const pos = setup.slotOf[mod];
+    if (!pos) continue;
+    cases.push({
+      name: `${label} held, chord key pressed, ${label} released first`,
+      events: [at(1000, pos, true), at(1300, key, true), at(1310, pos, false), at(1360, key, false)],
+    });
+  }
+  cases.push({
+    name: 'encoder turned while a chord key is held back',
+    events: [at(1000, key, true), { t: 1010, encoder: true }, at(1060, key, false)],
+  });
+  return cases;
+}
+
+// Filler chords on keys that are not typed (function row, macro column, navigation cluster)
+function fillers(setup, count) {
+  const typed = new Set(Object.entries(setup.slotOf)
+    .filter(([kc]) => /^KC_([A-Z0-9]|SPC|ENT|LSFT|RSFT|MINS|EQL|LBRC|RBRC|BSLS|SCLN|QUOT|COMM|DOT|SLSH|GRV|BSPC|TAB)$/.test(kc))
+    .map(([, p]) => p.slot));
+  const used = new Set(setup.chords.flatMap(c => c.keys));
+  const free = Object.values(setup.slotOf).map(p => p.slot).filter(s => !typed.has(s) && !used.has(s)).sort((a, b) => a - b);
+  // Pairs at growing distance in the free list, so every key gets about the same number of chords
+  const extra = [];
+  for (let d = 1; d < free.length && extra.length < count; d++) {
+    for (let i = 0; i + d < free.length && extra.length < count; i++) {
+      extra.push({ id: setup.chords.length + extra.length + 1, keys: [free[i], free[i + d]], action: 'filler' });
+    }
+  }
+  return extra;
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = { traces: [], text: null, words: 5000, wpm: 70, inject: 2, sizes: [3, 32, 250], runs: 20, seed: 1 };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    const number = () => {
+      const n = Number(value());
+      if (!Number.isFinite(n) || n < 0) throw new Error(`${arg} expects a non-negative number`);
+      return n;
+    };
+    switch (arg) {
+      case '--trace': options.traces.push(value()); break;
+      case '--text': options.text = value(); break;
+      case '--words': options.words = number(); break;
+      case '--wpm': options.wpm = number(); break;
+      case '--inject': options.inject = number(); break;
+      case '--sizes': options.sizes = value().split(',').map(Number); break;
+      case '--runs': options.runs = number(); break;
+      case '--seed': options.seed = number(); break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  if (options.sizes.some(n => !Number.isInteger(n) || n < 1 || n > CHORDS_MAX)) {
+    throw new Error(`--sizes: chord counts between 1 and ${CHORDS_MAX}`);
+  }
+  return options;
+}
+
+function defaultText() {
+  const files = execFileSync('git', ['ls-files', '*.md'], { cwd: REPO_DIR }).toString().trim().split('\n');
+  return files.map(f => fs.readFileSync(path.join(REPO_DIR, f), 'utf8')).join('\n');
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const setup = readSetup();
+
+  let trace;
+  let source;
+  if (options.traces.length) {
+    let offset = 0;
+    const events = [];
+    for (const file of options.traces) {
+      const part = readConsoleLog(file, offset);
+      events.push(...part);
+      offset = part[part.length - 1].t + 10000;
+    }
+    trace = { events, injected: [] };
+    source = `${options.traces.length} console log(s)`;
+  } else {
+    const text = options.text ? fs.readFileSync(options.text, 'utf8') : defaultText();
+    trace = simulate(text, setup, options);
+    source = `simulated typing, ${options.words} words at ${options.wpm} WPM, ${trace.injected.length} deliberate chords`;
+  }
+  const presses = trace.events.filter(e => e.pressed).length;
+
+  let guarded;
+  let unguarded;
+  try {
+    guarded = build(null);
+    unguarded = build(0);
+  } catch (err) {
+    throw new Error(`could not compile the harness (is a C compiler installed?): ${err.stderr || err.message}`);
+  }
+
+  console.log(`Chords: ${setup.chords.map(c => `${c.action} (${c.keys.length} keys)`).join(', ')}`);
+  console.log(`Trace:  ${source}, ${presses} presses\n`);
+
+  const perK = n => (presses ? (1000 * n / presses).toFixed(2) : '0');
+  let reordered = 0;
+  for (const [label, binary] of [['with idle guard', guarded], ['without idle guard', unguarded]]) {
+    const { fires, summary } = run(binary, setup.chords, trace.events, 1);
+    const { hits, misfires } = classify(fires, trace.injected);
+    const hitRate = trace.injected.length ? ` | hits ${hits}/${trace.injected.length}` : '';
+    reordered += summary.reordered;
+    console.log(`${label.padEnd(19)} misfires ${misfires} (${perK(misfires)} per 1000 presses)${hitRate}` +
+      ` | held back ${summary.held} presses, mean ${summary.held ? (summary.delay_total / summary.held).toFixed(1) : 0} ms,` +
+      ` max ${summary.delay_max} ms | out of order ${summary.reordered}`);
+  }
+
+  console.log('\nEvent order:');
+  for (const { name, events } of orderCases(setup)) {
+    const { summary } = run(guarded, setup.chords, events, 1);
+    reordered += summary.reordered;
+    console.log(`  ${summary.reordered ? 'OUT OF ORDER' : 'ok'.padEnd(12)}  ${name}`);
+  }
+  if (reordered) process.exitCode = 1;
+
+  console.log('\nResolution latency (host CPU, best of runs):');
+  console.log('  chords  max per key  chords_process ns/event  linear scan ns/press');
+  for (const size of options.sizes) {
+    const table = size <= setup.chords.length ? setup.chords.slice(0, size)
+      : [...setup.chords, ...fillers(setup, size - setup.chords.length)];
+    const { summary } = run(guarded, table, trace.events, options.runs);
+    console.log(`  ${String(summary.chords).padStart(6)}  ${String(summary.max_refs).padStart(11)}` +
+      `  ${summary.ns_event.toFixed(1).padStart(23)}  ${summary.ns_scan.toFixed(1).padStart(20)}`);
+  }
+}
+
+if (require.main === module) {
+  try {
+    main();
+  } catch (err) {
+    console.error(`chord-bench: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { readSetup, readConsoleLog, simulate, classify };
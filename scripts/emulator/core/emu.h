@@ -0,0 +1,78 @@
+/* Emulator internals shared by the emu_*.c files (not seen by the firmware sources) */
+#pragma once
+
+#include "emu_quantum.h"
+
+// ============================================
+// Options (emu_main.c)
+// ============================================
+
+typedef struct {
+    bool         master;       // This process: left half, USB side
+    bool         console;      // uprintf to stderr
+    bool         uinput;       // Virtual HID device through /dev/uinput instead of the report stream
+    bool         grab;         // Grab the uinput device's event node: its keys reach no other reader
+    bool         nkro;         // keymap_config.nkro at boot
+    uint32_t     loop_us;      // Shortest main-loop pass (the MCU is not emulated cycle by cycle)
+    uint32_t     poll_us;      // USB interrupt endpoint polling interval
+    uint8_t      ep_depth;     // Reports queued per IN endpoint before a send blocks
+    uint32_t     baud;         // Split link rate for the transfer time of each transaction
+    os_variant_t host_os;      // Reported by OS detection after boot
+    uint32_t     host_os_ms;   // ... this long after boot
+} emu_options_t;
+
+extern emu_options_t emu_options;
+
+// ============================================
+// Clock and output (emu_core.c)
+// ============================================
+
+// Microseconds since the run's epoch, shared by both halves (CLOCK_MONOTONIC)
+uint64_t emu_now_us(void);
+void     emu_set_epoch(uint64_t epoch_ns);
+void     emu_sleep_until(uint64_t us);
+
+// One line on stdout, written whole (both halves share the pipe)
+void emu_out(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// ============================================
+// Keyboard (emu_core.c)
+// ============================================
+
+void emu_keyboard_init(void);
+void emu_keyboard_task(void);
+void emu_matrix_inject(uint8_t row, uint8_t col, bool pressed);
+void emu_encoder_inject(uint8_t index, bool clockwise);
+void emu_print_stats(void);
+
+// Rows of this half in the full matrix
+#define EMU_HALF_ROWS (MATRIX_ROWS / 2)
+uint8_t emu_first_row(void);
+
+// Slave state read by the master every scan (EMU_TRANSACTION_SLAVE_STATE)
+typedef struct __attribute__((packed)) {
+    matrix_row_t rows[EMU_HALF_ROWS];
+    int8_t       encoder_steps;  // Detents since the last read, clockwise positive
+} emu_slave_state_t;
+
+void emu_slave_state_take(emu_slave_state_t *state);
+void emu_slave_state_apply(const emu_slave_state_t *state);
+
+// ============================================
+// Split link (emu_split.c)
+// ============================================
+
+void emu_split_init(int fd);
+void emu_split_serve(uint32_t timeout_us);  // Slave: answer requests, wait at most timeout_us for one
+bool emu_split_closed(void);                // Slave: the master has gone
+void emu_split_close(void);                 // Master: end of the run
+void emu_split_print_stats(void);
+
+// ============================================
+// USB host (emu_host.c)
+// ============================================
+
+bool emu_host_init(void);
+void emu_host_poll(void);    // Deliver the reports due at the frames passed so far
+void emu_host_finish(void);  // Drain the endpoints, read back the last input events
+void emu_host_print_stats(void);
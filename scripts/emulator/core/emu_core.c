@@ -0,0 +1,1131 @@
+/* Emulated QMK core - see emu_quantum.h
+ *
+ * Clock, console, EEPROM, layers, the record pipeline (action_exec →
+ * pre_process_record → process_record_quantum → process_action), reports,
+ * tap dance, SEND_STRING, and the keyboard task: matrix scan with QMK's
+ * default debounce (sym_defer_g), encoder map, housekeeping. Follows
+ * quantum/action.c, action_layer.c, keyboard.c and process_tap_dance.c in
+ * behaviour; the code paths the j-custom keymap does not use (tapping for
+ * LT/MT, one-shot, locking keys) are left out and counted when hit.
+ */
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "emu.h"
+#include "keymap_introspection.h"
+#include "transactions.h"
+
+// ============================================
+// Clock and output
+// ============================================
+
+static uint64_t epoch_ns;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void emu_set_epoch(uint64_t ns) {
+    epoch_ns = ns;
+}
+
+uint64_t emu_now_us(void) {
+    return (monotonic_ns() - epoch_ns) / 1000;
+}
+
+void emu_sleep_until(uint64_t us) {
+    uint64_t        ns = epoch_ns + us * 1000;
+    struct timespec ts = { .tv_sec = ns / 1000000000ULL, .tv_nsec = ns % 1000000000ULL };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+void emu_out(const char *fmt, ...) {
+    char    line[512];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(line, sizeof(line) - 1, fmt, args);
+    va_end(args);
+    if (n < 0) {
+        return;
+    }
+    if (n > (int)sizeof(line) - 2) {
+        n = sizeof(line) - 2;
+    }
+    line[n++] = '\n';
+    if (write(STDOUT_FILENO, line, n) < 0) {
+        // Reader gone: nothing to report to
+    }
+}
+
+int emu_console_printf(const char *fmt, ...) {
+    char    text[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(text, sizeof(text), fmt, args);  // Formatted either way, as the console task would
+    va_end(args);
+    if (emu_options.console && n > 0) {
+        fprintf(stderr, "%s%s", emu_options.master ? "" : "[slave] ", text);
+    }
+    return n;
+}
+
+uint32_t timer_read32(void) {
+    return emu_now_us() / 1000;
+}
+
+uint16_t timer_read(void) {
+    return (uint16_t)timer_read32();
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return TIMER_DIFF_32(timer_read32(), last);
+}
+
+// The USB host keeps polling while the firmware busy-waits
+void wait_us(uint32_t us) {
+    uint64_t end = emu_now_us() + us;
+    for (uint64_t now = emu_now_us(); now < end; now = emu_now_us()) {
+        uint64_t next = now + emu_options.poll_us;
+        emu_sleep_until(next < end ? next : end);
+        if (emu_options.master) {
+            emu_host_poll();
+        }
+    }
+}
+
+void wait_ms(uint32_t ms) {
+    wait_us(ms * 1000);
+}
+
+// ============================================
+// EEPROM (RAM, fresh every run)
+// ============================================
+
+#ifndef EECONFIG_USER_DATA_SIZE
+#    define EECONFIG_USER_DATA_SIZE 0
+#endif
+
+static uint32_t ee_user;
+static uint8_t  ee_datablock[EECONFIG_USER_DATA_SIZE + 1];
+static uint32_t ee_writes;
+
+uint32_t eeconfig_read_user(void) {
+    return ee_user;
+}
+
+void eeconfig_update_user(uint32_t val) {
+    if (val != ee_user) {
+        ee_user = val;
+        ee_writes++;
+    }
+}
+
+void eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length) {
+    if (offset + length <= EECONFIG_USER_DATA_SIZE) {
+        memcpy(data, ee_datablock + offset, length);
+    } else {
+        memset(data, 0, length);
+    }
+}
+
+void eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length) {
+    if (offset + length <= EECONFIG_USER_DATA_SIZE && memcmp(ee_datablock + offset, data, length) != 0) {
+        memcpy(ee_datablock + offset, data, length);
+        ee_writes++;
+    }
+}
+
+// ============================================
+// Weak hooks (as in QMK)
+// ============================================
+
+__attribute__((weak)) bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+__attribute__((weak)) bool pre_process_record_kb(uint16_t keycode, keyrecord_t *record) {
+    return pre_process_record_user(keycode, record);
+}
+
+__attribute__((weak)) bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+__attribute__((weak)) bool process_record_kb(uint16_t keycode, keyrecord_t *record) {
+    return process_record_user(keycode, record);
+}
+
+__attribute__((weak)) void post_process_record_user(uint16_t keycode, keyrecord_t *record) {}
+
+__attribute__((weak)) void keyboard_post_init_user(void) {}
+
+__attribute__((weak)) void keyboard_post_init_kb(void) {
+    keyboard_post_init_user();
+}
+
+__attribute__((weak)) void housekeeping_task_user(void) {}
+
+__attribute__((weak)) void housekeeping_task_kb(void) {
+    housekeeping_task_user();
+}
+
+__attribute__((weak)) void eeconfig_init_user(void) {}
+
+__attribute__((weak)) bool dip_switch_update_user(uint8_t index, bool active) {
+    return true;
+}
+
+__attribute__((weak)) bool dip_switch_update_kb(uint8_t index, bool active) {
+    return dip_switch_update_user(index, active);
+}
+
+__attribute__((weak)) void suspend_power_down_user(void) {}
+
+__attribute__((weak)) void suspend_wakeup_init_user(void) {}
+
+__attribute__((weak)) layer_state_t layer_state_set_user(layer_state_t state) {
+    return state;
+}
+
+__attribute__((weak)) layer_state_t default_layer_state_set_user(layer_state_t state) {
+    return state;
+}
+
+__attribute__((weak)) bool process_detected_host_os_user(os_variant_t detected_os) {
+    return true;
+}
+
+__attribute__((weak)) bool process_detected_host_os_kb(os_variant_t detected_os) {
+    return process_detected_host_os_user(detected_os);
+}
+
+__attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {}
+
+__attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return TAPPING_TERM;
+}
+
+#ifdef TAPPING_TERM_PER_KEY
+#    define GET_TAPPING_TERM(keycode, record) get_tapping_term(keycode, record)
+#else
+#    define GET_TAPPING_TERM(keycode, record) TAPPING_TERM
+#endif
+
+// ============================================
+// Layers
+// ============================================
+
+layer_state_t layer_state         = 0;
+layer_state_t default_layer_state = 0;
+
+void layer_state_set(layer_state_t state) {
+    layer_state = layer_state_set_user(state);
+}
+
+void layer_clear(void) {
+    layer_state_set(0);
+}
+
+void layer_move(uint8_t layer) {
+    layer_state_set((layer_state_t)1 << layer);
+}
+
+void layer_on(uint8_t layer) {
+    layer_state_set(layer_state | ((layer_state_t)1 << layer));
+}
+
+void layer_off(uint8_t layer) {
+    layer_state_set(layer_state & ~((layer_state_t)1 << layer));
+}
+
+void layer_invert(uint8_t layer) {
+    layer_state_set(layer_state ^ ((layer_state_t)1 << layer));
+}
+
+bool layer_state_cmp(layer_state_t state, uint8_t layer) {
+    if (!state) {
+        return layer == 0;
+    }
+    return (state & ((layer_state_t)1 << layer)) != 0;
+}
+
+bool layer_state_is(uint8_t layer) {
+    return layer_state_cmp(layer_state, layer);
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+    return state ? 31 - __builtin_clz(state) : 0;
+}
+
+void default_layer_set(layer_state_t state) {
+    default_layer_state = default_layer_state_set_user(state);
+}
+
+// ============================================
+// Keymap lookup with QMK's source layer cache
+// ============================================
+
+static uint8_t source_layers[MATRIX_ROWS][MATRIX_COLS];
+#ifdef ENCODER_MAP_ENABLE
+static uint8_t encoder_source_layers[NUM_ENCODERS][NUM_DIRECTIONS];
+#endif
+
+// Highest active layer where the key is not transparent
+static uint8_t layer_switch_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if ((layers & ((layer_state_t)1 << i)) && keymap_key_to_keycode(i, key) != KC_TRNS) {
+            return i;
+        }
+    }
+    return get_highest_layer(default_layer_state);
+}
+
+static uint8_t *source_layer(keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        return &source_layers[key.row][key.col];
+    }
+#ifdef ENCODER_MAP_ENABLE
+    if ((key.row == KEYLOC_ENCODER_CW || key.row == KEYLOC_ENCODER_CCW) && key.col < NUM_ENCODERS) {
+        return &encoder_source_layers[key.col][key.row == KEYLOC_ENCODER_CW ? 0 : 1];
+    }
+#endif
+    return NULL;
+}
+
+uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
+    keypos_t key   = record->event.key;
+    uint8_t *cache = source_layer(key);
+    uint8_t  layer;
+    if (!cache) {
+        layer = layer_switch_get_layer(key);
+    } else if (record->event.pressed && update_layer_cache) {
+        layer  = layer_switch_get_layer(key);
+        *cache = layer;
+    } else {
+        layer = *cache;
+    }
+    return keymap_key_to_keycode(layer, key);
+}
+
+action_t action_for_keycode(uint16_t keycode) {
+    return (action_t){ .code = keycode };
+}
+
+// ============================================
+// Reports
+// ============================================
+
+keymap_config_t keymap_config;
+
+static uint8_t           real_mods;
+static uint8_t           weak_mods;
+static report_keyboard_t keyboard_report;
+static report_nkro_t     nkro_report;
+static report_mouse_t    mouse_report;
+
+static struct {
+    uint32_t events;       // Key and encoder events through action_exec
+    uint32_t unsupported;  // Keycodes of features the emulated core leaves out
+    uint32_t lighting;     // RM_* keys (no LEDs here)
+    uint32_t rollover;     // Keys dropped from a full 6KRO report
+    uint32_t loops;
+    uint32_t max_loop_us;
+    uint64_t loop_us_sum;
+    uint32_t rgb_hits;
+} stats;
+
+static void unsupported(uint16_t keycode) {
+    if (stats.unsupported++ == 0) {
+        emu_console_printf("EMU: keycode 0x%04X needs a QMK feature the emulator leaves out\n", keycode);
+    }
+}
+
+uint8_t get_mods(void) {
+    return real_mods;
+}
+void add_mods(uint8_t mods) {
+    real_mods |= mods;
+}
+void del_mods(uint8_t mods) {
+    real_mods &= ~mods;
+}
+void set_mods(uint8_t mods) {
+    real_mods = mods;
+}
+void clear_mods(void) {
+    real_mods = 0;
+}
+uint8_t get_weak_mods(void) {
+    return weak_mods;
+}
+void add_weak_mods(uint8_t mods) {
+    weak_mods |= mods;
+}
+void del_weak_mods(uint8_t mods) {
+    weak_mods &= ~mods;
+}
+void clear_weak_mods(void) {
+    weak_mods = 0;
+}
+uint8_t get_oneshot_mods(void) {
+    return 0;
+}
+
+static bool nkro_active(void) {
+#ifdef NKRO_ENABLE
+    return keymap_config.nkro;
+#else
+    return false;
+#endif
+}
+
+static bool is_key_pressed(uint8_t code) {
+    if (nkro_active()) {
+        return code / 8 < NKRO_REPORT_BITS && (nkro_report.bits[code / 8] & (1 << (code % 8)));
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report.keys[i] == code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void add_key(uint8_t code) {
+    if (nkro_active()) {
+        if (code / 8 < NKRO_REPORT_BITS) {
+            nkro_report.bits[code / 8] |= 1 << (code % 8);
+        }
+        return;
+    }
+    int8_t empty = -1;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report.keys[i] == code) {
+            return;
+        }
+        if (empty < 0 && keyboard_report.keys[i] == 0) {
+            empty = i;
+        }
+    }
+    if (empty < 0) {
+        stats.rollover++;
+        return;
+    }
+    keyboard_report.keys[empty] = code;
+}
+
+static void del_key(uint8_t code) {
+    if (nkro_active()) {
+        if (code / 8 < NKRO_REPORT_BITS) {
+            nkro_report.bits[code / 8] &= ~(1 << (code % 8));
+        }
+        return;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report.keys[i] == code) {
+            keyboard_report.keys[i] = 0;
+        }
+    }
+}
+
+static void clear_keys(void) {
+    memset(keyboard_report.keys, 0, sizeof(keyboard_report.keys));
+    memset(nkro_report.bits, 0, sizeof(nkro_report.bits));
+}
+
+// Sent only when it differs from the last one, as QMK does
+void send_keyboard_report(void) {
+    if (nkro_active()) {
+        static report_nkro_t last;
+        nkro_report.mods = real_mods | weak_mods;
+        if (memcmp(&nkro_report, &last, sizeof(last)) != 0) {
+            last = nkro_report;
+            host_nkro_send(&nkro_report);
+        }
+        return;
+    }
+    static report_keyboard_t last;
+    keyboard_report.mods = real_mods | weak_mods;
+    if (memcmp(&keyboard_report, &last, sizeof(last)) != 0) {
+        last = keyboard_report;
+        host_keyboard_send(&keyboard_report);
+    }
+}
+
+// ============================================
+// Mouse keys (buttons and wheel; kinetic_mouse.c moves the pointer)
+// ============================================
+
+report_mouse_t mousekey_get_report(void) {
+    report_mouse_t report = mouse_report;
+    report.x = report.y = report.v = report.h = 0;
+    return report;
+}
+
+static void mousekey(uint8_t code, bool pressed) {
+    report_mouse_t report = mousekey_get_report();
+    if (code >= KC_MS_BTN1 && code <= KC_MS_BTN8) {
+        uint8_t bit = 1 << (code - KC_MS_BTN1);
+        mouse_report.buttons = pressed ? mouse_report.buttons | bit : mouse_report.buttons & ~bit;
+        report.buttons       = mouse_report.buttons;
+    } else if (pressed && code >= KC_MS_WH_UP && code <= KC_MS_WH_RIGHT) {
+        report.v = code == KC_MS_WH_UP ? 1 : code == KC_MS_WH_DOWN ? -1 : 0;
+        report.h = code == KC_MS_WH_RIGHT ? 1 : code == KC_MS_WH_LEFT ? -1 : 0;
+    } else if (pressed && code <= KC_MS_RIGHT) {
+        report.x = code == KC_MS_RIGHT ? 8 : code == KC_MS_LEFT ? -8 : 0;  // mousekey's first step
+        report.y = code == KC_MS_DOWN ? 8 : code == KC_MS_UP ? -8 : 0;
+    } else if (!(code >= KC_MS_BTN1 && code <= KC_MS_BTN8)) {
+        return;
+    }
+    host_mouse_send(&report);
+}
+
+// ============================================
+// Register / unregister / tap
+// ============================================
+
+static uint16_t keycode_to_consumer(uint8_t code) {
+    static const uint16_t usages[] = {
+        0x00E2, 0x00E9, 0x00EA, 0x00B5, 0x00B6, 0x00B7, 0x00CD, 0x0183, 0x00B8, 0x018A, 0x0192, 0x0194, 0x0221, 0x0223, 0x0224,
+        0x0225, 0x0226, 0x0227, 0x022A, 0x00B3, 0x00B4, 0x006F, 0x0070, 0x019F, 0x01CB, 0x029F, 0x02A0,
+    };
+    return usages[code - KC_AUDIO_MUTE];
+}
+
+static uint16_t keycode_to_system(uint8_t code) {
+    return 0x81 + (code - KC_SYSTEM_POWER);  // Power down, sleep, wake up
+}
+
+void register_code(uint8_t code) {
+    if (code == KC_NO) {
+        return;
+    }
+    if (IS_BASIC_KEYCODE(code)) {
+        if (is_key_pressed(code)) {
+            del_key(code);  // A new press of a held key (QMK issue #1708)
+            send_keyboard_report();
+        }
+        add_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        add_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (IS_SYSTEM_KEYCODE(code)) {
+        host_system_send(keycode_to_system(code));
+    } else if (IS_CONSUMER_KEYCODE(code)) {
+        host_consumer_send(keycode_to_consumer(code));
+    } else if (IS_MOUSE_KEYCODE(code)) {
+        mousekey(code, true);
+    }
+}
+
+void unregister_code(uint8_t code) {
+    if (code == KC_NO) {
+        return;
+    }
+    if (IS_BASIC_KEYCODE(code)) {
+        del_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        del_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (IS_SYSTEM_KEYCODE(code)) {
+        host_system_send(0);
+    } else if (IS_CONSUMER_KEYCODE(code)) {
+        host_consumer_send(0);
+    } else if (IS_MOUSE_KEYCODE(code)) {
+        mousekey(code, false);
+    }
+}
+
+void tap_code_delay(uint8_t code, uint16_t delay) {
+    register_code(code);
+    wait_ms(delay);
+    unregister_code(code);
+}
+
+void tap_code(uint8_t code) {
+    tap_code_delay(code, code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+}
+
+// 5-bit keycode mods (right-hand flag + 4 bits) to report mods
+static uint8_t mod_config(uint8_t mods) {
+    return mods & 0x10 ? (mods & 0x0F) << 4 : mods & 0x0F;
+}
+
+void register_code16(uint16_t code) {
+    uint8_t mods = mod_config(QK_MODS_GET_MODS(code));
+    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+        add_mods(mods);
+    } else {
+        add_weak_mods(mods);
+    }
+    if (mods) {
+        send_keyboard_report();
+    }
+    register_code(code);
+}
+
+void unregister_code16(uint16_t code) {
+    unregister_code(code);
+    uint8_t mods = mod_config(QK_MODS_GET_MODS(code));
+    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+        del_mods(mods);
+    } else {
+        del_weak_mods(mods);
+    }
+    if (mods) {
+        send_keyboard_report();
+    }
+}
+
+void tap_code16_delay(uint16_t code, uint16_t delay) {
+    register_code16(code);
+    wait_ms(delay);
+    unregister_code16(code);
+}
+
+void tap_code16(uint16_t code) {
+    tap_code16_delay(code, code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+}
+
+void clear_keyboard(void) {
+    clear_mods();
+    clear_weak_mods();
+    clear_keys();
+    send_keyboard_report();
+    if (mouse_report.buttons) {
+        mouse_report.buttons = 0;
+        report_mouse_t report = mousekey_get_report();
+        host_mouse_send(&report);
+    }
+    host_system_send(0);
+    host_consumer_send(0);
+}
+
+// ============================================
+// SEND_STRING (US layout)
+// ============================================
+
+static uint8_t ascii_to_keycode(char c, bool *shifted) {
+    static const char    unshifted_sym[] = " -=[]\\;'`,./";
+    static const uint8_t unshifted_kc[]  = { KC_SPC, KC_MINS, KC_EQL, KC_LBRC, KC_RBRC, KC_BSLS, KC_SCLN, KC_QUOT, KC_GRV, KC_COMM, KC_DOT, KC_SLSH };
+    static const char    shifted_sym[]   = "_+{}|:\"~<>?!@#$%^&*()";
+    static const uint8_t shifted_kc[]    = { KC_MINS, KC_EQL, KC_LBRC, KC_RBRC, KC_BSLS, KC_SCLN, KC_QUOT, KC_GRV, KC_COMM, KC_DOT, KC_SLSH,
+                                             KC_1,    KC_2,   KC_3,    KC_4,    KC_5,    KC_6,    KC_7,    KC_8,   KC_9,    KC_0 };
+    *shifted = false;
+    if (c >= 'a' && c <= 'z') {
+        return KC_A + (c - 'a');
+    }
+    if (c >= 'A' && c <= 'Z') {
+        *shifted = true;
+        return KC_A + (c - 'A');
+    }
+    if (c >= '1' && c <= '9') {
+        return KC_1 + (c - '1');
+    }
+    switch (c) {
+        case '0':
+            return KC_0;
+        case '\b':
+            return KC_BSPC;
+        case '\t':
+            return KC_TAB;
+        case '\n':
+            return KC_ENT;
+        case 0x1B:
+            return KC_ESC;
+        case 0x7F:
+            return KC_DEL;
+    }
+    for (uint8_t i = 0; unshifted_sym[i]; i++) {
+        if (unshifted_sym[i] == c) {
+            return unshifted_kc[i];
+        }
+    }
+    for (uint8_t i = 0; shifted_sym[i]; i++) {
+        if (shifted_sym[i] == c) {
+            *shifted = true;
+            return shifted_kc[i];
+        }
+    }
+    return KC_NO;
+}
+
+static void send_char_with_delay(char ascii_code, uint8_t interval) {
+    bool    shifted;
+    uint8_t keycode = ascii_to_keycode(ascii_code, &shifted);
+    if (shifted) {
+        register_code(KC_LSFT);
+    }
+    tap_code_delay(keycode, interval);
+    if (shifted) {
+        unregister_code(KC_LSFT);
+    }
+}
+
+void send_char(char ascii_code) {
+    send_char_with_delay(ascii_code, TAP_CODE_DELAY);
+}
+
+void send_string_with_delay(const char *string, uint8_t interval) {
+    for (; *string; string++) {
+        if (*string == SS_QMK_PREFIX) {
+            char code = *++string;
+            if (code == SS_TAP_CODE) {
+                tap_code((uint8_t)*++string);
+            } else if (code == SS_DOWN_CODE) {
+                register_code((uint8_t)*++string);
+            } else if (code == SS_UP_CODE) {
+                unregister_code((uint8_t)*++string);
+            } else if (code == SS_DELAY_CODE) {
+                uint32_t ms = 0;
+                while (isdigit((unsigned char)string[1])) {
+                    ms = ms * 10 + (*++string - '0');
+                }
+                string++;  // '|'
+                wait_ms(ms);
+            }
+        } else {
+            send_char_with_delay(*string, interval);
+        }
+        wait_ms(interval);
+    }
+}
+
+void send_string(const char *string) {
+    send_string_with_delay(string, TAP_CODE_DELAY);
+}
+
+// ============================================
+// Tap dance (process_tap_dance.c)
+// ============================================
+
+#ifdef TAP_DANCE_ENABLE
+static uint16_t active_td;
+static uint16_t last_tap_time;
+
+void tap_dance_pair_on_each_tap(tap_dance_state_t *state, void *user_data) {
+    tap_dance_pair_t *pair = (tap_dance_pair_t *)user_data;
+    if (state->count == 2) {
+        register_code16(pair->kc2);
+        state->finished = true;
+    }
+}
+
+void tap_dance_pair_finished(tap_dance_state_t *state, void *user_data) {
+    register_code16(((tap_dance_pair_t *)user_data)->kc1);
+}
+
+void tap_dance_pair_reset(tap_dance_state_t *state, void *user_data) {
+    tap_dance_pair_t *pair = (tap_dance_pair_t *)user_data;
+    if (state->count == 1) {
+        wait_ms(TAP_CODE_DELAY);
+        unregister_code16(pair->kc1);
+    } else if (state->count == 2) {
+        unregister_code16(pair->kc2);
+    }
+}
+
+static void td_call(tap_dance_action_t *action, tap_dance_user_fn_t fn) {
+    if (fn) {
+        fn(&action->state, action->user_data);
+    }
+}
+
+static void td_reset(tap_dance_action_t *action) {
+    td_call(action, action->fn.on_reset);
+    del_weak_mods(action->state.weak_mods);
+    send_keyboard_report();
+    action->state = (tap_dance_state_t){ 0 };
+}
+
+static void td_finished(tap_dance_action_t *action) {
+    if (!action->state.finished) {
+        action->state.finished = true;
+        add_weak_mods(action->state.weak_mods);
+        send_keyboard_report();
+        td_call(action, action->fn.on_dance_finished);
+    }
+    active_td = 0;
+    if (!action->state.pressed) {
+        td_reset(action);  // No release event will come
+    }
+}
+
+static bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed || !active_td || keycode == active_td) {
+        return false;
+    }
+    tap_dance_action_t *action         = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(active_td)];
+    action->state.interrupted          = true;
+    action->state.interrupting_keycode = keycode;
+    td_finished(action);
+    clear_weak_mods();  // Left by the dance, not for the interrupting key
+    return true;
+}
+
+static bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
+    if (!IS_QK_TAP_DANCE(keycode)) {
+        return true;
+    }
+    uint16_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+    if (index >= tap_dance_count()) {
+        return false;
+    }
+    tap_dance_action_t *action = &tap_dance_actions[index];
+    action->state.pressed      = record->event.pressed;
+    if (record->event.pressed) {
+        last_tap_time = timer_read();
+        action->state.count++;
+        action->state.weak_mods = get_mods() | get_weak_mods();
+        td_call(action, action->fn.on_each_tap);
+        active_td = action->state.finished ? 0 : keycode;
+    } else {
+        td_call(action, action->fn.on_each_release);
+        if (action->state.finished) {
+            td_reset(action);
+            if (active_td == keycode) {
+                active_td = 0;
+            }
+        }
+    }
+    return false;
+}
+
+static void tap_dance_task(void) {
+    if (!active_td || timer_elapsed(last_tap_time) <= GET_TAPPING_TERM(active_td, &(keyrecord_t){})) {
+        return;
+    }
+    tap_dance_action_t *action = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(active_td)];
+    if (!action->state.interrupted) {
+        td_finished(action);
+    }
+}
+#endif
+
+// ============================================
+// Record pipeline (action.c / quantum.c)
+// ============================================
+
+static bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+#ifdef TAP_DANCE_ENABLE
+    if (preprocess_tap_dance(keycode, record)) {
+        keycode = get_record_keycode(record, true);  // The dance may have changed layers
+    }
+#endif
+    if (!(process_record_kb(keycode, record)
+#ifdef TAP_DANCE_ENABLE
+          && process_tap_dance(keycode, record)
+#endif
+              )) {
+        return false;
+    }
+    if (keycode >= QK_LIGHTING && keycode <= QK_LIGHTING_MAX) {
+        stats.lighting += record->event.pressed;
+        return false;
+    }
+    if (keycode >= QK_MAGIC && keycode <= QK_MAGIC_MAX) {
+        if (record->event.pressed) {
+            switch (keycode) {
+                case QK_MAGIC_NKRO_ON:
+                case QK_MAGIC_NKRO_OFF:
+                case QK_MAGIC_TOGGLE_NKRO:
+                    clear_keyboard();  // Keys held now would be released in the other report
+                    keymap_config.nkro = keycode == QK_MAGIC_TOGGLE_NKRO ? !keymap_config.nkro : keycode == QK_MAGIC_NKRO_ON;
+                    break;
+                default:
+                    unsupported(keycode);
+            }
+        }
+        return false;
+    }
+    if (keycode >= QK_QUANTUM && keycode <= QK_KB_MAX) {
+        if (record->event.pressed) {
+            unsupported(keycode);  // Bootloader, EEPROM clear, keyboard keycodes
+        }
+        return false;
+    }
+    return true;
+}
+
+void process_action(keyrecord_t *record, action_t action) {
+    uint16_t keycode = action.code;
+    bool     pressed = record->event.pressed;
+
+    if (keycode <= KC_TRNS || keycode >= QK_USER) {
+        return;  // User keycodes are the keymap's, handled or not
+    }
+    if (keycode <= QK_BASIC_MAX) {
+        if (pressed) {
+            register_code(keycode);
+        } else {
+            unregister_code(keycode);
+        }
+    } else if (IS_QK_MODS(keycode)) {
+        if (pressed) {
+            register_code16(keycode);
+        } else {
+            unregister_code16(keycode);
+        }
+    } else if (keycode >= QK_TO && keycode <= QK_TO_MAX) {
+        if (pressed) {
+            layer_move(QK_TO_GET_LAYER(keycode));
+        }
+    } else if (keycode >= QK_MOMENTARY && keycode <= QK_MOMENTARY_MAX) {
+        if (pressed) {
+            layer_on(QK_MOMENTARY_GET_LAYER(keycode));
+        } else {
+            layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+        }
+    } else if (keycode >= QK_DEF_LAYER && keycode <= QK_DEF_LAYER_MAX) {
+        if (pressed) {
+            default_layer_set((layer_state_t)1 << QK_DEF_LAYER_GET_LAYER(keycode));
+        }
+    } else if (keycode >= QK_TOGGLE_LAYER && keycode <= QK_TOGGLE_LAYER_MAX) {
+        if (!pressed) {
+            layer_invert(QK_TOGGLE_LAYER_GET_LAYER(keycode));  // TG acts on release
+        }
+    } else if (!IS_QK_TAP_DANCE(keycode) && pressed) {
+        unsupported(keycode);  // Tapping (LT/MT/TT), one-shot, LM
+    }
+}
+
+static void process_record(keyrecord_t *record) {
+    if (!process_record_quantum(record)) {
+        return;
+    }
+    uint16_t keycode = get_record_keycode(record, false);
+    process_action(record, action_for_keycode(keycode));
+    post_process_record_user(keycode, record);
+}
+
+void action_exec(keyevent_t event) {
+    if (IS_NOEVENT(event)) {
+        return;
+    }
+    if (event.pressed) {
+        clear_weak_mods();
+    }
+    keyrecord_t record = { .event = event };
+    if (!pre_process_record_kb(get_record_keycode(&record, true), &record)) {
+        return;
+    }
+    stats.events++;
+    process_record(&record);
+}
+
+// ============================================
+// Matrix: injected switch states, sym_defer_g debounce per half
+// ============================================
+
+static matrix_row_t raw[EMU_HALF_ROWS];        // Switches of this half, as injected
+static matrix_row_t debounced[EMU_HALF_ROWS];  // After debounce
+static matrix_row_t matrix[MATRIX_ROWS];       // Master: both halves; slave: its own rows
+static uint32_t     last_activity   = 0;
+static bool         debouncing      = false;
+static uint32_t     debounce_time   = 0;
+static int8_t       encoder_pending = 0;       // This half's detents not yet taken
+static int8_t       slave_steps     = 0;       // Master: the slave's detents from the last read
+
+uint32_t last_input_activity_elapsed(void) {
+    return timer_elapsed32(last_activity);
+}
+
+uint8_t emu_first_row(void) {
+    return is_keyboard_left() ? 0 : EMU_HALF_ROWS;
+}
+
+void emu_matrix_inject(uint8_t row, uint8_t col, bool pressed) {
+    uint8_t r = row - emu_first_row();
+    if (r >= EMU_HALF_ROWS || col >= MATRIX_COLS) {
+        return;
+    }
+    raw[r] = pressed ? raw[r] | (1 << col) : raw[r] & ~(1 << col);
+}
+
+void emu_encoder_inject(uint8_t index, bool clockwise) {
+    encoder_pending += clockwise ? 1 : -1;
+}
+
+matrix_row_t matrix_get_row(uint8_t row) {
+    return row < MATRIX_ROWS ? matrix[row] : 0;
+}
+
+bool matrix_is_on(uint8_t row, uint8_t col) {
+    return (matrix_get_row(row) >> col) & 1;
+}
+
+static void debounce(void) {
+    if (memcmp(raw, debounced, sizeof(raw)) != 0) {
+        static matrix_row_t last_raw[EMU_HALF_ROWS];
+        if (!debouncing || memcmp(raw, last_raw, sizeof(raw)) != 0) {
+            debouncing    = true;  // Any change restarts the wait for the whole half
+            debounce_time = timer_read32();
+            memcpy(last_raw, raw, sizeof(raw));
+        } else if (TIMER_DIFF_32(timer_read32(), debounce_time) >= DEBOUNCE) {
+            memcpy(debounced, raw, sizeof(raw));
+            debouncing = false;
+        }
+    } else {
+        debouncing = false;
+    }
+}
+
+void emu_slave_state_take(emu_slave_state_t *state) {
+    memcpy(state->rows, debounced, sizeof(state->rows));
+    state->encoder_steps = encoder_pending;
+    encoder_pending      = 0;
+}
+
+void emu_slave_state_apply(const emu_slave_state_t *state) {
+    memcpy(&matrix[is_keyboard_left() ? EMU_HALF_ROWS : 0], state->rows, sizeof(state->rows));
+    slave_steps += state->encoder_steps;
+}
+
+static void matrix_scan(void) {
+    debounce();
+    memcpy(&matrix[emu_first_row()], debounced, sizeof(debounced));
+    if (is_keyboard_master()) {
+        emu_slave_state_t state;
+        if (transaction_rpc_exec(EMU_TRANSACTION_SLAVE_STATE, 0, NULL, sizeof(state), &state)) {
+            emu_slave_state_apply(&state);
+        }
+    }
+}
+
+// keyboard.c matrix_task: key events on the master, reactive RGB hits on both halves
+static void matrix_task(void) {
+    static matrix_row_t previous[MATRIX_ROWS];
+    matrix_scan();
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t changed = matrix[row] ^ previous[row];
+        if (!changed) {
+            continue;
+        }
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!(changed & (1 << col))) {
+                continue;
+            }
+            bool pressed  = (matrix[row] >> col) & 1;
+            last_activity = timer_read32();
+            if (is_keyboard_master()) {
+                emu_out("event %llu %u %u %u", (unsigned long long)emu_now_us(), row, col, pressed);
+                action_exec(MAKE_KEYEVENT(row, col, pressed));
+            }
+            process_rgb_matrix(row, col, pressed);
+        }
+        previous[row] = matrix[row];
+    }
+}
+
+// ============================================
+// Encoders (encoder map: a tap per detent)
+// ============================================
+
+#ifdef ENCODER_MAP_ENABLE
+static void encoder_exec_mapping(uint8_t index, bool clockwise) {
+    last_activity = timer_read32();
+    emu_out("encoder %llu %u %u", (unsigned long long)emu_now_us(), index, clockwise);
+    action_exec(clockwise ? MAKE_ENCODER_CW_EVENT(index, true) : MAKE_ENCODER_CCW_EVENT(index, true));
+    wait_ms(ENCODER_MAP_KEY_DELAY);
+    action_exec(clockwise ? MAKE_ENCODER_CW_EVENT(index, false) : MAKE_ENCODER_CCW_EVENT(index, false));
+}
+
+static void encoder_steps(uint8_t index, int8_t steps) {
+    for (; steps > 0; steps--) {
+        encoder_exec_mapping(index, true);
+    }
+    for (; steps < 0; steps++) {
+        encoder_exec_mapping(index, false);
+    }
+}
+#endif
+
+static void encoder_task(void) {
+#ifdef ENCODER_MAP_ENABLE
+    if (!is_keyboard_master()) {
+        return;  // Taken by the master with the matrix
+    }
+    uint8_t own   = is_keyboard_left() ? 0 : 1;
+    int8_t  steps = encoder_pending;
+    encoder_pending = 0;
+    encoder_steps(own, steps);
+    steps       = slave_steps;
+    slave_steps = 0;
+    encoder_steps(1 - own, steps);
+#endif
+}
+
+// ============================================
+// RGB hits (no LEDs: counted and reported with their time)
+// ============================================
+
+void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
+    stats.rgb_hits++;
+    if (!is_keyboard_master()) {
+        emu_out("hit %llu %u %u %u", (unsigned long long)emu_now_us(), row, col, pressed);
+    }
+}
+
+// ============================================
+// Keyboard
+// ============================================
+
+static bool     os_reported = false;
+static uint64_t boot_us     = 0;
+
+os_variant_t detected_host_os(void) {
+    return os_reported ? emu_options.host_os : OS_UNSURE;
+}
+
+void emu_keyboard_init(void) {
+    boot_us            = emu_now_us();
+    keymap_config.nkro = emu_options.nkro;
+    eeconfig_init_user();  // Fresh EEPROM on every run
+    default_layer_set(1);
+    keyboard_post_init_kb();
+}
+
+void emu_keyboard_task(void) {
+    uint64_t start = emu_now_us();
+
+    matrix_task();
+#ifdef TAP_DANCE_ENABLE
+    if (is_keyboard_master()) {
+        tap_dance_task();
+    }
+#endif
+    encoder_task();
+    if (is_keyboard_master() && !os_reported && emu_options.host_os != OS_UNSURE && start - boot_us >= emu_options.host_os_ms * 1000ULL) {
+        os_reported = true;
+        process_detected_host_os_kb(emu_options.host_os);
+    }
+    housekeeping_task_kb();
+
+    uint32_t took = emu_now_us() - start;
+    stats.loops++;
+    stats.loop_us_sum += took;
+    if (took > stats.max_loop_us) {
+        stats.max_loop_us = took;
+    }
+}
+
+void emu_print_stats(void) {
+    emu_out("stats %s loops=%lu mean_loop_us=%.1f max_loop_us=%lu events=%lu rgb_hits=%lu unsupported=%lu lighting=%lu rollover=%lu eeprom_writes=%lu layers=0x%08lX",
+            is_keyboard_master() ? "master" : "slave", (unsigned long)stats.loops, stats.loops ? (double)stats.loop_us_sum / stats.loops : 0.0,
+            (unsigned long)stats.max_loop_us, (unsigned long)stats.events, (unsigned long)stats.rgb_hits, (unsigned long)stats.unsupported,
+            (unsigned long)stats.lighting, (unsigned long)stats.rollover, (unsigned long)ee_writes, (unsigned long)layer_state);
+}
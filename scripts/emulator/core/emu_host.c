@@ -0,0 +1,482 @@
+/* Emulated USB host - see emu.h
+ *
+ * Each IN endpoint (keyboard, mouse, extrakey, raw HID) has a queue of
+ * emu_options.ep_depth reports; the host takes one per endpoint every
+ * poll_us frame, as it polls a full-speed interrupt endpoint. A send to a
+ * full endpoint blocks until a frame frees a slot, as the firmware's wait
+ * for the USB driver does.
+ *
+ * Delivered reports become Linux input events in one of two ways:
+ *   - stream (default): decoded here with the kernel's hid-input tables and
+ *     printed with the frame time;
+ *   - --uinput: written to a virtual input device (vendor/product of the
+ *     Q11) through /dev/uinput, and read back from its /dev/input/event*
+ *     node with the kernel's CLOCK_MONOTONIC timestamps, so the latency
+ *     includes the input core. The node is grabbed (EVIOCGRAB) unless
+ *     --no-grab, so the run types into no window.
+ *
+ * Output lines: report (sent by the firmware), usb (taken by the host),
+ * input (evdev event: type code value).
+ */
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "emu.h"
+
+typedef enum {
+    EP_KEYBOARD,
+    EP_MOUSE,
+    EP_EXTRAKEY,
+    EP_RAW,
+    EP_COUNT,
+} endpoint_t;
+
+typedef enum {
+    REPORT_KEYBOARD,
+    REPORT_NKRO,
+    REPORT_MOUSE,
+    REPORT_SYSTEM,
+    REPORT_CONSUMER,
+    REPORT_RAW,
+} report_kind_t;
+
+static const char *const kind_names[] = { "keyboard", "nkro", "mouse", "system", "consumer", "raw" };
+
+#define MAX_DEPTH 32
+#define MAX_REPORT 32
+
+typedef struct {
+    report_kind_t kind;
+    uint8_t       len;
+    uint8_t       data[MAX_REPORT];
+    uint64_t      sent_us;
+} report_t;
+
+typedef struct {
+    report_t entries[MAX_DEPTH];
+    uint8_t  head;
+    uint8_t  count;
+} queue_t;
+
+static queue_t  queues[EP_COUNT];
+static uint64_t next_frame_us;
+static uint8_t  leds;
+static int      uinput_fd = -1;
+static int      event_fd  = -1;
+
+static struct {
+    uint32_t reports[EP_COUNT];
+    uint32_t blocked;     // Sends that waited for a free slot
+    uint64_t blocked_us;  // ... in total
+    uint32_t max_queued;
+    uint32_t events;
+} stats;
+
+// ============================================
+// Kernel tables (drivers/hid/hid-input.c)
+// ============================================
+
+#define UNK KEY_UNKNOWN
+
+static const uint16_t hid_keyboard[256] = {
+    0,   0,   0,   0,   30,  48,  46,  32,  18,  33,  34,  35,  23,  36,  37,  38,  50,  49,  24,  25,  16,  19,  31,  20,  22,  47,  17,  45,  21,  44,  2,   3,
+    4,   5,   6,   7,   8,   9,   10,  11,  28,  1,   14,  15,  57,  12,  13,  26,  27,  43,  43,  39,  40,  41,  51,  52,  53,  58,  59,  60,  61,  62,  63,  64,
+    65,  66,  67,  68,  87,  88,  99,  70,  119, 110, 102, 104, 111, 107, 109, 106, 105, 108, 103, 69,  98,  55,  74,  78,  96,  79,  80,  81,  75,  76,  77,  71,
+    72,  73,  82,  83,  86,  127, 116, 117, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 134, 138, 130, 132, 128, 129, 131, 137, 133, 135, 136, 113,
+    115, 114, UNK, UNK, UNK, 121, UNK, 89,  93,  124, 92,  94,  95,  UNK, UNK, UNK, 122, 123, 90,  91,  85,  UNK, UNK, UNK, UNK, UNK, UNK, UNK, 111, UNK, UNK, UNK,
+    UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, 179, 180, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK,
+    UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, 111, UNK, UNK, UNK, UNK, UNK, UNK, UNK,
+    29,  42,  56,  125, 97,  54,  100, 126, 164, 166, 165, 163, 161, 115, 114, 113, 150, 158, 159, 128, 136, 177, 178, 176, 142, 152, 173, 140, UNK, UNK, UNK, UNK,
+};
+
+// Consumer page usages QMK sends (report_extra_t usage) and their key codes
+static const struct {
+    uint16_t usage;
+    uint16_t key;
+} consumer_keys[] = {
+    { 0x00E2, KEY_MUTE },        { 0x00E9, KEY_VOLUMEUP },     { 0x00EA, KEY_VOLUMEDOWN },   { 0x00B5, KEY_NEXTSONG },    { 0x00B6, KEY_PREVIOUSSONG },
+    { 0x00B7, KEY_STOPCD },      { 0x00CD, KEY_PLAYPAUSE },    { 0x0183, KEY_CONFIG },       { 0x00B8, KEY_EJECTCD },     { 0x018A, KEY_MAIL },
+    { 0x0192, KEY_CALC },        { 0x0194, KEY_FILE },         { 0x0221, KEY_SEARCH },       { 0x0223, KEY_HOMEPAGE },    { 0x0224, KEY_BACK },
+    { 0x0225, KEY_FORWARD },     { 0x0226, KEY_STOP },         { 0x0227, KEY_REFRESH },      { 0x022A, KEY_BOOKMARKS },   { 0x00B3, KEY_FASTFORWARD },
+    { 0x00B4, KEY_REWIND },      { 0x006F, KEY_BRIGHTNESSUP }, { 0x0070, KEY_BRIGHTNESSDOWN }, { 0x019F, KEY_CONTROLPANEL }, { 0x01CB, KEY_ASSISTANT },
+    { 0x029F, KEY_SCALE },       { 0x02A0, KEY_ALL_APPLICATIONS },
+};
+
+static const uint16_t system_keys[] = { KEY_POWER, KEY_SLEEP, KEY_WAKEUP };  // Usages 0x81-0x83
+
+static const uint16_t mouse_buttons[] = { BTN_LEFT, BTN_RIGHT, BTN_MIDDLE, BTN_SIDE, BTN_EXTRA, BTN_FORWARD, BTN_BACK, BTN_TASK };
+
+static uint16_t consumer_key(uint16_t usage) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(consumer_keys); i++) {
+        if (consumer_keys[i].usage == usage) {
+            return consumer_keys[i].key;
+        }
+    }
+    return usage ? KEY_UNKNOWN : 0;
+}
+
+static uint16_t system_key(uint16_t usage) {
+    return usage >= 0x81 && usage <= 0x83 ? system_keys[usage - 0x81] : usage ? KEY_UNKNOWN : 0;
+}
+
+// ============================================
+// Events: decoded (stream) or through uinput
+// ============================================
+
+static void emit(uint64_t t, uint16_t type, uint16_t code, int32_t value) {
+    stats.events++;
+    if (uinput_fd < 0) {
+        emu_out("input %llu %u %u %d", (unsigned long long)t, type, code, value);
+        return;
+    }
+    struct input_event ev = { .type = type, .code = code, .value = value };
+    if (write(uinput_fd, &ev, sizeof(ev)) < 0) {
+        emu_console_printf("EMU: uinput write failed\n");
+    }
+}
+
+static void sync_report(void) {
+    if (uinput_fd >= 0) {
+        struct input_event ev = { .type = EV_SYN, .code = SYN_REPORT };
+        if (write(uinput_fd, &ev, sizeof(ev)) < 0) {
+            emu_console_printf("EMU: uinput write failed\n");
+        }
+    }
+}
+
+// Events of the input node, with the kernel's time: the end of the measured path
+static void read_events(void) {
+    if (event_fd < 0) {
+        return;
+    }
+    struct input_event ev;
+    while (read(event_fd, &ev, sizeof(ev)) == sizeof(ev)) {
+        if (ev.type != EV_KEY && ev.type != EV_REL) {
+            continue;
+        }
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        uint64_t now_ns   = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+        uint64_t event_ns = (uint64_t)ev.input_event_sec * 1000000000ULL + (uint64_t)ev.input_event_usec * 1000;
+        uint64_t t        = emu_now_us() - (now_ns - event_ns) / 1000;
+        emu_out("input %llu %u %u %d", (unsigned long long)t, ev.type, ev.code, ev.value);
+    }
+}
+
+// Key state of the keyboard endpoint as the host sees it, whichever report format
+static uint8_t host_keys[32];
+
+static void key_set(uint64_t t, uint8_t usage, bool down) {
+    bool was = host_keys[usage / 8] & (1 << (usage % 8));
+    if (was == down) {
+        return;
+    }
+    host_keys[usage / 8] ^= 1 << (usage % 8);
+    uint16_t code = hid_keyboard[usage];
+    if (code && code != KEY_UNKNOWN) {
+        emit(t, EV_KEY, code, down);
+    }
+}
+
+// hid-input order: the modifier bits, then the key array (releases before presses)
+static void decode_keyboard(uint64_t t, uint8_t mods, const uint8_t *down) {
+    for (uint8_t i = 0; i < 8; i++) {
+        key_set(t, 0xE0 + i, (mods >> i) & 1);
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint16_t usage = 4; usage < 0xE0; usage++) {
+            bool is_down = down[usage / 8] & (1 << (usage % 8));
+            if (is_down == (pass == 1)) {
+                key_set(t, usage, is_down);
+            }
+        }
+    }
+}
+
+static void deliver(const report_t *report, uint64_t t) {
+    char hex[2 * MAX_REPORT + 1];
+    for (uint8_t i = 0; i < report->len; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", report->data[i]);
+    }
+    emu_out("usb %llu %llu %s %s", (unsigned long long)report->sent_us, (unsigned long long)t, kind_names[report->kind], hex);
+
+    switch (report->kind) {
+        case REPORT_KEYBOARD: {
+            uint8_t down[32] = { 0 };
+            for (uint8_t i = 2; i < 2 + KEYBOARD_REPORT_KEYS; i++) {
+                uint8_t usage = report->data[i];
+                down[usage / 8] |= 1 << (usage % 8);
+            }
+            decode_keyboard(t, report->data[0], down);
+            break;
+        }
+        case REPORT_NKRO: {
+            uint8_t down[32] = { 0 };
+            memcpy(down, report->data + 2, NKRO_REPORT_BITS);
+            decode_keyboard(t, report->data[1], down);
+            break;
+        }
+        case REPORT_MOUSE: {
+            static uint8_t buttons;
+            uint8_t        changed = buttons ^ report->data[0];
+            for (uint8_t i = 0; i < 8; i++) {
+                if (changed & (1 << i)) {
+                    emit(t, EV_KEY, mouse_buttons[i], (report->data[0] >> i) & 1);
+                }
+            }
+            buttons = report->data[0];
+            const uint16_t axes[] = { REL_X, REL_Y, REL_WHEEL, REL_HWHEEL };
+            for (uint8_t i = 0; i < 4; i++) {
+                if (report->data[1 + i]) {
+                    emit(t, EV_REL, axes[i], (int8_t)report->data[1 + i]);
+                }
+            }
+            break;
+        }
+        case REPORT_SYSTEM:
+        case REPORT_CONSUMER: {
+            // One usage per report: the previous one is released by the next
+            static uint16_t last[2];
+            uint16_t       *held  = &last[report->kind == REPORT_CONSUMER];
+            uint16_t        usage = report->data[0] | report->data[1] << 8;
+            uint16_t (*key)(uint16_t) = report->kind == REPORT_CONSUMER ? consumer_key : system_key;
+            if (*held && *held != usage) {
+                emit(t, EV_KEY, key(*held), 0);
+            }
+            if (usage && usage != *held) {
+                emit(t, EV_KEY, key(usage), 1);
+            }
+            *held = usage;
+            break;
+        }
+        case REPORT_RAW:
+            return;  // Read by the companion app, not the input core
+    }
+    sync_report();
+}
+
+// ============================================
+// Endpoints
+// ============================================
+
+static void deliver_frame(uint64_t t) {
+    for (uint8_t ep = 0; ep < EP_COUNT; ep++) {
+        queue_t *q = &queues[ep];
+        if (q->count) {
+            deliver(&q->entries[q->head], t);
+            q->head = (q->head + 1) % MAX_DEPTH;
+            q->count--;
+        }
+    }
+}
+
+void emu_host_poll(void) {
+    uint64_t now = emu_now_us();
+    while (next_frame_us <= now) {
+        deliver_frame(next_frame_us);
+        next_frame_us += emu_options.poll_us;
+    }
+    read_events();
+}
+
+static void send_report(endpoint_t ep, report_kind_t kind, const void *data, uint8_t len) {
+    queue_t *q = &queues[ep];
+    emu_host_poll();
+    if (q->count >= emu_options.ep_depth) {
+        uint64_t start = emu_now_us();
+        stats.blocked++;
+        while (q->count >= emu_options.ep_depth) {
+            emu_sleep_until(next_frame_us);
+            emu_host_poll();
+        }
+        stats.blocked_us += emu_now_us() - start;
+    }
+    report_t *report = &q->entries[(q->head + q->count) % MAX_DEPTH];
+    report->kind     = kind;
+    report->len      = len;
+    report->sent_us  = emu_now_us();
+    memcpy(report->data, data, len);
+    q->count++;
+    stats.reports[ep]++;
+    if (q->count > stats.max_queued) {
+        stats.max_queued = q->count;
+    }
+
+    char hex[2 * MAX_REPORT + 1];
+    for (uint8_t i = 0; i < len; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", report->data[i]);
+    }
+    emu_out("report %llu %s %s", (unsigned long long)report->sent_us, kind_names[kind], hex);
+}
+
+void host_keyboard_send(report_keyboard_t *report) {
+    send_report(EP_KEYBOARD, REPORT_KEYBOARD, report, sizeof(*report));
+}
+
+void host_nkro_send(report_nkro_t *report) {
+    send_report(EP_KEYBOARD, REPORT_NKRO, report, sizeof(*report));
+}
+
+void host_mouse_send(report_mouse_t *report) {
+    send_report(EP_MOUSE, REPORT_MOUSE, report, sizeof(*report));
+}
+
+void host_system_send(uint16_t usage) {
+    static uint16_t last;
+    if (usage != last) {
+        last = usage;
+        send_report(EP_EXTRAKEY, REPORT_SYSTEM, &usage, sizeof(usage));
+    }
+}
+
+void host_consumer_send(uint16_t usage) {
+    static uint16_t last;
+    if (usage != last) {
+        last = usage;
+        send_report(EP_EXTRAKEY, REPORT_CONSUMER, &usage, sizeof(usage));
+    }
+}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    if (is_keyboard_master()) {
+        send_report(EP_RAW, REPORT_RAW, data, length < MAX_REPORT ? length : MAX_REPORT);
+    }
+}
+
+// Lock LEDs from the host (none in stream mode), or from the master via split_sync on the slave
+uint8_t host_keyboard_leds(void) {
+    return leds;
+}
+
+led_t host_keyboard_led_state(void) {
+    return (led_t){ .raw = leds };
+}
+
+void set_split_host_keyboard_leds(uint8_t led_state) {
+    leds = led_state;
+}
+
+// ============================================
+// uinput device
+// ============================================
+
+static int open_event_node(void) {
+    char sysname[64];
+    if (ioctl(uinput_fd, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0) {
+        return -1;
+    }
+    char dir_path[128];
+    snprintf(dir_path, sizeof(dir_path), "/sys/devices/virtual/input/%s", sysname);
+    // udev creates the node after the device: wait for it up to a second
+    for (int tries = 0; tries < 100; tries++) {
+        DIR *dir = opendir(dir_path);
+        if (dir) {
+            struct dirent *entry;
+            while ((entry = readdir(dir))) {
+                if (strncmp(entry->d_name, "event", 5) == 0) {
+                    char node[300];
+                    snprintf(node, sizeof(node), "/dev/input/%s", entry->d_name);
+                    int fd = open(node, O_RDONLY | O_NONBLOCK);
+                    if (fd >= 0) {
+                        closedir(dir);
+                        return fd;
+                    }
+                }
+            }
+            closedir(dir);
+        }
+        usleep(10000);
+    }
+    return -1;
+}
+
+static bool uinput_init(void) {
+    uinput_fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+    if (uinput_fd < 0) {
+        fprintf(stderr, "EMU: cannot open /dev/uinput (modprobe uinput, and write access to it)\n");
+        return false;
+    }
+    ioctl(uinput_fd, UI_SET_EVBIT, EV_KEY);
+    ioctl(uinput_fd, UI_SET_EVBIT, EV_REL);
+    for (uint16_t usage = 4; usage < 256; usage++) {
+        if (hid_keyboard[usage] && hid_keyboard[usage] != KEY_UNKNOWN) {
+            ioctl(uinput_fd, UI_SET_KEYBIT, hid_keyboard[usage]);
+        }
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(consumer_keys); i++) {
+        ioctl(uinput_fd, UI_SET_KEYBIT, consumer_keys[i].key);
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(system_keys); i++) {
+        ioctl(uinput_fd, UI_SET_KEYBIT, system_keys[i]);
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(mouse_buttons); i++) {
+        ioctl(uinput_fd, UI_SET_KEYBIT, mouse_buttons[i]);
+    }
+    ioctl(uinput_fd, UI_SET_RELBIT, REL_X);
+    ioctl(uinput_fd, UI_SET_RELBIT, REL_Y);
+    ioctl(uinput_fd, UI_SET_RELBIT, REL_WHEEL);
+    ioctl(uinput_fd, UI_SET_RELBIT, REL_HWHEEL);
+
+    struct uinput_setup setup = { .id = { .bustype = BUS_USB, .vendor = 0x3434, .product = 0x01E0, .version = 1 } };
+    snprintf(setup.name, UINPUT_MAX_NAME_SIZE, "Keychron Q11 (emulated)");
+    if (ioctl(uinput_fd, UI_DEV_SETUP, &setup) < 0 || ioctl(uinput_fd, UI_DEV_CREATE) < 0) {
+        fprintf(stderr, "EMU: uinput device setup failed\n");
+        return false;
+    }
+    event_fd = open_event_node();
+    if (event_fd < 0) {
+        fprintf(stderr, "EMU: no event node for the uinput device (udev running?)\n");
+        return false;
+    }
+    int clock = CLOCK_MONOTONIC;
+    ioctl(event_fd, EVIOCSCLOCKID, &clock);
+    if (emu_options.grab && ioctl(event_fd, EVIOCGRAB, 1) < 0) {
+        fprintf(stderr, "EMU: cannot grab the event node\n");
+        return false;
+    }
+    return true;
+}
+
+// ============================================
+// API
+// ============================================
+
+bool emu_host_init(void) {
+    next_frame_us = emu_now_us() + emu_options.poll_us;
+    if (emu_options.ep_depth < 1 || emu_options.ep_depth > MAX_DEPTH) {
+        emu_options.ep_depth = emu_options.ep_depth < 1 ? 1 : MAX_DEPTH;
+    }
+    return !emu_options.uinput || uinput_init();
+}
+
+void emu_host_finish(void) {
+    for (uint8_t ep = 0; ep < EP_COUNT; ep++) {
+        while (queues[ep].count) {
+            emu_sleep_until(next_frame_us);
+            emu_host_poll();
+        }
+    }
+    if (uinput_fd >= 0) {
+        emu_sleep_until(emu_now_us() + 20000);  // Last events through the input core
+        read_events();
+        if (event_fd >= 0) {
+            ioctl(event_fd, EVIOCGRAB, 0);
+            close(event_fd);
+        }
+        ioctl(uinput_fd, UI_DEV_DESTROY);
+        close(uinput_fd);
+    }
+}
+
+void emu_host_print_stats(void) {
+    emu_out("stats host mode=%s poll_us=%lu ep_depth=%u keyboard=%lu mouse=%lu extrakey=%lu raw=%lu blocked=%lu blocked_us=%llu max_queued=%lu events=%lu",
+            uinput_fd >= 0 ? "uinput" : "stream", (unsigned long)emu_options.poll_us, emu_options.ep_depth, (unsigned long)stats.reports[EP_KEYBOARD],
+            (unsigned long)stats.reports[EP_MOUSE], (unsigned long)stats.reports[EP_EXTRAKEY], (unsigned long)stats.reports[EP_RAW], (unsigned long)stats.blocked,
+            (unsigned long long)stats.blocked_us, (unsigned long)stats.max_queued, (unsigned long)stats.events);
+}
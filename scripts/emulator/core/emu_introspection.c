@@ -0,0 +1,75 @@
+/* Keymap introspection for the emulated core - see keymap_introspection.h
+ *
+ * As QMK's quantum/keymap_introspection.c: the keymap is compiled here
+ * (#include KEYMAP_C), so the array sizes are known. The lookups are weak:
+ * sparse_keymap.c and key_remap.c replace them as they do in the firmware.
+ */
+#include KEYMAP_C
+
+#include "keymap_introspection.h"
+
+// ============================================
+// Keymaps
+// ============================================
+
+__attribute__((weak)) uint8_t keymap_layer_count(void) {
+    return ARRAY_SIZE(keymaps);
+}
+
+__attribute__((weak)) uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column) {
+    if (layer_num < ARRAY_SIZE(keymaps) && row < MATRIX_ROWS && column < MATRIX_COLS) {
+        return pgm_read_word(&keymaps[layer_num][row][column]);
+    }
+    return KC_TRNS;
+}
+
+__attribute__((weak)) uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return keycode_at_keymap_location_raw(layer_num, row, column);
+}
+
+// ============================================
+// Encoder map
+// ============================================
+
+#ifdef ENCODER_MAP_ENABLE
+__attribute__((weak)) uint8_t encodermap_layer_count(void) {
+    return ARRAY_SIZE(encoder_map);
+}
+
+__attribute__((weak)) uint16_t keycode_at_encodermap_location_raw(uint8_t layer_num, uint8_t encoder_idx, bool clockwise) {
+    if (layer_num < ARRAY_SIZE(encoder_map) && encoder_idx < NUM_ENCODERS) {
+        return pgm_read_word(&encoder_map[layer_num][encoder_idx][clockwise ? 0 : 1]);
+    }
+    return KC_TRNS;
+}
+
+__attribute__((weak)) uint16_t keycode_at_encodermap_location(uint8_t layer_num, uint8_t encoder_idx, bool clockwise) {
+    return keycode_at_encodermap_location_raw(layer_num, encoder_idx, clockwise);
+}
+#endif
+
+// keymap_common.c: matrix positions, then the encoder key locations
+__attribute__((weak)) uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        return keycode_at_keymap_location(layer, key.row, key.col);
+    }
+#ifdef ENCODER_MAP_ENABLE
+    if (key.row == KEYLOC_ENCODER_CW && key.col < NUM_ENCODERS) {
+        return keycode_at_encodermap_location(layer, key.col, true);
+    }
+    if (key.row == KEYLOC_ENCODER_CCW && key.col < NUM_ENCODERS) {
+        return keycode_at_encodermap_location(layer, key.col, false);
+    }
+#endif
+    return KC_NO;
+}
+
+// ============================================
+// Tap dance
+// ============================================
+
+#ifdef TAP_DANCE_ENABLE
+uint16_t tap_dance_count(void) {
+    return ARRAY_SIZE(tap_dance_actions);
+}
+#endif
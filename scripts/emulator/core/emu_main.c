@@ -0,0 +1,343 @@
+/* Emulator entry point - see scripts/emulator/emulate.js
+ *
+ *   emu [options] <script>   run both halves on the script's key events
+ *   emu --keys               dump the keymap and encoder map as keycodes
+ *
+ * The script has one event per line, at microseconds from the start:
+ *   <t_us> press <row> <col>
+ *   <t_us> release <row> <col>
+ *   <t_us> encoder <index> cw|ccw
+ *   <t_us> end
+ *
+ * The process forks: the parent is the master (left half, USB), the child
+ * the slave (right half); each applies the script events of its own rows
+ * and encoder at their time, and runs its own main loop. Output is one
+ * line per record on stdout (both halves, written whole):
+ *   inject  <t> <row> <col> <pressed> | inject <t> encoder <index> <cw>
+ *   event   <t> <row> <col> <pressed>    master: the key reached action_exec
+ *   encoder <t> <index> <cw>             master: an encoder detent's tap
+ *   hit     <t> <row> <col> <pressed>    slave: a reactive RGB hit
+ *   report / usb / input                 see emu_host.c
+ *   stats   <who> key=value...
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "emu.h"
+#include "keymap_introspection.h"
+
+emu_options_t emu_options = {
+    .master     = true,
+    .grab       = true,
+    .loop_us    = 100,
+    .poll_us    = 1000,
+    .ep_depth   = 4,
+    .baud       = 921600,
+    .host_os    = OS_MACOS,
+    .host_os_ms = 50,
+};
+
+typedef enum {
+    SCRIPT_PRESS,
+    SCRIPT_RELEASE,
+    SCRIPT_ENCODER,
+    SCRIPT_END,
+} script_kind_t;
+
+typedef struct {
+    uint64_t      t_us;
+    script_kind_t kind;
+    uint8_t       a;  // Row, or encoder index
+    uint8_t       b;  // Column, or clockwise
+} script_event_t;
+
+static script_event_t *script;
+static size_t          script_len;
+static size_t          script_next;
+
+// ============================================
+// Script
+// ============================================
+
+static bool read_script(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "EMU: cannot open %s\n", path);
+        return false;
+    }
+    size_t cap = 1024;
+    script     = malloc(cap * sizeof(*script));
+    char line[128];
+    for (unsigned n = 1; fgets(line, sizeof(line), file); n++) {
+        unsigned long long t;
+        char               kind[16], dir[8];
+        unsigned           a = 0, b = 0;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%llu %15s", &t, kind) != 2) {
+            fprintf(stderr, "EMU: %s:%u: expected '<t_us> <event> ...'\n", path, n);
+            fclose(file);
+            return false;
+        }
+        script_event_t event = { .t_us = t };
+        if (strcmp(kind, "press") == 0 || strcmp(kind, "release") == 0) {
+            if (sscanf(line, "%*u %*s %u %u", &a, &b) != 2 || a >= MATRIX_ROWS || b >= MATRIX_COLS) {
+                fprintf(stderr, "EMU: %s:%u: bad key position\n", path, n);
+                fclose(file);
+                return false;
+            }
+            event.kind = kind[0] == 'p' ? SCRIPT_PRESS : SCRIPT_RELEASE;
+        } else if (strcmp(kind, "encoder") == 0) {
+            if (sscanf(line, "%*u %*s %u %7s", &a, dir) != 2 || a >= NUM_ENCODERS || (strcmp(dir, "cw") && strcmp(dir, "ccw"))) {
+                fprintf(stderr, "EMU: %s:%u: expected 'encoder <index> cw|ccw'\n", path, n);
+                fclose(file);
+                return false;
+            }
+            event.kind = SCRIPT_ENCODER;
+            b          = strcmp(dir, "cw") == 0;
+        } else if (strcmp(kind, "end") == 0) {
+            event.kind = SCRIPT_END;
+        } else {
+            fprintf(stderr, "EMU: %s:%u: unknown event '%s'\n", path, n, kind);
+            fclose(file);
+            return false;
+        }
+        event.a = a;
+        event.b = b;
+        if (script_len == cap) {
+            cap *= 2;
+            script = realloc(script, cap * sizeof(*script));
+        }
+        if (script_len && event.t_us < script[script_len - 1].t_us) {
+            fprintf(stderr, "EMU: %s:%u: events out of order\n", path, n);
+            fclose(file);
+            return false;
+        }
+        script[script_len++] = event;
+    }
+    fclose(file);
+    if (!script_len || script[script_len - 1].kind != SCRIPT_END) {
+        fprintf(stderr, "EMU: %s: the script must finish with an 'end' event\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool own_event(const script_event_t *event) {
+    switch (event->kind) {
+        case SCRIPT_PRESS:
+        case SCRIPT_RELEASE:
+            return event->a >= emu_first_row() && event->a < emu_first_row() + EMU_HALF_ROWS;
+        case SCRIPT_ENCODER:
+            return event->a == (is_keyboard_left() ? 0 : 1);
+        default:
+            return false;
+    }
+}
+
+// Applies the events due; false once the end is reached
+static bool apply_script(void) {
+    uint64_t now = emu_now_us();
+    while (script_next < script_len && script[script_next].t_us <= now) {
+        const script_event_t *event = &script[script_next++];
+        if (event->kind == SCRIPT_END) {
+            return false;
+        }
+        if (!own_event(event)) {
+            continue;
+        }
+        if (event->kind == SCRIPT_ENCODER) {
+            emu_out("inject %llu encoder %u %u", (unsigned long long)now, event->a, event->b);
+            emu_encoder_inject(event->a, event->b);
+        } else {
+            emu_out("inject %llu %u %u %u", (unsigned long long)now, event->a, event->b, event->kind == SCRIPT_PRESS);
+            emu_matrix_inject(event->a, event->b, event->kind == SCRIPT_PRESS);
+        }
+    }
+    return true;
+}
+
+static uint64_t next_script_us(void) {
+    return script_next < script_len ? script[script_next].t_us : UINT64_MAX;
+}
+
+// ============================================
+// Halves
+// ============================================
+
+static int run_master(pid_t slave) {
+    if (!emu_host_init()) {
+        emu_split_close();
+        waitpid(slave, NULL, 0);
+        return 1;
+    }
+    emu_keyboard_init();
+    while (apply_script()) {
+        uint64_t start = emu_now_us();
+        emu_keyboard_task();
+        emu_host_poll();
+        emu_sleep_until(start + emu_options.loop_us);
+    }
+    emu_split_close();
+    emu_host_finish();
+    waitpid(slave, NULL, 0);  // Its stats first: the reader takes the master's as the last lines
+    emu_print_stats();
+    emu_split_print_stats();
+    emu_host_print_stats();
+    return 0;
+}
+
+static int run_slave(void) {
+    emu_keyboard_init();
+    while (!emu_split_closed()) {
+        uint64_t now     = emu_now_us();
+        uint64_t next    = next_script_us();
+        uint32_t timeout = next <= now ? 0 : next - now < 200 ? next - now : 200;
+        emu_split_serve(timeout);
+        apply_script();
+        emu_keyboard_task();
+    }
+    emu_print_stats();
+    emu_split_print_stats();
+    return 0;
+}
+
+// ============================================
+// Keymap dump (--keys)
+// ============================================
+
+static int dump_keys(void) {
+    emu_keyboard_init();
+    emu_out("layers %u", keymap_layer_count());
+    for (uint8_t layer = 0; layer < keymap_layer_count(); layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                uint16_t keycode = keymap_key_to_keycode(layer, MAKE_KEYPOS(row, col));
+                if (keycode != KC_NO) {
+                    emu_out("key %u %u %u %u", layer, row, col, keycode);
+                }
+            }
+        }
+#ifdef ENCODER_MAP_ENABLE
+        for (uint8_t index = 0; index < NUM_ENCODERS; index++) {
+            emu_out("encoder %u %u %u %u", layer, index, keymap_key_to_keycode(layer, MAKE_KEYPOS(KEYLOC_ENCODER_CW, index)),
+                    keymap_key_to_keycode(layer, MAKE_KEYPOS(KEYLOC_ENCODER_CCW, index)));
+        }
+#endif
+    }
+    return 0;
+}
+
+// ============================================
+// Main
+// ============================================
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: emu [options] <script>\n"
+            "       emu --keys\n"
+            "  --console          firmware uprintf to stderr\n"
+            "  --uinput           virtual input device through /dev/uinput\n"
+            "  --no-grab          leave the uinput device's events to the desktop\n"
+            "  --nkro             NKRO report at boot\n"
+            "  --loop-us N        shortest main loop pass (default 100)\n"
+            "  --poll-us N        USB polling interval (default 1000)\n"
+            "  --ep-depth N       reports queued per endpoint (default 4)\n"
+            "  --baud N           split link rate (default 921600)\n"
+            "  --host-os OS       none|linux|windows|macos|ios (default macos)\n"
+            "  --host-os-ms N     OS detection time after boot (default 50)\n");
+}
+
+static bool parse_os(const char *name, os_variant_t *os) {
+    static const char *const names[] = { "none", "linux", "windows", "macos", "ios" };
+    for (uint8_t i = 0; i < ARRAY_SIZE(names); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *os = (os_variant_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    bool        keys = false;
+    for (int i = 1; i < argc; i++) {
+        const char *arg  = argv[i];
+        const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--console") == 0) {
+            emu_options.console = true;
+        } else if (strcmp(arg, "--uinput") == 0) {
+            emu_options.uinput = true;
+        } else if (strcmp(arg, "--no-grab") == 0) {
+            emu_options.grab = false;
+        } else if (strcmp(arg, "--nkro") == 0) {
+            emu_options.nkro = true;
+        } else if (strcmp(arg, "--keys") == 0) {
+            keys = true;
+        } else if (next && strcmp(arg, "--loop-us") == 0) {
+            emu_options.loop_us = strtoul(argv[++i], NULL, 0);
+        } else if (next && strcmp(arg, "--poll-us") == 0) {
+            emu_options.poll_us = strtoul(argv[++i], NULL, 0);
+        } else if (next && strcmp(arg, "--ep-depth") == 0) {
+            emu_options.ep_depth = strtoul(argv[++i], NULL, 0);
+        } else if (next && strcmp(arg, "--baud") == 0) {
+            emu_options.baud = strtoul(argv[++i], NULL, 0);
+        } else if (next && strcmp(arg, "--host-os") == 0) {
+            if (!parse_os(argv[++i], &emu_options.host_os)) {
+                usage();
+                return 2;
+            }
+        } else if (next && strcmp(arg, "--host-os-ms") == 0) {
+            emu_options.host_os_ms = strtoul(argv[++i], NULL, 0);
+        } else if (arg[0] != '-' && !path) {
+            path = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!emu_options.poll_us || !emu_options.baud) {
+        usage();
+        return 2;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    emu_set_epoch((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+    if (keys) {
+        return dump_keys();
+    }
+    if (!path) {
+        usage();
+        return 2;
+    }
+    if (!read_script(path)) {
+        return 1;
+    }
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) < 0) {
+        perror("EMU: socketpair");
+        return 1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("EMU: fork");
+        return 1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        emu_options.master = false;
+        emu_split_init(fds[1]);
+        return run_slave();
+    }
+    close(fds[1]);
+    emu_split_init(fds[0]);
+    return run_master(pid);
+}
@@ -0,0 +1,387 @@
+/* Emulated QMK core for running the j-custom firmware on Linux
+ *
+ * The QMK_KEYBOARD_H of the emulator (scripts/emulator/emulate.js): the part
+ * of quantum.h that keymap.c and its modules use, with QMK's keycode values,
+ * event and record types, and the same processing order (pre_process_record,
+ * process_record_kb/user, tap dance, process_action). Reports go to the
+ * emulated USB host (emu_host.c), split transactions to the other half's
+ * process (emu_split.c). Hardware (LED drivers, USART, DWT) is not emulated;
+ * the modules that drive it are left out of the build.
+ *
+ * Built with -include emu_config.h (generated: keymap config.h, the
+ * LAYOUT macro and the matrix size from info.json, then post_config.h).
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "emu_keycodes.h"
+
+// ============================================
+// Platform
+// ============================================
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define memcpy_P(dst, src, n) memcpy(dst, src, n)
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#define TIMER_DIFF(a, b, max) ((max == UINT8_MAX) ? ((uint8_t)((a) - (b))) : ((max == UINT16_MAX) ? ((uint16_t)((a) - (b))) : ((uint32_t)((a) - (b)))))
+#define TIMER_DIFF_8(a, b) TIMER_DIFF(a, b, UINT8_MAX)
+#define TIMER_DIFF_16(a, b) TIMER_DIFF(a, b, UINT16_MAX)
+#define TIMER_DIFF_32(a, b) TIMER_DIFF(a, b, UINT32_MAX)
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+uint32_t last_input_activity_elapsed(void);  // Since the last matrix change or encoder detent
+void     wait_ms(uint32_t ms);
+void     wait_us(uint32_t us);
+
+#ifndef TAP_CODE_DELAY
+#    define TAP_CODE_DELAY 0
+#endif
+#ifndef TAP_HOLD_CAPS_DELAY
+#    define TAP_HOLD_CAPS_DELAY 80
+#endif
+#ifndef TAPPING_TERM
+#    define TAPPING_TERM 200
+#endif
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+#ifndef ENCODER_MAP_KEY_DELAY
+#    define ENCODER_MAP_KEY_DELAY TAP_CODE_DELAY
+#endif
+#ifndef RPC_M2S_BUFFER_SIZE
+#    define RPC_M2S_BUFFER_SIZE 32
+#endif
+#ifndef RPC_S2M_BUFFER_SIZE
+#    define RPC_S2M_BUFFER_SIZE 32
+#endif
+
+// Console: uprintf goes to stderr when the emulator runs with --console
+int  emu_console_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+#define uprintf(...) emu_console_printf(__VA_ARGS__)
+#define dprintf(...) emu_console_printf(__VA_ARGS__)
+#define print(s) emu_console_printf("%s", s)
+
+// ============================================
+// Matrix and events
+// ============================================
+
+typedef uint16_t matrix_row_t;
+
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef enum {
+    TICK_EVENT           = 0,
+    KEY_EVENT            = 1,
+    ENCODER_CW_EVENT     = 2,
+    ENCODER_CCW_EVENT    = 3,
+    COMBO_EVENT          = 4,
+    DIP_SWITCH_ON_EVENT  = 5,
+    DIP_SWITCH_OFF_EVENT = 6,
+} keyevent_type_t;
+
+typedef struct {
+    keypos_t        key;
+    uint16_t        time;
+    keyevent_type_t type;
+    bool            pressed;
+} keyevent_t;
+
+typedef struct {
+    bool    interrupted : 1;
+    bool    reserved2 : 1;
+    bool    reserved1 : 1;
+    bool    reserved0 : 1;
+    uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+    keyevent_t event;
+    tap_t      tap;
+} keyrecord_t;
+
+#define KEYLOC_ENCODER_CW 253
+#define KEYLOC_ENCODER_CCW 252
+#define NUM_DIRECTIONS 2
+#define ENCODER_CCW_CW(ccw, cw) \
+    { (cw), (ccw) }
+
+#define MAKE_KEYPOS(row_num, col_num) ((keypos_t){.row = (row_num), .col = (col_num)})
+#define MAKE_EVENT(row_num, col_num, press, event_type) ((keyevent_t){.key = MAKE_KEYPOS((row_num), (col_num)), .pressed = (press), .time = timer_read(), .type = (event_type)})
+#define MAKE_KEYEVENT(row_num, col_num, press) MAKE_EVENT((row_num), (col_num), (press), KEY_EVENT)
+#define MAKE_ENCODER_CW_EVENT(enc_id, press) MAKE_EVENT(KEYLOC_ENCODER_CW, (enc_id), (press), ENCODER_CW_EVENT)
+#define MAKE_ENCODER_CCW_EVENT(enc_id, press) MAKE_EVENT(KEYLOC_ENCODER_CCW, (enc_id), (press), ENCODER_CCW_EVENT)
+#define IS_NOEVENT(event) ((event).type == TICK_EVENT)
+#define IS_EVENT(event) ((event).type != TICK_EVENT)
+
+matrix_row_t matrix_get_row(uint8_t row);
+bool         matrix_is_on(uint8_t row, uint8_t col);
+
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+#ifdef ENCODER_MAP_ENABLE
+extern const uint16_t encoder_map[][NUM_ENCODERS][NUM_DIRECTIONS];
+#endif
+
+// ============================================
+// Actions and layers
+// ============================================
+
+// The emulated core's actions are keycodes: process_action() dispatches on the keycode ranges
+typedef struct {
+    uint16_t code;
+} action_t;
+
+typedef uint32_t layer_state_t;
+#define MAX_LAYER 32
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+void          layer_clear(void);
+void          layer_move(uint8_t layer);
+void          layer_on(uint8_t layer);
+void          layer_off(uint8_t layer);
+void          layer_invert(uint8_t layer);
+void          layer_state_set(layer_state_t state);
+bool          layer_state_is(uint8_t layer);
+bool          layer_state_cmp(layer_state_t state, uint8_t layer);
+uint8_t       get_highest_layer(layer_state_t state);
+void          default_layer_set(layer_state_t state);
+layer_state_t layer_state_set_user(layer_state_t state);
+layer_state_t default_layer_state_set_user(layer_state_t state);
+#define IS_LAYER_ON(layer) layer_state_is(layer)
+#define IS_LAYER_OFF(layer) (!layer_state_is(layer))
+
+void     action_exec(keyevent_t event);
+action_t action_for_keycode(uint16_t keycode);
+void     process_action(keyrecord_t *record, action_t action);
+uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+void     clear_keyboard(void);
+
+// Hooks: weak in the emulated core, as in QMK
+bool pre_process_record_kb(uint16_t keycode, keyrecord_t *record);
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record);
+bool process_record_kb(uint16_t keycode, keyrecord_t *record);
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
+void post_process_record_user(uint16_t keycode, keyrecord_t *record);
+void keyboard_post_init_kb(void);
+void keyboard_post_init_user(void);
+void housekeeping_task_kb(void);
+void housekeeping_task_user(void);
+void eeconfig_init_user(void);
+bool dip_switch_update_kb(uint8_t index, bool active);
+bool dip_switch_update_user(uint8_t index, bool active);
+void suspend_power_down_user(void);
+void suspend_wakeup_init_user(void);
+
+// ============================================
+// Keys, mods and reports
+// ============================================
+
+#define KEYBOARD_REPORT_KEYS 6
+#define NKRO_REPORT_BITS 30
+
+typedef struct {
+    uint8_t mods;
+    uint8_t reserved;
+    uint8_t keys[KEYBOARD_REPORT_KEYS];
+} report_keyboard_t;
+
+typedef struct {
+    uint8_t report_id;
+    uint8_t mods;
+    uint8_t bits[NKRO_REPORT_BITS];
+} report_nkro_t;
+
+typedef struct {
+    uint8_t buttons;
+    int8_t  x;
+    int8_t  y;
+    int8_t  v;
+    int8_t  h;
+} report_mouse_t;
+
+typedef union {
+    uint8_t raw;
+    struct {
+        bool    num_lock : 1;
+        bool    caps_lock : 1;
+        bool    scroll_lock : 1;
+        bool    compose : 1;
+        bool    kana : 1;
+        uint8_t reserved : 3;
+    };
+} led_t;
+
+void register_code(uint8_t code);
+void unregister_code(uint8_t code);
+void tap_code(uint8_t code);
+void tap_code_delay(uint8_t code, uint16_t delay);
+void register_code16(uint16_t code);
+void unregister_code16(uint16_t code);
+void tap_code16(uint16_t code);
+void tap_code16_delay(uint16_t code, uint16_t delay);
+
+uint8_t get_mods(void);
+void    add_mods(uint8_t mods);
+void    del_mods(uint8_t mods);
+void    set_mods(uint8_t mods);
+void    clear_mods(void);
+uint8_t get_weak_mods(void);
+void    add_weak_mods(uint8_t mods);
+void    del_weak_mods(uint8_t mods);
+void    clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+void    send_keyboard_report(void);
+
+void           host_keyboard_send(report_keyboard_t *report);
+void           host_nkro_send(report_nkro_t *report);
+void           host_mouse_send(report_mouse_t *report);
+void           host_consumer_send(uint16_t usage);
+void           host_system_send(uint16_t usage);
+uint8_t        host_keyboard_leds(void);
+led_t          host_keyboard_led_state(void);
+report_mouse_t mousekey_get_report(void);
+
+typedef union {
+    uint16_t raw;
+    struct {
+        bool nkro : 1;
+    };
+} keymap_config_t;
+
+extern keymap_config_t keymap_config;
+
+// ============================================
+// SEND_STRING
+// ============================================
+
+#define SS_QMK_PREFIX 1
+#define SS_TAP_CODE 1
+#define SS_DOWN_CODE 2
+#define SS_UP_CODE 3
+#define SS_DELAY_CODE 4
+
+#define STRINGIZE(z) #z
+#define ADD_SLASH_X(y) STRINGIZE(\x##y)
+#define SS_TAP(keycode) "\1\1" ADD_SLASH_X(keycode)
+#define SS_DOWN(keycode) "\1\2" ADD_SLASH_X(keycode)
+#define SS_UP(keycode) "\1\3" ADD_SLASH_X(keycode)
+#define SS_DELAY(msecs) "\1\4" #msecs "|"
+#define SS_LCTL(string) SS_DOWN(X_LCTL) string SS_UP(X_LCTL)
+#define SS_LSFT(string) SS_DOWN(X_LSFT) string SS_UP(X_LSFT)
+#define SS_LALT(string) SS_DOWN(X_LALT) string SS_UP(X_LALT)
+#define SS_LGUI(string) SS_DOWN(X_LGUI) string SS_UP(X_LGUI)
+#define SS_LCMD(string) SS_LGUI(string)
+
+void send_string(const char *string);
+void send_string_with_delay(const char *string, uint8_t interval);
+void send_char(char ascii_code);
+#define SEND_STRING(string) send_string(PSTR(string))
+#define SEND_STRING_DELAY(string, interval) send_string_with_delay(PSTR(string), interval)
+
+// ============================================
+// Tap dance
+// ============================================
+
+typedef struct {
+    uint16_t interrupting_keycode;
+    uint8_t  count;
+    uint8_t  weak_mods;
+    uint8_t  oneshot_mods;
+    bool     pressed : 1;
+    bool     finished : 1;
+    bool     interrupted : 1;
+} tap_dance_state_t;
+
+typedef void (*tap_dance_user_fn_t)(tap_dance_state_t *state, void *user_data);
+
+typedef struct {
+    tap_dance_state_t state;
+    struct {
+        tap_dance_user_fn_t on_each_tap;
+        tap_dance_user_fn_t on_dance_finished;
+        tap_dance_user_fn_t on_reset;
+        tap_dance_user_fn_t on_each_release;
+    } fn;
+    void *user_data;
+} tap_dance_action_t;
+
+typedef struct {
+    uint16_t kc1;
+    uint16_t kc2;
+} tap_dance_pair_t;
+
+void tap_dance_pair_on_each_tap(tap_dance_state_t *state, void *user_data);
+void tap_dance_pair_finished(tap_dance_state_t *state, void *user_data);
+void tap_dance_pair_reset(tap_dance_state_t *state, void *user_data);
+
+#define ACTION_TAP_DANCE_DOUBLE(kc1, kc2) \
+    { .fn = {tap_dance_pair_on_each_tap, tap_dance_pair_finished, tap_dance_pair_reset, NULL}, .user_data = (void *)&((tap_dance_pair_t){kc1, kc2}), }
+#define ACTION_TAP_DANCE_FN(user_fn) \
+    { .fn = {NULL, user_fn, NULL, NULL}, .user_data = NULL, }
+#define ACTION_TAP_DANCE_FN_ADVANCED(user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset) \
+    { .fn = {user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset, NULL}, .user_data = NULL, }
+
+extern tap_dance_action_t tap_dance_actions[];
+uint16_t                  get_tapping_term(uint16_t keycode, keyrecord_t *record);
+
+// ============================================
+// EEPROM (in RAM, fresh per run)
+// ============================================
+
+uint32_t eeconfig_read_user(void);
+void     eeconfig_update_user(uint32_t val);
+void     eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length);
+void     eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length);
+
+// ============================================
+// Split
+// ============================================
+
+#define SPLIT_KEYBOARD
+
+typedef void (*slave_callback_t)(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+bool is_keyboard_master(void);
+bool is_keyboard_left(void);
+bool is_transport_connected(void);
+void set_split_host_keyboard_leds(uint8_t led_state);
+
+// ============================================
+// OS detection, raw HID, RGB hits
+// ============================================
+
+typedef enum {
+    OS_UNSURE,
+    OS_LINUX,
+    OS_WINDOWS,
+    OS_MACOS,
+    OS_IOS,
+} os_variant_t;
+
+bool         process_detected_host_os_kb(os_variant_t detected_os);
+bool         process_detected_host_os_user(os_variant_t detected_os);
+os_variant_t detected_host_os(void);
+
+void raw_hid_send(uint8_t *data, uint8_t length);
+void raw_hid_receive(uint8_t *data, uint8_t length);
+
+// Key hits for the reactive effects; recorded with their time (no LEDs here)
+void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed);
@@ -0,0 +1,195 @@
+/* Emulated split link - see transactions.h
+ *
+ * The halves are two processes joined by a SOCK_SEQPACKET socketpair: one
+ * packet per transaction each way, so framing comes for free. The master
+ * blocks in transaction_rpc_exec() as it does on the USART, and sleeps out
+ * the wire time of the request and reply at the emulated baud rate (10 bits
+ * per byte, two header bytes) when the socket was quicker. A transaction
+ * without a reply in EMU_SPLIT_TIMEOUT_US fails; EMU_SPLIT_MAX_ERRORS in a
+ * row mark the link disconnected until the next success, as QMK's
+ * SPLIT_MAX_CONNECTION_ERRORS does.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "emu.h"
+#include "transactions.h"
+
+#ifndef EMU_SPLIT_TIMEOUT_US
+#    define EMU_SPLIT_TIMEOUT_US 20000
+#endif
+#ifndef EMU_SPLIT_MAX_ERRORS
+#    define EMU_SPLIT_MAX_ERRORS 10
+#endif
+
+#define HEADER_SIZE 3  // id, request size, reply size
+#define PACKET_SIZE (HEADER_SIZE + 255)
+
+static int              fd = -1;
+static bool             closed;
+static uint8_t          errors;
+static slave_callback_t callbacks[NUM_TOTAL_TRANSACTIONS];
+
+static struct {
+    uint32_t transactions;
+    uint32_t failures;
+    uint64_t bytes;
+    uint64_t wire_us;   // Emulated transfer time
+    uint64_t round_us;  // Request to reply, wire time included
+    uint32_t max_round_us;
+} stats;
+
+// ============================================
+// Roles
+// ============================================
+
+bool is_keyboard_master(void) {
+    return emu_options.master;
+}
+
+// The USB side is the left half (MASTER_LEFT)
+bool is_keyboard_left(void) {
+    return emu_options.master;
+}
+
+bool is_transport_connected(void) {
+    return errors < EMU_SPLIT_MAX_ERRORS;
+}
+
+// ============================================
+// Slave: callbacks
+// ============================================
+
+static void slave_state_handler(uint8_t in_len, const void *in, uint8_t out_len, void *out) {
+    if (out_len == sizeof(emu_slave_state_t)) {
+        emu_slave_state_take(out);
+    }
+}
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback) {
+    if (transaction_id >= 0 && transaction_id < NUM_TOTAL_TRANSACTIONS) {
+        callbacks[transaction_id] = callback;
+    }
+}
+
+void emu_split_init(int socket_fd) {
+    fd = socket_fd;
+    if (!is_keyboard_master()) {
+        transaction_register_rpc(EMU_TRANSACTION_SLAVE_STATE, slave_state_handler);
+    }
+}
+
+void emu_split_serve(uint32_t timeout_us) {
+    struct pollfd   pfd     = { .fd = fd, .events = POLLIN };
+    struct timespec timeout = { .tv_sec = timeout_us / 1000000, .tv_nsec = (timeout_us % 1000000) * 1000 };
+    // Every request waiting, then back to the main loop
+    while (!closed && ppoll(&pfd, 1, &timeout, NULL) > 0) {
+        uint8_t packet[PACKET_SIZE];
+        ssize_t n = recv(fd, packet, sizeof(packet), 0);
+        if (n <= 0) {
+            closed = n == 0 || errno != EINTR;
+            return;
+        }
+        uint8_t id = packet[0], in_len = packet[1], out_len = packet[2];
+        uint8_t reply[PACKET_SIZE] = { id, out_len };
+        if (n != HEADER_SIZE + in_len || id >= NUM_TOTAL_TRANSACTIONS || !callbacks[id]) {
+            reply[1] = 0;  // No handler: an empty reply fails the transaction on the master
+            out_len  = 0;
+        } else {
+            callbacks[id](in_len, packet + HEADER_SIZE, out_len, reply + 2);
+        }
+        if (send(fd, reply, 2 + out_len, 0) < 0) {
+            closed = true;
+        }
+        stats.transactions++;
+        stats.bytes += 2 + in_len + out_len;
+        timeout = (struct timespec){ 0 };
+    }
+}
+
+bool emu_split_closed(void) {
+    return closed;
+}
+
+// ============================================
+// Master: transactions
+// ============================================
+
+static bool fail(void) {
+    stats.failures++;
+    if (errors < EMU_SPLIT_MAX_ERRORS) {
+        errors++;
+    }
+    return false;
+}
+
+bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    if (!is_keyboard_master() || closed || transaction_id < 0 || transaction_id >= NUM_TOTAL_TRANSACTIONS) {
+        return false;
+    }
+    uint64_t start   = emu_now_us();
+    uint32_t bytes   = 2 + initiator2target_buffer_size + target2initiator_buffer_size;
+    uint32_t wire_us = (uint64_t)bytes * 10 * 1000000 / emu_options.baud;
+    stats.transactions++;
+
+    uint8_t packet[PACKET_SIZE] = { transaction_id, initiator2target_buffer_size, target2initiator_buffer_size };
+    if (initiator2target_buffer_size) {
+        memcpy(packet + HEADER_SIZE, initiator2target_buffer, initiator2target_buffer_size);
+    }
+    if (send(fd, packet, HEADER_SIZE + initiator2target_buffer_size, 0) < 0) {
+        closed = true;
+        return fail();
+    }
+
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    uint8_t       reply[PACKET_SIZE];
+    ssize_t       n = -1;
+    if (poll(&pfd, 1, EMU_SPLIT_TIMEOUT_US / 1000) > 0) {
+        n = recv(fd, reply, sizeof(reply), 0);
+    }
+    emu_sleep_until(start + wire_us);  // No faster than the USART
+    stats.bytes += bytes;
+    stats.wire_us += wire_us;
+    if (n != 2 + target2initiator_buffer_size || reply[0] != (uint8_t)transaction_id || reply[1] != target2initiator_buffer_size) {
+        return fail();
+    }
+    if (target2initiator_buffer_size) {
+        memcpy(target2initiator_buffer, reply + 2, target2initiator_buffer_size);
+    }
+    uint32_t round_us = emu_now_us() - start;
+    stats.round_us += round_us;
+    if (round_us > stats.max_round_us) {
+        stats.max_round_us = round_us;
+    }
+    errors = 0;
+    return true;
+}
+
+bool transaction_rpc_send(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer) {
+    return transaction_rpc_exec(transaction_id, initiator2target_buffer_size, initiator2target_buffer, 0, NULL);
+}
+
+bool transaction_rpc_recv(int8_t transaction_id, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    return transaction_rpc_exec(transaction_id, 0, NULL, target2initiator_buffer_size, target2initiator_buffer);
+}
+
+void emu_split_close(void) {
+    if (fd >= 0) {
+        shutdown(fd, SHUT_RDWR);
+        close(fd);
+        fd = -1;
+    }
+    closed = true;
+}
+
+void emu_split_print_stats(void) {
+    uint32_t ok = stats.transactions - stats.failures;
+    emu_out("stats link side=%s transactions=%lu failures=%lu bytes=%llu baud=%lu wire_us=%llu mean_round_us=%.1f max_round_us=%lu",
+            is_keyboard_master() ? "master" : "slave", (unsigned long)stats.transactions, (unsigned long)stats.failures,
+            (unsigned long long)stats.bytes, (unsigned long)emu_options.baud, (unsigned long long)stats.wire_us,
+            ok ? (double)stats.round_us / ok : 0.0, (unsigned long)stats.max_round_us);
+}
@@ -0,0 +1,16 @@
+/* keymap_introspection.h for the emulated core (emu_introspection.c) */
+#pragma once
+
+#include "emu_quantum.h"
+
+uint8_t  keymap_layer_count(void);
+uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column);
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column);
+
+#ifdef ENCODER_MAP_ENABLE
+uint8_t  encodermap_layer_count(void);
+uint16_t keycode_at_encodermap_location_raw(uint8_t layer_num, uint8_t encoder_idx, bool clockwise);
+uint16_t keycode_at_encodermap_location(uint8_t layer_num, uint8_t encoder_idx, bool clockwise);
+#endif
+
+uint16_t tap_dance_count(void);
@@ -0,0 +1,4 @@
+/* os_detection.h for the emulated core: the result comes from --host-os (see emu_main.c) */
+#pragma once
+
+#include "emu_quantum.h"
@@ -0,0 +1,4 @@
+/* raw_hid.h for the emulated core: raw_hid_send() is counted by the emulated host */
+#pragma once
+
+#include "emu_quantum.h"
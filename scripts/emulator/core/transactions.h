@@ -0,0 +1,17 @@
+/* transactions.h for the emulated core: RPCs to the other half's process (emu_split.c) */
+#pragma once
+
+#include "emu_quantum.h"
+
+enum serial_transaction_id {
+    EMU_TRANSACTION_SLAVE_STATE,  // Slave matrix and encoder steps, every master scan
+#ifdef SPLIT_TRANSACTION_IDS_USER
+    SPLIT_TRANSACTION_IDS_USER,
+#endif
+    NUM_TOTAL_TRANSACTIONS
+};
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
+bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+bool transaction_rpc_send(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer);
+bool transaction_rpc_recv(int8_t transaction_id, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
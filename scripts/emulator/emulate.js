@@ -0,0 +1,676 @@
+#!/usr/bin/env node
+
+//
+// Firmware emulator: both halves of the j-custom firmware on Linux
+//
+// Compiles keymap.c and its modules against the emulated QMK core in core/
+// (keycodes, record pipeline, tap dance, SEND_STRING, debounce, encoder map,
+// split transactions, USB endpoints), as two processes joined by a socket
+// for the split link, and drives them with scripted key and encoder events.
+// The master's reports go to an emulated USB host that polls the endpoints
+// once per frame and turns them into Linux input events: decoded with the
+// kernel's hid-input tables (default), or through a uinput device whose
+// event node is read back (--uinput; needs write access to /dev/uinput).
+//
+// The modules that drive hardware are left out of the build (USART, LED
+// driver, DWT, USB suspend: see HARDWARE); the others run unchanged.
+//
+// Scenarios:
+//   latency   isolated taps on both halves: key to input event, per stage
+//             (scan and debounce, split transport, firmware, USB, input)
+//   typing    text at --wpm with rollover: the decoded text must match
+//   macros    typing with app launcher sequences (K+L chord, then keys):
+//             the shortcuts of app_leader.json must come out in order
+//   encoder   typing with encoder spins on both halves: every detent must
+//             give its volume key or zoom shortcut
+//   all       each of the above (default)
+//
+// Usage: node scripts/emulator/emulate.js [options]
+//
+// Options:
+//   --scenario <name>  latency, typing, macros, encoder or all (default: all)
+//   --taps <n>         Taps per half for latency (default: 200)
+//   --wpm <n>          Typing speed (default: 150)
+//   --text <string>    Text to type (default: a built-in paragraph)
+//   --detent-ms <ms>   Time between encoder detents in a spin (default: 8)
+//   --seed <n>         Timing jitter seed (default: 1)
+//   --poll-us <us>     USB polling interval (default: 1000)
+//   --ep-depth <n>     Reports queued per endpoint (default: 4)
+//   --baud <n>         Split link rate (default: SERIAL_USART_SPEED of config.h)
+//   --loop-us <us>     Shortest main loop pass (default: 100)
+//   --nkro             NKRO keyboard report instead of 6KRO
+//   --uinput           Virtual input device through /dev/uinput
+//   --no-grab          Do not grab the uinput device (its keys reach the desktop)
+//   --console          Firmware console output (uprintf) on stderr
+//   --json             Print the results as JSON instead of a table
+//
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const { readLayout } = require('../rgb-preview/rgb-preview.js');
+
+const REPO_DIR = path.resolve(__dirname, '..', '..');
+const CORE_DIR = path.join(__dirname, 'core');
+const BUILD_DIR = path.join(REPO_DIR, '.build', 'emulator');
+const KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+
+// Modules left out of the emulator build, and what they drive
+const HARDWARE = {
+  SPLIT_LINK_ENABLE: 'USART driver rate switching',
+  SPLIT_HEALTH_ENABLE: 'USART error events, reset flags, DWT',
+  LED_LIMIT_ENABLE: 'SNLED27351 LED driver',
+  FAST_RESUME_ENABLE: 'USB suspend and the LED drivers',
+  PROFILER_ENABLE: 'DWT cycle counter',
+};
+
+// info.json features → QMK defines
+const INFO_FEATURES = {
+  dip_switch: 'DIP_SWITCH_ENABLE',
+  encoder: 'ENCODER_ENABLE',
+  extrakey: 'EXTRAKEY_ENABLE',
+  mousekey: 'MOUSEKEY_ENABLE',
+  nkro: 'NKRO_ENABLE',
+  rgb_matrix: 'RGB_MATRIX_ENABLE',
+};
+
+const DEFAULT_TEXT = 'The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs! ' +
+  'How vexingly quick daft zebras jump; "sphinx of black quartz, judge my vow" (42 times, 7/8 of 100%).';
+
+// ============================================
+// Keys: QMK keycode (= HID usage), evdev code, US characters
+// ============================================
+
+const KEYS = [];
+const KEY_BY_KC = new Map();
+const KEY_BY_EVDEV = new Map();
+const KEY_BY_CHAR = new Map();
+
+function key(name, kc, evdev, char, shifted) {
+  const entry = { name, kc, evdev, char, shifted };
+  KEYS.push(entry);
+  KEY_BY_KC.set(kc, entry);
+  KEY_BY_EVDEV.set(evdev, entry);
+  if (char !== undefined) KEY_BY_CHAR.set(char, { ...entry, shift: false });
+  if (shifted !== undefined) KEY_BY_CHAR.set(shifted, { ...entry, shift: true });
+}
+
+[30, 48, 46, 32, 18, 33, 34, 35, 23, 36, 37, 38, 50, 49, 24, 25, 16, 19, 31, 20, 22, 47, 17, 45, 21, 44].forEach((evdev, i) => {
+  const c = String.fromCharCode(97 + i);
+  key(c.toUpperCase(), 0x04 + i, evdev, c, c.toUpperCase());
+});
+'1234567890'.split('').forEach((c, i) => key(c, 0x1E + i, 2 + i, c, '!@#$%^&*()'[i]));
+key('ENTER', 0x28, 28, '\n');
+key('ESCAPE', 0x29, 1);
+key('BACKSPACE', 0x2A, 14);
+key('TAB', 0x2B, 15, '\t');
+key('SPACE', 0x2C, 57, ' ');
+[['MINUS', '-', '_', 12], ['EQUAL', '=', '+', 13], ['LEFTBRACE', '[', '{', 26], ['RIGHTBRACE', ']', '}', 27],
+  ['BACKSLASH', '\\', '|', 43], [null], ['SEMICOLON', ';', ':', 39], ['APOSTROPHE', '\'', '"', 40], ['GRAVE', '`', '~', 41],
+  ['COMMA', ',', '<', 51], ['DOT', '.', '>', 52], ['SLASH', '/', '?', 53]].forEach(([name, c, s, evdev], i) => {
+  if (name) key(name, 0x2D + i, evdev, c, s);
+});
+key('RIGHT', 0x4F, 106);
+key('LEFT', 0x50, 105);
+key('DOWN', 0x51, 108);
+key('UP', 0x52, 103);
+['LCTL', 'LSFT', 'LALT', 'LGUI', 'RCTL', 'RSFT', 'RALT', 'RGUI'].forEach((name, i) => {
+  key(name, 0xE0 + i, [29, 42, 56, 125, 97, 54, 100, 126][i]);
+});
+// Consumer keys: evdev only (their QMK keycodes are not usages)
+KEY_BY_EVDEV.set(113, { name: 'MUTE' });
+KEY_BY_EVDEV.set(114, { name: 'VOLUMEDOWN' });
+KEY_BY_EVDEV.set(115, { name: 'VOLUMEUP' });
+
+const MODIFIERS = new Set(['LCTL', 'LSFT', 'LALT', 'LGUI', 'RCTL', 'RSFT', 'RALT', 'RGUI']);
+const SHORTCUT_MODS = ['LCTL', 'LALT', 'LGUI', 'RCTL', 'RALT', 'RGUI'];
+
+// QMK modifier wrappers (LAG(kc) etc.) → modifier names
+const MOD_MACROS = {
+  LCTL: ['LCTL'], LSFT: ['LSFT'], LALT: ['LALT'], LGUI: ['LGUI'], LCMD: ['LGUI'], LOPT: ['LALT'],
+  LCS: ['LCTL', 'LSFT'], LCA: ['LCTL', 'LALT'], LCG: ['LCTL', 'LGUI'], LSA: ['LSFT', 'LALT'], LSG: ['LSFT', 'LGUI'],
+  LAG: ['LALT', 'LGUI'], LCSG: ['LCTL', 'LSFT', 'LGUI'], LCAG: ['LCTL', 'LALT', 'LGUI'], LSAG: ['LSFT', 'LALT', 'LGUI'],
+  MEH: ['LCTL', 'LSFT', 'LALT'], HYPR: ['LCTL', 'LSFT', 'LALT', 'LGUI'],
+};
+
+// QMK basic keycode names used in keymap.c's shortcut #defines
+const KC_NAMES = {
+  KC_ESC: 'ESCAPE', KC_GRV: 'GRAVE', KC_SPC: 'SPACE', KC_MINS: 'MINUS', KC_EQL: 'EQUAL', KC_ENT: 'ENTER',
+  KC_LBRC: 'LEFTBRACE', KC_RBRC: 'RIGHTBRACE', KC_SCLN: 'SEMICOLON', KC_QUOT: 'APOSTROPHE', KC_COMM: 'COMMA',
+  KC_DOT: 'DOT', KC_SLSH: 'SLASH', KC_BSLS: 'BACKSLASH', KC_TAB: 'TAB', KC_BSPC: 'BACKSPACE',
+};
+
+function shortcutToken(mods, name) {
+  return [...new Set(mods)].sort().concat(name).join('+');
+}
+
+// #define KC_FOO LAG(KC_Z) → 'LALT+LGUI+Z'
+function readShortcuts() {
+  const source = fs.readFileSync(path.join(KEYMAP_DIR, 'keymap.c'), 'utf8');
+  const shortcuts = {};
+  for (const m of source.matchAll(/^#define\s+(KC_\w+)\s+([A-Z]+)\((KC_\w+)\)/gm)) {
+    const mods = MOD_MACROS[m[2]];
+    const basic = KC_NAMES[m[3]] || m[3].replace(/^KC_/, '');
+    if (mods && KEYS.some(k => k.name === basic)) shortcuts[m[1]] = shortcutToken(mods, basic);
+  }
+  return shortcuts;
+}
+
+// ============================================
+// Build
+// ============================================
+
+// rules.mk as make would read it: assignments, and ifeq ($(strip $(X)), yes) blocks
+function readRules() {
+  const vars = {};
+  const defines = new Set();
+  const sources = [];
+  const stack = [];
+  const active = () => stack.every(Boolean);
+  for (const raw of fs.readFileSync(path.join(KEYMAP_DIR, 'rules.mk'), 'utf8').split('\n')) {
+    const line = raw.replace(/#.*/, '').trim();
+    if (!line) continue;
+    let m;
+    if ((m = line.match(/^ifeq\s*\(\$\(strip \$\((\w+)\)\),\s*(\w+)\)$/))) {
+      stack.push(active() && vars[m[1]] === m[2]);
+    } else if (line === 'endif') {
+      stack.pop();
+    } else if (!active()) {
+      continue;
+    } else if ((m = line.match(/^(\w+)\s*(\+?=)\s*(.*)$/))) {
+      const [, name, op, value] = m;
+      if (HARDWARE[name] && value === 'yes') continue;  // Left out: stays unset
+      if (name === 'OPT_DEFS') {
+        for (const d of value.split(/\s+/)) defines.add(d.replace(/^-D/, ''));
+      } else if (name === 'SRC') {
+        sources.push(...value.split(/\s+/));
+      } else {
+        vars[name] = op === '+=' && vars[name] ? `${vars[name]} ${value}` : value;
+      }
+    }
+  }
+  for (const [name, value] of Object.entries(vars)) {
+    if (/_ENABLE$/.test(name) && value === 'yes') defines.add(name);
+  }
+  const info = JSON.parse(fs.readFileSync(path.join(KEYMAP_DIR, '../../../info.json'), 'utf8'));
+  for (const [feature, define] of Object.entries(INFO_FEATURES)) {
+    if ((info.features || {})[feature]) defines.add(define);
+  }
+  return { defines: [...defines].sort(), sources };
+}
+
+function configHeader(layout) {
+  const { keys, rows, cols, layoutName } = layout;
+  const args = keys.map((k, i) => `k${i}`);
+  const grid = Array.from({ length: rows }, () => Array(cols).fill('KC_NO'));
+  keys.forEach((k, i) => {
+    grid[k.matrix[0]][k.matrix[1]] = args[i];
+  });
+  return [
+    '// Generated by scripts/emulator/emulate.js from info.json, config.h and post_config.h',
+    '#pragma once',
+    '',
+    `#define MATRIX_ROWS ${rows}`,
+    `#define MATRIX_COLS ${cols}`,
+    '#define NUM_ENCODERS 2',
+    '',
+    `#define ${layoutName}(${args.join(', ')}) { \\`,
+    ...grid.map(row => `    { ${row.join(', ')} }, \\`),
+    '}',
+    '',
+    `#include "${path.join(KEYMAP_DIR, 'config.h')}"`,
+    `#include "${path.join(KEYMAP_DIR, 'post_config.h')}"`,
+    '',
+  ].join('\n');
+}
+
+// Boot rate of the split link from config.h (QMK's default otherwise)
+function defaultBaud() {
+  const config = fs.readFileSync(path.join(KEYMAP_DIR, 'config.h'), 'utf8');
+  const m = config.match(/#\s*define\s+SERIAL_USART_SPEED\s+(\d+)/);
+  return m ? Number(m[1]) : 921600;
+}
+
+function build() {
+  const rules = readRules();
+  const binary = path.join(BUILD_DIR, 'emu');
+  const config = path.join(BUILD_DIR, 'emu_config.h');
+  fs.mkdirSync(BUILD_DIR, { recursive: true });
+  fs.writeFileSync(config, configHeader(readLayout()));
+  const core = fs.readdirSync(CORE_DIR).filter(f => f.endsWith('.c')).map(f => path.join(CORE_DIR, f));
+  execFileSync(process.env.CC || 'cc', ['-O2', '-std=gnu11', '-Wall', '-Wno-unused-function', '-Wno-unused-variable',
+    `-I${CORE_DIR}`, `-I${KEYMAP_DIR}`, '-include', config,
+    '-DQMK_KEYBOARD_H="emu_quantum.h"', `-DKEYMAP_C="${path.join(KEYMAP_DIR, 'keymap.c')}"`,
+    ...rules.defines.map(d => `-D${d}`), '-o', binary, ...core,
+    ...rules.sources.map(s => path.join(KEYMAP_DIR, s))], { stdio: ['ignore', 'inherit', 'inherit'] });
+  return { binary, rules };
+}
+
+// Keycodes of every layer as the firmware resolves them (key_remap, sparse keymap)
+function readKeymap(binary) {
+  const keymap = { layers: [], encoders: [] };
+  for (const line of execFileSync(binary, ['--keys']).toString().trim().split('\n')) {
+    const f = line.split(' ');
+    const [layer, a, b, c] = f.slice(1).map(Number);
+    if (f[0] === 'key') {
+      (keymap.layers[layer] = keymap.layers[layer] || []).push({ row: a, col: b, kc: c });
+    } else if (f[0] === 'encoder') {
+      (keymap.encoders[layer] = keymap.encoders[layer] || [])[a] = { cw: b, ccw: c };
+    }
+  }
+  return keymap;
+}
+
+// ============================================
+// Scripts
+// ============================================
+
+// Deterministic jitter (mulberry32)
+function random(seed) {
+  let s = seed >>> 0;
+  return () => {
+    s = (s + 0x6D2B79F5) >>> 0;
+    let t = s;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+const BOOT_MS = 300;  // OS detection and the modules' first passes before any key
+
+class Script {
+  constructor() {
+    this.events = [];
+    this.expected = [];  // Text characters and shortcut tokens, in order
+  }
+
+  add(t, line) {
+    this.events.push({ t: Math.round(t * 1000), line });
+  }
+
+  tap(pos, down, up) {
+    this.add(down, `press ${pos.row} ${pos.col}`);
+    this.add(up, `release ${pos.row} ${pos.col}`);
+  }
+
+  text() {
+    const sorted = [...this.events].sort((a, b) => a.t - b.t);
+    const end = sorted.length ? sorted[sorted.length - 1].t + 300000 : 300000;
+    return `${sorted.map(e => `${e.t} ${e.line}`).join('\n')}\n${end} end\n`;
+  }
+}
+
+// Base layer positions of the characters and of left shift
+function basePositions(keymap) {
+  const positions = new Map();
+  for (const k of keymap.layers[0] || []) {
+    if (!positions.has(k.kc)) positions.set(k.kc, k);
+  }
+  const find = kc => {
+    const pos = positions.get(kc);
+    if (!pos) throw new Error(`no key for keycode 0x${kc.toString(16)} on the base layer`);
+    return pos;
+  };
+  return { find, shift: find(0xE1) };
+}
+
+// Types text from time t at options.wpm: rollover between keys, shift held around shifted ones
+function typeText(script, base, text, t, options, rand) {
+  const interval = 60000 / (options.wpm * 5);
+  const chars = text.split('');
+  const times = [];
+  for (let i = 0; i < chars.length; i++) {
+    times.push(t);
+    t += interval * (0.75 + rand() * 0.5);
+  }
+  chars.forEach((c, i) => {
+    const entry = KEY_BY_CHAR.get(c);
+    if (!entry) throw new Error(`cannot type ${JSON.stringify(c)}`);
+    const pos = base.find(entry.kc);
+    const down = times[i];
+    const next = i + 1 < times.length ? times[i + 1] : down + interval;
+    const following = i + 1 < chars.length ? KEY_BY_CHAR.get(chars[i + 1]) : null;
+    let up = down + interval * (0.8 + rand() * 0.5);  // Usually still down at the next press
+    // Released before the next press when that is the same key, or shift changes (away from its debounce)
+    if (entry.shift || (following && (following.shift || following.kc === entry.kc))) up = Math.min(up, next - 14);
+    // Shift held across a run of shifted characters
+    if (entry.shift && !(i > 0 && KEY_BY_CHAR.get(chars[i - 1]).shift)) {
+      script.add(down - 12, `press ${base.shift.row} ${base.shift.col}`);
+    }
+    if (entry.shift && !(following && following.shift)) {
+      script.add(up + 2, `release ${base.shift.row} ${base.shift.col}`);
+    }
+    script.tap(pos, down, up);
+    script.expected.push(c);
+  });
+  return t;
+}
+
+function latencyScript(keymap, options, rand) {
+  const script = new Script();
+  const base = basePositions(keymap);
+  // One letter per half, neither of them a chord key (those wait up to CHORD_TERM for a partner)
+  const keys = [base.find(KEY_BY_CHAR.get('e').kc), base.find(KEY_BY_CHAR.get('i').kc)];
+  let t = BOOT_MS;
+  for (let i = 0; i < options.taps * 2; i++) {
+    const pos = keys[i % 2];
+    script.tap(pos, t, t + 30);
+    script.expected.push(i % 2 ? 'i' : 'e');
+    t += 180 + rand() * 20;  // Past CHORD_IDLE_MS, at a random scan and USB frame phase
+  }
+  return script;
+}
+
+function typingScript(keymap, options, rand) {
+  const script = new Script();
+  typeText(script, basePositions(keymap), options.text, BOOT_MS, options, rand);
+  return script;
+}
+
+// Text, then an app launcher sequence after each sentence
+function macrosScript(keymap, options, rand) {
+  const script = new Script();
+  const base = basePositions(keymap);
+  const shortcuts = readShortcuts();
+  const leader = JSON.parse(fs.readFileSync(path.join(KEYMAP_DIR, 'app_leader.json'), 'utf8')).sequences
+    .filter(s => shortcuts[s.keycode]);
+  const k = base.find(KEY_BY_CHAR.get('k').kc);
+  const l = base.find(KEY_BY_CHAR.get('l').kc);
+  const sentences = options.text.match(/[^.!;]+[.!;]?\s*/g) || [options.text];
+  let t = BOOT_MS;
+  sentences.forEach((sentence, i) => {
+    t = typeText(script, base, sentence, t, options, rand) + 300;  // Quiet for the chord
+    const sequence = leader[i % leader.length];
+    script.tap(k, t, t + 60);
+    script.tap(l, t + 8, t + 62);
+    t += 150;
+    for (const c of sequence.keys) {
+      script.tap(base.find(KEY_BY_CHAR.get(c).kc), t, t + 50);
+      t += 120;
+    }
+    script.expected.push({ token: shortcuts[sequence.keycode], label: sequence.label });
+    t += 200;
+  });
+  return script;
+}
+
+// Text with spins of both encoders in between the words
+function encoderScript(keymap, options, rand) {
+  const script = new Script();
+  const base = basePositions(keymap);
+  const shortcuts = readShortcuts();
+  const tokens = [
+    { cw: 'VOLUMEUP', ccw: 'VOLUMEDOWN' },
+    { cw: shortcuts.KC_ZOOM_IN, ccw: shortcuts.KC_ZOOM_OUT },
+  ];
+  const words = options.text.match(/\S+\s*/g) || [];
+  let t = BOOT_MS;
+  words.forEach((word, i) => {
+    t = typeText(script, base, word, t, options, rand);
+    if (i % 3 !== 2) return;
+    const index = (i / 3 | 0) % 2;
+    const cw = rand() < 0.5;
+    const detents = 3 + Math.floor(rand() * 10);
+    for (let d = 0; d < detents; d++) {
+      script.add(t + d * options.detentMs, `encoder ${index} ${cw ? 'cw' : 'ccw'}`);
+      script.expected.push({ token: tokens[index][cw ? 'cw' : 'ccw'], encoder: index });
+    }
+    t += detents * options.detentMs + 60;
+  });
+  return script;
+}
+
+const SCENARIOS = {
+  latency: latencyScript,
+  typing: typingScript,
+  macros: macrosScript,
+  encoder: encoderScript,
+};
+
+// ============================================
+// Run and analysis
+// ============================================
+
+function run(binary, name, script, options) {
+  const scriptFile = path.join(BUILD_DIR, `${name}.script`);
+  fs.writeFileSync(scriptFile, script.text());
+  const args = ['--poll-us', options.pollUs, '--ep-depth', options.epDepth, '--baud', options.baud, '--loop-us', options.loopUs]
+    .map(String);
+  if (options.nkro) args.push('--nkro');
+  if (options.uinput) args.push('--uinput');
+  if (!options.grab) args.push('--no-grab');
+  if (options.console) args.push('--console');
+  const output = execFileSync(binary, [...args, scriptFile], { maxBuffer: 1 << 28, stdio: ['ignore', 'pipe', 'inherit'] }).toString();
+  fs.writeFileSync(path.join(BUILD_DIR, `${name}.log`), output);
+  return output.trim().split('\n').map(line => line.split(' '));
+}
+
+function percentiles(values) {
+  const sorted = [...values].sort((a, b) => a - b);
+  const at = p => sorted.length ? sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))] : null;
+  const round = v => v === null ? null : Math.round(v) / 1000;
+  return { n: sorted.length, p50: round(at(0.5)), p95: round(at(0.95)), p99: round(at(0.99)), max: round(sorted.length ? sorted[sorted.length - 1] : null) };
+}
+
+function parseStats(lines) {
+  const stats = {};
+  for (const f of lines.filter(l => l[0] === 'stats')) {
+    const side = f[1] === 'link' ? `link_${f[2].split('=')[1]}` : f[1];
+    stats[side] = Object.fromEntries(f.slice(2).map(kv => kv.split('=')).map(([k, v]) => [k, isNaN(Number(v)) ? v : Number(v)]));
+  }
+  return stats;
+}
+
+const MATCH_US = 250000;  // A press without its input event by then produced none
+
+// Input events → typed characters and shortcut tokens; each key press matched to its first input event
+function analyse(lines, keymap) {
+  const base = new Map((keymap.layers[0] || []).map(k => [`${k.row},${k.col}`, k.kc]));
+  const held = new Set();
+  const output = [];
+  const presses = [];  // { row, col, inject, event, report, usb, input }
+  const pending = new Map();  // evdev → presses waiting for their input event
+  const byPos = new Map();
+  const reports = [];
+  const hits = [];
+  for (const f of lines) {
+    const t = Number(f[1]);
+    switch (f[0]) {
+      case 'inject': {
+        if (f[2] === 'encoder' || f[4] !== '1') break;
+        const press = { pos: `${f[2]},${f[3]}`, right: Number(f[2]) >= 6, inject: t };
+        presses.push(press);
+        byPos.set(press.pos, press);
+        const entry = KEY_BY_KC.get(base.get(press.pos));
+        if (entry) {
+          if (!pending.has(entry.evdev)) pending.set(entry.evdev, []);
+          pending.get(entry.evdev).push(press);
+        }
+        break;
+      }
+      case 'event': {
+        const press = byPos.get(`${f[2]},${f[3]}`);
+        if (f[4] === '1' && press && press.event === undefined) press.event = t;
+        break;
+      }
+      case 'hit': {
+        const press = byPos.get(`${f[2]},${f[3]}`);
+        if (f[4] === '1' && press && !press.right && press.hit === undefined) press.hit = t;
+        break;
+      }
+      case 'report':
+        reports.push(t);
+        break;
+      case 'input': {
+        const [type, code, value] = f.slice(2).map(Number);
+        if (type !== 1) break;
+        const entry = KEY_BY_EVDEV.get(code);
+        const name = entry ? entry.name : `KEY_${code}`;
+        if (value === 0) {
+          held.delete(name);
+          break;
+        }
+        held.add(name);
+        const mods = [...held].filter(m => MODIFIERS.has(m) && m !== name);
+        const shortcut = !MODIFIERS.has(name) && !(entry && entry.char !== undefined && !mods.some(m => SHORTCUT_MODS.includes(m)));
+        // Shortcuts come from the firmware (leader, encoder map, macros), not from the key of that name
+        const queue = shortcut ? [] : pending.get(code) || [];
+        while (queue.length && t - queue[0].inject > MATCH_US) queue.shift();  // Taken by the firmware (chord, leader)
+        if (queue.length) {
+          const press = queue.shift();
+          press.input = t;
+          press.report = reports.find(r => r >= press.event);
+        }
+        if (shortcut) {
+          output.push({ token: shortcutToken(mods, name) });
+        } else if (!MODIFIERS.has(name)) {
+          output.push(mods.length ? entry.shifted : entry.char);
+        }
+        break;
+      }
+    }
+  }
+  return { output, presses, stats: parseStats(lines) };
+}
+
+function compare(expected, output) {
+  const show = items => items.map(i => typeof i === 'string' ? i : `⟨${i.token}⟩`).join('');
+  const want = show(expected);
+  const got = show(output);
+  if (want === got) return null;
+  let i = 0;
+  while (i < want.length && want[i] === got[i]) i++;
+  return { at: i, expected: want.slice(Math.max(0, i - 20), i + 40), got: got.slice(Math.max(0, i - 20), i + 40) };
+}
+
+function summarize(name, script, result) {
+  const done = result.presses.filter(p => p.input !== undefined && p.event !== undefined);
+  const stage = (list, from, to) => percentiles(list.filter(p => p[from] !== undefined && p[to] !== undefined).map(p => p[to] - p[from]));
+  const halves = { left: done.filter(p => !p.right), right: done.filter(p => p.right) };
+  const summary = {
+    scenario: name,
+    presses: result.presses.length,
+    matched: done.length,
+    latency: Object.fromEntries(Object.entries(halves).map(([half, list]) => [half, {
+      total: stage(list, 'inject', 'input'),
+      scan: stage(list, 'inject', 'event'),
+      firmware: stage(list, 'event', 'report'),
+      usb: stage(list, 'report', 'input'),
+    }])),
+    slaveHit: stage(halves.left, 'inject', 'hit'),
+    mismatch: compare(script.expected, result.output),
+    stats: result.stats,
+  };
+  const encoderTokens = script.expected.filter(e => e.encoder !== undefined);
+  if (encoderTokens.length) {
+    const count = (items, token) => items.filter(i => typeof i === 'object' && i.token === token).length;
+    summary.encoder = [...new Set(encoderTokens.map(e => e.token))].map(token => ({
+      token, detents: count(encoderTokens, token), received: count(result.output, token),
+    }));
+  }
+  summary.ok = !summary.mismatch && (summary.encoder || []).every(e => e.detents === e.received);
+  return summary;
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = {
+    scenario: 'all', taps: 200, wpm: 150, text: DEFAULT_TEXT, detentMs: 8, seed: 1,
+    pollUs: 1000, epDepth: 4, baud: defaultBaud(), loopUs: 100,
+    nkro: false, uinput: false, grab: true, console: false, json: false,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--scenario': options.scenario = value(); break;
+      case '--taps': options.taps = Number(value()); break;
+      case '--wpm': options.wpm = Number(value()); break;
+      case '--text': options.text = value(); break;
+      case '--detent-ms': options.detentMs = Number(value()); break;
+      case '--seed': options.seed = Number(value()); break;
+      case '--poll-us': options.pollUs = Number(value()); break;
+      case '--ep-depth': options.epDepth = Number(value()); break;
+      case '--baud': options.baud = Number(value()); break;
+      case '--loop-us': options.loopUs = Number(value()); break;
+      case '--nkro': options.nkro = true; break;
+      case '--uinput': options.uinput = true; break;
+      case '--no-grab': options.grab = false; break;
+      case '--console': options.console = true; break;
+      case '--json': options.json = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  if (options.scenario !== 'all' && !SCENARIOS[options.scenario]) throw new Error(`Unknown scenario: ${options.scenario}`);
+  return options;
+}
+
+function printSummary(summary) {
+  const ms = s => s.n ? `${s.p50.toFixed(2)} / ${s.p95.toFixed(2)} / ${s.p99.toFixed(2)} / ${s.max.toFixed(2)}` : '-';
+  const { master = {}, slave = {}, host = {}, link_master: link = {} } = summary.stats;
+  console.log(`${summary.scenario}: ${summary.ok ? 'ok' : 'FAILED'} (${summary.matched}/${summary.presses} presses reached the host)`);
+  console.log('  latency ms (p50 / p95 / p99 / max)');
+  for (const [half, stages] of Object.entries(summary.latency)) {
+    for (const [stage, s] of Object.entries(stages)) console.log(`    ${half.padEnd(6)} ${stage.padEnd(9)} ${ms(s)}`);
+  }
+  console.log(`    left key → slave RGB hit ${ms(summary.slaveHit)}`);
+  console.log(`  master loop mean ${master.mean_loop_us} us, max ${master.max_loop_us} us; slave max ${slave.max_loop_us} us`);
+  console.log(`  link ${link.transactions} transactions, ${link.failures} failed, round trip mean ${link.mean_round_us} us, max ${link.max_round_us} us`);
+  console.log(`  usb ${host.keyboard} keyboard / ${host.extrakey} extrakey / ${host.mouse} mouse reports, ` +
+    `${host.blocked} sends blocked (${host.blocked_us} us), deepest queue ${host.max_queued}; 6KRO drops ${master.rollover}, ` +
+    `unsupported keycodes ${master.unsupported}`);
+  for (const e of summary.encoder || []) console.log(`  encoder ${e.token}: ${e.received}/${e.detents}`);
+  if (summary.mismatch) {
+    console.log(`  output differs at ${summary.mismatch.at}:\n    expected ${JSON.stringify(summary.mismatch.expected)}\n` +
+      `    got      ${JSON.stringify(summary.mismatch.got)}`);
+  }
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const { binary, rules } = build();
+  const keymap = readKeymap(binary);
+  const names = options.scenario === 'all' ? Object.keys(SCENARIOS) : [options.scenario];
+  const summaries = names.map(name => {
+    const script = SCENARIOS[name](keymap, options, random(options.seed));
+    return summarize(name, script, analyse(run(binary, name, script, options), keymap));
+  });
+
+  if (options.json) {
+    console.log(JSON.stringify(summaries, null, 2));
+  } else {
+    const left = Object.keys(HARDWARE).filter(d => !rules.defines.includes(d));
+    console.log(`Modules: ${rules.defines.filter(d => /_ENABLE$/.test(d)).join(' ')}`);
+    console.log(`Left out (hardware): ${left.join(' ')}`);
+    console.log(`USB poll ${options.pollUs} us, endpoint depth ${options.epDepth}, split link ${options.baud} baud, ` +
+      `${options.uinput ? 'uinput' : 'decoded'} input\n`);
+    summaries.forEach(printSummary);
+    console.log(`\nLogs: ${path.relative(process.cwd(), BUILD_DIR)}/<scenario>.log`);
+  }
+  if (summaries.some(s => !s.ok)) process.exitCode = 1;
+}
+
+if (require.main === module) {
+  try {
+    main();
+  } catch (err) {
+    console.error(`emulate: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { readRules, readKeymap, analyse };
@@ -7,7 +7,7 @@
 
 const fs = require('fs');
 const path = require('path');
-const { execSync } = require('child_process');
+const { parseKeybindingsFile } = require('./keybinding-db');
 
 const CURSOR_USER_DIR = path.join(
   process.env.HOME,
@@ -22,8 +22,9 @@ console.log('Exporting Cursor IDE Keybindings...\n');
 let userKeybindings = [];
 if (fs.existsSync(KEYBINDINGS_FILE)) {
   try {
+    // keybindings.json is JSONC (comments, trailing commas); parse leniently
     const content = fs.readFileSync(KEYBINDINGS_FILE, 'utf8');
-    userKeybindings = JSON.parse(content);
+    userKeybindings = parseKeybindingsFile(content).bindings;
     console.log(`Found ${userKeybindings.length} custom keybindings\n`);
   } catch (e) {
     console.error('Error reading keybindings.json:', e.message);
@@ -0,0 +1,354 @@
+#!/usr/bin/env node
+//
+// Firmware flash/RAM budget report from a GNU ld map file
+//
+// Breaks the linked firmware down per feature (CONSOLE_ENABLE, tap dance, RGB
+// matrix, mousekey, ...) and per symbol, writes a JSON report, and compares it
+// against a stored baseline. Exits with status 2 on a budget regression.
+//
+// Usage: node scripts/firmware-size-report.js <firmware.map> [options]
+//   --output <file>             Write the JSON report here
+//   --baseline <file>           Compare against this report (created if missing)
+//   --update-baseline           Overwrite the baseline with this report
+//   --max-flash-growth <bytes>  Allowed flash growth vs baseline (default: 1024)
+//   --max-ram-growth <bytes>    Allowed RAM growth vs baseline (default: 512)
+//   --max-usage <percent>       Allowed flash/RAM region usage (default: 95)
+//   --top <n>                   Symbols to list (default: 20)
+//   --quiet                     Only print regressions and the summary line
+//
+
+const fs = require('fs');
+const path = require('path');
+
+// Object path (or "path::symbol") → feature. First match wins, so more
+// specific rules (keymap before keyboard, tap dance before quantum) go first.
+const FEATURE_RULES = [
+  ['console', /\/quantum\/logging\/|\/lib\/printf\/|console/],
+  ['tap_dance', /process_tap_dance/],
+  ['rgb_matrix', /\/quantum\/rgb_matrix\/|\/drivers\/led\/|rgb_matrix/],
+  ['mousekey', /mousekey/],
+  ['nkro', /::.*nkro/],
+  ['encoder', /\/quantum\/encoder|\/drivers\/encoder\/|::encoder_/],
+  ['split', /\/quantum\/split_common\/|serial_usart|transactions/],
+  ['dip_switch', /dip_switch/],
+  ['keymap', /\/keymaps\//],
+  ['keyboard', /\/keyboards\/|\/keychron\//],
+  ['eeprom', /dynamic_keymap|eeconfig|eeprom|wear_leveling/],
+  ['usb', /\/tmk_core\/protocol\/|\/lib\/chibios-contrib\/os\/hal\/ports\/.*USB|usb_/],
+  ['chibios', /\/lib\/chibios|\/platforms\/chibios\//],
+  ['libc', /libc(_nano)?\.a|libgcc\.a|libm\.a|libnosys\.a/],
+  ['quantum', /\/quantum\/|\/tmk_core\//],
+];
+
+function parseArgs(argv) {
+  const opts = {
+    map: null,
+    output: null,
+    baseline: null,
+    updateBaseline: false,
+    maxFlashGrowth: 1024,
+    maxRamGrowth: 512,
+    maxUsage: 95,
+    top: 20,
+    quiet: false,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) {
+        console.error(`Option ${arg} requires a value`);
+        process.exit(1);
+      }
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--output': opts.output = value(); break;
+      case '--baseline': opts.baseline = value(); break;
+      case '--update-baseline': opts.updateBaseline = true; break;
+      case '--max-flash-growth': opts.maxFlashGrowth = Number(value()); break;
+      case '--max-ram-growth': opts.maxRamGrowth = Number(value()); break;
+      case '--max-usage': opts.maxUsage = Number(value()); break;
+      case '--top': opts.top = Number(value()); break;
+      case '--quiet': opts.quiet = true; break;
+      default:
+        if (arg.startsWith('--') || opts.map) {
+          console.error(`Unknown option: ${arg}`);
+          process.exit(1);
+        }
+        opts.map = arg;
+    }
+  }
+  if (!opts.map) {
+    console.error('Usage: node scripts/firmware-size-report.js <firmware.map> [--baseline file] [--output file]');
+    process.exit(1);
+  }
+  return opts;
+}
+
+// ============================================
+// Map file parsing
+// ============================================
+
+function parseMap(text) {
+  const lines = text.split('\n');
+  const regions = [];
+  const inputs = [];
+
+  let i = 0;
+  // Memory Configuration: name origin length
+  while (i < lines.length && !lines[i].startsWith('Memory Configuration')) i++;
+  for (; i < lines.length && !lines[i].startsWith('Linker script and memory map'); i++) {
+    const m = lines[i].match(/^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)/i);
+    if (m && m[1] !== '*default*') {
+      regions.push({ name: m[1], origin: parseInt(m[2], 16), length: parseInt(m[3], 16) });
+    }
+  }
+
+  let output = null; // { name, inFlash, inRam }
+  let pendingName = null;
+  const regionOf = addr => regions.find(r => addr >= r.origin && addr < r.origin + r.length);
+  const isFlash = r => r && /flash|rom/i.test(r.name);
+  const isRam = r => r && /ram/i.test(r.name);
+
+  for (; i < lines.length; i++) {
+    const line = lines[i];
+
+    // Output section: ".name  0xVMA  0xSIZE [load address 0xLMA]" at column 0 (may wrap)
+    const out = line.match(/^(\.\S+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+load address 0x([0-9a-f]+))?)?\s*$/i);
+    if (out && !line.startsWith(' ')) {
+      let vma = out[2];
+      let lma = out[4];
+      if (!vma && i + 1 < lines.length) {
+        const cont = lines[i + 1].match(/^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+load address 0x([0-9a-f]+))?\s*$/i);
+        if (cont) {
+          vma = cont[1];
+          lma = cont[3];
+          i++;
+        }
+      }
+      if (!vma) {
+        output = null;
+        continue;
+      }
+      const vmaRegion = regionOf(parseInt(vma, 16));
+      const lmaRegion = lma ? regionOf(parseInt(lma, 16)) : vmaRegion;
+      output = {
+        name: out[1],
+        inFlash: isFlash(vmaRegion) || isFlash(lmaRegion),
+        inRam: isRam(vmaRegion),
+      };
+      continue;
+    }
+    if (!output || (!output.inFlash && !output.inRam)) continue;
+
+    // Input section: " .text.sym  0xADDR  0xSIZE  object" (name may wrap onto its own line)
+    const wrapped = line.match(/^ (\.\S+|COMMON)\s*$/);
+    if (wrapped) {
+      pendingName = wrapped[1];
+      continue;
+    }
+    let m = line.match(/^ (\.\S+|COMMON|\*fill\*)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s*(.*)$/i);
+    let name;
+    if (m) {
+      name = m[1];
+      pendingName = null;
+    } else if (pendingName) {
+      m = line.match(/^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$/i);
+      if (m) {
+        m = [m[0], pendingName, m[1], m[2], m[3]];
+        name = pendingName;
+      }
+      pendingName = null;
+    }
+    if (!m) continue;
+
+    const size = parseInt(m[3], 16);
+    if (size === 0) continue;
+    const object = (m[4] || '').trim() || '(fill)';
+    inputs.push({
+      section: name,
+      output: output.name,
+      symbol: symbolName(name, output.name),
+      object,
+      size,
+      flash: output.inFlash ? size : 0,
+      ram: output.inRam ? size : 0,
+    });
+  }
+  return { regions, inputs };
+}
+
+// ".text.process_tap_dance" → "process_tap_dance"; plain ".text" keeps the object name
+function symbolName(section, outputName) {
+  const m = section.match(/^\.(?:text|rodata|data|bss|ram\d*(?:_init)?|noinit)\.(.+)$/);
+  if (m) return m[1];
+  if (section === '*fill*') return '(padding)';
+  return `${section} (${outputName})`;
+}
+
+function featureOf(object, symbol) {
+  const key = `${object}::${symbol}`;
+  for (const [feature, re] of FEATURE_RULES) {
+    if (re.test(key)) return feature;
+  }
+  return 'other';
+}
+
+// ============================================
+// Report
+// ============================================
+
+function buildReport(mapFile, parsed) {
+  const features = {};
+  const symbols = {};
+  let flash = 0;
+  let ram = 0;
+
+  for (const input of parsed.inputs) {
+    const feature = featureOf(input.object, input.symbol);
+    const f = features[feature] || (features[feature] = { flash: 0, ram: 0 });
+    f.flash += input.flash;
+    f.ram += input.ram;
+    flash += input.flash;
+    ram += input.ram;
+
+    const key = `${input.symbol}\t${path.basename(input.object)}`;
+    const s = symbols[key] || (symbols[key] = {
+      symbol: input.symbol,
+      object: path.basename(input.object),
+      feature,
+      flash: 0,
+      ram: 0,
+    });
+    s.flash += input.flash;
+    s.ram += input.ram;
+  }
+
+  const regionSize = re => parsed.regions.filter(r => re.test(r.name)).reduce((sum, r) => sum + r.length, 0);
+
+  return {
+    map: path.basename(mapFile),
+    totals: {
+      flash,
+      ram,
+      flash_limit: regionSize(/flash|rom/i),
+      ram_limit: regionSize(/ram/i),
+    },
+    features: Object.fromEntries(Object.entries(features).sort((a, b) => b[1].flash - a[1].flash)),
+    symbols: Object.values(symbols).sort((a, b) => (b.flash + b.ram) - (a.flash + a.ram)),
+  };
+}
+
+const kb = n => `${(n / 1024).toFixed(1)} KB`;
+const signed = n => (n > 0 ? `+${n}` : `${n}`);
+const pct = (n, limit) => (limit ? `${((100 * n) / limit).toFixed(1)}%` : '-');
+
+function printReport(report, top) {
+  const t = report.totals;
+  console.log(`## Firmware size: ${report.map}\n`);
+  console.log(`Flash: ${t.flash} bytes (${kb(t.flash)}, ${pct(t.flash, t.flash_limit)} of ${kb(t.flash_limit)})`);
+  console.log(`RAM:   ${t.ram} bytes (${kb(t.ram)}, ${pct(t.ram, t.ram_limit)} of ${kb(t.ram_limit)})\n`);
+
+  console.log('| Feature | Flash | RAM |');
+  console.log('|---------|------:|----:|');
+  for (const [name, f] of Object.entries(report.features)) {
+    console.log(`| ${name} | ${f.flash} | ${f.ram} |`);
+  }
+
+  console.log(`\n| Symbol | Object | Feature | Flash | RAM |`);
+  console.log('|--------|--------|---------|------:|----:|');
+  for (const s of report.symbols.slice(0, top)) {
+    console.log(`| \`${s.symbol}\` | ${s.object} | ${s.feature} | ${s.flash} | ${s.ram} |`);
+  }
+  console.log('');
+}
+
+// Returns a list of regression messages (empty when within budget)
+function compareBaseline(report, baseline, opts) {
+  const problems = [];
+  const t = report.totals;
+  const b = baseline.totals;
+
+  const flashDelta = t.flash - b.flash;
+  const ramDelta = t.ram - b.ram;
+  if (flashDelta > opts.maxFlashGrowth) {
+    problems.push(`Flash grew by ${flashDelta} bytes (limit ${opts.maxFlashGrowth})`);
+  }
+  if (ramDelta > opts.maxRamGrowth) {
+    problems.push(`RAM grew by ${ramDelta} bytes (limit ${opts.maxRamGrowth})`);
+  }
+
+  if (!opts.quiet) {
+    console.log(`## Compared to baseline (${baseline.map})\n`);
+    console.log(`Flash: ${signed(flashDelta)} bytes, RAM: ${signed(ramDelta)} bytes\n`);
+    const names = new Set([...Object.keys(report.features), ...Object.keys(baseline.features)]);
+    const rows = [...names]
+      .map(name => {
+        const now = report.features[name] || { flash: 0, ram: 0 };
+        const then = baseline.features[name] || { flash: 0, ram: 0 };
+        return { name, flash: now.flash - then.flash, ram: now.ram - then.ram };
+      })
+      .filter(r => r.flash !== 0 || r.ram !== 0)
+      .sort((a, b) => Math.abs(b.flash) - Math.abs(a.flash));
+    if (rows.length > 0) {
+      console.log('| Feature | Flash Δ | RAM Δ |');
+      console.log('|---------|--------:|------:|');
+      rows.forEach(r => console.log(`| ${r.name} | ${signed(r.flash)} | ${signed(r.ram)} |`));
+      console.log('');
+    }
+  }
+  return problems;
+}
+
+function checkUsage(report, opts) {
+  const problems = [];
+  const t = report.totals;
+  if (t.flash_limit && (100 * t.flash) / t.flash_limit > opts.maxUsage) {
+    problems.push(`Flash usage ${pct(t.flash, t.flash_limit)} exceeds ${opts.maxUsage}%`);
+  }
+  if (t.ram_limit && (100 * t.ram) / t.ram_limit > opts.maxUsage) {
+    problems.push(`RAM usage ${pct(t.ram, t.ram_limit)} exceeds ${opts.maxUsage}%`);
+  }
+  return problems;
+}
+
+function main() {
+  const opts = parseArgs(process.argv.slice(2));
+
+  if (!fs.existsSync(opts.map)) {
+    console.error(`Map file not found: ${opts.map}`);
+    process.exit(1);
+  }
+  const parsed = parseMap(fs.readFileSync(opts.map, 'utf8'));
+  if (parsed.inputs.length === 0) {
+    console.error(`No flash/RAM sections found in ${opts.map} (is it a GNU ld map with a Memory Configuration?)`);
+    process.exit(1);
+  }
+  const report = buildReport(opts.map, parsed);
+
+  if (!opts.quiet) printReport(report, opts.top);
+  if (opts.output) {
+    fs.mkdirSync(path.dirname(opts.output), { recursive: true });
+    fs.writeFileSync(opts.output, JSON.stringify(report, null, 2) + '\n');
+  }
+
+  const problems = checkUsage(report, opts);
+  if (opts.baseline) {
+    if (opts.updateBaseline || !fs.existsSync(opts.baseline)) {
+      fs.mkdirSync(path.dirname(opts.baseline), { recursive: true });
+      fs.writeFileSync(opts.baseline, JSON.stringify(report, null, 2) + '\n');
+      console.log(`Baseline written: ${opts.baseline}`);
+    } else {
+      problems.push(...compareBaseline(report, JSON.parse(fs.readFileSync(opts.baseline, 'utf8')), opts));
+    }
+  }
+
+  const t = report.totals;
+  console.log(`Flash ${t.flash} bytes (${pct(t.flash, t.flash_limit)}), RAM ${t.ram} bytes (${pct(t.ram, t.ram_limit)})`);
+  if (problems.length > 0) {
+    problems.forEach(p => console.error(`SIZE REGRESSION: ${p}`));
+    process.exit(2);
+  }
+}
+
+main();
@@ -0,0 +1,195 @@
+#!/usr/bin/env node
+//
+// Generate the app launcher leader trie from app_leader.json
+//
+// Reads the leader sequences (keys → KC_APP_* launcher) from the keymap's
+// app_leader.json, checks that no sequence is a prefix of another (so every
+// sequence fires on its last key, with no timeout), and writes the trie as
+// flash tables to app_leader_trie.h next to keymap.c: a column per key used,
+// next state = app_leader_next[state * columns + column], one table step per
+// key.
+//
+// Regeneration is skipped when the inputs hash recorded in the header matches.
+//
+// Usage: node scripts/generate-app-leader.js [keymap_dir] [--force] [--check]
+//   keymap_dir  Default: keychron/q11/ansi_encoder/keymaps/j-custom
+//   --force     Regenerate even if the header is up to date
+//   --check     Only verify the header is up to date (exit 1 if not)
+//
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const { readKeymap } = require('./generate-sparse-keymap');
+const { keymapNames, evaluate } = require('./key-stats/key-stats');
+
+const REPO_DIR = path.resolve(__dirname, '..');
+const DEFAULT_KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const SPEC_FILE = 'app_leader.json';
+const HEADER_FILE = 'app_leader_trie.h';
+const GENERATOR_VERSION = 1;
+const MAX_STATES = 255;
+const QK_MODS_MAX = 0x1FFF;
+
+// Sequence characters → basic keycodes (all below APP_LEADER_KEYCODES, see app_leader.h)
+const KEY_NAMES = {
+  '-': 'KC_MINS', '=': 'KC_EQL', '[': 'KC_LBRC', ']': 'KC_RBRC', '\\': 'KC_BSLS', ';': 'KC_SCLN',
+  "'": 'KC_QUOT', '`': 'KC_GRV', ',': 'KC_COMM', '.': 'KC_DOT', '/': 'KC_SLSH',
+};
+
+function keyName(ch) {
+  if (/^[a-z0-9]$/i.test(ch)) return `KC_${ch.toUpperCase()}`;
+  if (KEY_NAMES[ch]) return KEY_NAMES[ch];
+  throw new Error(`'${ch}' cannot be part of a sequence (letters, digits, ${Object.keys(KEY_NAMES).join(' ')})`);
+}
+
+// ============================================
+// Trie
+// ============================================
+
+function buildTrie(spec, names, file) {
+  if (!Array.isArray(spec.sequences) || !spec.sequences.length) throw new Error(`${file}: no sequences`);
+  const sequences = spec.sequences.map((s, i) => {
+    const where = `${file}: sequences[${i}]`;
+    if (typeof s.keys !== 'string' || !s.keys.length) throw new Error(`${where}: "keys" must be a non-empty string`);
+    if (!names.defines[s.keycode]) throw new Error(`${where}: ${s.keycode} is not #define'd in keymap.c`);
+    const value = evaluate(s.keycode, names);
+    if (value === undefined || value > QK_MODS_MAX) {
+      throw new Error(`${where}: ${s.keycode} must be a basic keycode with modifiers (tapped with tap_code16)`);
+    }
+    let keys;
+    try {
+      keys = [...s.keys].map(keyName);
+    } catch (err) {
+      throw new Error(`${where}: ${err.message}`);
+    }
+    return { text: s.keys, keys, keycode: s.keycode, label: s.label || s.keycode };
+  });
+
+  // Prefix-free: each sequence must be decided by its own last key
+  for (const a of sequences) {
+    for (const b of sequences) {
+      if (a !== b && b.text.startsWith(a.text)) {
+        throw new Error(`${file}: "${a.text}" (${a.label}) is a prefix of "${b.text}" (${b.label}); it could only fire on a timeout`);
+      }
+    }
+  }
+
+  const valueOf = kc => evaluate(kc, names);
+  const columns = [...new Set(sequences.flatMap(s => s.keys))].sort((a, b) => valueOf(a) - valueOf(b));
+  const column = Object.fromEntries(columns.map((k, i) => [k, i + 1]));  // Column 0: key in no sequence
+
+  const states = [{ next: {}, action: null, path: '' }];
+  for (const s of sequences) {
+    let state = 0;
+    for (const [i, key] of s.keys.entries()) {
+      if (states[state].next[key] === undefined) {
+        states[state].next[key] = states.length;
+        states.push({ next: {}, action: null, path: s.text.slice(0, i + 1) });
+      }
+      state = states[state].next[key];
+    }
+    states[state].action = s;
+  }
+  if (states.length > MAX_STATES) throw new Error(`${file}: ${states.length} trie states, at most ${MAX_STATES} fit uint8_t`);
+  return { sequences, columns, column, states, valueOf };
+}
+
+function inputsHash(spec) {
+  const hash = crypto.createHash('sha1');
+  hash.update(`v${GENERATOR_VERSION}\n`);
+  hash.update(JSON.stringify(spec.sequences));
+  return hash.digest('hex');
+}
+
+function tableBytes(trie) {
+  const keycodes = Math.max(...trie.columns.map(trie.valueOf)) + 1;
+  return keycodes + trie.states.length * (trie.columns.length + 1) + trie.states.length * 2 + 1;
+}
+
+function renderHeader(trie, hash) {
+  const width = trie.columns.length + 1;
+  const lines = [];
+  lines.push(`/* Generated by scripts/generate-app-leader.js from ${SPEC_FILE} - do not edit.`);
+  lines.push(' * Regenerate: node scripts/generate-app-leader.js');
+  lines.push(` * inputs: ${hash}`);
+  lines.push(` * ${trie.sequences.length} sequences, ${trie.states.length} states x ${width} columns: ${tableBytes(trie)} bytes of flash`);
+  lines.push(' */');
+  lines.push('#pragma once');
+  lines.push('');
+  lines.push(`#define APP_LEADER_STATES  ${trie.states.length}`);
+  lines.push(`#define APP_LEADER_COLUMNS ${width}`);
+  lines.push('');
+  lines.push('const uint8_t PROGMEM app_leader_columns = APP_LEADER_COLUMNS;');
+  lines.push('');
+  lines.push('// Column of each basic keycode (0 = in no sequence)');
+  lines.push('const uint8_t PROGMEM app_leader_column[APP_LEADER_KEYCODES] = {');
+  for (const key of trie.columns) lines.push(`    [${key}] = ${trie.column[key]},`);
+  lines.push('};');
+  lines.push('');
+  lines.push('// Next state at [state * APP_LEADER_COLUMNS + column] (0 = no sequence continues this way)');
+  lines.push('const uint8_t PROGMEM app_leader_next[APP_LEADER_STATES * APP_LEADER_COLUMNS] = {');
+  trie.states.forEach((state, i) => {
+    const row = [0, ...trie.columns.map(key => state.next[key] || 0)];
+    lines.push(`    ${row.join(', ')},  // ${i}: "${state.path}"`);
+  });
+  lines.push('};');
+  lines.push('');
+  lines.push('// Keycode tapped on reaching a state (KC_NO = read another key)');
+  lines.push('const uint16_t PROGMEM app_leader_action[APP_LEADER_STATES] = {');
+  trie.states.forEach((state, i) => {
+    if (state.action) lines.push(`    [${i}] = ${state.action.keycode},  // "${state.action.text}": ${state.action.label}`);
+  });
+  lines.push('};');
+  lines.push('');
+  return lines.join('\n');
+}
+
+// ============================================
+// Main
+// ============================================
+
+function main() {
+  const args = process.argv.slice(2);
+  const force = args.includes('--force');
+  const checkOnly = args.includes('--check');
+  if (args.includes('-h') || args.includes('--help')) {
+    console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+      .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+    return 0;
+  }
+  const keymapDir = path.resolve(args.find(a => !a.startsWith('--')) || DEFAULT_KEYMAP_DIR);
+  const specPath = path.join(keymapDir, SPEC_FILE);
+  const headerPath = path.join(keymapDir, HEADER_FILE);
+  const spec = JSON.parse(fs.readFileSync(specPath, 'utf8'));
+  const hash = inputsHash(spec);
+  const rel = path.relative(REPO_DIR, headerPath);
+
+  if (!force && fs.existsSync(headerPath) && fs.readFileSync(headerPath, 'utf8').includes(`inputs: ${hash}`)) {
+    console.log(`${rel} is up to date`);
+    return 0;
+  }
+  if (checkOnly) {
+    console.error(`${rel} is out of date with ${SPEC_FILE}; run: node scripts/generate-app-leader.js`);
+    return 1;
+  }
+
+  const keymap = readKeymap(keymapDir);
+  const names = keymapNames(fs.readFileSync(keymap.file, 'utf8'), keymap.layerEnum);
+  const trie = buildTrie(spec, names, path.relative(REPO_DIR, specPath));
+  fs.writeFileSync(headerPath, renderHeader(trie, hash));
+  console.log(`Wrote ${rel}`);
+  console.log(`  ${trie.sequences.length} sequences, ${trie.states.length} states, ${trie.columns.length} keys: ${tableBytes(trie)} bytes of flash`);
+  return 0;
+}
+
+if (require.main === module) {
+  try {
+    process.exit(main());
+  } catch (err) {
+    console.error(`generate-app-leader: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { buildTrie };
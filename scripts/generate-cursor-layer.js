@@ -0,0 +1,273 @@
+#!/usr/bin/env node
+//
+// Generate the CURSOR_LAYER macro table from the Cursor keybinding database
+//
+// Reads the action list (keycode → Cursor command) from the keymap's
+// cursor_layer.json, resolves each command to its effective chord through
+// scripts/keybinding-db.js, checks the chords against the APP_LAYER and
+// WIN_LAYER modifier combos (global shortcuts would swallow them) and writes
+// cursor_layer_macros.h next to keymap.c.
+//
+// Regeneration is skipped when the inputs hash recorded in the header matches.
+//
+// Usage: node scripts/generate-cursor-layer.js [keymap_dir] [--force] [--check]
+//   keymap_dir  Default: keychron/q11/ansi_encoder/keymaps/j-custom
+//   --force     Regenerate even if the header is up to date
+//   --check     Only verify the header is up to date (exit 1 if not)
+//
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const { loadDb, lookupCommand, normalizeChord } = require('./keybinding-db');
+
+const REPO_DIR = path.resolve(__dirname, '..');
+const DEFAULT_KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const SPEC_FILE = 'cursor_layer.json';
+const HEADER_FILE = 'cursor_layer_macros.h';
+const GENERATOR_VERSION = 2;
+
+// Layers whose macros are global (OS-level) shortcuts that must not collide
+const CONFLICT_PREFIXES = ['KC_APP_', 'KC_WIN_'];
+
+// ============================================
+// Chord ↔ QMK keycode tables
+// ============================================
+
+const QMK_MODIFIER_FUNCS = {
+  LCTL: ['ctrl'], C: ['ctrl'], RCTL: ['ctrl'],
+  LSFT: ['shift'], S: ['shift'], RSFT: ['shift'],
+  LALT: ['alt'], A: ['alt'], LOPT: ['alt'], RALT: ['alt'], ROPT: ['alt'],
+  LGUI: ['cmd'], G: ['cmd'], LCMD: ['cmd'], LWIN: ['cmd'], RGUI: ['cmd'], RCMD: ['cmd'],
+  LCA: ['ctrl', 'alt'], LCG: ['ctrl', 'cmd'], LCS: ['ctrl', 'shift'],
+  LSA: ['shift', 'alt'], LSG: ['shift', 'cmd'], LAG: ['alt', 'cmd'],
+  LCAG: ['ctrl', 'alt', 'cmd'], LSAG: ['shift', 'alt', 'cmd'], LCSG: ['ctrl', 'shift', 'cmd'],
+  MEH: ['ctrl', 'shift', 'alt'], HYPR: ['ctrl', 'shift', 'alt', 'cmd'],
+};
+
+// Chord modifier → QMK wrapper, applied outermost first in canonical order
+const MODIFIER_WRAPPERS = { ctrl: 'LCTL', shift: 'LSFT', alt: 'LALT', cmd: 'LGUI' };
+
+const NAMED_KEYS = {
+  enter: 'KC_ENT', escape: 'KC_ESC', tab: 'KC_TAB', space: 'KC_SPC', backspace: 'KC_BSPC',
+  delete: 'KC_DEL', insert: 'KC_INS', home: 'KC_HOME', end: 'KC_END', pageup: 'KC_PGUP',
+  pagedown: 'KC_PGDN', up: 'KC_UP', down: 'KC_DOWN', left: 'KC_LEFT', right: 'KC_RIGHT',
+  '[': 'KC_LBRC', ']': 'KC_RBRC', ';': 'KC_SCLN', "'": 'KC_QUOT', ',': 'KC_COMM', '.': 'KC_DOT',
+  '/': 'KC_SLSH', '\\': 'KC_BSLS', '`': 'KC_GRV', '-': 'KC_MINS', '=': 'KC_EQL',
+};
+const NAMED_KEYS_REVERSE = Object.fromEntries(Object.entries(NAMED_KEYS).map(([k, v]) => [v, k]));
+Object.assign(NAMED_KEYS_REVERSE, {
+  KC_ENTER: 'enter', KC_ESCAPE: 'escape', KC_SPACE: 'space', KC_BACKSPACE: 'backspace',
+  KC_DELETE: 'delete', KC_GRAVE: '`', KC_MINUS: '-', KC_EQUAL: '=', KC_SEMICOLON: ';',
+  KC_QUOTE: "'", KC_COMMA: ',', KC_SLASH: '/', KC_BACKSLASH: '\\',
+});
+
+function keyToQmk(key) {
+  if (/^[a-z]$/.test(key)) return `KC_${key.toUpperCase()}`;
+  if (/^[0-9]$/.test(key)) return `KC_${key}`;
+  if (/^f([1-9]|1[0-9]|2[0-4])$/.test(key)) return `KC_${key.toUpperCase()}`;
+  return NAMED_KEYS[key] || null;
+}
+
+function qmkToKey(keycode) {
+  const m = keycode.match(/^KC_([A-Z0-9]|F[0-9]{1,2})$/);
+  if (m) return m[1].toLowerCase();
+  return NAMED_KEYS_REVERSE[keycode] || null;
+}
+
+// "shift+cmd+p" → "LSFT(LGUI(KC_P))"
+function chordToQmk(chord) {
+  const tokens = chord.split('+');
+  const key = keyToQmk(tokens.pop());
+  if (!key) return null;
+  return tokens.reduceRight((expr, mod) => `${MODIFIER_WRAPPERS[mod]}(${expr})`, key);
+}
+
+// "LSFT(LCA(KC_LEFT))" → "ctrl+shift+alt+left" (null when not a plain modifier combo)
+function qmkToChord(expr) {
+  const mods = new Set();
+  let rest = expr.replace(/\s+/g, '');
+  for (;;) {
+    const m = rest.match(/^([A-Z]+)\((.*)\)$/);
+    if (!m) break;
+    const fn = QMK_MODIFIER_FUNCS[m[1]];
+    if (!fn) return null;
+    fn.forEach(mod => mods.add(mod));
+    rest = m[2];
+  }
+  const key = qmkToKey(rest);
+  if (!key) return null;
+  return normalizeChord([...mods, key].join('+'));
+}
+
+// ============================================
+// keymap.c scanning
+// ============================================
+
+function readCustomKeycodes(keymapSource) {
+  const m = keymapSource.match(/enum\s+custom_keycodes\s*\{([\s\S]*?)\};/);
+  if (!m) return [];
+  return m[1]
+    .split('\n')
+    .map(line => line.replace(/\/\/.*$/, '').trim())
+    .map(line => line.match(/^(\w+)/))
+    .filter(Boolean)
+    .map(match => match[1]);
+}
+
+function readModifierMacros(keymapSource) {
+  const macros = [];
+  const re = /^#define\s+(\w+)\s+(.+?)\s*(?:\/\/.*)?$/gm;
+  let m;
+  while ((m = re.exec(keymapSource)) !== null) {
+    if (!CONFLICT_PREFIXES.some(prefix => m[1].startsWith(prefix))) continue;
+    const chord = qmkToChord(m[2]);
+    if (chord) macros.push({ name: m[1], expr: m[2], chord });
+  }
+  return macros;
+}
+
+// ============================================
+// Generation
+// ============================================
+
+// Pick the chord Cursor actually responds to: user bindings win, then
+// unconditional defaults, then the first default
+function resolveChord(db, action) {
+  if (action.chord) {
+    return { chord: normalizeChord(action.chord), key: action.chord, source: 'spec', when: null };
+  }
+  const bindings = lookupCommand(db, action.command);
+  if (bindings.length === 0) return null;
+  const preferred = bindings.find(b => b.source === 'user') || bindings.find(b => !b.when) || bindings[0];
+  return preferred;
+}
+
+// The header names keycodes, not enum values: of enum custom_keycodes only the
+// run the table is indexed by counts, so unrelated keycodes leave it valid
+function inputsHash(db, spec, specText, keymapSource) {
+  const keycodes = readCustomKeycodes(keymapSource);
+  const first = keycodes.indexOf(spec.macros[0].keycode);
+  const hash = crypto.createHash('sha1');
+  hash.update(`v${GENERATOR_VERSION}\n`);
+  db.sources.forEach(s => hash.update(`${s.kind}:${s.sha1}\n`));
+  hash.update(specText);
+  readModifierMacros(keymapSource).forEach(m => hash.update(`${m.name}=${m.chord}\n`));
+  hash.update(first < 0 ? '' : keycodes.slice(first, first + spec.macros.length).join(','));
+  return hash.digest('hex');
+}
+
+function renderHeader(spec, resolved, hash) {
+  const maxChords = Math.max(1, ...resolved.map(r => r.chords.length));
+  const first = resolved[0].action.keycode;
+  const last = resolved[resolved.length - 1].action.keycode;
+  const lines = [];
+  lines.push(`/* Generated by scripts/generate-cursor-layer.js from ${SPEC_FILE} - do not edit.`);
+  lines.push(' * Regenerate: node scripts/generate-cursor-layer.js');
+  lines.push(` * inputs: ${hash}`);
+  lines.push(' */');
+  lines.push('#pragma once');
+  lines.push('');
+  lines.push(`#define CURSOR_MACRO_FIRST      ${first}`);
+  lines.push(`#define CURSOR_MACRO_LAST       ${last}`);
+  lines.push(`#define CURSOR_MACRO_MAX_CHORDS ${maxChords}`);
+  lines.push('');
+  lines.push('// Chords tapped in order for each CURSOR_LAYER action (KC_NO = end)');
+  lines.push('static const uint16_t PROGMEM cursor_macro_chords[][CURSOR_MACRO_MAX_CHORDS] = {');
+  for (const r of resolved) {
+    const cells = [...r.qmk];
+    while (cells.length < maxChords) cells.push('KC_NO');
+    lines.push(`    // ${r.action.key}: ${r.action.label} - ${r.action.command} (${r.binding.key})`);
+    lines.push(`    [${r.action.keycode} - CURSOR_MACRO_FIRST] = { ${cells.join(', ')} },`);
+  }
+  lines.push('};');
+  lines.push('');
+  return lines.join('\n');
+}
+
+function main() {
+  const args = process.argv.slice(2);
+  const force = args.includes('--force');
+  const checkOnly = args.includes('--check');
+  const keymapDir = path.resolve(args.find(a => !a.startsWith('--')) || DEFAULT_KEYMAP_DIR);
+
+  const specPath = path.join(keymapDir, SPEC_FILE);
+  const keymapPath = path.join(keymapDir, 'keymap.c');
+  const headerPath = path.join(keymapDir, HEADER_FILE);
+  for (const file of [specPath, keymapPath]) {
+    if (!fs.existsSync(file)) {
+      console.error(`Not found: ${file}`);
+      process.exit(1);
+    }
+  }
+
+  const specText = fs.readFileSync(specPath, 'utf8');
+  const spec = JSON.parse(specText);
+  const keymapSource = fs.readFileSync(keymapPath, 'utf8');
+  const db = loadDb();
+  const hash = inputsHash(db, spec, specText, keymapSource);
+
+  if (!force && fs.existsSync(headerPath) && fs.readFileSync(headerPath, 'utf8').includes(`inputs: ${hash}`)) {
+    console.log(`Up to date: ${path.relative(REPO_DIR, headerPath)}`);
+    return;
+  }
+  if (checkOnly) {
+    console.error(`Out of date: ${path.relative(REPO_DIR, headerPath)} (run node scripts/generate-cursor-layer.js)`);
+    process.exit(1);
+  }
+
+  const errors = [];
+
+  // The table is indexed by keycode offset, so the enum entries must be contiguous and in order
+  const keycodes = readCustomKeycodes(keymapSource);
+  const firstIndex = keycodes.indexOf(spec.macros[0].keycode);
+  spec.macros.forEach((action, i) => {
+    if (firstIndex < 0 || keycodes[firstIndex + i] !== action.keycode) {
+      errors.push(`${action.keycode} must follow ${i === 0 ? 'in' : spec.macros[i - 1].keycode + ' in'} enum custom_keycodes (table is indexed by offset)`);
+    }
+  });
+
+  // Resolve chords
+  const resolved = [];
+  for (const action of spec.macros) {
+    const binding = resolveChord(db, action);
+    if (!binding) {
+      errors.push(`${action.keycode}: no keybinding for ${action.command} (bind it in Cursor or set "chord")`);
+      continue;
+    }
+    const chords = binding.chord.split(' ');
+    const qmk = chords.map(chordToQmk);
+    if (qmk.includes(null)) {
+      errors.push(`${action.keycode}: cannot express "${binding.key}" as QMK keycodes`);
+      continue;
+    }
+    resolved.push({ action, binding, chords, qmk });
+  }
+
+  // Conflicts with global APP_LAYER / WIN_LAYER shortcuts and between actions
+  const globalChords = new Map(readModifierMacros(keymapSource).map(m => [m.chord, m]));
+  const seen = new Map();
+  for (const r of resolved) {
+    for (const chord of r.chords) {
+      const clash = globalChords.get(chord);
+      if (clash) {
+        errors.push(`${r.action.keycode}: ${chord} (${r.action.command}) is taken by ${clash.name} = ${clash.expr}`);
+      }
+    }
+    if (seen.has(r.binding.chord)) {
+      errors.push(`${r.action.keycode}: ${r.binding.chord} duplicates ${seen.get(r.binding.chord)}`);
+    }
+    seen.set(r.binding.chord, r.action.keycode);
+  }
+
+  if (errors.length > 0) {
+    errors.forEach(e => console.error(`✗ ${e}`));
+    process.exit(1);
+  }
+
+  fs.writeFileSync(headerPath, renderHeader(spec, resolved, hash));
+  console.log(`Generated: ${path.relative(REPO_DIR, headerPath)}`);
+  resolved.forEach(r => console.log(`  ${r.action.key.padEnd(2)} ${r.action.keycode.padEnd(28)} ${r.binding.key.padEnd(16)} ${r.action.command}`));
+}
+
+main();
@@ -2,18 +2,16 @@
 
 const fs = require('fs');
 
-const keybindingsFile = '/tmp/cursor-default-keybindings.json';
+const { loadDb } = require('./keybinding-db');
 
-if (!fs.existsSync(keybindingsFile)) {
+let db;
+try {
+  db = loadDb();
+} catch (e) {
   console.error('Keybindings file not found. Please download it first.');
   process.exit(1);
 }
-
-// Read and strip comments
-let content = fs.readFileSync(keybindingsFile, 'utf8');
-content = content.replace(/\/\/.*$/gm, '');
-content = content.replace(/\/\*[\s\S]*?\*\//g, '');
-const keybindings = JSON.parse(content);
+const keybindings = db.bindings.filter(k => k.source === 'default');
 
 // Sort by key, then by command
 keybindings.sort((a, b) => {
@@ -28,10 +26,8 @@ keybindings.sort((a, b) => {
   return 0;
 });
 
-// Filter for cmd+k keybindings
-const cmdKKeybindings = keybindings.filter(k => 
-  k.key && k.key.toLowerCase().includes('cmd+k')
-);
+// Cmd+K keybindings: chord sequences starting with cmd+k (sorted like the full list)
+const cmdKKeybindings = keybindings.filter(k => k.chord.split(' ')[0] === 'cmd+k');
 
 const output = [];
 
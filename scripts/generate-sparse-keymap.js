@@ -0,0 +1,332 @@
+#!/usr/bin/env node
+//
+// Generate the sparse keymap tables from keymap.c
+//
+// Reads the LAYOUT_* layers (keymaps[]) and encoder_map[] from the keymap's
+// keymap.c, maps every layout key to its matrix position through the
+// keyboard's info.json and writes sparse_keymap_table.h next to keymap.c:
+// per layer a bitmap of the positions that are not _______ plus the keycodes
+// of those positions, packed (see sparse_keymap.h for the lookup).
+//
+// Keycodes are copied as written, so the compiler still resolves custom
+// keycodes, tap dances and modifier macros.
+// Regeneration is skipped when the inputs hash recorded in the header matches.
+//
+// Usage: node scripts/generate-sparse-keymap.js [keymap_dir] [--force] [--check]
+//   keymap_dir  Default: keychron/q11/ansi_encoder/keymaps/j-custom
+//   --force     Regenerate even if the header is up to date
+//   --check     Only verify the header is up to date (exit 1 if not)
+//
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+
+const REPO_DIR = path.resolve(__dirname, '..');
+const DEFAULT_KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const HEADER_FILE = 'sparse_keymap_table.h';
+const GENERATOR_VERSION = 1;
+
+const TRANSPARENT = new Set(['_______', 'KC_TRNS', 'KC_TRANSPARENT']);
+
+// ============================================
+// C source scanning
+// ============================================
+
+function stripComments(source) {
+  return source.replace(/\/\*[\s\S]*?\*\/|\/\/[^\n]*|"(?:\\.|[^"\\])*"|'(?:\\.|[^'\\])*'/g,
+    m => (m.startsWith('/') ? ' ' : m));
+}
+
+// Index just past the bracket matching source[open]
+function matchBracket(source, open) {
+  const pairs = { '(': ')', '{': '}', '[': ']' };
+  const stack = [];
+  for (let i = open; i < source.length; i++) {
+    const c = source[i];
+    if (pairs[c]) stack.push(pairs[c]);
+    else if (c === stack[stack.length - 1]) {
+      stack.pop();
+      if (stack.length === 0) return i + 1;
+    }
+  }
+  throw new Error(`unbalanced '${source[open]}'`);
+}
+
+// Split on commas outside brackets
+function splitTopLevel(text) {
+  const parts = [];
+  let depth = 0;
+  let current = '';
+  for (const c of text) {
+    if ('({['.includes(c)) depth++;
+    if (')}]'.includes(c)) depth--;
+    if (c === ',' && depth === 0) {
+      parts.push(current);
+      current = '';
+    } else {
+      current += c;
+    }
+  }
+  parts.push(current);
+  return parts.map(p => p.replace(/\s+/g, ' ').trim()).filter(p => p.length > 0);
+}
+
+// Body of the first non-empty initializer of an array declared as `<name>[]...`
+function arrayInitializer(source, names, file) {
+  const re = new RegExp(`\\b(?:${names.join('|')})\\s*\\[\\][^=;]*=\\s*\\{`, 'g');
+  for (const m of source.matchAll(re)) {
+    let open = m.index + m[0].length - 1;
+    // #ifdef'd alternative declarations (sparse source / plain array) share one initializer
+    for (let next; (next = source.slice(open + 1).match(/^\s*(?:static|const)\b[^;{]*=\s*\{/));) {
+      open += next[0].length;
+    }
+    const body = source.slice(open + 1, matchBracket(source, open) - 1);
+    if (body.trim().length > 0) return body;
+  }
+  throw new Error(`${file}: no ${names.join(' / ')} initializer found`);
+}
+
+// `[NAME] = value` entries of a designated initializer
+function designatedEntries(body) {
+  return splitTopLevel(body).map(entry => {
+    const m = entry.match(/^\[\s*(\w+)\s*\]\s*=\s*([\s\S]+)$/);
+    if (!m) throw new Error(`expected [LAYER] = ... entries, got: ${entry.slice(0, 60)}`);
+    return { layer: m[1], value: m[2] };
+  });
+}
+
+function readLayerEnum(source, file) {
+  const m = source.match(/enum\s+layers\s*\{([^}]*)\}/);
+  if (!m) throw new Error(`${file}: enum layers not found`);
+  let next = 0;
+  const layers = {};
+  for (const item of splitTopLevel(m[1])) {
+    const [name, value] = item.split('=').map(s => s.trim());
+    next = value !== undefined ? Number(value) : next;
+    layers[name] = next++;
+  }
+  return layers;
+}
+
+// ============================================
+// Keyboard geometry
+// ============================================
+
+function findInfoJson(keymapDir, layoutMacro) {
+  for (let dir = keymapDir; dir !== path.dirname(dir); dir = path.dirname(dir)) {
+    for (const name of ['keyboard.json', 'info.json']) {
+      const file = path.join(dir, name);
+      if (!fs.existsSync(file)) continue;
+      const info = JSON.parse(fs.readFileSync(file, 'utf8'));
+      if (info.layouts && info.layouts[layoutMacro]) return { file, info };
+    }
+    if (path.basename(dir) === 'keychron' || dir === REPO_DIR) break;
+  }
+  throw new Error(`no info.json with ${layoutMacro} above ${keymapDir}`);
+}
+
+function geometry(info, layoutMacro) {
+  const pins = info.matrix_pins;
+  const split = info.split && info.split.enabled;
+  const rows = pins.rows.length * (split ? 2 : 1);
+  const cols = pins.cols.length;
+  const keys = info.layouts[layoutMacro].layout.map(k => k.matrix);
+  keys.forEach(([r, c], i) => {
+    if (r >= rows || c >= cols) throw new Error(`${layoutMacro} key ${i} at [${r}, ${c}] outside ${rows}x${cols} matrix`);
+  });
+  return { rows, cols, keys };
+}
+
+// ============================================
+// Table building
+// ============================================
+
+function readKeymap(keymapDir) {
+  const file = path.join(keymapDir, 'keymap.c');
+  const raw = fs.readFileSync(file, 'utf8');
+  const source = stripComments(raw).replace(/^[ \t]*#.*$/gm, '');
+  const layerEnum = readLayerEnum(source, file);
+
+  const layers = designatedEntries(arrayInitializer(source, ['keymaps_source', 'keymaps'], file)).map(e => {
+    const m = e.value.match(/^(LAYOUT\w*)\s*\(([\s\S]*)\)$/);
+    if (!m) throw new Error(`${file}: [${e.layer}] is not a LAYOUT_* call`);
+    return { name: e.layer, macro: m[1], keys: splitTopLevel(m[2]) };
+  });
+
+  let encoders = null;
+  if (/\bencoder_map(?:_source)?\s*\[\]/.test(source)) {
+    encoders = {};
+    for (const e of designatedEntries(arrayInitializer(source, ['encoder_map_source', 'encoder_map'], file))) {
+      const inner = e.value.replace(/^\{([\s\S]*)\}$/, '$1');
+      // ENCODER_CCW_CW(ccw, cw) is { cw, ccw }: clockwise slot first
+      encoders[e.layer] = splitTopLevel(inner).flatMap(item => {
+        const m = item.match(/^ENCODER_CCW_CW\s*\(([\s\S]*)\)$/);
+        if (!m) throw new Error(`${file}: encoder_map [${e.layer}] entry is not ENCODER_CCW_CW(): ${item}`);
+        const [ccw, cw] = splitTopLevel(m[1]);
+        return [cw, ccw];
+      });
+    }
+  }
+  return { file, layerEnum, layers, encoders, source };
+}
+
+function buildTables(keymap, geo) {
+  const encoderSlots = keymap.encoders ? Math.max(0, ...Object.values(keymap.encoders).map(e => e.length)) : 0;
+  const matrixSlots = geo.rows * geo.cols;
+  const slots = matrixSlots + encoderSlots;
+  const words = Math.ceil(slots / 32);
+  const count = Math.max(...Object.values(keymap.layerEnum)) + 1;
+
+  const byIndex = new Array(count).fill(null);
+  for (const layer of keymap.layers) {
+    const index = keymap.layerEnum[layer.name];
+    if (index === undefined) throw new Error(`${keymap.file}: [${layer.name}] is not in enum layers`);
+    if (layer.keys.length !== geo.keys.length) {
+      throw new Error(`${keymap.file}: [${layer.name}] has ${layer.keys.length} keys, ${layer.macro} has ${geo.keys.length}`);
+    }
+    byIndex[index] = layer;
+  }
+
+  const tables = [];
+  let base = 0;
+  byIndex.forEach((layer, index) => {
+    const name = Object.keys(keymap.layerEnum).find(n => keymap.layerEnum[n] === index);
+    if (!layer) throw new Error(`${keymap.file}: layer ${name} has no keymaps[] entry`);
+    const slotKeys = new Array(slots).fill(null);
+    layer.keys.forEach((key, i) => {
+      const [r, c] = geo.keys[i];
+      slotKeys[r * geo.cols + c] = key;
+    });
+    const encoder = (keymap.encoders && keymap.encoders[name]) || [];
+    encoder.forEach((key, i) => { slotKeys[matrixSlots + i] = key; });
+
+    const bits = new Array(words).fill(0);
+    const rank = new Array(words).fill(0);
+    const stored = [];
+    slotKeys.forEach((key, slot) => {
+      if (key === null || TRANSPARENT.has(key)) return;
+      bits[slot >> 5] = (bits[slot >> 5] | (1 << (slot & 31))) >>> 0;
+      stored.push(key);
+    });
+    let before = 0;
+    for (let w = 0; w < words; w++) {
+      rank[w] = before;
+      before += bits[w].toString(2).replace(/0/g, '').length;
+    }
+    tables.push({ name, bits, rank, base, stored });
+    base += stored.length;
+  });
+
+  return { tables, slots, words, matrixSlots, encoderSlots, total: base };
+}
+
+// Flash bytes: sparse_layer_t is bits[words] + base + rank[words], padded to 4
+function sizes(built, layerCount) {
+  const entry = Math.ceil((built.words * 4 + 2 + built.words) / 4) * 4;
+  return {
+    dense: layerCount * built.slots * 2,
+    sparse: layerCount * entry + built.total * 2 + 1,
+  };
+}
+
+function inputsHash(keymap, geo) {
+  const hash = crypto.createHash('sha1');
+  hash.update(`v${GENERATOR_VERSION}\n`);
+  hash.update(JSON.stringify(keymap.layerEnum));
+  hash.update(JSON.stringify(keymap.layers));
+  hash.update(JSON.stringify(keymap.encoders));
+  hash.update(JSON.stringify(geo));
+  return hash.digest('hex');
+}
+
+function renderHeader(built, geo, hash) {
+  const { dense, sparse } = sizes(built, built.tables.length);
+  const hex = v => `0x${v.toString(16).toUpperCase().padStart(8, '0')}`;
+  const lines = [];
+  lines.push('/* Generated by scripts/generate-sparse-keymap.js from keymap.c - do not edit.');
+  lines.push(' * Regenerate: node scripts/generate-sparse-keymap.js');
+  lines.push(` * inputs: ${hash}`);
+  lines.push(` * ${built.tables.length} layers, ${built.total} of ${built.tables.length * built.slots} slots stored: ${sparse} bytes (dense: ${dense})`);
+  lines.push(' */');
+  lines.push('#pragma once');
+  lines.push('');
+  lines.push(`_Static_assert(MATRIX_ROWS == ${geo.rows} && MATRIX_COLS == ${geo.cols}, "${HEADER_FILE}: generated for a ${geo.rows}x${geo.cols} matrix");`);
+  lines.push(`_Static_assert(SPARSE_KEYMAP_ENCODER_SLOTS == ${built.encoderSlots}, "${HEADER_FILE}: generated for ${built.encoderSlots} encoder_map slots");`);
+  lines.push('');
+  lines.push(`#define SPARSE_KEYMAP_LAYERS ${built.tables.length}`);
+  lines.push('');
+  lines.push('const uint8_t PROGMEM sparse_keymap_layer_count = SPARSE_KEYMAP_LAYERS;');
+  lines.push('');
+  lines.push('const sparse_layer_t PROGMEM sparse_keymap_layers[] = {');
+  for (const t of built.tables) {
+    lines.push(`    [${t.name}] = { .bits = { ${t.bits.map(hex).join(', ')} }, .base = ${t.base}, .rank = { ${t.rank.join(', ')} } },  // ${t.stored.length} stored`);
+  }
+  lines.push('};');
+  lines.push('');
+  lines.push('// Stored keycodes per layer in slot order: matrix row by row, then encoder_map');
+  lines.push('const uint16_t PROGMEM sparse_keymap_keys[] = {');
+  for (const t of built.tables) {
+    lines.push(`    // ${t.name}`);
+    for (let i = 0; i < t.stored.length; i += 6) {
+      lines.push(`    ${t.stored.slice(i, i + 6).join(', ')},`);
+    }
+  }
+  lines.push('};');
+  lines.push('');
+  return lines.join('\n');
+}
+
+// ============================================
+// Main
+// ============================================
+
+function main() {
+  const args = process.argv.slice(2);
+  const force = args.includes('--force');
+  const checkOnly = args.includes('--check');
+  if (args.includes('-h') || args.includes('--help')) {
+    console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+      .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+    return 0;
+  }
+  const keymapDir = path.resolve(args.find(a => !a.startsWith('--')) || DEFAULT_KEYMAP_DIR);
+  const headerPath = path.join(keymapDir, HEADER_FILE);
+
+  const keymap = readKeymap(keymapDir);
+  const macro = keymap.layers[0].macro;
+  const { info } = findInfoJson(keymapDir, macro);
+  const geo = geometry(info, macro);
+  const hash = inputsHash(keymap, geo);
+  const rel = path.relative(REPO_DIR, headerPath);
+
+  if (!force && fs.existsSync(headerPath) && fs.readFileSync(headerPath, 'utf8').includes(`inputs: ${hash}`)) {
+    console.log(`${rel} is up to date`);
+    return 0;
+  }
+  if (checkOnly) {
+    console.error(`${rel} is out of date with keymap.c; run: node scripts/generate-sparse-keymap.js`);
+    return 1;
+  }
+
+  const built = buildTables(keymap, geo);
+  fs.writeFileSync(headerPath, renderHeader(built, geo, hash));
+  const { dense, sparse } = sizes(built, built.tables.length);
+  console.log(`Wrote ${rel}`);
+  for (const t of built.tables) {
+    console.log(`  ${t.name.padEnd(16)} ${String(t.stored.length).padStart(4)} / ${built.slots} stored`);
+  }
+  console.log(`  flash: ${sparse} bytes sparse, ${dense} bytes dense (${dense - sparse} saved)`);
+  return 0;
+}
+
+if (require.main === module) {
+  try {
+    process.exit(main());
+  } catch (err) {
+    console.error(`generate-sparse-keymap: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { readKeymap, buildTables, geometry };
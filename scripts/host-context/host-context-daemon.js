@@ -0,0 +1,229 @@
+#!/usr/bin/env node
+
+//
+// Host context daemon
+//
+// Watches the focused application and pushes its ID to the keyboard over the
+// raw HID host context channel (j-custom/host_context.h), so the keymap can
+// apply per-app overlay layers and retarget the RGUI tap (e.g. straight into
+// CURSOR_LAYER while Cursor is focused). Sends only on focus changes plus a
+// heartbeat PING; the firmware clears the context if the daemon goes silent.
+//
+// Usage: node scripts/host-context/host-context-daemon.js [options]
+//
+// Options:
+//   --source <macos|stdin>   Focus source (default: macos on darwin, else stdin)
+//   --transport <spec>       loopback | hidraw:/dev/hidrawN | hid (default: hid)
+//   --poll <ms>              Focus poll interval for the macos source (default: 250)
+//   --heartbeat <ms>         PING interval (default: 1000)
+//   --verbose                Log every reply
+//
+// The stdin source reads one application name or bundle id per line, which
+// makes it easy to drive from other tools (or by hand with --transport loopback).
+//
+
+const { execFile } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const readline = require('readline');
+const { RAW_EPSIZE, openTransport } = require('./raw-hid-transport');
+
+const HEADER = path.join(__dirname, '..', '..', 'keychron/q11/ansi_encoder/keymaps/j-custom/host_context.h');
+const APPS_FILE = path.join(__dirname, 'apps.json');
+
+// ============================================
+// Protocol (values read from host_context.h)
+// ============================================
+
+function parseHeader(file = HEADER) {
+  const source = fs.readFileSync(file, 'utf8');
+  const defines = {};
+  for (const m of source.matchAll(/#\s*define\s+(HOST_CONTEXT_\w+)\s+(0x[0-9A-Fa-f]+|\d+)/g)) {
+    defines[m[1]] = Number(m[2]);
+  }
+  for (const m of source.matchAll(/^\s*((?:HOST_CONTEXT|HC_APP)_\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)/gm)) {
+    defines[m[1]] = Number(m[2]);
+  }
+  const required = ['HOST_CONTEXT_CHANNEL', 'HOST_CONTEXT_REPLY', 'HOST_CONTEXT_OP_SET', 'HOST_CONTEXT_OP_CLEAR',
+    'HOST_CONTEXT_OP_PING', 'HOST_CONTEXT_OP_QUERY', 'HC_APP_NONE'];
+  const missing = required.filter(name => defines[name] === undefined);
+  if (missing.length > 0) throw new Error(`${file}: missing ${missing.join(', ')}`);
+  return defines;
+}
+
+function createProtocol(defines = parseHeader()) {
+  let seq = 0;
+  return {
+    defines,
+    frame(opcode, appId = 0) {
+      const frame = Buffer.alloc(RAW_EPSIZE);
+      seq = (seq + 1) & 0xff;
+      frame[0] = defines.HOST_CONTEXT_CHANNEL;
+      frame[1] = opcode;
+      frame[2] = seq;
+      frame.writeUInt16LE(appId, 3);
+      return frame;
+    },
+    parseReply(reply) {
+      return {
+        channel: reply[0],
+        opcode: reply[1] & ~defines.HOST_CONTEXT_REPLY,
+        isReply: (reply[1] & defines.HOST_CONTEXT_REPLY) !== 0,
+        seq: reply[2],
+        status: reply[3],
+        app: reply.readUInt16LE(4),
+        layerState: reply.readUInt32LE(6),
+        helperLayer: reply[10],
+      };
+    },
+  };
+}
+
+// Application name / bundle id -> app id
+function loadAppMap(defines, file = APPS_FILE) {
+  const config = JSON.parse(fs.readFileSync(file, 'utf8'));
+  const map = new Map();
+  for (const [name, entry] of Object.entries(config)) {
+    if (name.startsWith('_')) continue;
+    if (defines[name] === undefined) throw new Error(`${file}: ${name} is not defined in host_context.h`);
+    for (const key of [...(entry.names || []), ...(entry.bundleIds || [])]) {
+      map.set(key.toLowerCase(), defines[name]);
+    }
+  }
+  return map;
+}
+
+// ============================================
+// Focus sources
+// ============================================
+
+const FRONTMOST_SCRIPT = 'tell application "System Events" to set p to first process whose frontmost is true\n' +
+  'return (name of p) & "\\n" & (bundle identifier of p)';
+
+function watchMacos(pollMs, onFocus) {
+  let last = null;
+  let busy = false;
+  const timer = setInterval(() => {
+    if (busy) return;
+    busy = true;
+    execFile('osascript', ['-e', FRONTMOST_SCRIPT], (err, stdout) => {
+      busy = false;
+      if (err) return;
+      const [name, bundleId] = stdout.trim().split('\n');
+      const key = `${name}\n${bundleId}`;
+      if (key !== last) {
+        last = key;
+        onFocus([name, bundleId]);
+      }
+    });
+  }, pollMs);
+  return () => clearInterval(timer);
+}
+
+function watchStdin(onFocus, onEnd) {
+  const rl = readline.createInterface({ input: process.stdin });
+  rl.on('line', line => {
+    const name = line.trim();
+    if (name) onFocus([name]);
+  });
+  rl.on('close', onEnd);
+  return () => rl.close();
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = {
+    source: process.platform === 'darwin' ? 'macos' : 'stdin',
+    transport: 'hid',
+    poll: 250,
+    heartbeat: 1000,
+    verbose: false,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--source': options.source = value(); break;
+      case '--transport': options.transport = value(); break;
+      case '--poll': options.poll = Number(value()); break;
+      case '--heartbeat': options.heartbeat = Number(value()); break;
+      case '--verbose': options.verbose = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  if (!['macos', 'stdin'].includes(options.source)) throw new Error(`Unknown source: ${options.source}`);
+  return options;
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const protocol = createProtocol();
+  const { defines } = protocol;
+  const apps = loadAppMap(defines);
+  const transport = openTransport(options.transport);
+  let current = null;
+  let chain = Promise.resolve();
+
+  // Requests are chained so focus changes and heartbeats never interleave
+  const send = (opcode, appId, label) => {
+    chain = chain.then(async () => {
+      const started = process.hrtime.bigint();
+      const reply = protocol.parseReply(await transport.request(protocol.frame(opcode, appId)));
+      const micros = Number(process.hrtime.bigint() - started) / 1000;
+      if (options.verbose || opcode !== defines.HOST_CONTEXT_OP_PING) {
+        console.log(`${label}: status=${reply.status} app=${reply.app} ` +
+          `layers=0x${reply.layerState.toString(16).padStart(8, '0')} helper=${reply.helperLayer} (${micros.toFixed(0)}us)`);
+      }
+    }).catch(err => {
+      console.error(`host-context: ${err.message}`);
+      process.exitCode = 1;
+    });
+    return chain;
+  };
+
+  const onFocus = keys => {
+    const appId = keys.map(k => apps.get(String(k).toLowerCase())).find(id => id !== undefined) ?? defines.HC_APP_NONE;
+    if (appId === current) return;
+    current = appId;
+    if (appId === defines.HC_APP_NONE) {
+      send(defines.HOST_CONTEXT_OP_CLEAR, 0, `clear (${keys[0]})`);
+    } else {
+      send(defines.HOST_CONTEXT_OP_SET, appId, `set ${keys[0]}`);
+    }
+  };
+
+  const heartbeat = setInterval(() => send(defines.HOST_CONTEXT_OP_PING, 0, 'ping'), options.heartbeat);
+  const shutdown = async () => {
+    clearInterval(heartbeat);
+    stop();
+    await send(defines.HOST_CONTEXT_OP_CLEAR, 0, 'clear (exit)');
+    await transport.close();
+  };
+  const stop = options.source === 'macos'
+    ? watchMacos(options.poll, onFocus)
+    : watchStdin(onFocus, shutdown);
+  process.on('SIGINT', () => shutdown().then(() => process.exit(0)));
+  process.on('SIGTERM', () => shutdown().then(() => process.exit(0)));
+}
+
+if (require.main === module) {
+  main().catch(err => {
+    console.error(`host-context: ${err.message}`);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseHeader, createProtocol, loadAppMap };
@@ -0,0 +1,103 @@
+#!/usr/bin/env node
+
+//
+// Loopback check for the host context channel
+//
+// Compiles j-custom/host_context.c for the host (loopback/ harness, 300ms
+// timeout) and drives it through the same transport and protocol code as the
+// daemon: focus switches, unknown apps, clear, heartbeat latency and the
+// silent-daemon timeout, with the key remap profile keymap.c selects for each
+// (the harness's LOOPBACK_CHANNEL). Exits non-zero on the first mismatch.
+//
+// Usage: node scripts/host-context/loopback-test.js [--iterations <n>]
+//
+
+const { openTransport } = require('./raw-hid-transport');
+const { createProtocol } = require('./host-context-daemon');
+
+const TIMEOUT_MS = 300;
+const CURSOR_LAYER = 3;
+const BASE_STATE = 1;  // MAC_BASE
+const LOOPBACK_CHANNEL = 0xfe;  // host_context_loopback.c
+const REMAP = ['none', 'windows'];  // LOOPBACK_REMAP_*
+
+const sleep = ms => new Promise(resolve => setTimeout(resolve, ms));
+
+async function main() {
+  const iterIndex = process.argv.indexOf('--iterations');
+  const iterations = iterIndex > 0 ? Number(process.argv[iterIndex + 1]) : 1000;
+  const protocol = createProtocol();
+  const d = protocol.defines;
+  const transport = openTransport('loopback', { timeoutMs: TIMEOUT_MS });
+  let failures = 0;
+
+  const request = async (opcode, appId = 0) => {
+    const frame = protocol.frame(opcode, appId);
+    const reply = protocol.parseReply(await transport.request(frame));
+    if (reply.channel !== d.HOST_CONTEXT_CHANNEL || !reply.isReply || reply.seq !== frame[2]) {
+      throw new Error(`malformed reply to opcode ${opcode}: ${JSON.stringify(reply)}`);
+    }
+    return reply;
+  };
+
+  // A host context reply with the remap profile in use after it
+  const withRemap = async pending => {
+    const reply = await pending;
+    const frame = Buffer.alloc(32);
+    frame[0] = LOOPBACK_CHANNEL;
+    const state = await transport.request(frame);
+    return { ...reply, remap: REMAP[state[1]] };
+  };
+
+  const expect = (label, reply, want) => {
+    const diffs = Object.entries(want).filter(([k, v]) => reply[k] !== v);
+    if (diffs.length === 0) {
+      console.log(`  ok    ${label}`);
+    } else {
+      failures++;
+      console.log(`  FAIL  ${label}: ${diffs.map(([k, v]) => `${k}=${reply[k]} (want ${v})`).join(', ')}`);
+    }
+  };
+
+  console.log('Host context loopback:');
+  expect('query at start', await withRemap(request(d.HOST_CONTEXT_OP_QUERY)),
+    { status: d.HOST_CONTEXT_OK, app: d.HC_APP_NONE, layerState: BASE_STATE, helperLayer: d.HOST_CONTEXT_NO_LAYER, remap: 'none' });
+  expect('Cursor focused: helper layer only', await withRemap(request(d.HOST_CONTEXT_OP_SET, d.HC_APP_CURSOR)),
+    { status: d.HOST_CONTEXT_OK, app: d.HC_APP_CURSOR, layerState: BASE_STATE, helperLayer: CURSOR_LAYER, remap: 'none' });
+  expect('remote desktop: Windows key remap, no layers', await withRemap(request(d.HOST_CONTEXT_OP_SET, d.HC_APP_REMOTE_DESKTOP)),
+    { status: d.HOST_CONTEXT_OK, app: d.HC_APP_REMOTE_DESKTOP, layerState: BASE_STATE, helperLayer: d.HOST_CONTEXT_NO_LAYER, remap: 'windows' });
+  expect('unmapped app drops the remap', await withRemap(request(d.HOST_CONTEXT_OP_SET, d.HC_APP_BROWSER)),
+    { status: d.HOST_CONTEXT_UNKNOWN_APP, app: d.HC_APP_NONE, layerState: BASE_STATE, remap: 'none' });
+  await request(d.HOST_CONTEXT_OP_SET, d.HC_APP_REMOTE_DESKTOP);
+  expect('clear', await withRemap(request(d.HOST_CONTEXT_OP_CLEAR)),
+    { status: d.HOST_CONTEXT_OK, app: d.HC_APP_NONE, layerState: BASE_STATE, remap: 'none' });
+  expect('bad opcode', await request(0x7f), { status: d.HOST_CONTEXT_BAD_REQUEST });
+
+  // Round-trip latency through the full host path (transport + firmware logic)
+  const samples = [];
+  for (let i = 0; i < iterations; i++) {
+    const started = process.hrtime.bigint();
+    await request(d.HOST_CONTEXT_OP_PING);
+    samples.push(Number(process.hrtime.bigint() - started) / 1000);
+  }
+  samples.sort((a, b) => a - b);
+  const pct = p => samples[Math.min(samples.length - 1, Math.floor(samples.length * p))].toFixed(0);
+  console.log(`  info  ping round trip over ${iterations}: p50 ${pct(0.5)}us, p99 ${pct(0.99)}us`);
+
+  await request(d.HOST_CONTEXT_OP_SET, d.HC_APP_REMOTE_DESKTOP);
+  await sleep(TIMEOUT_MS * 2);
+  expect('silent daemon times out', await withRemap(request(d.HOST_CONTEXT_OP_QUERY)),
+    { app: d.HC_APP_NONE, layerState: BASE_STATE, remap: 'none' });
+
+  await transport.close();
+  if (failures > 0) {
+    console.log(`${failures} check(s) failed`);
+    process.exit(1);
+  }
+  console.log('All checks passed');
+}
+
+main().catch(err => {
+  console.error(`loopback-test: ${err.message}`);
+  process.exit(1);
+});
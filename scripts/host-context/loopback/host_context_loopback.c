@@ -0,0 +1,114 @@
+/* Loopback harness for the host context channel
+ *
+ * Links the keymap's host_context.c (and the timer_wheel.c it expires on)
+ * against qmk_stubs.h and speaks the raw HID report format over stdin/stdout
+ * (RAW_EPSIZE-byte frames each way), so the host daemon and loopback-test.js
+ * can exercise the firmware logic with no keyboard attached. The table and
+ * host_context_changed_user() mirror j-custom's keymap.c: a focused remote
+ * desktop selects the Windows key remap profile (key_remap.h).
+ *
+ * One extra channel, LOOPBACK_CHANNEL, reports what the keymap side did:
+ *   Request: [0] LOOPBACK_CHANNEL
+ *   Reply:   [0] LOOPBACK_CHANNEL  [1] remap profile (LOOPBACK_REMAP_*)
+ *
+ * Build: cc -O2 -I. -DQMK_KEYBOARD_H='"qmk_stubs.h"' -DHOST_CONTEXT_TIMEOUT=300 \
+ *           -o host_context_loopback host_context_loopback.c \
+ *           .../j-custom/host_context.c .../j-custom/timer_wheel.c
+ */
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "qmk_stubs.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/host_context.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/key_remap.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/timer_wheel.h"
+
+#define LOOPBACK_CHANNEL       0xFE
+#define LOOPBACK_REMAP_NONE    0
+#define LOOPBACK_REMAP_WINDOWS 1
+
+// j-custom layer numbers (enum layers in keymap.c)
+#define CURSOR_LAYER 3
+
+const host_context_entry_t host_context_table[] = {
+    { HC_APP_CURSOR,         0,                    CURSOR_LAYER          },
+    { HC_APP_VSCODE,         0,                    CURSOR_LAYER          },
+    { HC_APP_REMOTE_DESKTOP, 0,                    HOST_CONTEXT_NO_LAYER },
+};
+const uint8_t host_context_table_size = sizeof(host_context_table) / sizeof(host_context_table[0]);
+
+// ============================================
+// Keymap side (keymap.c, Key Remap)
+// ============================================
+
+static const key_remap_profile_t  win_profile = { .mods = { KEY_REMAP_GUI, KEY_REMAP_SHIFT, KEY_REMAP_ALT, KEY_REMAP_CTRL } };
+static const key_remap_profile_t *remap       = NULL;
+
+void key_remap_set(const key_remap_profile_t *profile) {
+    remap = profile;
+}
+
+void host_context_changed_user(uint16_t app_id) {
+    key_remap_set(host_context_app() == HC_APP_REMOTE_DESKTOP ? &win_profile : NULL);
+}
+
+// ============================================
+// QMK stubs
+// ============================================
+
+layer_state_t layer_state        = 1;  // MAC_BASE
+unsigned long stub_layer_commits = 0;
+
+void layer_state_set(layer_state_t state) {
+    layer_state = state;
+    stub_layer_commits++;
+}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    fwrite(data, 1, length, stdout);
+    fflush(stdout);
+}
+
+uint32_t timer_read32(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return timer_read32() - last;
+}
+
+// ============================================
+// Main loop: frames in, replies out, housekeeping between frames
+// ============================================
+
+int main(void) {
+    uint8_t frame[RAW_EPSIZE];
+    size_t  filled = 0;
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+
+    for (;;) {
+        if (poll(&pfd, 1, 10) > 0) {
+            ssize_t n = read(STDIN_FILENO, frame + filled, sizeof(frame) - filled);
+            if (n <= 0) {
+                break;
+            }
+            filled += (size_t)n;
+            if (filled == sizeof(frame)) {
+                if (frame[0] == LOOPBACK_CHANNEL) {
+                    memset(frame + 1, 0, sizeof(frame) - 1);
+                    frame[1] = remap == &win_profile ? LOOPBACK_REMAP_WINDOWS : LOOPBACK_REMAP_NONE;
+                    raw_hid_send(frame, sizeof(frame));
+                } else if (!host_context_receive(frame, sizeof(frame))) {
+                    fprintf(stderr, "loopback: ignored frame for channel 0x%02X\n", frame[0]);
+                }
+                filled = 0;
+            }
+        }
+        timer_wheel_task();
+    }
+    fprintf(stderr, "loopback: %lu layer commits\n", stub_layer_commits);
+    return 0;
+}
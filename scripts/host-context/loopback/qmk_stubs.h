@@ -0,0 +1,28 @@
+/* Minimal QMK environment for building keymap modules on the host
+ *
+ * Provides just enough of quantum.h / raw_hid.h / timer.h for
+ * host_context.c and timer_wheel.c to compile and run in the loopback harness.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(p)  (*(const uint8_t *)(p))
+#define pgm_read_word(p)  (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+
+#define RAW_EPSIZE 32
+
+typedef uint32_t layer_state_t;
+
+extern layer_state_t layer_state;
+extern unsigned long stub_layer_commits;
+
+void     layer_state_set(layer_state_t state);
+void     raw_hid_send(uint8_t *data, uint8_t length);
+uint32_t timer_read32(void);
+uint32_t timer_elapsed32(uint32_t last);
@@ -0,0 +1,125 @@
+//
+// Raw HID transports for host-side tools
+//
+// openTransport(spec) returns { request(frame) → Promise<reply>, close() } where
+// frames are RAW_EPSIZE-byte Buffers. Specs:
+//   loopback             Firmware logic compiled for the host (loopback/ harness, or
+//                        options.binary for another module's harness)
+//   hidraw:/dev/hidrawN  Linux hidraw device node
+//   hid                  node-hid (if installed), Keychron Q11 raw HID interface
+//
+
+const { execFileSync, spawn } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const RAW_EPSIZE = 32;
+const KEYCHRON_VID = 0x3434;
+const Q11_PID = 0x01e0;
+const RAW_USAGE_PAGE = 0xff60;
+const RAW_USAGE = 0x61;
+
+const LOOPBACK_DIR = path.join(__dirname, 'loopback');
+const LOOPBACK_BIN = path.join(__dirname, '..', '..', '.build', 'host_context_loopback');
+const KEYMAP_DIR = path.join(__dirname, '..', '..', 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const LOOPBACK_SOURCES = ['host_context_loopback.c', 'qmk_stubs.h', 'raw_hid.h'].map(f => path.join(LOOPBACK_DIR, f))
+  .concat(['host_context.c', 'host_context.h', 'key_remap.h', 'timer_wheel.c', 'timer_wheel.h'].map(f => path.join(KEYMAP_DIR, f)));
+
+// Compile the loopback harness when missing or older than its sources
+function buildLoopback(timeoutMs = 300) {
+  const binary = `${LOOPBACK_BIN}-${timeoutMs}`;
+  const built = fs.existsSync(binary) ? fs.statSync(binary).mtimeMs : 0;
+  if (LOOPBACK_SOURCES.some(f => fs.statSync(f).mtimeMs > built)) {
+    fs.mkdirSync(path.dirname(binary), { recursive: true });
+    execFileSync(process.env.CC || 'cc', [
+      '-O2', '-std=gnu99', `-I${LOOPBACK_DIR}`,
+      '-DQMK_KEYBOARD_H="qmk_stubs.h"', `-DHOST_CONTEXT_TIMEOUT=${timeoutMs}`,
+      '-o', binary, path.join(LOOPBACK_DIR, 'host_context_loopback.c'),
+      path.join(KEYMAP_DIR, 'host_context.c'), path.join(KEYMAP_DIR, 'timer_wheel.c'),
+    ], { stdio: 'inherit' });
+  }
+  return binary;
+}
+
+// Serialize requests: one outstanding frame at a time, replies in order
+function frameQueue(write) {
+  const waiting = [];
+  let buffer = Buffer.alloc(0);
+  return {
+    request(frame) {
+      return new Promise((resolve, reject) => {
+        waiting.push({ resolve, reject });
+        write(frame);
+      });
+    },
+    feed(chunk, size = RAW_EPSIZE) {
+      buffer = Buffer.concat([buffer, chunk]);
+      while (buffer.length >= size && waiting.length > 0) {
+        waiting.shift().resolve(buffer.subarray(0, size));
+        buffer = buffer.subarray(size);
+      }
+    },
+    fail(err) {
+      while (waiting.length > 0) waiting.shift().reject(err);
+    },
+  };
+}
+
+function openLoopback(options) {
+  const child = spawn(options.binary || buildLoopback(options.timeoutMs), [], { stdio: ['pipe', 'pipe', 'inherit'] });
+  const queue = frameQueue(frame => child.stdin.write(frame));
+  child.stdout.on('data', chunk => queue.feed(chunk));
+  child.on('exit', () => queue.fail(new Error('loopback harness exited')));
+  return {
+    request: frame => queue.request(frame),
+    close: () => new Promise(resolve => {
+      child.on('exit', resolve);
+      child.stdin.end();
+    }),
+  };
+}
+
+function openHidraw(device) {
+  const fd = fs.openSync(device, 'r+');
+  const stream = fs.createReadStream(null, { fd, autoClose: false, highWaterMark: RAW_EPSIZE });
+  // hidraw writes are prefixed with the report ID (0: raw HID has none)
+  const queue = frameQueue(frame => fs.writeSync(fd, Buffer.concat([Buffer.from([0]), frame])));
+  stream.on('data', chunk => queue.feed(chunk));
+  stream.on('error', err => queue.fail(err));
+  return {
+    request: frame => queue.request(frame),
+    close: async () => {
+      stream.destroy();
+      fs.closeSync(fd);
+    },
+  };
+}
+
+function openNodeHid() {
+  let HID;
+  try {
+    HID = require('node-hid');
+  } catch (e) {
+    throw new Error('node-hid is not installed (npm install -g node-hid), use hidraw:/dev/hidrawN on Linux');
+  }
+  const info = HID.devices().find(d => d.vendorId === KEYCHRON_VID && d.productId === Q11_PID &&
+    d.usagePage === RAW_USAGE_PAGE && d.usage === RAW_USAGE);
+  if (!info) throw new Error('Keychron Q11 raw HID interface not found (is RAW_ENABLE firmware flashed?)');
+  const device = new HID.HID(info.path);
+  const queue = frameQueue(frame => device.write([0, ...frame]));
+  device.on('data', data => queue.feed(Buffer.from(data)));
+  device.on('error', err => queue.fail(err));
+  return {
+    request: frame => queue.request(frame),
+    close: async () => device.close(),
+  };
+}
+
+function openTransport(spec, options = {}) {
+  if (spec === 'loopback') return openLoopback(options);
+  if (spec.startsWith('hidraw:')) return openHidraw(spec.slice('hidraw:'.length));
+  if (spec === 'hid') return openNodeHid();
+  throw new Error(`Unknown transport: ${spec} (expected loopback, hidraw:/dev/hidrawN or hid)`);
+}
+
+module.exports = { RAW_EPSIZE, buildLoopback, openTransport };
@@ -0,0 +1,297 @@
+#!/usr/bin/env node
+
+//
+// Key usage exporter
+//
+// Reads the usage counters kept by j-custom/key_stats.c over raw HID and
+// writes them as CSV or JSON: presses per key (labelled with the MAC_BASE
+// keycode at that position), dwell time per layer, presses per custom
+// keycode / tap dance / macro (named from keymap.c where possible) and WPM.
+//
+// Usage: node scripts/key-stats/key-stats.js [options]
+//
+// Options:
+//   --transport <spec>   hid | hidraw:/dev/hidrawN (default: hid)
+//   --format <fmt>       csv | json (default: csv)
+//   --output <file>      Write to a file instead of stdout
+//   --save               Ask the keyboard to save its counters to EEPROM first
+//   --reset              Zero the counters after reading them
+//
+// CSV columns: section, id, name, keycode, value
+//   summary   id = field name
+//   key       id = matrix slot (row * cols + col), value = presses
+//   layer     id = layer index, value = dwell seconds
+//   keycode   id = keycode (hex), value = presses
+//
+
+const fs = require('fs');
+const path = require('path');
+const { RAW_EPSIZE, openTransport } = require('../host-context/raw-hid-transport');
+const { readKeymap, geometry } = require('../generate-sparse-keymap');
+
+const KEYMAP_DIR = path.join(__dirname, '..', '..', 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const HEADER = path.join(KEYMAP_DIR, 'key_stats.h');
+const INFO_JSON = path.join(__dirname, '..', '..', 'keychron/q11/info.json');
+
+// ============================================
+// Protocol (values read from key_stats.h)
+// ============================================
+
+function parseHeader(file = HEADER) {
+  const source = fs.readFileSync(file, 'utf8');
+  const defines = {};
+  for (const m of source.matchAll(/(?:#\s*define\s+|^\s*)(KEY_STATS_\w+)\s*=?\s*(0x[0-9A-Fa-f]+|\d+)/gm)) {
+    defines[m[1]] = Number(m[2]);
+  }
+  const required = ['KEY_STATS_CHANNEL', 'KEY_STATS_REPLY', 'KEY_STATS_OP_READ', 'KEY_STATS_OP_RESET', 'KEY_STATS_OP_SAVE',
+    'KEY_STATS_SECTION_SUMMARY', 'KEY_STATS_SECTION_KEYS', 'KEY_STATS_SECTION_LAYERS', 'KEY_STATS_SECTION_KEYCODES'];
+  const missing = required.filter(name => defines[name] === undefined);
+  if (missing.length > 0) throw new Error(`${file}: missing ${missing.join(', ')}`);
+  return defines;
+}
+
+async function request(transport, d, opcode, section, first = 0) {
+  const frame = Buffer.alloc(RAW_EPSIZE);
+  frame[0] = d.KEY_STATS_CHANNEL;
+  frame[1] = opcode;
+  frame[2] = section;
+  frame[3] = first;
+  const reply = await transport.request(frame);
+  if (reply[0] !== d.KEY_STATS_CHANNEL || reply[1] !== (opcode | d.KEY_STATS_REPLY)) {
+    throw new Error(`unexpected reply to section ${section} (is KEY_STATS_ENABLE firmware flashed?)`);
+  }
+  return { count: reply[4], data: reply.subarray(5) };
+}
+
+// Every entry of a section, asking again from where the last reply ended
+async function readSection(transport, d, section, total, entrySize, decode) {
+  const entries = [];
+  while (entries.length < total) {
+    const { count, data } = await request(transport, d, d.KEY_STATS_OP_READ, section, entries.length);
+    if (count === 0) break;
+    for (let i = 0; i < count; i++) entries.push(decode(data, i * entrySize));
+  }
+  return entries;
+}
+
+async function readStats(transport, d, options = {}) {
+  const opcode = options.save ? d.KEY_STATS_OP_SAVE : d.KEY_STATS_OP_READ;
+  const s = (await request(transport, d, opcode, d.KEY_STATS_SECTION_SUMMARY)).data;
+  const summary = {
+    keySlots: s[0], layers: s[1], keycodesUsed: s[2], keycodeSlots: s[3],
+    epochs: s.readUInt16LE(4), wpm: s.readUInt16LE(6), peakWpm: s.readUInt16LE(8),
+    safeRange: s.readUInt16LE(10), overflow: s.readUInt16LE(12), saves: s.readUInt16LE(14),
+    uptimeS: s.readUInt32LE(16),
+  };
+  const keys = await readSection(transport, d, d.KEY_STATS_SECTION_KEYS, summary.keySlots, 2, (b, o) => b.readUInt16LE(o));
+  const layers = await readSection(transport, d, d.KEY_STATS_SECTION_LAYERS, summary.layers, 4, (b, o) => b.readUInt32LE(o));
+  const keycodes = await readSection(transport, d, d.KEY_STATS_SECTION_KEYCODES, summary.keycodesUsed, 4,
+    (b, o) => ({ keycode: b.readUInt16LE(o), presses: b.readUInt16LE(o + 2) }));
+  if (options.reset) await request(transport, d, d.KEY_STATS_OP_RESET, d.KEY_STATS_SECTION_SUMMARY);
+  return { summary, keys, layers, keycodes };
+}
+
+// ============================================
+// Keycode names
+// ============================================
+
+const BASIC = {};
+'ABCDEFGHIJKLMNOPQRSTUVWXYZ'.split('').forEach((c, i) => { BASIC[`KC_${c}`] = 0x04 + i; });
+'1234567890'.split('').forEach((c, i) => { BASIC[`KC_${c}`] = 0x1E + i; });
+Object.assign(BASIC, {
+  KC_ENT: 0x28, KC_ESC: 0x29, KC_BSPC: 0x2A, KC_TAB: 0x2B, KC_SPC: 0x2C, KC_MINS: 0x2D, KC_EQL: 0x2E,
+  KC_LBRC: 0x2F, KC_RBRC: 0x30, KC_BSLS: 0x31, KC_SCLN: 0x33, KC_QUOT: 0x34, KC_GRV: 0x35,
+  KC_COMM: 0x36, KC_DOT: 0x37, KC_SLSH: 0x38, KC_CAPS: 0x39, KC_PSCR: 0x46, KC_INS: 0x49, KC_HOME: 0x4A,
+  KC_PGUP: 0x4B, KC_DEL: 0x4C, KC_END: 0x4D, KC_PGDN: 0x4E, KC_RGHT: 0x4F, KC_LEFT: 0x50, KC_DOWN: 0x51, KC_UP: 0x52,
+  KC_LCTL: 0xE0, KC_LSFT: 0xE1, KC_LALT: 0xE2, KC_LGUI: 0xE3, KC_RCTL: 0xE4, KC_RSFT: 0xE5, KC_RALT: 0xE6, KC_RGUI: 0xE7,
+});
+for (let i = 1; i <= 12; i++) BASIC[`KC_F${i}`] = 0x39 + i;
+const BASIC_ALIASES = {
+  KC_ENTER: 'KC_ENT', KC_ESCAPE: 'KC_ESC', KC_BACKSPACE: 'KC_BSPC', KC_SPACE: 'KC_SPC', KC_RIGHT: 'KC_RGHT',
+  KC_MINUS: 'KC_MINS', KC_EQUAL: 'KC_EQL', KC_COMMA: 'KC_COMM', KC_SLASH: 'KC_SLSH', KC_DELETE: 'KC_DEL',
+  KC_LCMD: 'KC_LGUI', KC_LOPT: 'KC_LALT', KC_RCMD: 'KC_RGUI', KC_ROPT: 'KC_RALT',
+};
+const BASIC_NAMES = Object.fromEntries(Object.entries(BASIC).map(([name, code]) => [code, name]));
+
+// Modifier bits of QK_MODS / QK_MOD_TAP: ctrl 1, shift 2, alt 4, gui 8, right-hand 0x10
+const MOD_FUNCS = {
+  LCTL: 0x01, C: 0x01, LSFT: 0x02, S: 0x02, LALT: 0x04, A: 0x04, LOPT: 0x04, LGUI: 0x08, G: 0x08, LCMD: 0x08, LWIN: 0x08,
+  RCTL: 0x11, RSFT: 0x12, RALT: 0x14, ROPT: 0x14, RGUI: 0x18, RCMD: 0x18,
+  LCA: 0x05, LCG: 0x09, LCS: 0x03, LSA: 0x06, LSG: 0x0A, LAG: 0x0C, LCAG: 0x0D, LSAG: 0x0E, LCSG: 0x0B,
+  MEH: 0x07, HYPR: 0x0F,
+};
+const MOD_NAMES = { 0x01: 'LCTL', 0x02: 'LSFT', 0x04: 'LALT', 0x08: 'LGUI', 0x05: 'LCA', 0x09: 'LCG', 0x03: 'LCS',
+  0x06: 'LSA', 0x0A: 'LSG', 0x0C: 'LAG', 0x0D: 'LCAG', 0x0E: 'LSAG', 0x0B: 'LCSG', 0x07: 'MEH', 0x0F: 'HYPR',
+  0x11: 'RCTL', 0x12: 'RSFT', 0x14: 'RALT', 0x18: 'RGUI' };
+
+const QK = { MODS: 0x0100, MOD_TAP: 0x2000, LAYER_TAP: 0x4000, TO: 0x5200, MO: 0x5220, DF: 0x5240, TG: 0x5260,
+  OSL: 0x5280, TT: 0x52C0, TAP_DANCE: 0x5700 };
+const LAYER_FUNCS = { TO: QK.TO, MO: QK.MO, DF: QK.DF, TG: QK.TG, OSL: QK.OSL, TT: QK.TT };
+
+// Names from keymap.c: layers, custom keycodes (from SAFE_RANGE), tap dances, #define'd macros
+function keymapNames(raw, layerEnum) {
+  const source = raw.replace(/\/\*[\s\S]*?\*\/|\/\/[^\n]*/g, '');
+  const custom = [];
+  const block = source.match(/enum\s+custom_keycodes\s*\{([\s\S]*?)\}/);
+  if (block) {
+    for (const item of block[1].split(',')) {
+      const name = item.split('=')[0].trim();
+      if (name) custom.push(name);
+    }
+  }
+  const tapDances = {};
+  for (const m of source.matchAll(/\b(TD_\w+)\s*=\s*(\d+)/g)) tapDances[Number(m[2])] = m[1];
+  const defines = {};
+  for (const m of source.matchAll(/^#define\s+(KC_\w+)\s+([^\n]+?)\s*$/gm)) defines[m[1]] = m[2].trim();
+  return { layers: Object.fromEntries(Object.entries(layerEnum).map(([n, i]) => [i, n])), layerEnum, custom, tapDances, defines };
+}
+
+// Numeric value of a keycode expression from keymap.c, or undefined
+function evaluate(expr, names, depth = 0) {
+  expr = expr.trim();
+  if (depth > 8) return undefined;
+  if (BASIC[expr] !== undefined) return BASIC[expr];
+  if (BASIC_ALIASES[expr]) return BASIC[BASIC_ALIASES[expr]];
+  if (names.defines[expr]) return evaluate(names.defines[expr], names, depth + 1);
+  const m = expr.match(/^(\w+)\s*\(([\s\S]*)\)$/);
+  if (!m) return undefined;
+  const [, fn, arg] = m;
+  if (MOD_FUNCS[fn] !== undefined) {
+    const inner = evaluate(arg, names, depth + 1);
+    return inner === undefined ? undefined : inner | (MOD_FUNCS[fn] << 8);
+  }
+  if (LAYER_FUNCS[fn] !== undefined && names.layerEnum[arg.trim()] !== undefined) {
+    return LAYER_FUNCS[fn] | names.layerEnum[arg.trim()];
+  }
+  return undefined;
+}
+
+// Keycode → the name keymap.c uses for it (macro name first, then the decoded expression)
+function keycodeNamer(names, safeRange) {
+  const macros = {};
+  for (const name of Object.keys(names.defines)) {
+    const value = evaluate(name, names);
+    if (value !== undefined && macros[value] === undefined) macros[value] = name;
+  }
+  const layer = n => names.layers[n] || String(n);
+  const basic = code => BASIC_NAMES[code] || `0x${code.toString(16).padStart(2, '0')}`;
+  return keycode => {
+    if (macros[keycode]) return macros[keycode];
+    if (keycode >= safeRange && keycode - safeRange < names.custom.length) return names.custom[keycode - safeRange];
+    if (keycode <= 0xFF) return basic(keycode);
+    if (keycode < QK.MOD_TAP) {
+      const mods = keycode >> 8;
+      return MOD_NAMES[mods] ? `${MOD_NAMES[mods]}(${basic(keycode & 0xFF)})` : `MODS(0x${mods.toString(16)}, ${basic(keycode & 0xFF)})`;
+    }
+    if (keycode < QK.LAYER_TAP) {
+      const mods = (keycode >> 8) & 0x1F;
+      return `MT(${MOD_NAMES[mods] ? `MOD_${MOD_NAMES[mods]}` : `0x${mods.toString(16)}`}, ${basic(keycode & 0xFF)})`;
+    }
+    if (keycode < 0x5000) return `LT(${layer((keycode >> 8) & 0x0F)}, ${basic(keycode & 0xFF)})`;
+    for (const [fn, base] of Object.entries(LAYER_FUNCS)) {
+      if (keycode >= base && keycode < base + 0x20) return `${fn}(${layer(keycode - base)})`;
+    }
+    if (keycode >= QK.TAP_DANCE && keycode < QK.TAP_DANCE + 0x100) {
+      const index = keycode - QK.TAP_DANCE;
+      return `TD(${names.tapDances[index] || index})`;
+    }
+    return `0x${keycode.toString(16).padStart(4, '0')}`;
+  };
+}
+
+// ============================================
+// Export
+// ============================================
+
+function describe(stats) {
+  const keymap = readKeymap(KEYMAP_DIR);
+  const info = JSON.parse(fs.readFileSync(INFO_JSON, 'utf8'));
+  const geo = geometry(info, keymap.layers[0].macro);
+  const names = keymapNames(fs.readFileSync(path.join(KEYMAP_DIR, 'keymap.c'), 'utf8'), keymap.layerEnum);
+  const nameOf = keycodeNamer(names, stats.summary.safeRange);
+
+  // Position labels: the MAC_BASE keycode at each matrix slot
+  const labels = {};
+  const base = keymap.layers.find(l => keymap.layerEnum[l.name] === 0);
+  geo.keys.forEach(([r, c], i) => { labels[r * geo.cols + c] = base.keys[i]; });
+
+  const totalDwell = stats.layers.reduce((a, b) => a + b, 0);
+  return {
+    summary: stats.summary,
+    keys: stats.keys.map((presses, slot) => ({
+      slot, row: Math.floor(slot / geo.cols), col: slot % geo.cols, label: labels[slot] || null, presses,
+    })).filter(k => k.label !== null || k.presses > 0),
+    layers: stats.layers.map((seconds, index) => ({
+      index, name: names.layers[index] || null, seconds, share: totalDwell ? seconds / totalDwell : 0,
+    })).filter(l => l.name !== null || l.seconds > 0),
+    keycodes: stats.keycodes.map(k => ({ ...k, name: nameOf(k.keycode) })).sort((a, b) => b.presses - a.presses),
+  };
+}
+
+function toCsv(report) {
+  const quote = v => (/[",\n]/.test(String(v)) ? `"${String(v).replace(/"/g, '""')}"` : String(v));
+  const rows = [['section', 'id', 'name', 'keycode', 'value']];
+  for (const [field, value] of Object.entries(report.summary)) rows.push(['summary', field, '', '', value]);
+  for (const k of report.keys) rows.push(['key', k.slot, `r${k.row}c${k.col}`, k.label || '', k.presses]);
+  for (const l of report.layers) rows.push(['layer', l.index, l.name || '', '', l.seconds]);
+  for (const k of report.keycodes) rows.push(['keycode', `0x${k.keycode.toString(16).padStart(4, '0')}`, k.name, '', k.presses]);
+  return rows.map(r => r.map(quote).join(',')).join('\n') + '\n';
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = { transport: 'hid', format: 'csv', output: null, save: false, reset: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--transport': options.transport = value(); break;
+      case '--format': options.format = value(); break;
+      case '--output': options.output = value(); break;
+      case '--save': options.save = true; break;
+      case '--reset': options.reset = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  if (!['csv', 'json'].includes(options.format)) throw new Error(`Unknown format: ${options.format} (csv or json)`);
+  return options;
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const d = parseHeader();
+  const transport = openTransport(options.transport);
+  const stats = await readStats(transport, d, options);
+  await transport.close();
+
+  const report = describe(stats);
+  const text = options.format === 'json' ? `${JSON.stringify(report, null, 2)}\n` : toCsv(report);
+  if (options.output) {
+    fs.writeFileSync(options.output, text);
+    console.error(`Wrote ${options.output}`);
+  } else {
+    process.stdout.write(text);
+  }
+}
+
+if (require.main === module) {
+  main().catch(err => {
+    console.error(`key-stats: ${err.message}`);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseHeader, readStats, describe, keymapNames, keycodeNamer, evaluate, toCsv };
@@ -0,0 +1,315 @@
+#!/usr/bin/env node
+//
+// Indexed Cursor keybinding database
+//
+// Parses the Cursor keybinding dumps (default + user JSONC files) once into an
+// index keyed by command and by normalized chord, cached in
+// scripts/.cache/keybindings-db.json. The cache is reused while the source files
+// are unchanged (size + mtime, then content hash), so lookups and generators
+// no longer re-parse ~400 KB of JSONC on every run.
+//
+// Usage: node scripts/keybinding-db.js build [--force]
+//        node scripts/keybinding-db.js command <command-id>
+//        node scripts/keybinding-db.js chord <chord>        (e.g. "cmd+shift+p", "cmd+k cmd+s")
+//        node scripts/keybinding-db.js stats
+//
+// Library: const { loadDb, lookupCommand, lookupChord, normalizeChord } = require('./keybinding-db');
+//
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+
+const REPO_DIR = path.resolve(__dirname, '..');
+const KEYMAPPING_DIR = path.join(REPO_DIR, 'specs/keychron/q11/custom-refs/keymapping');
+const CACHE_FILE = path.join(__dirname, '.cache', 'keybindings-db.json');
+const DB_VERSION = 1;
+
+// Legacy download location used by the markdown generators takes precedence
+const DEFAULT_SOURCES = {
+  defaults: ['/tmp/cursor-default-keybindings.json', path.join(KEYMAPPING_DIR, 'default-cursor-keybindings-full-list.json')],
+  user: [path.join(KEYMAPPING_DIR, 'cursor-keybindings.json')],
+};
+
+// ============================================
+// Chord normalization
+// ============================================
+
+// Canonical modifier order used in every normalized chord
+const MODIFIER_ORDER = ['ctrl', 'shift', 'alt', 'cmd'];
+const MODIFIER_ALIASES = {
+  ctrl: 'ctrl', control: 'ctrl',
+  shift: 'shift',
+  alt: 'alt', option: 'alt', opt: 'alt',
+  cmd: 'cmd', meta: 'cmd', command: 'cmd', super: 'cmd', win: 'cmd',
+};
+
+// "Shift+Cmd+P  cmd+K" → "shift+cmd+p cmd+k"
+function normalizeChord(chord) {
+  return chord
+    .trim()
+    .toLowerCase()
+    .split(/\s+/)
+    .map(part => {
+      // A trailing "+" key ("cmd++") would be lost by split('+')
+      const plusKey = part.endsWith('++');
+      const tokens = (plusKey ? part.slice(0, -2) : part).split('+').filter(Boolean);
+      const mods = new Set();
+      let key = plusKey ? '+' : null;
+      for (const token of tokens) {
+        if (MODIFIER_ALIASES[token]) {
+          mods.add(MODIFIER_ALIASES[token]);
+        } else {
+          key = token;
+        }
+      }
+      return [...MODIFIER_ORDER.filter(m => mods.has(m)), ...(key ? [key] : [])].join('+');
+    })
+    .join(' ');
+}
+
+// ============================================
+// Lenient JSONC parsing
+// ============================================
+
+// Extract every top-level binding object from a JSONC keybindings file.
+// Comments are skipped outside strings only, and objects that are not valid
+// JSON (hand-edited user files) fall back to field extraction.
+function parseKeybindingsFile(text) {
+  const objects = [];
+  const unbound = [];
+  let depth = 0;
+  let start = -1;
+
+  for (let i = 0; i < text.length; i++) {
+    const c = text[i];
+    if (c === '"') {
+      i++;
+      while (i < text.length && text[i] !== '"') {
+        if (text[i] === '\\') i++;
+        i++;
+      }
+    } else if (c === '/' && text[i + 1] === '/') {
+      const end = text.indexOf('\n', i);
+      const comment = text.slice(i, end < 0 ? text.length : end);
+      // "// - command.id" lines list commands that have no default binding
+      const m = depth === 0 && comment.match(/^\/\/ - (\S+)\s*$/);
+      if (m) unbound.push(m[1]);
+      i = end < 0 ? text.length : end;
+    } else if (c === '/' && text[i + 1] === '*') {
+      const end = text.indexOf('*/', i + 2);
+      i = end < 0 ? text.length : end + 1;
+    } else if (c === '{') {
+      if (depth === 0) start = i;
+      depth++;
+    } else if (c === '}' && depth > 0) {
+      depth--;
+      if (depth === 0) objects.push(text.slice(start, i + 1));
+    }
+  }
+
+  const bindings = [];
+  for (const raw of objects) {
+    let obj = null;
+    try {
+      obj = JSON.parse(raw.replace(/\/\*[\s\S]*?\*\//g, '').replace(/,\s*}/g, '}'));
+    } catch (e) {
+      obj = {};
+      for (const field of ['key', 'command', 'when']) {
+        const m = raw.match(new RegExp(`"${field}"\\s*:\\s*"((?:[^"\\\\]|\\\\.)*)"`));
+        if (m) obj[field] = JSON.parse(`"${m[1]}"`);
+      }
+    }
+    if (obj && typeof obj.key === 'string' && typeof obj.command === 'string') {
+      bindings.push({ key: obj.key, command: obj.command, when: obj.when || null });
+    }
+  }
+  return { bindings, unbound };
+}
+
+// ============================================
+// Database build / cache
+// ============================================
+
+function firstExisting(paths) {
+  return paths.find(p => fs.existsSync(p)) || null;
+}
+
+function resolveSources(overrides = {}) {
+  const sources = [];
+  const defaults = overrides.defaults || firstExisting(DEFAULT_SOURCES.defaults);
+  const user = overrides.user !== undefined ? overrides.user : firstExisting(DEFAULT_SOURCES.user);
+  if (defaults) sources.push({ kind: 'default', path: path.resolve(defaults) });
+  if (user) sources.push({ kind: 'user', path: path.resolve(user) });
+  return sources;
+}
+
+function fileSignature(file) {
+  const stat = fs.statSync(file);
+  return { size: stat.size, mtimeMs: stat.mtimeMs };
+}
+
+function hashFile(file) {
+  return crypto.createHash('sha1').update(fs.readFileSync(file)).digest('hex');
+}
+
+function buildDb(sources) {
+  const db = {
+    version: DB_VERSION,
+    sources: [],
+    bindings: [],
+    unbound: [],
+    byCommand: {},
+    byChord: {},
+  };
+
+  for (const source of sources) {
+    const { bindings, unbound } = parseKeybindingsFile(fs.readFileSync(source.path, 'utf8'));
+    db.sources.push({ ...source, ...fileSignature(source.path), sha1: hashFile(source.path) });
+    for (const b of bindings) {
+      const removal = b.command.startsWith('-');
+      db.bindings.push({
+        key: b.key,
+        chord: normalizeChord(b.key),
+        command: removal ? b.command.slice(1) : b.command,
+        when: b.when,
+        source: source.kind,
+        removed: removal || undefined,
+      });
+    }
+    db.unbound.push(...unbound);
+  }
+
+  db.bindings.forEach((b, i) => {
+    (db.byCommand[b.command] = db.byCommand[b.command] || []).push(i);
+    (db.byChord[b.chord] = db.byChord[b.chord] || []).push(i);
+  });
+  return db;
+}
+
+// Cache is valid when the same files are used and none of them changed
+function cacheIsFresh(db, sources) {
+  if (!db || db.version !== DB_VERSION || db.sources.length !== sources.length) return false;
+  let touched = false;
+  for (let i = 0; i < sources.length; i++) {
+    const cached = db.sources[i];
+    if (cached.path !== sources[i].path || cached.kind !== sources[i].kind || !fs.existsSync(cached.path)) return false;
+    const sig = fileSignature(cached.path);
+    if (sig.size !== cached.size) return false;
+    if (sig.mtimeMs !== cached.mtimeMs) {
+      // Touched but maybe not changed (git checkout, copy): compare content
+      if (hashFile(cached.path) !== cached.sha1) return false;
+      cached.mtimeMs = sig.mtimeMs;
+      touched = true;
+    }
+  }
+  db.touched = touched;
+  return true;
+}
+
+// Load the database, rebuilding the cache only when a source changed.
+// options: { defaults, user, force, cacheFile }
+function loadDb(options = {}) {
+  const sources = resolveSources(options);
+  if (sources.length === 0) {
+    throw new Error('No keybinding files found. Download the Cursor default keybindings first.');
+  }
+  const cacheFile = options.cacheFile || CACHE_FILE;
+
+  if (!options.force && fs.existsSync(cacheFile)) {
+    try {
+      const cached = JSON.parse(fs.readFileSync(cacheFile, 'utf8'));
+      if (cacheIsFresh(cached, sources)) {
+        if (cached.touched) {
+          delete cached.touched;
+          fs.writeFileSync(cacheFile, JSON.stringify(cached));
+        }
+        cached.fromCache = true;
+        return cached;
+      }
+    } catch (e) {
+      // Corrupt cache: rebuild below
+    }
+  }
+
+  const db = buildDb(sources);
+  fs.mkdirSync(path.dirname(cacheFile), { recursive: true });
+  fs.writeFileSync(cacheFile, JSON.stringify(db));
+  db.fromCache = false;
+  return db;
+}
+
+// Effective bindings for a command: user bindings first, minus "-command" removals
+function lookupCommand(db, command) {
+  const entries = (db.byCommand[command] || []).map(i => db.bindings[i]);
+  const removed = new Set(entries.filter(b => b.removed).map(b => `${b.chord}\t${b.when || ''}`));
+  const active = entries.filter(b => !b.removed && !(b.source === 'default' && removed.has(`${b.chord}\t${b.when || ''}`)));
+  return active.sort((a, b) => (a.source === b.source ? 0 : a.source === 'user' ? -1 : 1));
+}
+
+function lookupChord(db, chord) {
+  return (db.byChord[normalizeChord(chord)] || []).map(i => db.bindings[i]).filter(b => !b.removed);
+}
+
+module.exports = {
+  CACHE_FILE,
+  DEFAULT_SOURCES,
+  loadDb,
+  lookupChord,
+  lookupCommand,
+  normalizeChord,
+  parseKeybindingsFile,
+};
+
+// ============================================
+// CLI
+// ============================================
+
+function printBindings(bindings) {
+  if (bindings.length === 0) {
+    console.log('(no bindings)');
+    return;
+  }
+  console.log('| Keybinding | Command | When | Source |');
+  console.log('|------------|---------|------|--------|');
+  bindings.forEach(b => console.log(`| \`${b.key}\` | \`${b.command}\` | ${b.when || '-'} | ${b.source} |`));
+}
+
+function main() {
+  const [cmd, ...args] = process.argv.slice(2);
+  const force = args.includes('--force');
+  const query = args.filter(a => a !== '--force').join(' ');
+
+  let db;
+  try {
+    db = loadDb({ force });
+  } catch (e) {
+    console.error(e.message);
+    process.exit(1);
+  }
+
+  switch (cmd) {
+    case 'build':
+      console.log(`${db.fromCache ? 'Up to date' : 'Built'}: ${CACHE_FILE}`);
+      console.log(`Bindings: ${db.bindings.length}, commands: ${Object.keys(db.byCommand).length}, chords: ${Object.keys(db.byChord).length}`);
+      break;
+    case 'command':
+      printBindings(lookupCommand(db, query));
+      if (db.unbound.includes(query)) console.log(`\n\`${query}\` has no default keybinding.`);
+      break;
+    case 'chord':
+      printBindings(lookupChord(db, query));
+      break;
+    case 'stats':
+      for (const s of db.sources) console.log(`${s.kind}: ${s.path} (${s.size} bytes)`);
+      console.log(`Bindings: ${db.bindings.length}, unbound commands: ${db.unbound.length}`);
+      break;
+    default:
+      console.error('Usage: node scripts/keybinding-db.js build|command <id>|chord <chord>|stats [--force]');
+      process.exit(1);
+  }
+}
+
+if (require.main === module) {
+  main();
+}
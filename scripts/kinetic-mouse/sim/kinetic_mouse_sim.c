@@ -0,0 +1,103 @@
+/* Motion simulation harness for the kinetic mouse engine
+ *
+ * Links the keymap's kinetic_mouse.c on the host with one profile (taken
+ * from the command line, active on layer 1) and replays key events from
+ * stdin, one command per line:
+ *   key <ms> <u|d|l|r> <0|1>   Cursor key release / press at an absolute time
+ *   end <ms>                   Stop the run
+ * Output, one line per mouse report:
+ *   report <ms> <dx> <dy>
+ *
+ * The run steps a virtual 1 ms clock and runs timer_wheel_task() every tick,
+ * as housekeeping does once per scan.
+ *
+ * Usage: kinetic_mouse_sim <start> <max> <ramp> <curve> <glide>
+ * Build: cc -I<this dir> -DQMK_KEYBOARD_H='"qmk_stubs.h"' kinetic_mouse_sim.c \
+ *           .../j-custom/kinetic_mouse.c .../j-custom/timer_wheel.c
+ */
+#include <stdlib.h>
+
+#include "qmk_stubs.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/kinetic_mouse.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/timer_wheel.h"
+
+layer_state_t layer_state         = 1UL << 1;
+layer_state_t default_layer_state = 1;
+
+static uint32_t now_ms = 0;
+
+// ============================================
+// QMK stubs
+// ============================================
+
+uint8_t get_highest_layer(layer_state_t state) {
+    for (int i = 31; i > 0; i--) {
+        if (state & (1UL << i)) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+uint32_t timer_read32(void) {
+    return now_ms;
+}
+
+report_mouse_t mousekey_get_report(void) {
+    return (report_mouse_t){ 0 };
+}
+
+void host_mouse_send(report_mouse_t *report) {
+    printf("report %u %d %d\n", now_ms, report->x, report->y);
+}
+
+// ============================================
+// Replay
+// ============================================
+
+static uint16_t keycode_of(char key) {
+    switch (key) {
+        case 'u':
+            return KC_MS_U;
+        case 'd':
+            return KC_MS_D;
+        case 'l':
+            return KC_MS_L;
+        default:
+            return KC_MS_R;
+    }
+}
+
+// Run the clock up to t, a timer wheel pass per ms
+static void advance(uint32_t t) {
+    while (now_ms < t) {
+        now_ms++;
+        timer_wheel_task();
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 6) {
+        fprintf(stderr, "usage: %s <start> <max> <ramp> <curve> <glide>\n", argv[0]);
+        return 2;
+    }
+    static kinetic_mouse_layer_t table[1];
+    table[0] = (kinetic_mouse_layer_t){ 1, { atoi(argv[1]), atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), atoi(argv[5]) } };
+    kinetic_mouse_init(table, 1);
+
+    char     line[64];
+    unsigned t;
+    char     key;
+    int      pressed;
+    while (fgets(line, sizeof(line), stdin)) {
+        if (sscanf(line, "key %u %c %d", &t, &key, &pressed) == 3) {
+            advance(t);
+            keyrecord_t record = { .event = { .pressed = pressed } };
+            kinetic_mouse_process(keycode_of(key), &record);
+        } else if (sscanf(line, "end %u", &t) == 1) {
+            advance(t);
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+/* Minimal QMK environment for building kinetic_mouse.c on the host
+ *
+ * Provides just enough of quantum.h (key records, layers, mouse reports,
+ * timer) for the motion simulation (kinetic_mouse.c and timer_wheel.c); the
+ * clock is virtual and advanced by the harness.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define memcpy_P(dst, src, n) memcpy(dst, src, n)
+
+// Mouse key keycodes (QMK keycodes.h values)
+#define KC_MS_U 0x00CD
+#define KC_MS_D 0x00CE
+#define KC_MS_L 0x00CF
+#define KC_MS_R 0x00D0
+
+typedef uint32_t layer_state_t;
+
+typedef struct {
+    bool pressed;
+} keyevent_t;
+
+typedef struct {
+    keyevent_t event;
+} keyrecord_t;
+
+typedef struct {
+    uint8_t buttons;
+    int8_t  x;
+    int8_t  y;
+    int8_t  v;
+    int8_t  h;
+} report_mouse_t;
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+uint8_t        get_highest_layer(layer_state_t state);
+uint32_t       timer_read32(void);
+report_mouse_t mousekey_get_report(void);
+void           host_mouse_send(report_mouse_t *report);
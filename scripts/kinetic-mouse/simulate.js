@@ -0,0 +1,239 @@
+#!/usr/bin/env node
+
+//
+// Kinetic mouse motion simulation (j-custom/kinetic_mouse.c)
+//
+// Compiles kinetic_mouse.c for the host (sim/ harness) and drives it with
+// each profile of keymap.c's mouse_profiles[] (plus the KINETIC_MOUSE_DEFAULT_*
+// profile) through a few gestures:
+//   - tap: a short press, how far one nudge moves the pointer
+//   - hold: a long press then release, speed ramp and glide
+//   - diagonal: two keys held, speed on each axis
+// Prints distances and timings per profile and writes the speed and
+// position curves of the hold gesture as an SVG plot.
+//
+// Usage: node scripts/kinetic-mouse/simulate.js [options]
+//
+// Options:
+//   --output <file>    SVG plot (default: .build/kinetic-mouse.svg)
+//   --hold <ms>        Hold gesture length (default: 1500)
+//   --tap <ms>         Tap gesture length (default: 30)
+//   --json             Print the results as JSON instead of a table
+//
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const REPO_DIR = path.resolve(__dirname, '..', '..');
+const SIM_DIR = path.join(__dirname, 'sim');
+const BUILD_DIR = path.join(REPO_DIR, '.build');
+const KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const FIELDS = ['start', 'max', 'ramp', 'curve', 'glide'];
+
+// ============================================
+// Profiles
+// ============================================
+
+// KINETIC_MOUSE_DEFAULT_* from kinetic_mouse.h, then the mouse_profiles[] entries of keymap.c
+function readProfiles() {
+  const header = fs.readFileSync(path.join(KEYMAP_DIR, 'kinetic_mouse.h'), 'utf8');
+  const fallback = { name: 'default' };
+  for (const field of FIELDS) {
+    const m = header.match(new RegExp(`#\\s*define\\s+KINETIC_MOUSE_DEFAULT_${field.toUpperCase()}\\s+(\\d+)`));
+    if (!m) throw new Error(`kinetic_mouse.h: missing KINETIC_MOUSE_DEFAULT_${field.toUpperCase()}`);
+    fallback[field] = Number(m[1]);
+  }
+
+  const keymap = fs.readFileSync(path.join(KEYMAP_DIR, 'keymap.c'), 'utf8');
+  const table = keymap.match(/mouse_profiles\s*\[\s*\]\s*=\s*\{([\s\S]*?)\n\};/);
+  if (!table) throw new Error('no mouse_profiles[] table in keymap.c');
+  const profiles = [];
+  for (const m of table[1].matchAll(/\{\s*(\w+)\s*,\s*\{([^}]*)\}\s*\}/g)) {
+    const profile = { name: m[1] };
+    for (const f of m[2].matchAll(/\.(\w+)\s*=\s*(\d+)/g)) profile[f[1]] = Number(f[2]);
+    const missing = FIELDS.filter(field => profile[field] === undefined);
+    if (missing.length > 0) throw new Error(`keymap.c: ${m[1]} profile lacks ${missing.join(', ')}`);
+    profiles.push(profile);
+  }
+  return [...profiles, fallback];
+}
+
+// ============================================
+// Harness
+// ============================================
+
+function build() {
+  const binary = path.join(BUILD_DIR, 'kinetic_mouse_sim');
+  fs.mkdirSync(BUILD_DIR, { recursive: true });
+  execFileSync(process.env.CC || 'cc', ['-O2', '-std=gnu11', '-Wall', `-I${SIM_DIR}`, '-DQMK_KEYBOARD_H="qmk_stubs.h"',
+    '-o', binary, path.join(SIM_DIR, 'kinetic_mouse_sim.c'),
+    path.join(KEYMAP_DIR, 'kinetic_mouse.c'), path.join(KEYMAP_DIR, 'timer_wheel.c')], { stdio: ['ignore', 'inherit', 'pipe'] });
+  return binary;
+}
+
+// Reports of one gesture: keys = [{ key, down, up }], times in ms
+function run(binary, profile, keys, end) {
+  const events = keys.flatMap(k => [{ t: k.down, line: `key ${k.down} ${k.key} 1` }, { t: k.up, line: `key ${k.up} ${k.key} 0` }]);
+  events.sort((a, b) => a.t - b.t);
+  const input = `${events.map(e => e.line).join('\n')}\nend ${end}\n`;
+  const output = execFileSync(binary, FIELDS.map(f => String(profile[f])), { input }).toString().trim();
+  return output ? output.split('\n').map(l => {
+    const [, t, dx, dy] = l.split(' ').map(Number);
+    return { t, dx, dy };
+  }) : [];
+}
+
+// Position and speed per ms (speed averaged over the last 16 ms of reports)
+function trace(reports, end) {
+  const points = [];
+  let x = 0;
+  let i = 0;
+  const window = [];
+  for (let t = 0; t <= end; t++) {
+    let moved = 0;
+    while (i < reports.length && reports[i].t === t) moved += Math.hypot(reports[i].dx, reports[i++].dy);
+    x += moved;
+    window.push(moved);
+    if (window.length > 16) window.shift();
+    points.push({ t, distance: x, speed: (window.reduce((a, b) => a + b, 0) / window.length) * 1000 });
+  }
+  return points;
+}
+
+function simulate(binary, profile, options) {
+  const start = 10;
+  const tap = run(binary, profile, [{ key: 'r', down: start, up: start + options.tap }], start + options.tap + 500);
+  const holdEnd = start + options.hold;
+  const holdRun = 1000 + options.hold;
+  const hold = trace(run(binary, profile, [{ key: 'r', down: start, up: holdEnd }], holdRun), holdRun);
+  const diagonal = run(binary, profile, [{ key: 'r', down: start, up: start + 500 }, { key: 'd', down: start, up: start + 500 }], 1000);
+
+  const peak = Math.max(...hold.map(p => p.speed));
+  const reached = hold.find(p => p.speed >= 0.95 * peak);
+  const atRelease = hold[holdEnd].distance;
+  const stopped = [...hold].reverse().find(p => p.speed > 0);
+  return {
+    profile,
+    tapPx: tap.reduce((a, r) => a + r.dx, 0),
+    reports: tap.length,
+    peakSpeed: Math.round(peak),
+    msTo95: reached ? reached.t - start : null,
+    px500: Math.round(hold[start + 500].distance),
+    pxHold: Math.round(atRelease),
+    glidePx: Math.round(hold[hold.length - 1].distance - atRelease),
+    glideMs: stopped ? Math.max(0, stopped.t - holdEnd) : 0,
+    diagonal: { x: diagonal.reduce((a, r) => a + r.dx, 0), y: diagonal.reduce((a, r) => a + r.dy, 0) },
+    curve: hold,
+  };
+}
+
+// ============================================
+// Plot
+// ============================================
+
+const COLORS = ['#1f77b4', '#d62728', '#2ca02c', '#9467bd', '#ff7f0e'];
+
+function plot(results, options) {
+  const width = 720;
+  const height = 260;
+  const margin = { left: 60, right: 20, top: 30, bottom: 30 };
+  const end = results[0].curve.length - 1;
+  const charts = [
+    { title: 'Speed (px/s), key held from 10 ms', key: 'speed' },
+    { title: 'Distance (px)', key: 'distance' },
+  ];
+  const parts = [];
+  charts.forEach((chart, c) => {
+    const top = c * (height + 20);
+    const max = Math.max(...results.flatMap(r => r.curve.map(p => p[chart.key]))) * 1.05 || 1;
+    const sx = t => margin.left + (t / end) * (width - margin.left - margin.right);
+    const sy = v => top + height - margin.bottom - (v / max) * (height - margin.top - margin.bottom);
+    parts.push(`<text x="${margin.left}" y="${top + 18}" font-size="13" font-weight="bold">${chart.title}</text>`);
+    parts.push(`<line x1="${sx(0)}" y1="${sy(0)}" x2="${sx(end)}" y2="${sy(0)}" stroke="#888"/>`);
+    parts.push(`<line x1="${sx(0)}" y1="${sy(0)}" x2="${sx(0)}" y2="${sy(max)}" stroke="#888"/>`);
+    for (let t = 0; t <= end; t += 250) {
+      parts.push(`<text x="${sx(t)}" y="${sy(0) + 14}" font-size="10" text-anchor="middle">${t}</text>`);
+    }
+    for (let i = 0; i <= 4; i++) {
+      const v = (max / 4) * i;
+      parts.push(`<text x="${sx(0) - 6}" y="${sy(v) + 3}" font-size="10" text-anchor="end">${Math.round(v)}</text>`);
+    }
+    const release = 10 + options.hold;
+    parts.push(`<line x1="${sx(release)}" y1="${sy(0)}" x2="${sx(release)}" y2="${sy(max)}" stroke="#bbb" stroke-dasharray="4 3"/>`);
+    results.forEach((r, i) => {
+      const points = r.curve.filter((p, j) => j % 4 === 0).map(p => `${sx(p.t).toFixed(1)},${sy(p[chart.key]).toFixed(1)}`);
+      parts.push(`<polyline fill="none" stroke="${COLORS[i % COLORS.length]}" stroke-width="1.5" points="${points.join(' ')}"/>`);
+      if (c === 0) {
+        parts.push(`<text x="${width - margin.right}" y="${top + 18 + i * 14}" font-size="11" text-anchor="end" ` +
+          `fill="${COLORS[i % COLORS.length]}">${r.profile.name}</text>`);
+      }
+    });
+  });
+  const total = charts.length * (height + 20);
+  return `<svg xmlns="http://www.w3.org/2000/svg" width="${width}" height="${total}" font-family="sans-serif">\n` +
+    `<rect width="100%" height="100%" fill="white"/>\n${parts.join('\n')}\n</svg>\n`;
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = { output: path.join(BUILD_DIR, 'kinetic-mouse.svg'), hold: 1500, tap: 30, json: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--output': options.output = value(); break;
+      case '--hold': options.hold = Number(value()); break;
+      case '--tap': options.tap = Number(value()); break;
+      case '--json': options.json = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  return options;
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const binary = build();
+  const results = readProfiles().map(profile => simulate(binary, profile, options));
+
+  fs.mkdirSync(path.dirname(options.output), { recursive: true });
+  fs.writeFileSync(options.output, plot(results, options));
+
+  if (options.json) {
+    console.log(JSON.stringify(results.map(({ curve, ...r }) => r), null, 2));
+    return;
+  }
+  const cell = (v, w = 9) => String(v).padStart(w);
+  console.log(`${'profile'.padEnd(14)}${cell('tap px')}${cell('peak/s')}${cell('95% ms')}${cell('@500ms')}` +
+    `${cell('@release')}${cell('glide px')}${cell('glide ms')}${cell('diag x,y', 11)}`);
+  for (const r of results) {
+    console.log(`${r.profile.name.padEnd(14)}${cell(r.tapPx)}${cell(r.peakSpeed)}${cell(r.msTo95 ?? '-')}${cell(r.px500)}` +
+      `${cell(r.pxHold)}${cell(r.glidePx)}${cell(r.glideMs)}${cell(`${r.diagonal.x},${r.diagonal.y}`, 11)}`);
+  }
+  console.log(`\nTap ${options.tap} ms, hold ${options.hold} ms (distances in px). Plot: ${path.relative(process.cwd(), options.output)}`);
+}
+
+if (require.main === module) {
+  try {
+    main();
+  } catch (err) {
+    console.error(`simulate: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { readProfiles, simulate };
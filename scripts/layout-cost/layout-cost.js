@@ -0,0 +1,605 @@
+#!/usr/bin/env node
+
+//
+// Keystroke-cost model and layout optimizer
+//
+// Scores every action in a usage trace by the key presses it really takes
+// under the j-custom layer design (an app launcher is RGUI tap → F → key →
+// RGUI back to base: 4 presses, 2 layer transitions), then proposes moving
+// frequent actions to free slots where they cost less, and prints the change
+// as a diff against the current layers.
+//
+// Usage: node scripts/layout-cost/layout-cost.js <trace> [options]
+//
+// Trace (either):
+//   key-stats JSON   node scripts/key-stats/key-stats.js --format json > usage.json
+//                    Presses per keycode above the basic range; each press is
+//                    costed on its own, from MAC_BASE and back.
+//   console log      qmk console > keys.log (CONSOLE_ENABLE build)
+//                    The "DEBUG: kc: 0x...., col:, row:, pressed:1" lines in
+//                    order; actions are replayed as typed, so consecutive
+//                    actions on one layer share the way in and out.
+//
+// Options:
+//   --keymap <dir>       Keymap directory (default: j-custom)
+//   --keyboard <kb>      Keyboard for qmk c2json (default: keychron/q11/ansi_encoder)
+//   --model <file>       Layer transitions and optimizer constraints
+//                        (default: layout-cost/j-custom.json)
+//   --parser             Read keymap.c with the built-in parser instead of qmk c2json
+//   --safe-range <n>     SAFE_RANGE for console logs (default: 0x7E40)
+//   --max-moves <n>      Moves to propose (default: 10, 0 = score only)
+//   --top <n>            Actions listed in the report (default: 20)
+//   --json               Machine-readable report instead of text
+//
+// Model file (JSON):
+//   base          Layer every cost starts from and returns to
+//   transitions   Custom keycode → rules, first match wins:
+//                   when     "base" (no other layer on), "other", or a layer that must be on
+//                   on/off   Layer turned on / off;  base: true  = back to the base layer only
+//                   presses  Presses the key takes (2 for a double tap; default 1)
+//                 MO/LT/TT/OSL (held for one action), TG and TO need no entry.
+//   optimizer     targets          Layers that may receive actions
+//                 movable          Layers actions may be taken from
+//                 pinned           Keycodes never moved
+//                 lockedPositions  MAC_BASE keycodes whose positions stay free on
+//                                  every layer (modifiers, thumbs, the RGUI key)
+//                 transitionWeight Cost of a layer transition on top of its press
+//
+
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const { readKeymap } = require('../generate-sparse-keymap');
+const { keymapNames, keycodeNamer, evaluate } = require('../key-stats/key-stats');
+
+const REPO_DIR = path.resolve(__dirname, '..', '..');
+const KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const MODEL = path.join(__dirname, 'j-custom.json');
+const INFO_JSON = path.join(REPO_DIR, 'keychron/q11/info.json');
+const TRANSPARENT = new Set(['_______', 'KC_TRNS', 'KC_TRANSPARENT']);
+const NO_ACTION = new Set([...TRANSPARENT, 'XXXXXXX', 'KC_NO']);
+const QK_TAP_DANCE = 0x5700;
+
+// ============================================
+// Keymap
+// ============================================
+
+const normalize = kc => kc.replace(/\s+/g, '');
+
+// Layers by index, from qmk c2json when it is available, else the built-in parser
+function loadKeymap(options) {
+  const parsed = readKeymap(options.keymap);
+  const count = Object.keys(parsed.layerEnum).length;
+  const names = [];
+  for (const [name, index] of Object.entries(parsed.layerEnum)) names[index] = name;
+
+  let layers = null;
+  let source = 'parser';
+  if (!options.parser) {
+    const file = path.join(options.keymap, 'keymap.c');
+    const run = spawnSync('qmk', ['c2json', '-kb', options.keyboard, '-km', path.basename(options.keymap), file],
+      { encoding: 'utf8' });
+    if (run.status === 0) {
+      try {
+        const json = JSON.parse(run.stdout);
+        if (json.layers && json.layers.length === count) {
+          layers = json.layers.map(l => l.map(normalize));
+          source = 'qmk c2json';
+        }
+      } catch (err) {
+        // Fall through to the parser
+      }
+    }
+    if (!layers) console.error('layout-cost: qmk c2json unavailable or incomplete, using the built-in parser');
+  }
+  if (!layers) {
+    layers = [];
+    for (const layer of parsed.layers) layers[parsed.layerEnum[layer.name]] = layer.keys.map(normalize);
+  }
+  if (layers.length !== count || layers.some(l => !l)) throw new Error(`expected ${count} layers in ${parsed.file}`);
+
+  const macro = parsed.layers[0].macro;
+  const info = JSON.parse(fs.readFileSync(INFO_JSON, 'utf8'));
+  const layout = info.layouts[macro].layout;
+  const rowOf = [...new Set(layout.map(k => k.y))].sort((a, b) => a - b);
+  const keys = layout.map(k => ({ matrix: k.matrix, row: rowOf.indexOf(k.y), x: k.x }));
+  return { file: parsed.file, raw: fs.readFileSync(parsed.file, 'utf8'), layerEnum: parsed.layerEnum,
+    names, layers, macro, keys, source };
+}
+
+// ============================================
+// Layer model
+// ============================================
+
+// Layer state is a bitmask of the layers on above the base layer
+class Model {
+  constructor(keymap, config) {
+    this.keymap = keymap;
+    this.names = keymap.names;
+    this.layers = keymap.layers;
+    this.index = name => {
+      if (keymap.layerEnum[name] === undefined) throw new Error(`model: unknown layer ${name}`);
+      return keymap.layerEnum[name];
+    };
+    this.base = this.index(config.base);
+    this.rules = {};
+    for (const [kc, rules] of Object.entries(config.transitions || {})) {
+      this.rules[normalize(kc)] = rules.map(r => ({
+        when: r.when === undefined || r.when === 'base' || r.when === 'other' ? r.when : this.index(r.when),
+        on: r.on === undefined ? null : this.index(r.on),
+        off: r.off === undefined ? null : this.index(r.off),
+        base: !!r.base,
+        presses: r.presses || 1,
+      }));
+    }
+    const opt = config.optimizer || {};
+    this.weight = opt.transitionWeight === undefined ? 0.5 : opt.transitionWeight;
+    this.overrides = new Map();  // "layer:pos" → keycode, for trial moves
+    this.graphs = new Map();
+    this.tops = new Map();
+  }
+
+  key(layer, pos) {
+    const moved = this.overrides.get(`${layer}:${pos}`);
+    return moved === undefined ? this.layers[layer][pos] : moved;
+  }
+
+  // Keycode a press at pos produces with the given layers on
+  top(state, pos) {
+    for (let layer = this.layers.length - 1; layer >= 0; layer--) {
+      if (layer !== this.base && !(state & (1 << layer))) continue;
+      const kc = this.key(layer, pos);
+      if (!TRANSPARENT.has(kc)) return kc;
+    }
+    return 'KC_NO';
+  }
+
+  // What a keycode does to the layer state: { to, presses } for a switch,
+  // { hold } for a key held while the next action is typed, or null
+  effect(kc, state) {
+    const rules = this.rules[kc];
+    if (rules) {
+      for (const r of rules) {
+        if (r.when === 'base' && state !== 0) continue;
+        if (r.when === 'other' && state === 0) continue;
+        if (typeof r.when === 'number' && !(state & (1 << r.when))) continue;
+        let to = r.base ? 0 : state;
+        if (r.off !== null) to &= ~(1 << r.off);
+        if (r.on !== null && r.on !== this.base) to |= 1 << r.on;
+        return { to, presses: r.presses };
+      }
+      return null;
+    }
+    const m = kc.match(/^(MO|TT|OSL|TG|TO|LT)\((\w+)/);
+    if (!m || this.keymap.layerEnum[m[2]] === undefined) return null;
+    const layer = this.keymap.layerEnum[m[2]];
+    if (m[1] === 'TG') return { to: layer === this.base ? state : state ^ (1 << layer), presses: 1 };
+    if (m[1] === 'TO') return { to: layer === this.base ? 0 : 1 << layer, presses: 1 };
+    return { hold: layer };
+  }
+
+  isTransition(kc) {
+    return this.rules[kc] !== undefined || /^(MO|TT|OSL|TG|TO|DF)\(/.test(kc);
+  }
+
+  // Layer switches reachable from state: shortest press paths (cached; moves
+  // never touch transition keys, so trial moves keep the graph valid)
+  graph(start) {
+    if (this.graphs.has(start)) return this.graphs.get(start);
+    const best = new Map([[start, { cost: 0, presses: 0, transitions: 0, path: [] }]]);
+    const queue = [start];
+    const done = new Set();
+    while (queue.length) {
+      queue.sort((a, b) => best.get(a).cost - best.get(b).cost);
+      const state = queue.shift();
+      if (done.has(state)) continue;
+      done.add(state);
+      const here = best.get(state);
+      for (let pos = 0; pos < this.layers[this.base].length; pos++) {
+        const kc = this.top(state, pos);
+        const e = this.effect(kc, state);
+        if (!e || e.hold !== undefined || e.to === state) continue;
+        const next = { cost: here.cost + e.presses + this.weight, presses: here.presses + e.presses,
+          transitions: here.transitions + 1, path: [...here.path, kc] };
+        const known = best.get(e.to);
+        if (!known || next.cost < known.cost) {
+          best.set(e.to, next);
+          queue.push(e.to);
+        }
+      }
+    }
+    this.graphs.set(start, best);
+    return best;
+  }
+
+  // Hold keys visible in state: [{ kc, layer }]
+  holds(state) {
+    if (this.tops.has(state)) return this.tops.get(state);
+    const found = [];
+    for (let pos = 0; pos < this.layers[this.base].length; pos++) {
+      const kc = this.top(state, pos);
+      const e = this.effect(kc, state);
+      if (e && e.hold !== undefined && !found.some(h => h.layer === e.hold)) found.push({ kc, layer: e.hold });
+    }
+    this.tops.set(state, found);
+    return found;
+  }
+
+  placements(kc) {
+    const found = [];
+    for (let layer = 0; layer < this.layers.length; layer++) {
+      for (let pos = 0; pos < this.layers[layer].length; pos++) {
+        if (this.key(layer, pos) === kc) found.push({ layer, pos });
+      }
+    }
+    return found;
+  }
+
+  // Cheapest way to press kc starting from state: ends in the state reached
+  reach(kc, start) {
+    const spots = this.placements(kc);
+    let best = null;
+    const consider = (via, state, extra) => {
+      const cost = via.cost + 1 + extra.cost;
+      if (best && cost >= best.cost) return;
+      best = { cost, presses: via.presses + 1 + extra.presses, transitions: via.transitions + extra.transitions,
+        path: [...via.path, ...extra.path, kc], end: state };
+    };
+    for (const [state, via] of this.graph(start)) {
+      if (spots.some(s => this.top(state, s.pos) === kc)) consider(via, state, { cost: 0, presses: 0, transitions: 0, path: [] });
+      for (const hold of this.holds(state)) {
+        const held = hold.layer === this.base ? state : state | (1 << hold.layer);
+        if (spots.some(s => this.top(held, s.pos) === kc)) {
+          consider(via, state, { cost: 1 + this.weight, presses: 1, transitions: 1, path: [`${hold.kc}+`] });
+        }
+      }
+    }
+    return best;
+  }
+
+  // Press kc from the base layer and come back to it
+  isolated(kc) {
+    const there = this.reach(kc, 0);
+    if (!there) return null;
+    if (there.end === 0) return there;
+    const back = this.graph(there.end).get(0);
+    if (!back) return null;
+    return { cost: there.cost + back.cost, presses: there.presses + back.presses,
+      transitions: there.transitions + back.transitions, path: [...there.path, ...back.path], end: 0 };
+  }
+}
+
+// ============================================
+// Traces
+// ============================================
+
+// Keycode value → keymap.c spelling (custom keycodes and tap dances included)
+function keycodeResolver(model, raw, safeRange) {
+  const names = keymapNames(raw, model.keymap.layerEnum);
+  const nameOf = keycodeNamer(names, safeRange);
+  const valueOf = kc => {
+    const custom = names.custom.indexOf(kc);
+    if (custom >= 0) return safeRange + custom;
+    const td = kc.match(/^TD\((\w+)\)$/);
+    if (td) {
+      const index = Object.entries(names.tapDances).find(([, n]) => n === td[1]);
+      return index ? QK_TAP_DANCE + Number(index[0]) : undefined;
+    }
+    return evaluate(kc, names);
+  };
+  const byValue = new Map();
+  for (const layer of model.layers) {
+    for (const kc of layer) {
+      const value = valueOf(kc);
+      if (value !== undefined && !byValue.has(value)) byValue.set(value, kc);
+    }
+  }
+  return value => byValue.get(value) || normalize(nameOf(value));
+}
+
+function readTrace(file, model, raw, safeRange) {
+  const text = fs.readFileSync(file, 'utf8');
+  if (text.trimStart().startsWith('{')) {
+    const report = JSON.parse(text);
+    if (!Array.isArray(report.keycodes)) throw new Error(`${file}: not a key-stats JSON export`);
+    const resolve = keycodeResolver(model, raw, report.summary.safeRange || safeRange);
+    const counts = new Map();
+    for (const k of report.keycodes) {
+      const kc = resolve(k.keycode);
+      counts.set(kc, (counts.get(kc) || 0) + k.presses);
+    }
+    return { kind: 'counts', counts };
+  }
+  const resolve = keycodeResolver(model, raw, safeRange);
+  const sequence = [];
+  for (const m of text.matchAll(/kc:\s*0x([0-9A-Fa-f]{1,4})\b[^\n]*?pressed:\s*(\d)/g)) {
+    if (m[2] === '1') sequence.push(resolve(parseInt(m[1], 16)));
+  }
+  if (!sequence.length) throw new Error(`${file}: no "kc: 0x..., pressed:1" lines (qmk console with CONSOLE_ENABLE)`);
+  return { kind: 'sequence', sequence };
+}
+
+// Actions: everything pressed that is not a layer switch
+function actionCounts(trace, model) {
+  const counts = new Map();
+  const add = (kc, n) => {
+    if (NO_ACTION.has(kc) || model.isTransition(kc)) return;
+    counts.set(kc, (counts.get(kc) || 0) + n);
+  };
+  if (trace.kind === 'counts') trace.counts.forEach((n, kc) => add(kc, n));
+  else trace.sequence.forEach(kc => add(kc, 1));
+  return counts;
+}
+
+// ============================================
+// Scoring
+// ============================================
+
+// Keycodes with no placement (encoders, host-side) are typed on the base layer
+const UNPLACED = { cost: 1, presses: 1, transitions: 0 };
+
+function score(model, trace, counts) {
+  const actions = [];
+  const totals = { presses: 0, transitions: 0, cost: 0, unreachable: 0 };
+  for (const [kc, count] of counts) {
+    const placed = model.placements(kc).length > 0;
+    const each = placed ? model.isolated(kc) : { ...UNPLACED, path: [kc] };
+    actions.push({ kc, count, placed, each });
+    if (!each) totals.unreachable += count;
+  }
+  actions.sort((a, b) => b.count * (b.each ? b.each.cost : 1e6) - a.count * (a.each ? a.each.cost : 1e6));
+
+  if (trace.kind === 'counts') {
+    for (const a of actions) {
+      if (!a.each) continue;
+      totals.presses += a.count * a.each.presses;
+      totals.transitions += a.count * a.each.transitions;
+    }
+  } else {
+    // Replay in order: stay on the layer an action left us on while the next one is there
+    let state = 0;
+    for (const kc of trace.sequence) {
+      if (!counts.has(kc)) continue;
+      if (!model.placements(kc).length) {
+        totals.presses += 1;
+        continue;
+      }
+      // graph(state) includes the way back to base, so null means no route at all
+      const step = model.reach(kc, state);
+      if (!step) continue;
+      totals.presses += step.presses;
+      totals.transitions += step.transitions;
+      state = step.end;
+    }
+    const back = model.graph(state).get(0);
+    if (state !== 0 && back) {
+      totals.presses += back.presses;
+      totals.transitions += back.transitions;
+    }
+  }
+  totals.cost = totals.presses + model.weight * totals.transitions;
+  return { actions, totals };
+}
+
+// ============================================
+// Optimizer
+// ============================================
+
+// Greedy: repeatedly make the single move that saves the most weighted presses
+function optimize(model, counts, config, maxMoves) {
+  const opt = config.optimizer || {};
+  const targets = (opt.targets || []).map(model.index);
+  const movable = new Set((opt.movable || []).map(model.index));
+  const pinned = new Set((opt.pinned || []).map(normalize));
+  const locked = new Set((opt.lockedPositions || []).map(normalize));
+  // Tie-break: rows away from the home row plus keys outside its A..' span
+  const homeKeys = ['KC_A', 'KC_QUOT'].map(kc => model.keymap.keys[model.layers[model.base].indexOf(kc)]);
+  const effort = pos => {
+    const k = model.keymap.keys[pos];
+    if (homeKeys.some(h => !h)) return 0;
+    const [left, right] = homeKeys;
+    return Math.abs(k.row - left.row) + Math.max(0, left.x - k.x, k.x - right.x);
+  };
+
+  const free = () => {
+    const slots = [];
+    for (const layer of targets) {
+      for (let pos = 0; pos < model.layers[layer].length; pos++) {
+        if (!TRANSPARENT.has(model.key(layer, pos)) || locked.has(model.layers[model.base][pos])) continue;
+        if (model.isTransition(model.top(1 << layer, pos))) continue;
+        slots.push({ layer, pos });
+      }
+    }
+    return slots;
+  };
+
+  const moves = [];
+  for (let n = 0; n < maxMoves; n++) {
+    let best = null;
+    const slots = free();
+    for (const [kc, count] of counts) {
+      if (pinned.has(kc) || model.isTransition(kc)) continue;
+      const now = model.isolated(kc);
+      if (!now || now.cost <= 1) continue;
+      const from = model.placements(kc).filter(p => movable.has(p.layer) && p.layer !== model.base);
+      if (from.length !== 1) continue;
+      const old = `${from[0].layer}:${from[0].pos}`;
+      for (const slot of slots) {
+        if (slot.layer === from[0].layer) continue;
+        const key = `${slot.layer}:${slot.pos}`;
+        model.overrides.set(old, '_______');
+        model.overrides.set(key, kc);
+        const after = model.isolated(kc);
+        model.overrides.delete(old);
+        model.overrides.delete(key);
+        if (!after) continue;
+        const gain = count * (now.cost - after.cost);
+        const tie = effort(slot.pos);
+        if (gain > 0 && (!best || gain > best.gain || (gain === best.gain && tie < best.tie))) {
+          best = { kc, count, from: from[0], to: slot, gain, tie, before: now, after };
+        }
+      }
+    }
+    if (!best) break;
+    model.layers[best.from.layer][best.from.pos] = '_______';
+    model.layers[best.to.layer][best.to.pos] = best.kc;
+    moves.push(best);
+  }
+  return moves;
+}
+
+// ============================================
+// Report
+// ============================================
+
+function where(model, p) {
+  const k = model.keymap.keys[p.pos];
+  return `${model.names[p.layer]} r${k.matrix[0]}c${k.matrix[1]} (${model.layers[model.base][p.pos]})`;
+}
+
+// One line per layout row, for the rows of each layer that changed
+function layerDiff(keymap, before) {
+  const lines = [`--- ${path.relative(REPO_DIR, keymap.file)} (current)`, `+++ ${path.relative(REPO_DIR, keymap.file)} (proposed)`];
+  const rows = Math.max(...keymap.keys.map(k => k.row)) + 1;
+  keymap.layers.forEach((layer, index) => {
+    const changed = layer.some((kc, pos) => kc !== before[index][pos]);
+    if (!changed) return;
+    lines.push(`@@ [${keymap.names[index]}] = ${keymap.macro}( @@`);
+    for (let row = 0; row < rows; row++) {
+      const positions = keymap.keys.map((k, pos) => (k.row === row ? pos : -1)).filter(p => p >= 0);
+      const line = keys => `    ${positions.map(p => keys[p]).join(', ')}`;
+      if (positions.every(p => layer[p] === before[index][p])) continue;
+      lines.push(`-${line(before[index])}`, `+${line(layer)}`);
+    }
+  });
+  return lines.join('\n');
+}
+
+function textReport(result, options) {
+  const { keymap, trace, current, proposed, moves, unreachable } = result;
+  const out = [];
+  const traceDesc = trace.kind === 'counts' ? 'key-stats counters (each press costed from base and back)' :
+    `console log, ${trace.sequence.length} presses replayed in order`;
+  out.push(`Keymap: ${path.relative(REPO_DIR, keymap.file)} via ${keymap.source}`);
+  out.push(`Trace:  ${traceDesc}`);
+  if (unreachable.length) out.push(`Unreachable from ${keymap.names[0]}: ${unreachable.join(', ')}`);
+  out.push('', 'Costliest actions:');
+  out.push('   presses  each  transitions  action                          path');
+  for (const a of current.actions.slice(0, options.top)) {
+    const each = a.each ? `${a.each.presses}`.padStart(4) : '   -';
+    const tr = a.each ? `${a.each.transitions}`.padStart(11) : '          -';
+    const route = a.each ? a.each.path.join(' → ') : 'unreachable';
+    out.push(`  ${String(a.count).padStart(8)}  ${each}  ${tr}  ${a.kc.padEnd(30)}  ${a.placed ? route : '(not in keymap)'}`);
+  }
+  const t = current.totals;
+  out.push('', `Total: ${t.presses} presses, ${t.transitions} layer transitions`);
+  if (t.unreachable) out.push(`       ${t.unreachable} presses of actions with no route from base not counted`);
+  if (!moves.length) {
+    out.push('', 'No move lowers the cost within the model constraints.');
+    return out.join('\n');
+  }
+  out.push('', 'Proposed moves:');
+  for (const m of moves) {
+    out.push(`  ${m.kc}: ${where(result.model, m.from)} → ${where(result.model, m.to)}`);
+    out.push(`      ${m.before.presses} → ${m.after.presses} presses each (${m.after.path.join(' → ')}), ${m.count} uses`);
+  }
+  const p = proposed.totals;
+  const pct = t.presses ? ` (${(100 * (t.presses - p.presses) / t.presses).toFixed(1)}% fewer presses)` : '';
+  out.push('', `Proposed total: ${p.presses} presses, ${p.transitions} layer transitions${pct}`);
+  out.push('', result.diff);
+  return out.join('\n');
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = { trace: null, keymap: KEYMAP_DIR, keyboard: 'keychron/q11/ansi_encoder', model: MODEL,
+    parser: false, safeRange: 0x7E40, maxMoves: 10, top: 20, json: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    const number = () => {
+      const n = Number(value());
+      if (!Number.isInteger(n) || n < 0) throw new Error(`${arg} expects a non-negative integer`);
+      return n;
+    };
+    switch (arg) {
+      case '--keymap': options.keymap = path.resolve(value()); break;
+      case '--keyboard': options.keyboard = value(); break;
+      case '--model': options.model = path.resolve(value()); break;
+      case '--parser': options.parser = true; break;
+      case '--safe-range': options.safeRange = number(); break;
+      case '--max-moves': options.maxMoves = number(); break;
+      case '--top': options.top = number(); break;
+      case '--json': options.json = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        if (arg.startsWith('-') || options.trace) throw new Error(`Unknown option: ${arg}`);
+        options.trace = arg;
+    }
+  }
+  if (!options.trace) throw new Error('missing trace file (key-stats JSON or qmk console log); see --help');
+  return options;
+}
+
+function analyze(options) {
+  const config = JSON.parse(fs.readFileSync(options.model, 'utf8'));
+  const keymap = loadKeymap(options);
+  const model = new Model(keymap, config);
+  const trace = readTrace(options.trace, model, keymap.raw, options.safeRange);
+  const counts = actionCounts(trace, model);
+
+  const reached = new Set([...model.graph(0).keys()].flatMap(s => keymap.names.map((_, i) => i).filter(i => s & (1 << i))));
+  model.holds(0).forEach(h => reached.add(h.layer));
+  const unreachable = keymap.names.filter((n, i) => i !== model.base && !reached.has(i));
+
+  const before = keymap.layers.map(l => [...l]);
+  const current = score(model, trace, counts);
+  const moves = optimize(model, counts, config, options.maxMoves);
+  const proposed = score(model, trace, counts);
+  const diff = layerDiff(keymap, before);
+  return { keymap, model, trace, current, proposed, moves, unreachable, diff };
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const result = analyze(options);
+  if (!options.json) {
+    console.log(textReport(result, options));
+    return;
+  }
+  const route = e => (e ? { presses: e.presses, transitions: e.transitions, path: e.path } : null);
+  console.log(JSON.stringify({
+    keymap: path.relative(REPO_DIR, result.keymap.file),
+    source: result.keymap.source,
+    trace: result.trace.kind,
+    unreachable: result.unreachable,
+    current: { totals: result.current.totals,
+      actions: result.current.actions.map(a => ({ keycode: a.kc, count: a.count, placed: a.placed, each: route(a.each) })) },
+    proposed: { totals: result.proposed.totals },
+    moves: result.moves.map(m => ({ keycode: m.kc, count: m.count, from: where(result.model, m.from),
+      to: where(result.model, m.to), before: route(m.before), after: route(m.after) })),
+    diff: result.diff,
+  }, null, 2));
+}
+
+if (require.main === module) {
+  try {
+    main();
+  } catch (err) {
+    console.error(`layout-cost: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { loadKeymap, Model, readTrace, actionCounts, score, optimize, layerDiff };
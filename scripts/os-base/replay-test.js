@@ -0,0 +1,212 @@
+#!/usr/bin/env node
+
+//
+// Replay check for OS base layer selection (j-custom/os_base.c)
+//
+// Compiles os_base.c for the host (replay/ harness) and runs scripted
+// scenarios: persistence across power cycles, machine switches, manual
+// override, DIP switch and EEPROM write counts. When a QMK checkout is found
+// ($QMK_HOME or ~/qmk_firmware, as used by build.sh), the captured descriptor
+// request sequences in captures.json are also replayed through QMK's own
+// fingerprint (quantum/os_detection.c); otherwise those cases are skipped.
+//
+// Usage: node scripts/os-base/replay-test.js [--qmk <path>]
+//
+// Scenario lines are harness commands (see replay/os_base_replay.c); an
+// "expect key=value ..." line checks the output of the command before it.
+//
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const REPLAY_DIR = path.join(__dirname, 'replay');
+const BUILD_DIR = path.join(__dirname, '..', '..', '.build');
+const CAPTURES = path.join(__dirname, 'captures.json');
+const KEYMAP_DIR = path.join(__dirname, '..', '..', 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const REMAP = { mac: 'none', win: 'win' };  // Both hosts on MAC_BASE (layer 0), Windows through the key remap profile
+const EEPROM = { none: '0', mac: '4', win: '8' };  // Last host in bits 2-3, mode AUTO
+
+const SCENARIOS = [
+  {
+    name: 'fresh EEPROM starts without a remap, detected Windows persists',
+    script: `
+      eeprom 0
+      boot
+      expect layer=0 remap=none mode=0 writes=0
+      detect windows
+      expect layer=0 remap=win eeprom=0x00000008 writes=1`,
+  },
+  {
+    name: 'same machine after power cycle: first key already remapped for Windows',
+    script: `
+      eeprom 8
+      boot
+      key
+      expect layer=0 remap=win
+      detect windows
+      expect remap=win writes=0`,
+  },
+  {
+    name: 'switching Windows → Mac drops the remap',
+    script: `
+      eeprom 8
+      boot
+      detect macos
+      key
+      expect layer=0 remap=none eeprom=0x00000004 writes=1`,
+  },
+  {
+    name: 'unsure detection keeps the persisted host',
+    script: `
+      eeprom 8
+      boot
+      detect unsure
+      expect remap=win writes=0`,
+  },
+  {
+    name: 'override cycles AUTO → MAC → WIN → AUTO and wins over detection',
+    script: `
+      eeprom 8
+      boot
+      cycle
+      expect remap=none mode=1 eeprom=0x00000009
+      detect windows
+      expect remap=none mode=1
+      cycle
+      expect remap=win mode=2
+      detect macos
+      expect remap=win mode=2
+      cycle
+      expect remap=none mode=0 eeprom=0x00000004`,
+  },
+  {
+    name: 'DIP read at power-on is ignored, flipping it pins the host',
+    script: `
+      eeprom 8
+      dip 1
+      boot
+      expect remap=win mode=0
+      dip 1
+      expect remap=none mode=1
+      dip 0
+      expect layer=0 remap=win mode=2`,
+  },
+  {
+    name: 'other EEPROM user bits are preserved',
+    script: `
+      eeprom ABCD0000
+      boot
+      detect windows
+      expect eeprom=0xABCD0008
+      cycle
+      expect eeprom=0xABCD0009`,
+  },
+];
+
+// A capture replayed after booting with the other host persisted (machine switch)
+function captureScenario(name, capture) {
+  const other = capture.base === 'mac' ? 'win' : 'mac';
+  const setups = capture.wLength.map(w => `setup ${w}\nwait 1`).join('\n');
+  return {
+    name: `${name}: ${capture.os} → remap ${REMAP[capture.base]}`,
+    qmk: true,
+    script: `
+      eeprom ${EEPROM[other]}
+      boot
+      ${setups}
+      wait 300
+      key
+      expect layer=0 remap=${REMAP[capture.base]}
+      unplug
+      wait 10
+      ${setups}
+      wait 300
+      expect layer=0 remap=${REMAP[capture.base]} writes=1`,
+  };
+}
+
+function findQmk() {
+  const flag = process.argv.indexOf('--qmk');
+  const candidates = [flag > 0 ? process.argv[flag + 1] : null, process.env.QMK_HOME, path.join(os.homedir(), 'qmk_firmware')];
+  return candidates.find(dir => dir && fs.existsSync(path.join(dir, 'quantum', 'os_detection.c'))) || null;
+}
+
+function build(qmk) {
+  const binary = path.join(BUILD_DIR, qmk ? 'os_base_replay_qmk' : 'os_base_replay');
+  fs.mkdirSync(BUILD_DIR, { recursive: true });
+  const args = ['-O1', '-std=gnu11', '-Wall', `-I${REPLAY_DIR}`, '-DQMK_KEYBOARD_H="qmk_stubs.h"'];
+  const sources = [path.join(REPLAY_DIR, 'os_base_replay.c'), path.join(KEYMAP_DIR, 'os_base.c')];
+  if (qmk) {
+    args.push('-DOS_BASE_REPLAY_QMK', `-I${path.join(qmk, 'quantum')}`, `-I${path.join(qmk, 'platforms')}`,
+      '-ffunction-sections', '-fdata-sections', '-Wl,--gc-sections');
+    sources.push(path.join(qmk, 'quantum', 'os_detection.c'));
+  } else {
+    args.push(`-I${path.join(REPLAY_DIR, 'no_qmk')}`);
+  }
+  execFileSync(process.env.CC || 'cc', [...args, '-o', binary, ...sources], { stdio: ['ignore', 'inherit', 'pipe'] });
+  return binary;
+}
+
+function run(binary, scenario) {
+  const lines = scenario.script.trim().split('\n').map(l => l.trim()).filter(Boolean);
+  const commands = lines.filter(l => !l.startsWith('expect'));
+  const output = execFileSync(binary, { input: commands.join('\n') + '\n' }).toString().trim().split('\n');
+  const failures = [];
+  let index = -1;
+  for (const line of lines) {
+    if (!line.startsWith('expect')) {
+      index++;
+      continue;
+    }
+    const actual = Object.fromEntries(output[index].split(' ').slice(2).map(kv => kv.split('=')));
+    for (const [key, want] of line.split(/\s+/).slice(1).map(kv => kv.split('='))) {
+      if (actual[key] !== want) failures.push(`after "${commands[index]}": ${key}=${actual[key]} (want ${want})`);
+    }
+  }
+  return failures;
+}
+
+function main() {
+  const qmk = findQmk();
+  let binary;
+  try {
+    binary = build(qmk);
+  } catch (e) {
+    console.error(`replay-test: build failed${qmk ? ` against ${qmk}` : ''}\n${e.stderr || e.message}`);
+    process.exit(1);
+  }
+
+  const captures = JSON.parse(fs.readFileSync(CAPTURES, 'utf8'));
+  const scenarios = SCENARIOS.concat(Object.entries(captures)
+    .filter(([name]) => !name.startsWith('_'))
+    .map(([name, capture]) => captureScenario(name, capture)));
+
+  console.log(`OS base replay${qmk ? ` (fingerprint: ${qmk}/quantum/os_detection.c)` : ''}:`);
+  let failed = 0;
+  let skipped = 0;
+  for (const scenario of scenarios) {
+    if (scenario.qmk && !qmk) {
+      skipped++;
+      console.log(`  skip  ${scenario.name}`);
+      continue;
+    }
+    const failures = run(binary, scenario);
+    if (failures.length === 0) {
+      console.log(`  ok    ${scenario.name}`);
+    } else {
+      failed++;
+      console.log(`  FAIL  ${scenario.name}`);
+      failures.forEach(f => console.log(`          ${f}`));
+    }
+  }
+  if (skipped > 0) console.log(`${skipped} capture replay(s) skipped: no QMK checkout (set QMK_HOME or pass --qmk)`);
+  if (failed > 0) {
+    console.log(`${failed} scenario(s) failed`);
+    process.exit(1);
+  }
+  console.log('All scenarios passed');
+}
+
+main();
@@ -0,0 +1,13 @@
+/* os_detection.h stand-in for replays without a QMK checkout
+ *
+ * Same variants as quantum/os_detection.h; only "detect" scenarios can run.
+ */
+#pragma once
+
+typedef enum {
+    OS_UNSURE,
+    OS_LINUX,
+    OS_WINDOWS,
+    OS_MACOS,
+    OS_IOS,
+} os_variant_t;
@@ -0,0 +1,184 @@
+/* Replay harness for OS base layer selection
+ *
+ * Links the keymap's os_base.c on the host and drives it with a script on
+ * stdin, one command per line:
+ *   eeprom <hex>    EEPROM user word before power-on
+ *   boot            keyboard_post_init_user: os_base_init(MAC_BASE, MAC_BASE)
+ *   setup <hex>     GET_DESCRIPTOR(String) wLength from the host (QMK fingerprint)
+ *   detect <os>     Detection result directly (unsure/linux/windows/macos/ios)
+ *   wait <ms>       Advance the clock; reports detection after the debounce like os_detection_task
+ *   unplug          Host disconnected (fingerprint data erased)
+ *   dip <0|1>       Mac/Win DIP switch moved (1 = Mac)
+ *   cycle           KC_OS_BASE pressed
+ *   key             Keystroke: prints the default layer and remap profile it would use
+ * Every command prints "<t>ms <cmd> layer=<n> remap=<none|win> mode=<m> eeprom=<hex> writes=<n>".
+ * As in keymap.c, both hosts share MAC_BASE and os_base_changed_user() picks
+ * the Windows key remap profile (key_remap.h) for a Windows host.
+ *
+ * With -DOS_BASE_REPLAY_QMK the fingerprint is QMK's own quantum/os_detection.c
+ * (linked with --gc-sections so only process_wlength/detected_host_os are used);
+ * without it "setup" is rejected and scenarios must use "detect".
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "qmk_stubs.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/os_base.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/key_remap.h"
+
+#ifndef OS_DETECTION_DEBOUNCE
+#    define OS_DETECTION_DEBOUNCE 250
+#endif
+
+// j-custom layer numbers (enum layers in keymap.c)
+#define MAC_BASE 0
+
+// ============================================
+// Keymap side (keymap.c, Key Remap)
+// ============================================
+
+static const key_remap_profile_t  win_profile = { .mods = { KEY_REMAP_GUI, KEY_REMAP_SHIFT, KEY_REMAP_ALT, KEY_REMAP_CTRL } };
+static const key_remap_profile_t *remap       = NULL;
+
+void key_remap_set(const key_remap_profile_t *profile) {
+    remap = profile;
+}
+
+void os_base_changed_user(os_base_mode_t host) {
+    key_remap_set(host == OS_BASE_WIN ? &win_profile : NULL);
+}
+
+// ============================================
+// QMK stubs
+// ============================================
+
+layer_state_t default_layer_state = 0;
+
+static uint32_t now_ms        = 0;
+static uint32_t eeprom_user   = 0;
+static unsigned eeprom_writes = 0;
+
+void default_layer_set(layer_state_t state) {
+    default_layer_state = state;
+}
+
+uint32_t eeconfig_read_user(void) {
+    return eeprom_user;
+}
+
+void eeconfig_update_user(uint32_t val) {
+    eeprom_user = val;
+    eeprom_writes++;
+}
+
+uint16_t timer_read(void) {
+    return (uint16_t)now_ms;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return (uint16_t)(now_ms - last);
+}
+
+uint32_t timer_read32(void) {
+    return now_ms;
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return now_ms - last;
+}
+
+fast_timer_t timer_read_fast(void) {
+    return now_ms;
+}
+
+fast_timer_t timer_elapsed_fast(fast_timer_t last) {
+    return now_ms - last;
+}
+
+#ifdef OS_BASE_REPLAY_QMK
+void process_wlength(const uint16_t w_length);
+void erase_wlength_data(void);
+#endif
+
+// ============================================
+// Replay
+// ============================================
+
+static int default_layer(void) {
+    for (int i = 31; i >= 0; i--) {
+        if (default_layer_state & (1UL << i)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static os_variant_t parse_os(const char *name) {
+    static const char *names[] = { "unsure", "linux", "windows", "macos", "ios" };
+    for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return (os_variant_t)i;
+        }
+    }
+    fprintf(stderr, "replay: unknown os '%s'\n", name);
+    exit(2);
+}
+
+int main(void) {
+    char     line[128];
+    uint32_t last_setup    = 0;
+    bool     setup_pending = false;
+
+    while (fgets(line, sizeof(line), stdin)) {
+        char cmd[16] = "", arg[32] = "";
+        if (sscanf(line, "%15s %31s", cmd, arg) < 1 || cmd[0] == '#') {
+            continue;
+        }
+
+        if (strcmp(cmd, "eeprom") == 0) {
+            eeprom_user = (uint32_t)strtoul(arg, NULL, 16);
+        } else if (strcmp(cmd, "boot") == 0) {
+            os_base_init(MAC_BASE, MAC_BASE);
+        } else if (strcmp(cmd, "setup") == 0) {
+#ifdef OS_BASE_REPLAY_QMK
+            process_wlength((uint16_t)strtoul(arg, NULL, 16));
+            last_setup    = now_ms;
+            setup_pending = true;
+#else
+            fprintf(stderr, "replay: 'setup' needs QMK's os_detection.c (build with -DOS_BASE_REPLAY_QMK)\n");
+            return 2;
+#endif
+        } else if (strcmp(cmd, "detect") == 0) {
+            os_base_detected(parse_os(arg));
+        } else if (strcmp(cmd, "wait") == 0) {
+            uint32_t until = now_ms + (uint32_t)strtoul(arg, NULL, 10);
+            while (now_ms < until) {
+                now_ms++;
+#ifdef OS_BASE_REPLAY_QMK
+                // os_detection_task: report once the host stopped asking for descriptors
+                if (setup_pending && now_ms - last_setup >= OS_DETECTION_DEBOUNCE) {
+                    setup_pending = false;
+                    os_base_detected(detected_host_os());
+                }
+#endif
+            }
+        } else if (strcmp(cmd, "unplug") == 0) {
+#ifdef OS_BASE_REPLAY_QMK
+            erase_wlength_data();
+#endif
+            setup_pending = false;
+        } else if (strcmp(cmd, "dip") == 0) {
+            os_base_dip(atoi(arg) != 0);
+        } else if (strcmp(cmd, "cycle") == 0) {
+            os_base_cycle_mode();
+        } else if (strcmp(cmd, "key") != 0) {
+            fprintf(stderr, "replay: unknown command '%s'\n", cmd);
+            return 2;
+        }
+
+        printf("%ums %s layer=%d remap=%s mode=%d eeprom=0x%08X writes=%u\n", (unsigned)now_ms, cmd, default_layer(), remap == &win_profile ? "win" : "none",
+               (int)os_base_mode(), (unsigned)eeprom_user, eeprom_writes);
+    }
+    (void)last_setup;
+    return 0;
+}
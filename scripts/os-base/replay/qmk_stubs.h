@@ -0,0 +1,20 @@
+/* Minimal QMK environment for building os_base.c on the host
+ *
+ * Provides just enough of quantum.h (layers, EEPROM user word) for the
+ * replay harness; timer.h is stubbed next to it with a virtual clock.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "timer.h"
+
+typedef uint32_t layer_state_t;
+
+extern layer_state_t default_layer_state;
+
+void     default_layer_set(layer_state_t state);
+uint32_t eeconfig_read_user(void);
+void     eeconfig_update_user(uint32_t val);
@@ -0,0 +1,13 @@
+/* timer.h stand-in: virtual clock advanced by the replay harness */
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t fast_timer_t;
+
+uint16_t     timer_read(void);
+uint16_t     timer_elapsed(uint16_t last);
+uint32_t     timer_read32(void);
+uint32_t     timer_elapsed32(uint32_t last);
+fast_timer_t timer_read_fast(void);
+fast_timer_t timer_elapsed_fast(fast_timer_t last);
@@ -1,26 +1,21 @@
 #!/usr/bin/env node
 
-const fs = require('fs');
+const { loadDb } = require('./keybinding-db');
 
-const keybindingsFile = '/tmp/cursor-default-keybindings.json';
-
-if (!fs.existsSync(keybindingsFile)) {
+let db;
+try {
+  db = loadDb();
+} catch (e) {
   console.error('Keybindings file not found. Please download it first.');
   process.exit(1);
 }
+const keybindings = db.bindings.filter(k => k.source === 'default');
 
-// Read and strip comments
-let content = fs.readFileSync(keybindingsFile, 'utf8');
-// Remove single-line comments
-content = content.replace(/\/\/.*$/gm, '');
-// Remove multi-line comments (if any)
-content = content.replace(/\/\*[\s\S]*?\*\//g, '');
-const keybindings = JSON.parse(content);
-
-// Filter for cmd+k keybindings
-const cmdKKeybindings = keybindings.filter(k => 
-  k.key && k.key.toLowerCase().includes('cmd+k')
-);
+// Cmd+K keybindings: chord sequences starting with cmd+k (from the chord index)
+const cmdKKeybindings = Object.keys(db.byChord)
+  .filter(chord => chord.split(' ')[0] === 'cmd+k')
+  .flatMap(chord => db.byChord[chord].map(i => db.bindings[i]))
+  .filter(k => k.source === 'default');
 
 // Sort by key
 cmdKKeybindings.sort((a, b) => {
@@ -0,0 +1,114 @@
+/* Loopback harness for the main-loop profiler
+ *
+ * Builds the keymap's profiler.c with the wall clock backend
+ * (PROFILER_WALL_CLOCK, ticks are nanoseconds) against qmk_stubs.h and runs
+ * a stand-in main loop that spends time in the same sections as the
+ * firmware, nested the same way (debounce inside the matrix scan, SNLED flush
+ * inside the RGB task). Raw HID frames are read from stdin and answered on
+ * stdout (RAW_EPSIZE bytes each way) from the USB section, as raw_hid_task
+ * does, so profiler.js can be tried with no keyboard attached.
+ *
+ * Section costs are rough Q11 figures; every PROFILER_LOOPBACK_SPIKE passes
+ * the RGB task renders a heavy frame, so the slowest pass trace has
+ * something to show.
+ *
+ * Build: cc -O2 -I. -DQMK_KEYBOARD_H='"qmk_stubs.h"' -DPROFILER_WALL_CLOCK \
+ *           -o profiler_loopback profiler_loopback.c
+ */
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "qmk_stubs.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/profiler.c"
+
+#ifndef PROFILER_LOOPBACK_SPIKE
+#    define PROFILER_LOOPBACK_SPIKE 5000
+#endif
+
+// ============================================
+// QMK stubs
+// ============================================
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    fwrite(data, 1, length, stdout);
+    fflush(stdout);
+}
+
+// ============================================
+// Simulated work
+// ============================================
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void spin_us(uint32_t us) {
+    uint64_t until = now_ns() + us * 1000ULL;
+    while (now_ns() < until) {
+    }
+}
+
+static void section(uint8_t id, uint32_t us) {
+    profiler_begin(id);
+    spin_us(us);
+    profiler_end();
+}
+
+// ============================================
+// Main loop: one pass per iteration, frames answered in the USB section
+// ============================================
+
+int main(void) {
+    uint8_t       frame[RAW_EPSIZE];
+    size_t        filled = 0;
+    struct pollfd pfd    = { .fd = STDIN_FILENO, .events = POLLIN };
+    bool          open   = true;
+
+    profiler_init();
+    for (uint32_t pass = 0; open; pass++) {
+        profiler_begin(PROFILER_MATRIX);
+        spin_us(20);
+        section(PROFILER_DEBOUNCE, 4);
+        profiler_end();
+
+        section(PROFILER_TRANSPORT, 45);
+
+        if (pass % 40 == 0) {
+            section(PROFILER_PROCESS_RECORD, 12);
+        }
+
+        profiler_begin(PROFILER_RGB);
+        spin_us(pass % PROFILER_LOOPBACK_SPIKE == PROFILER_LOOPBACK_SPIKE - 1 ? 2500 : 30);
+        if (pass % 8 == 0) {
+            section(PROFILER_SNLED, 350);
+        }
+        profiler_end();
+
+        section(PROFILER_CONSOLE, 1);
+
+        profiler_begin(PROFILER_USB);
+        spin_us(2);
+        while (poll(&pfd, 1, 0) > 0) {
+            ssize_t n = read(STDIN_FILENO, frame + filled, sizeof(frame) - filled);
+            if (n <= 0) {
+                open = false;
+                break;
+            }
+            filled += (size_t)n;
+            if (filled == sizeof(frame)) {
+                if (!profiler_receive(frame, sizeof(frame))) {
+                    fprintf(stderr, "loopback: ignored frame for channel 0x%02X\n", frame[0]);
+                }
+                filled = 0;
+            }
+        }
+        profiler_end();
+
+        section(PROFILER_HOUSEKEEPING, 3);
+        profiler_pass();
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+/* Minimal QMK environment for building profiler.c on the host
+ *
+ * Provides just enough of quantum.h / raw_hid.h for the profiler loopback
+ * harness; profiler.c is built with PROFILER_WALL_CLOCK, so no DWT.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RAW_EPSIZE 32
+
+void raw_hid_send(uint8_t *data, uint8_t length);
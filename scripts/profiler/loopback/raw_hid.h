@@ -0,0 +1,4 @@
+/* raw_hid.h stand-in for the loopback harness (see qmk_stubs.h) */
+#pragma once
+
+#include "qmk_stubs.h"
@@ -0,0 +1,218 @@
+#!/usr/bin/env node
+
+//
+// Main-loop profiler viewer
+//
+// Reads the per-section cycle counts kept by j-custom/profiler.c over raw HID
+// (firmware built with PROFILER_ENABLE = yes) and shows min / mean / max per
+// main-loop pass for each subsystem, its share of the mean pass, and the
+// slowest pass since the last reset as a timeline.
+//
+// Usage: node scripts/profiler/profiler.js [options]
+//
+// Options:
+//   --transport <spec>   hid | hidraw:/dev/hidrawN | loopback (default: hid)
+//                        loopback runs profiler.c on the host (loopback/ harness)
+//   --interval <ms>      Refresh interval (default: 1000)
+//   --once               Print one snapshot and exit
+//   --json               Print snapshots as JSON lines (for logging)
+//   --reset              Zero the statistics and the trace first
+//
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const { RAW_EPSIZE, openTransport } = require('../host-context/raw-hid-transport');
+
+const KEYMAP_DIR = path.join(__dirname, '..', '..', 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const HEADER = path.join(KEYMAP_DIR, 'profiler.h');
+const LOOPBACK_DIR = path.join(__dirname, 'loopback');
+const LOOPBACK_BIN = path.join(__dirname, '..', '..', '.build', 'profiler_loopback');
+const LOOPBACK_SOURCES = ['profiler_loopback.c', 'qmk_stubs.h', 'raw_hid.h'].map(f => path.join(LOOPBACK_DIR, f))
+  .concat(['profiler.c', 'profiler.h'].map(f => path.join(KEYMAP_DIR, f)));
+
+// profiler_section order in profiler.h
+const SECTION_NAMES = ['matrix scan', 'debounce', 'split transport', 'process_record', 'RGB render', 'SNLED flush',
+  'console', 'USB', 'housekeeping'];
+
+// ============================================
+// Protocol (values read from profiler.h)
+// ============================================
+
+function parseHeader(file = HEADER) {
+  const source = fs.readFileSync(file, 'utf8');
+  const defines = {};
+  for (const m of source.matchAll(/(?:#\s*define\s+|^\s*)(PROFILER_\w+)\s*=?\s*(0x[0-9A-Fa-f]+|\d+)/gm)) {
+    defines[m[1]] = Number(m[2]);
+  }
+  const required = ['PROFILER_CHANNEL', 'PROFILER_REPLY', 'PROFILER_OP_READ', 'PROFILER_OP_RESET',
+    'PROFILER_PAGE_SUMMARY', 'PROFILER_PAGE_SECTIONS', 'PROFILER_PAGE_TRACE'];
+  const missing = required.filter(name => defines[name] === undefined);
+  if (missing.length > 0) throw new Error(`${file}: missing ${missing.join(', ')}`);
+  return defines;
+}
+
+async function request(transport, d, opcode, page, first = 0) {
+  const frame = Buffer.alloc(RAW_EPSIZE);
+  frame[0] = d.PROFILER_CHANNEL;
+  frame[1] = opcode;
+  frame[2] = page;
+  frame[3] = first;
+  const reply = await transport.request(frame);
+  if (reply[0] !== d.PROFILER_CHANNEL || reply[1] !== (opcode | d.PROFILER_REPLY)) {
+    throw new Error(`unexpected reply to page ${page} (is PROFILER_ENABLE firmware flashed?)`);
+  }
+  return { count: reply[4], data: reply.subarray(5) };
+}
+
+// Every entry of a page, asking again from where the last reply ended
+async function readPage(transport, d, page, total, entrySize, decode) {
+  const entries = [];
+  while (entries.length < total) {
+    const { count, data } = await request(transport, d, d.PROFILER_OP_READ, page, entries.length);
+    if (count === 0) break;
+    for (let i = 0; i < count; i++) entries.push(decode(data, i * entrySize));
+  }
+  return entries;
+}
+
+async function snapshot(transport, d, reset = false) {
+  if (reset) await request(transport, d, d.PROFILER_OP_RESET, d.PROFILER_PAGE_SUMMARY);
+  const s = (await request(transport, d, d.PROFILER_OP_READ, d.PROFILER_PAGE_SUMMARY)).data;
+  const ticksPerUs = s.readUInt16LE(0);
+  const us = ticks => ticks / ticksPerUs;
+  const summary = {
+    ticksPerUs, sections: s[2], traceEvents: s[3],
+    passes: s.readUInt32LE(4), minUs: us(s.readUInt32LE(8)), meanUs: us(s.readUInt32LE(12)), maxUs: us(s.readUInt32LE(16)),
+  };
+  const sections = await readPage(transport, d, d.PROFILER_PAGE_SECTIONS, summary.sections, 20, (b, o) => ({
+    passes: b.readUInt32LE(o), minUs: us(b.readUInt32LE(o + 4)), meanUs: us(b.readUInt32LE(o + 8)),
+    maxUs: us(b.readUInt32LE(o + 12)), worstUs: us(b.readUInt32LE(o + 16)),
+  }));
+  sections.forEach((section, i) => { section.name = SECTION_NAMES[i] || `section ${i}`; });
+  const trace = await readPage(transport, d, d.PROFILER_PAGE_TRACE, summary.traceEvents, 9, (b, o) => ({
+    section: SECTION_NAMES[b[o]] || `section ${b[o]}`, startUs: us(b.readUInt32LE(o + 1)), us: us(b.readUInt32LE(o + 5)),
+  }));
+  return { time: Date.now(), summary, sections, trace };
+}
+
+// ============================================
+// Display
+// ============================================
+
+const fmt = us => (us >= 1000 ? `${(us / 1000).toFixed(2)}ms` : `${us.toFixed(1)}us`);
+
+// Mean cost of a section per pass (it may run in only some of them)
+function perPass(section, summary) {
+  return summary.passes > 0 ? (section.meanUs * section.passes) / summary.passes : 0;
+}
+
+function render(snap, options) {
+  if (options.json) {
+    console.log(JSON.stringify(snap));
+    return;
+  }
+
+  const { summary, sections, trace } = snap;
+  const lines = [];
+  const cell = (v, w = 10) => String(v).padStart(w);
+  lines.push(`Main loop: ${summary.passes} passes   min ${fmt(summary.minUs)}  mean ${fmt(summary.meanUs)}  max ${fmt(summary.maxUs)}` +
+    (summary.meanUs > 0 ? `   (${Math.round(1e6 / summary.meanUs)} passes/s)` : ''));
+  lines.push('');
+  lines.push(`  ${'section'.padEnd(16)}${cell('runs', 8)}${cell('min')}${cell('mean')}${cell('max')}${cell('per pass')}${cell('share', 7)}${cell('worst')}`);
+  let covered = 0;
+  for (const section of sections) {
+    const share = perPass(section, summary);
+    covered += share;
+    const pct = summary.meanUs > 0 ? `${((share / summary.meanUs) * 100).toFixed(1)}%` : '-';
+    lines.push(`  ${section.name.padEnd(16)}${cell(section.passes, 8)}${cell(fmt(section.minUs))}${cell(fmt(section.meanUs))}` +
+      `${cell(fmt(section.maxUs))}${cell(fmt(share))}${cell(pct, 7)}${cell(fmt(section.worstUs))}`);
+  }
+  const other = Math.max(0, summary.meanUs - covered);
+  const pct = summary.meanUs > 0 ? `${((other / summary.meanUs) * 100).toFixed(1)}%` : '-';
+  lines.push(`  ${'other'.padEnd(16)}${cell('', 8)}${cell('')}${cell('')}${cell('')}${cell(fmt(other))}${cell(pct, 7)}`);
+  lines.push('');
+
+  lines.push(`  Slowest pass (${fmt(summary.maxUs)}), exclusive time per section run:`);
+  const scale = summary.maxUs > 0 ? 40 / summary.maxUs : 0;
+  for (const event of trace) {
+    const bar = ' '.repeat(Math.round(event.startUs * scale)) + '#'.repeat(Math.max(1, Math.round(event.us * scale)));
+    lines.push(`  ${cell(fmt(event.startUs))}  ${event.section.padEnd(16)}${cell(fmt(event.us))}  ${bar}`);
+  }
+  if (trace.length === 0) lines.push('  (no pass recorded yet)');
+
+  if (!options.once) process.stdout.write('\x1b[2J\x1b[H');
+  console.log(lines.join('\n'));
+}
+
+// ============================================
+// Main
+// ============================================
+
+// Compile the loopback harness when missing or older than its sources
+function buildLoopback() {
+  const built = fs.existsSync(LOOPBACK_BIN) ? fs.statSync(LOOPBACK_BIN).mtimeMs : 0;
+  if (LOOPBACK_SOURCES.some(f => fs.statSync(f).mtimeMs > built)) {
+    fs.mkdirSync(path.dirname(LOOPBACK_BIN), { recursive: true });
+    execFileSync(process.env.CC || 'cc', [
+      '-O2', '-std=gnu99', `-I${LOOPBACK_DIR}`, '-DQMK_KEYBOARD_H="qmk_stubs.h"', '-DPROFILER_WALL_CLOCK',
+      '-o', LOOPBACK_BIN, path.join(LOOPBACK_DIR, 'profiler_loopback.c'),
+    ], { stdio: 'inherit' });
+  }
+  return LOOPBACK_BIN;
+}
+
+function parseArgs(argv) {
+  const options = { transport: 'hid', interval: 1000, once: false, json: false, reset: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--transport': options.transport = value(); break;
+      case '--interval': options.interval = Number(value()); break;
+      case '--once': options.once = true; break;
+      case '--json': options.json = true; break;
+      case '--reset': options.reset = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  return options;
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const d = parseHeader();
+  const loopback = options.transport === 'loopback';
+  const transport = openTransport(options.transport, loopback ? { binary: buildLoopback() } : {});
+  if (loopback && options.once) {
+    await new Promise(resolve => setTimeout(resolve, options.interval));  // Let the harness run some passes
+  }
+  let first = true;
+  for (;;) {
+    const snap = await snapshot(transport, d, first && options.reset);
+    first = false;
+    render(snap, options);
+    if (options.once) break;
+    await new Promise(resolve => setTimeout(resolve, options.interval));
+  }
+  await transport.close();
+}
+
+if (require.main === module) {
+  main().catch(err => {
+    console.error(`profiler: ${err.message}`);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseHeader, snapshot, SECTION_NAMES };
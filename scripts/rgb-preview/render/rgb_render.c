@@ -0,0 +1,321 @@
+/* Offline RGB matrix renderer: host harness for scripts/rgb-preview/rgb-preview.js
+ *
+ * Compiles QMK's own effect sources (quantum/rgb_matrix/animations and their
+ * runners) with the part of rgb_matrix.c they rely on, for the LED layout and
+ * enabled effects that rgb-preview.js generates into rgb_preview_config.h
+ * (force-included). One run renders one effect on one half, as that half's
+ * MCU would with RGB_MATRIX_SPLIT: its own LEDs only, in
+ * RGB_MATRIX_LED_PROCESS_LIMIT chunks, with its own effect state.
+ *
+ * Frames are RGB_MATRIX_LED_FLUSH_LIMIT-style ticks of a virtual clock. Key
+ * presses for the reactive effects come from a seeded generator, so both
+ * halves see the same hits (as split_hits.c gives the slave).
+ *
+ * Usage: rgb_render --list
+ *        rgb_render <effect> <left|right|all> <frames> <interval ms>
+ *                   <hue> <sat> <val> <speed> <flags> <keys per s> <seed>
+ * Output, per frame:
+ *   hit <frame> <led>                          a key press before the frame
+ *   frame <frame> <ns> <iterations> <rrggbb per LED...>
+ * ns is the host time of the effect calls for the frame (all iterations).
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+_Static_assert(MATRIX_ROWS <= 16 && MATRIX_COLS <= 16, "a key packs row and col in one byte");
+
+#include "color.h"
+#include "lib/lib8tion/lib8tion.h"
+#include "rgb_matrix_types.h"
+
+// ============================================
+// rgb_matrix.h / rgb_matrix.c glue the effects expect
+// ============================================
+
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+#    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
+#endif
+#ifndef RGB_MATRIX_MAXIMUM_BRIGHTNESS
+#    define RGB_MATRIX_MAXIMUM_BRIGHTNESS UINT8_MAX
+#endif
+
+static uint8_t  led_first = 0;  // This half's LEDs: [led_first, led_end)
+static uint8_t  led_end   = RGB_MATRIX_LED_COUNT;
+static bool     left_half = true;
+static uint32_t clock_ms  = 0;
+
+// RGB_MATRIX_SPLIT limits with the half chosen at run time
+#define RGB_MATRIX_USE_LIMITS_ITER(min, max, iter)                   \
+    uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (iter);             \
+    uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;                \
+    if (max > RGB_MATRIX_LED_COUNT) max = RGB_MATRIX_LED_COUNT;      \
+    if (max > led_end) max = led_end;                                \
+    if (min < led_first) min = led_first;
+#define RGB_MATRIX_USE_LIMITS(min, max) RGB_MATRIX_USE_LIMITS_ITER(min, max, params->iter)
+
+#define RGB_MATRIX_TEST_LED_FLAGS() \
+    if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
+
+#define rgb_matrix_hsv_to_rgb(hsv) hsv_to_rgb(hsv)
+
+rgb_config_t rgb_matrix_config;
+uint32_t     g_rgb_timer;
+led_config_t g_led_config = RGB_PREVIEW_LED_CONFIG;
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+last_hit_t        g_last_hit_tracker;
+static last_hit_t last_hit_buffer;
+#endif
+#ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
+uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
+#endif
+
+static uint8_t colors[RGB_MATRIX_LED_COUNT][3];
+
+bool is_keyboard_left(void) {
+    return left_half;
+}
+
+uint16_t timer_read(void) {
+    return (uint16_t)clock_ms;
+}
+
+uint32_t timer_read32(void) {
+    return clock_ms;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return (uint16_t)clock_ms - last;
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return clock_ms - last;
+}
+
+static inline bool rgb_matrix_check_finished_leds(uint8_t led_idx) {
+    return led_idx < led_end;
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index >= 0 && index < RGB_MATRIX_LED_COUNT) {
+        colors[index][0] = red;
+        colors[index][1] = green;
+        colors[index][2] = blue;
+    }
+}
+
+void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        rgb_matrix_set_color(i, red, green, blue);
+    }
+}
+
+// ============================================
+// Effects
+// ============================================
+
+enum rgb_matrix_effects {
+    RGB_MATRIX_NONE = 0,
+#define RGB_MATRIX_EFFECT(name, ...) RGB_MATRIX_##name,
+#include "rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+#ifdef RGB_MATRIX_CUSTOM_USER
+#    define RGB_MATRIX_EFFECT(name, ...) RGB_MATRIX_CUSTOM_##name,
+#    include "rgb_matrix_user.inc"
+#    undef RGB_MATRIX_EFFECT
+#endif
+    RGB_MATRIX_EFFECT_MAX
+};
+
+#include "rgb_matrix_runners.inc"
+
+#define RGB_MATRIX_EFFECT(name, ...)
+#define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#include "rgb_matrix_effects.inc"
+#ifdef RGB_MATRIX_CUSTOM_USER
+#    include "rgb_matrix_user.inc"
+#endif
+#undef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#undef RGB_MATRIX_EFFECT
+
+typedef struct {
+    const char *name;
+    uint8_t     mode;
+    bool (*render)(effect_params_t *params);
+} effect_t;
+
+static const effect_t effects[] = {
+#define RGB_MATRIX_EFFECT(name, ...) {#name, RGB_MATRIX_##name, name},
+#include "rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+#ifdef RGB_MATRIX_CUSTOM_USER
+#    define RGB_MATRIX_EFFECT(name, ...) {#name, RGB_MATRIX_CUSTOM_##name, name},
+#    include "rgb_matrix_user.inc"
+#    undef RGB_MATRIX_EFFECT
+#endif
+};
+
+#define EFFECT_COUNT (sizeof(effects) / sizeof(effects[0]))
+
+// ============================================
+// Key presses (process_rgb_matrix)
+// ============================================
+
+static uint32_t hit_seed;
+
+// Separate from the effects' random8()/rand(): the same hits on both halves
+static uint32_t hit_random(void) {
+    hit_seed ^= hit_seed << 13;
+    hit_seed ^= hit_seed >> 17;
+    hit_seed ^= hit_seed << 5;
+    return hit_seed;
+}
+
+static void press(uint8_t row, uint8_t col) {
+    uint8_t led = g_led_config.matrix_co[row][col];
+    (void)led;
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+    if (last_hit_buffer.count + 1 > LED_HITS_TO_REMEMBER) {
+        memmove(&last_hit_buffer.x[0], &last_hit_buffer.x[1], LED_HITS_TO_REMEMBER - 1);
+        memmove(&last_hit_buffer.y[0], &last_hit_buffer.y[1], LED_HITS_TO_REMEMBER - 1);
+        memmove(&last_hit_buffer.tick[0], &last_hit_buffer.tick[1], (LED_HITS_TO_REMEMBER - 1) * sizeof(last_hit_buffer.tick[0]));
+        memmove(&last_hit_buffer.index[0], &last_hit_buffer.index[1], LED_HITS_TO_REMEMBER - 1);
+        last_hit_buffer.count = LED_HITS_TO_REMEMBER - 1;
+    }
+    uint8_t i                = last_hit_buffer.count++;
+    last_hit_buffer.x[i]     = g_led_config.point[led].x;
+    last_hit_buffer.y[i]     = g_led_config.point[led].y;
+    last_hit_buffer.index[i] = led;
+    last_hit_buffer.tick[i]  = 0;
+#endif
+#if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
+    if (rgb_matrix_config.mode == RGB_MATRIX_TYPING_HEATMAP) {
+        process_rgb_matrix_typing_heatmap(row, col);
+    }
+#endif
+}
+
+// rgb_task_timers(): age the hits by the frame time
+static void age_hits(uint16_t delta) {
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+    uint8_t count = last_hit_buffer.count;
+    for (uint8_t i = 0; i < count; ++i) {
+        if (UINT16_MAX - delta < last_hit_buffer.tick[i]) {
+            last_hit_buffer.count--;
+            continue;
+        }
+        last_hit_buffer.tick[i] += delta;
+    }
+    g_last_hit_tracker = last_hit_buffer;
+#else
+    (void)delta;
+#endif
+}
+
+// ============================================
+// Main
+// ============================================
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 2 && strcmp(argv[1], "--list") == 0) {
+        for (size_t i = 0; i < EFFECT_COUNT; i++) {
+            printf("%s\n", effects[i].name);
+        }
+        return 0;
+    }
+    if (argc != 12) {
+        fprintf(stderr, "usage: rgb_render <effect> <left|right|all> <frames> <interval ms> <hue> <sat> <val> <speed> <flags> <keys per s> <seed>\n");
+        return 2;
+    }
+
+    const effect_t *effect = NULL;
+    for (size_t i = 0; i < EFFECT_COUNT; i++) {
+        if (strcmp(effects[i].name, argv[1]) == 0) {
+            effect = &effects[i];
+        }
+    }
+    if (!effect) {
+        fprintf(stderr, "rgb_render: effect %s is not enabled\n", argv[1]);
+        return 2;
+    }
+
+#ifdef RGB_PREVIEW_SPLIT_LEFT
+    if (strcmp(argv[2], "left") == 0) {
+        led_end = RGB_PREVIEW_SPLIT_LEFT;
+    } else if (strcmp(argv[2], "right") == 0) {
+        led_first = RGB_PREVIEW_SPLIT_LEFT;
+        left_half = false;
+    }
+#endif
+    uint32_t frames      = strtoul(argv[3], NULL, 0);
+    uint16_t interval    = strtoul(argv[4], NULL, 0);
+    double   keys_per_s  = strtod(argv[10], NULL);
+    uint32_t seed        = strtoul(argv[11], NULL, 0);
+    double   hit_chance  = keys_per_s * interval / 1000.0;  // Per frame
+    double   hit_pending = 0;
+
+    rgb_matrix_config.enable = 1;
+    rgb_matrix_config.mode   = effect->mode;
+    rgb_matrix_config.hsv.h  = strtoul(argv[5], NULL, 0);
+    rgb_matrix_config.hsv.s  = strtoul(argv[6], NULL, 0);
+    rgb_matrix_config.hsv.v  = strtoul(argv[7], NULL, 0);
+    rgb_matrix_config.speed  = strtoul(argv[8], NULL, 0);
+    rgb_matrix_config.flags  = strtoul(argv[9], NULL, 0);
+    if (rgb_matrix_config.hsv.v > RGB_MATRIX_MAXIMUM_BRIGHTNESS) {
+        rgb_matrix_config.hsv.v = RGB_MATRIX_MAXIMUM_BRIGHTNESS;
+    }
+    srand(seed);
+    random16_set_seed(seed);
+    hit_seed = seed ? seed : 1;
+
+    uint8_t keys[MATRIX_ROWS * MATRIX_COLS];  // row << 4 | col of the keys with an LED
+    uint8_t key_count = 0;
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            if (g_led_config.matrix_co[r][c] != NO_LED) {
+                keys[key_count++] = r << 4 | c;
+            }
+        }
+    }
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        hit_pending += hit_chance * (hit_random() % 1001) / 500.0;  // Jittered around keys_per_s
+        for (; hit_pending >= 1.0 && key_count > 0; hit_pending -= 1.0) {
+            uint8_t key = keys[hit_random() % key_count];
+            press(key >> 4, key & 0x0F);
+            printf("hit %u %u\n", frame, g_led_config.matrix_co[key >> 4][key & 0x0F]);
+        }
+        if (frame > 0) {
+            clock_ms += interval;
+        }
+        age_hits(frame > 0 ? interval : 0);
+        g_rgb_timer = clock_ms;
+
+        effect_params_t params = { .iter = 0, .flags = rgb_matrix_config.flags, .init = frame == 0 };
+        uint8_t         iterations = 0;
+        bool            rendering;
+        uint64_t        start = now_ns();
+        do {
+            rendering = effect->render(&params);
+            params.iter++;
+            iterations++;
+        } while (rendering && iterations < UINT8_MAX);
+        uint64_t elapsed = now_ns() - start;
+
+        printf("frame %u %llu %u", frame, (unsigned long long)elapsed, iterations);
+        for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+            printf(" %02x%02x%02x", colors[i][0], colors[i][1], colors[i][2]);
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,576 @@
+#!/usr/bin/env node
+
+//
+// Offline RGB matrix effect renderer and previewer
+//
+// Compiles QMK's rgb_matrix effects (the ones enabled in info.json /
+// keyboard.json, plus the keymap's rgb_matrix_user.inc if it has one) for
+// the host against the real LED layout and split_count, renders frames
+// headlessly and writes them as PNG frames, an animated GIF or a video
+// (through ffmpeg). Each half renders its own LEDs in its own process, as
+// on the two STM32s, and the effect calls of every frame are timed.
+//
+// The effect sources come from the QMK checkout build.sh uses; nothing is
+// flashed. Host times rank effects and show per-frame spikes; they are not
+// STM32L432 microseconds.
+//
+// Usage: node scripts/rgb-preview/rgb-preview.js [options]
+//
+// Options:
+//   --qmk <dir>          QMK checkout (default: $QMK_FIRMWARE_DIR or ~/qmk_firmware)
+//   --effect <name>      Effect to render, e.g. cycle_all (repeatable, default: all enabled)
+//   --list               List the enabled effects and exit
+//   --frames <n>         Frames per effect (default: 300)
+//   --interval <ms>      Time between frames (default: 16, RGB_MATRIX_LED_FLUSH_LIMIT)
+//   --hsv <h,s,v>        Color (default: 0,255,255)
+//   --speed <n>          Effect speed 0-255 (default: 127)
+//   --flags <n>          LED flags to draw (default: 255, all)
+//   --typing <keys/s>    Simulated typing for the reactive effects (default: 5, 0 = none)
+//   --seed <n>           Seed of the typing and the effects' random numbers (default: 1)
+//   --format <fmt>       gif, png (one file per frame), mp4, webm or none (default: gif)
+//   --output <dir>       Output directory (default: .build/rgb-preview)
+//   --scale <px>         Pixels per key unit (default: 24)
+//   --custom <file>      Custom effects (rgb_matrix_user.inc format, default: the keymap's)
+//   --define <N[=V]>     Extra define for the effects, e.g. RGB_MATRIX_TYPING_HEATMAP_SPREAD=60
+//   --json               Print the timing statistics as JSON
+//
+
+const { execFileSync, spawnSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const zlib = require('zlib');
+
+const REPO_DIR = path.resolve(__dirname, '..', '..');
+const RENDER_DIR = path.join(__dirname, 'render');
+const BUILD_DIR = path.join(REPO_DIR, '.build', 'rgb-preview');
+const KEYBOARD_DIR = path.join(REPO_DIR, 'keychron/q11');
+const VARIANT_DIR = path.join(KEYBOARD_DIR, 'ansi_encoder');
+const KEYMAP_DIR = path.join(VARIANT_DIR, 'keymaps/j-custom');
+
+// Effects that need key hits / the frame buffer (rgb_matrix post_config)
+const REACTIVE = /^(solid_reactive|splash|multisplash|solid_splash|solid_multisplash)/;
+const FRAMEBUFFER = ['typing_heatmap', 'digital_rain'];
+
+// ============================================
+// Layout
+// ============================================
+
+// LEDs, split and effects from keyboard.json over info.json; keys from the first ANSI layout
+function readLayout() {
+  const info = JSON.parse(fs.readFileSync(path.join(KEYBOARD_DIR, 'info.json'), 'utf8'));
+  const variant = JSON.parse(fs.readFileSync(path.join(VARIANT_DIR, 'keyboard.json'), 'utf8'));
+  const rgb = { ...info.rgb_matrix, ...variant.rgb_matrix };
+  rgb.animations = { ...(info.rgb_matrix || {}).animations, ...(variant.rgb_matrix || {}).animations };
+  if (!rgb.layout || rgb.layout.length === 0) throw new Error('no rgb_matrix.layout in keyboard.json');
+
+  const layouts = { ...info.layouts, ...variant.layouts };
+  const name = Object.keys(layouts).find(n => /ansi/i.test(n)) || Object.keys(layouts)[0];
+  if (!name) throw new Error('no layout in info.json');
+  const keys = layouts[name].layout.map(k => ({ matrix: k.matrix, x: k.x, y: k.y, w: k.w || 1, h: k.h || 1 }));
+
+  const cells = [...keys.map(k => k.matrix), ...rgb.layout.map(l => l.matrix)].filter(Boolean);
+  const rows = Math.max(...cells.map(m => m[0])) + 1;
+  const cols = Math.max(...cells.map(m => m[1])) + 1;
+  const effects = Object.keys(rgb.animations).filter(a => rgb.animations[a]);
+  return { leds: rgb.layout, split: rgb.split_count || null, effects, keys, layoutName: name, rows, cols };
+}
+
+function configHeader(layout, options) {
+  const { leds, rows, cols } = layout;
+  const matrix = Array.from({ length: rows }, () => Array(cols).fill('NO_LED'));
+  leds.forEach((led, i) => {
+    if (led.matrix) matrix[led.matrix[0]][led.matrix[1]] = i;
+  });
+  const lines = [
+    '// Generated by scripts/rgb-preview/rgb-preview.js from info.json / keyboard.json',
+    '#pragma once',
+    '',
+    `#define MATRIX_ROWS ${rows}`,
+    `#define MATRIX_COLS ${cols}`,
+    `#define RGB_MATRIX_LED_COUNT ${leds.length}`,
+  ];
+  if (layout.split) lines.push(`#define RGB_PREVIEW_SPLIT_LEFT ${layout.split[0]}`);
+  lines.push('');
+  for (const effect of layout.effects) lines.push(`#define ENABLE_RGB_MATRIX_${effect.toUpperCase()}`);
+  if (layout.effects.some(e => REACTIVE.test(e))) {
+    lines.push('#define RGB_MATRIX_KEYPRESSES', '#define RGB_MATRIX_KEYREACTIVE_ENABLED');
+  }
+  if (layout.effects.some(e => FRAMEBUFFER.includes(e))) lines.push('#define RGB_MATRIX_FRAMEBUFFER_EFFECTS');
+  if (options.custom) lines.push('#define RGB_MATRIX_CUSTOM_USER');
+  for (const define of options.defines) {
+    const [name, ...value] = define.split('=');
+    lines.push(`#define ${name} ${value.join('=')}`.trimEnd());
+  }
+  lines.push('', '#define RGB_PREVIEW_LED_CONFIG { \\', '    { \\');
+  for (const row of matrix) lines.push(`        { ${row.join(', ')} }, \\`);
+  lines.push('    }, \\', `    { ${leds.map(l => `{${l.x}, ${l.y}}`).join(', ')} }, \\`);
+  lines.push(`    { ${leds.map(l => l.flags || 0).join(', ')} } \\`, '}', '');
+  return lines.join('\n');
+}
+
+// ============================================
+// Harness
+// ============================================
+
+function build(layout, options) {
+  const quantum = path.join(options.qmk, 'quantum');
+  if (!fs.existsSync(path.join(quantum, 'rgb_matrix', 'animations', 'rgb_matrix_effects.inc'))) {
+    throw new Error(`no QMK checkout with rgb_matrix at ${options.qmk} (use --qmk)`);
+  }
+  fs.mkdirSync(BUILD_DIR, { recursive: true });
+  const config = path.join(BUILD_DIR, 'rgb_preview_config.h');
+  fs.writeFileSync(config, configHeader(layout, options));
+  if (options.custom) fs.copyFileSync(options.custom, path.join(BUILD_DIR, 'rgb_matrix_user.inc'));
+
+  const binary = path.join(BUILD_DIR, 'rgb_render');
+  const includes = [BUILD_DIR, quantum, path.join(quantum, 'rgb_matrix'), path.join(quantum, 'rgb_matrix', 'animations'),
+    path.join(quantum, 'rgb_matrix', 'animations', 'runners'), path.join(options.qmk, 'platforms')];
+  execFileSync(process.env.CC || 'cc', ['-O2', '-std=gnu11', '-Wall', '-Wno-unused-function',
+    ...includes.map(dir => `-I${dir}`), '-include', config, '-o', binary, path.join(RENDER_DIR, 'rgb_render.c'),
+    path.join(quantum, 'color.c'), path.join(quantum, 'lib', 'lib8tion', 'lib8tion.c')], { stdio: ['ignore', 'inherit', 'pipe'] });
+  return binary;
+}
+
+function list(binary) {
+  return execFileSync(binary, ['--list']).toString().trim().split('\n').filter(Boolean);
+}
+
+// Frames of one half: [{ ns, iterations, colors: [[r, g, b]...], hits: [led...] }]
+function renderHalf(binary, effect, half, options) {
+  const [h, s, v] = options.hsv;
+  const args = [effect, half, options.frames, options.interval, h, s, v, options.speed, options.flags, options.typing, options.seed];
+  const result = spawnSync(binary, args.map(String), { maxBuffer: 1 << 30 });
+  if (result.status !== 0) throw new Error(`rgb_render ${effect} ${half}: ${result.stderr.toString().trim()}`);
+  const frames = [];
+  let hits = [];
+  for (const line of result.stdout.toString().split('\n')) {
+    const fields = line.split(' ');
+    if (fields[0] === 'hit') {
+      hits.push(Number(fields[2]));
+    } else if (fields[0] === 'frame') {
+      const colors = fields.slice(4).map(c => [parseInt(c.slice(0, 2), 16), parseInt(c.slice(2, 4), 16), parseInt(c.slice(4, 6), 16)]);
+      frames.push({ ns: Number(fields[2]), iterations: Number(fields[3]), colors, hits });
+      hits = [];
+    }
+  }
+  return frames;
+}
+
+// Both halves' LEDs into one frame each; timings stay per half
+function render(binary, layout, effect, options) {
+  const halves = layout.split ? [
+    { name: 'left', first: 0, end: layout.split[0] },
+    { name: 'right', first: layout.split[0], end: layout.leds.length },
+  ] : [{ name: 'all', first: 0, end: layout.leds.length }];
+  const runs = halves.map(half => ({ ...half, frames: renderHalf(binary, effect, half.name, options) }));
+  const frames = runs[0].frames.map((frame, i) => ({
+    colors: runs.flatMap(run => run.frames[i].colors.slice(run.first, run.end)),
+    hits: frame.hits,
+  }));
+  return { frames, halves: runs.map(run => ({ name: run.name, ns: run.frames.map(f => f.ns), iterations: run.frames.map(f => f.iterations) })) };
+}
+
+// ============================================
+// Statistics
+// ============================================
+
+function percentile(sorted, p) {
+  return sorted[Math.min(sorted.length - 1, Math.floor((sorted.length - 1) * p))];
+}
+
+function stats(effect, rendered, layout) {
+  const halves = rendered.halves.map(half => {
+    const sorted = [...half.ns].sort((a, b) => a - b);
+    return {
+      half: half.name,
+      iterations: Math.max(...half.iterations),
+      minNs: sorted[0],
+      p50Ns: percentile(sorted, 0.5),
+      p95Ns: percentile(sorted, 0.95),
+      maxNs: sorted[sorted.length - 1],
+      meanNs: Math.round(half.ns.reduce((a, b) => a + b, 0) / half.ns.length),
+      worstFrame: half.ns.indexOf(sorted[sorted.length - 1]),
+    };
+  });
+  // Mean PWM duty over all channels: a rough share of the LED current at full scale
+  const duty = rendered.frames.reduce((sum, f) => sum + f.colors.reduce((s, c) => s + c[0] + c[1] + c[2], 0), 0);
+  return { effect, frames: rendered.frames.length, halves, duty: duty / (rendered.frames.length * layout.leds.length * 3 * 255) };
+}
+
+// ============================================
+// Raster
+// ============================================
+
+const BACKGROUND = [16, 16, 16];
+const KEY_OFF = [36, 36, 36];
+const HIT = [255, 255, 255];
+const HIT_MS = 120;  // Outline a pressed key this long
+
+function canvas(layout, scale) {
+  const margin = Math.round(scale / 2);
+  let width = Math.ceil(Math.max(...layout.keys.map(k => k.x + k.w)) * scale) + 2 * margin;
+  let height = Math.ceil(Math.max(...layout.keys.map(k => k.y + k.h)) * scale) + 2 * margin;
+  width += width % 2;  // Even sizes for yuv420p video
+  height += height % 2;
+  const ledByMatrix = new Map(layout.leds.map((led, i) => [String(led.matrix), i]));
+  const keyed = new Set();
+  const shapes = layout.keys.map(k => {
+    const led = ledByMatrix.get(String(k.matrix));
+    if (led !== undefined) keyed.add(led);
+    return { led, x: margin + k.x * scale, y: margin + k.y * scale, w: k.w * scale, h: k.h * scale };
+  });
+  // LEDs without a key (underglow): a dot at their rgb_matrix point
+  const spanX = width - 2 * margin;
+  const spanY = height - 2 * margin;
+  layout.leds.forEach((led, i) => {
+    if (!keyed.has(i)) {
+      shapes.push({ led: i, x: margin + (led.x / 224) * spanX - scale / 6, y: margin + (led.y / 64) * spanY - scale / 6, w: scale / 3, h: scale / 3 });
+    }
+  });
+  return { width, height, shapes, gap: Math.max(1, Math.round(scale / 12)) };
+}
+
+function fill(pixels, width, x0, y0, x1, y1, color) {
+  for (let y = Math.max(0, Math.round(y0)); y < Math.round(y1); y++) {
+    for (let x = Math.max(0, Math.round(x0)); x < Math.round(x1); x++) {
+      const o = (y * width + x) * 3;
+      pixels[o] = color[0];
+      pixels[o + 1] = color[1];
+      pixels[o + 2] = color[2];
+    }
+  }
+}
+
+function rasterize(surface, colors, hit) {
+  const { width, height, shapes, gap } = surface;
+  const pixels = Buffer.alloc(width * height * 3);
+  fill(pixels, width, 0, 0, width, height, BACKGROUND);
+  for (const shape of shapes) {
+    const x0 = shape.x + gap;
+    const y0 = shape.y + gap;
+    const x1 = shape.x + shape.w - gap;
+    const y1 = shape.y + shape.h - gap;
+    if (hit.has(shape.led)) fill(pixels, width, x0 - gap, y0 - gap, x1 + gap, y1 + gap, HIT);
+    const color = shape.led === undefined ? BACKGROUND : colors[shape.led];
+    fill(pixels, width, x0, y0, x1, y1, color[0] || color[1] || color[2] ? color : KEY_OFF);
+  }
+  return pixels;
+}
+
+// Pixels of each frame, pressed keys outlined for HIT_MS
+function* images(surface, rendered, options) {
+  const recent = new Map();  // led -> frames left
+  const hold = Math.max(1, Math.round(HIT_MS / options.interval));
+  for (const frame of rendered.frames) {
+    for (const [led, left] of recent) {
+      if (left <= 1) recent.delete(led);
+      else recent.set(led, left - 1);
+    }
+    for (const led of frame.hits) recent.set(led, hold);
+    yield rasterize(surface, frame.colors, recent);
+  }
+}
+
+// ============================================
+// Encoders
+// ============================================
+
+const CRC_TABLE = Array.from({ length: 256 }, (_, n) => {
+  let c = n;
+  for (let k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+  return c >>> 0;
+});
+
+function crc32(buffer) {
+  let c = 0xffffffff;
+  for (const byte of buffer) c = CRC_TABLE[(c ^ byte) & 0xff] ^ (c >>> 8);
+  return (c ^ 0xffffffff) >>> 0;
+}
+
+function png(width, height, pixels) {
+  const chunk = (type, data) => {
+    const head = Buffer.alloc(8);
+    head.writeUInt32BE(data.length, 0);
+    head.write(type, 4, 'ascii');
+    const crc = Buffer.alloc(4);
+    crc.writeUInt32BE(crc32(Buffer.concat([head.subarray(4), data])), 0);
+    return Buffer.concat([head, data, crc]);
+  };
+  const ihdr = Buffer.alloc(13);
+  ihdr.writeUInt32BE(width, 0);
+  ihdr.writeUInt32BE(height, 4);
+  ihdr[8] = 8;  // Bit depth
+  ihdr[9] = 2;  // RGB
+  const stride = width * 3;
+  const raw = Buffer.alloc((stride + 1) * height);
+  for (let y = 0; y < height; y++) pixels.copy(raw, y * (stride + 1) + 1, y * stride, (y + 1) * stride);
+  return Buffer.concat([Buffer.from([0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a]),
+    chunk('IHDR', ihdr), chunk('IDAT', zlib.deflateSync(raw)), chunk('IEND', Buffer.alloc(0))]);
+}
+
+// GIF LZW of palette indices, in 255-byte sub-blocks
+function lzw(indices, minCodeSize) {
+  const clear = 1 << minCodeSize;
+  const eoi = clear + 1;
+  const out = [];
+  let codeSize = minCodeSize + 1;
+  let next = eoi + 1;
+  let table = new Map();
+  let acc = 0;
+  let bits = 0;
+  const emit = code => {
+    acc |= code << bits;
+    bits += codeSize;
+    while (bits >= 8) {
+      out.push(acc & 0xff);
+      acc >>>= 8;
+      bits -= 8;
+    }
+  };
+  emit(clear);
+  let prefix = indices[0];
+  for (let i = 1; i < indices.length; i++) {
+    const key = (prefix << 8) | indices[i];
+    const code = table.get(key);
+    if (code !== undefined) {
+      prefix = code;
+      continue;
+    }
+    emit(prefix);
+    if (next === 4096) {
+      emit(clear);
+      table = new Map();
+      codeSize = minCodeSize + 1;
+      next = eoi + 1;
+    } else {
+      if (next >= 1 << codeSize) codeSize++;
+      table.set(key, next++);
+    }
+    prefix = indices[i];
+  }
+  emit(prefix);
+  emit(eoi);
+  if (bits > 0) out.push(acc & 0xff);
+  const blocks = [];
+  for (let i = 0; i < out.length; i += 255) {
+    const block = out.slice(i, i + 255);
+    blocks.push(block.length, ...block);
+  }
+  blocks.push(0);
+  return Buffer.from(blocks);
+}
+
+// Exact colors when a frame has at most 256 (the LEDs, keys and background), else fewer bits per channel
+function palette(pixels) {
+  for (const mask of [0xffffff, 0xf8f8f8, 0xe0e0c0]) {
+    const colors = new Map();
+    const indices = new Uint8Array(pixels.length / 3);
+    let fits = true;
+    for (let p = 0; p < indices.length; p++) {
+      const rgb = ((pixels[p * 3] << 16) | (pixels[p * 3 + 1] << 8) | pixels[p * 3 + 2]) & mask;
+      let index = colors.get(rgb);
+      if (index === undefined) {
+        if (colors.size === 256) {
+          fits = false;
+          break;
+        }
+        index = colors.size;
+        colors.set(rgb, index);
+      }
+      indices[p] = index;
+    }
+    if (fits) return { colors: [...colors.keys()], indices };
+  }
+  throw new Error('unreachable: 3-3-2 bits always fit a palette');
+}
+
+function gif(width, height, frames, interval) {
+  const parts = [];
+  const screen = Buffer.alloc(13);
+  screen.write('GIF89a', 0, 'ascii');
+  screen.writeUInt16LE(width, 6);
+  screen.writeUInt16LE(height, 8);
+  parts.push(screen);
+  parts.push(Buffer.from([0x21, 0xff, 0x0b, ...Buffer.from('NETSCAPE2.0'), 0x03, 0x01, 0x00, 0x00, 0x00]));  // Loop forever
+
+  let shown = 0;  // Centiseconds, rounding spread over the frames
+  let index = 0;
+  for (const pixels of frames) {
+    index++;
+    const delay = Math.round((index * interval) / 10) - shown;
+    shown += delay;
+    const { colors, indices } = palette(pixels);
+    const bits = Math.max(1, Math.ceil(Math.log2(colors.length)));
+    const control = Buffer.from([0x21, 0xf9, 0x04, 0x04, delay & 0xff, delay >> 8, 0x00, 0x00]);
+    const descriptor = Buffer.alloc(10);
+    descriptor[0] = 0x2c;
+    descriptor.writeUInt16LE(width, 5);
+    descriptor.writeUInt16LE(height, 7);
+    descriptor[9] = 0x80 | (bits - 1);  // Local color table
+    const table = Buffer.alloc(3 << bits);
+    colors.forEach((rgb, i) => {
+      table[i * 3] = rgb >> 16;
+      table[i * 3 + 1] = (rgb >> 8) & 0xff;
+      table[i * 3 + 2] = rgb & 0xff;
+    });
+    parts.push(control, descriptor, table, Buffer.from([Math.max(2, bits)]), lzw(indices, Math.max(2, bits)));
+  }
+  parts.push(Buffer.from([0x3b]));
+  return Buffer.concat(parts);
+}
+
+function video(file, width, height, frames, interval) {
+  const input = Buffer.concat([...frames]);
+  const result = spawnSync('ffmpeg', ['-y', '-loglevel', 'error', '-f', 'rawvideo', '-pix_fmt', 'rgb24', '-s', `${width}x${height}`,
+    '-framerate', String(1000 / interval), '-i', '-', '-pix_fmt', 'yuv420p', file], { input, maxBuffer: 1 << 30 });
+  if (result.error && result.error.code === 'ENOENT') throw new Error('ffmpeg not found: use --format gif or png');
+  if (result.status !== 0) throw new Error(`ffmpeg: ${result.stderr.toString().trim()}`);
+}
+
+function write(surface, rendered, effect, options) {
+  const frames = images(surface, rendered, options);
+  const { width, height } = surface;
+  switch (options.format) {
+    case 'none':
+      return null;
+    case 'png': {
+      const dir = path.join(options.output, effect);
+      fs.mkdirSync(dir, { recursive: true });
+      let i = 0;
+      for (const pixels of frames) fs.writeFileSync(path.join(dir, `frame-${String(i++).padStart(4, '0')}.png`), png(width, height, pixels));
+      return dir;
+    }
+    case 'gif': {
+      const file = path.join(options.output, `${effect}.gif`);
+      fs.writeFileSync(file, gif(width, height, frames, options.interval));
+      return file;
+    }
+    default: {
+      const file = path.join(options.output, `${effect}.${options.format}`);
+      video(file, width, height, frames, options.interval);
+      return file;
+    }
+  }
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = {
+    qmk: process.env.QMK_FIRMWARE_DIR || path.join(os.homedir(), 'qmk_firmware'),
+    effects: [],
+    list: false,
+    frames: 300,
+    interval: 16,
+    hsv: [0, 255, 255],
+    speed: 127,
+    flags: 255,
+    typing: 5,
+    seed: 1,
+    format: 'gif',
+    output: BUILD_DIR,
+    scale: 24,
+    custom: fs.existsSync(path.join(KEYMAP_DIR, 'rgb_matrix_user.inc')) ? path.join(KEYMAP_DIR, 'rgb_matrix_user.inc') : null,
+    defines: [],
+    json: false,
+  };
+  const byte = (arg, v) => {
+    const n = Number(v);
+    if (!Number.isInteger(n) || n < 0 || n > 255) throw new Error(`${arg}: ${v} is not 0-255`);
+    return n;
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--qmk': options.qmk = value(); break;
+      case '--effect': options.effects.push(...value().split(',').map(e => e.trim())); break;
+      case '--list': options.list = true; break;
+      case '--frames': options.frames = Number(value()); break;
+      case '--interval': options.interval = Number(value()); break;
+      case '--hsv': options.hsv = value().split(',').map(v => byte(arg, v)); break;
+      case '--speed': options.speed = byte(arg, value()); break;
+      case '--flags': options.flags = byte(arg, value()); break;
+      case '--typing': options.typing = Number(value()); break;
+      case '--seed': options.seed = Number(value()); break;
+      case '--format': options.format = value(); break;
+      case '--output': options.output = value(); break;
+      case '--scale': options.scale = Number(value()); break;
+      case '--custom': options.custom = path.resolve(value()); break;
+      case '--define': options.defines.push(value()); break;
+      case '--json': options.json = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  if (options.hsv.length !== 3) throw new Error('--hsv takes h,s,v');
+  if (!['gif', 'png', 'mp4', 'webm', 'none'].includes(options.format)) throw new Error(`Unknown format: ${options.format}`);
+  for (const key of ['frames', 'interval', 'scale']) {
+    if (!(options[key] >= 1)) throw new Error(`--${key} must be at least 1`);
+  }
+  return options;
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const layout = readLayout();
+  const binary = build(layout, options);
+  const enabled = list(binary);
+  if (options.list) {
+    console.log(enabled.map(e => e.toLowerCase()).join('\n'));
+    return;
+  }
+  const find = name => enabled.find(e => e.toLowerCase() === name.toLowerCase());
+  const unknown = options.effects.filter(e => !find(e));
+  if (unknown.length > 0) throw new Error(`not enabled: ${unknown.join(', ')} (see --list)`);
+  const effects = options.effects.length > 0 ? options.effects.map(find) : enabled;
+
+  fs.mkdirSync(options.output, { recursive: true });
+  const surface = canvas(layout, options.scale);
+  const results = [];
+  for (const effect of effects) {
+    const rendered = render(binary, layout, effect, options);
+    results.push({ ...stats(effect.toLowerCase(), rendered, layout), output: write(surface, rendered, effect.toLowerCase(), options) });
+  }
+
+  if (options.json) {
+    console.log(JSON.stringify(results, null, 2));
+    return;
+  }
+  const us = ns => (ns / 1000).toFixed(1);
+  const cell = (v, w = 8) => String(v).padStart(w);
+  const halves = results[0].halves.map(h => h.half);
+  console.log(`${'effect'.padEnd(26)}${cell('iter', 5)}${halves.map(h => `${cell(`${h} p50`, 11)}${cell('p95')}${cell('max')}`).join('')}` +
+    `${cell('duty', 7)}  output`);
+  for (const r of results) {
+    console.log(`${r.effect.padEnd(26)}${cell(Math.max(...r.halves.map(h => h.iterations)), 5)}` +
+      `${r.halves.map(h => `${cell(us(h.p50Ns), 11)}${cell(us(h.p95Ns))}${cell(us(h.maxNs))}`).join('')}` +
+      `${cell(`${(r.duty * 100).toFixed(1)}%`, 7)}  ${r.output ? path.relative(process.cwd(), r.output) : '-'}`);
+  }
+  console.log(`\n${options.frames} frames every ${options.interval} ms, ${layout.leds.length} LEDs` +
+    `${layout.split ? ` (split ${layout.split.join('/')})` : ''}, layout ${layout.layoutName}. ` +
+    'Host µs per frame (all iterations): compare effects, not MCU time.');
+}
+
+if (require.main === module) {
+  try {
+    main();
+  } catch (err) {
+    console.error(`rgb-preview: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { readLayout, configHeader, png, gif };
@@ -0,0 +1,204 @@
+#!/usr/bin/env node
+
+//
+// Split link health viewer
+//
+// Reads the link counters kept by j-custom/split_health.c over raw HID and
+// shows them with per-interval deltas, the round-trip time histogram and a
+// hint whether trouble looks like cable noise or a stalled half.
+//
+// Usage: node scripts/split-health/split-health.js [options]
+//
+// Options:
+//   --transport <spec>   hid | hidraw:/dev/hidrawN (default: hid)
+//   --interval <ms>      Refresh interval (default: 1000)
+//   --once               Print one snapshot and exit
+//   --json               Print snapshots as JSON lines (for logging)
+//   --reset              Zero the link and RTT counters first
+//
+
+const fs = require('fs');
+const path = require('path');
+const { RAW_EPSIZE, openTransport } = require('../host-context/raw-hid-transport');
+
+const HEADER = path.join(__dirname, '..', '..', 'keychron/q11/ansi_encoder/keymaps/j-custom/split_health.h');
+
+// ============================================
+// Protocol (values read from split_health.h)
+// ============================================
+
+function parseHeader(file = HEADER) {
+  const source = fs.readFileSync(file, 'utf8');
+  const defines = {};
+  for (const m of source.matchAll(/(?:#\s*define\s+|^\s*)(SPLIT_HEALTH_\w+)\s*=?\s*(0x[0-9A-Fa-f]+|\d+)/gm)) {
+    defines[m[1]] = Number(m[2]);
+  }
+  const required = ['SPLIT_HEALTH_CHANNEL', 'SPLIT_HEALTH_REPLY', 'SPLIT_HEALTH_OP_READ', 'SPLIT_HEALTH_OP_RESET',
+    'SPLIT_HEALTH_PAGE_LINK', 'SPLIT_HEALTH_PAGE_RTT', 'SPLIT_HEALTH_PAGE_HALVES', 'SPLIT_HEALTH_RTT_BUCKETS', 'SPLIT_HEALTH_RTT_FIRST'];
+  const missing = required.filter(name => defines[name] === undefined);
+  if (missing.length > 0) throw new Error(`${file}: missing ${missing.join(', ')}`);
+  return defines;
+}
+
+function reader(buffer) {
+  let pos = 3;
+  return {
+    u16() { const v = buffer.readUInt16LE(pos); pos += 2; return v; },
+    u32() { const v = buffer.readUInt32LE(pos); pos += 4; return v; },
+  };
+}
+
+async function readPage(transport, d, page, opcode = d.SPLIT_HEALTH_OP_READ) {
+  const frame = Buffer.alloc(RAW_EPSIZE);
+  frame[0] = d.SPLIT_HEALTH_CHANNEL;
+  frame[1] = opcode;
+  frame[2] = page;
+  const reply = await transport.request(frame);
+  if (reply[0] !== d.SPLIT_HEALTH_CHANNEL || reply[1] !== (opcode | d.SPLIT_HEALTH_REPLY)) {
+    throw new Error(`unexpected reply to page ${page} (is SPLIT_HEALTH_ENABLE firmware flashed?)`);
+  }
+  return reader(reply);
+}
+
+async function snapshot(transport, d, reset = false) {
+  const r0 = await readPage(transport, d, d.SPLIT_HEALTH_PAGE_LINK, reset ? d.SPLIT_HEALTH_OP_RESET : d.SPLIT_HEALTH_OP_READ);
+  const link = {
+    transactions: r0.u32(), timeouts: r0.u32(), badReplies: r0.u32(), usartErrors: r0.u32(),
+    retries: r0.u32(), disconnects: r0.u32(), fallbacks: r0.u16(), baud: r0.u16() * 100,
+  };
+  const r1 = await readPage(transport, d, d.SPLIT_HEALTH_PAGE_RTT);
+  const rtt = { buckets: Array.from({ length: d.SPLIT_HEALTH_RTT_BUCKETS }, () => r1.u32()), maxUs: r1.u16() };
+  const r2 = await readPage(transport, d, d.SPLIT_HEALTH_PAGE_HALVES);
+  const master = { boots: r2.u16(), resets: r2.u16(), roleChanges: r2.u16() };
+  const slave = { boots: r2.u16(), resets: r2.u16(), roleChanges: r2.u16(), usartErrors: r2.u32(), polls: r2.u32(), uptimeS: r2.u32() };
+  master.uptimeS = r2.u32();
+  return { time: Date.now(), link, rtt, master, slave };
+}
+
+// ============================================
+// Display
+// ============================================
+
+function bucketLabels(d) {
+  const labels = [];
+  let limit = d.SPLIT_HEALTH_RTT_FIRST;
+  for (let i = 0; i < d.SPLIT_HEALTH_RTT_BUCKETS - 1; i++, limit *= 2) labels.push(`< ${limit}us`);
+  labels.push(`>= ${limit / 2}us`);
+  return labels;
+}
+
+// Rough classification from the deltas since the previous snapshot
+function diagnose(delta, rtt, d) {
+  const corruption = delta.usartErrors + delta.badReplies;
+  const slowShare = rtt.total > 0 ? rtt.slow / rtt.total : 0;
+  if (delta.slaveResets > 0 || delta.roleChanges > 0) return 'half reset (split watchdog) - firmware stall or power/USB detection issue';
+  if (corruption > 0 && delta.timeouts <= corruption) return 'corrupted frames with normal timing - cable or connector noise';
+  if (delta.timeouts > 0 && slowShare > 0.05) return 'timeouts with a long RTT tail - a half is stalling (busy loop, flash write, RGB)';
+  if (delta.timeouts > 0) return 'timeouts without corruption - slave not answering (loose cable or stalled slave)';
+  if (delta.fallbacks > 0) return 'link rate fell back - marginal signal at the faster rate';
+  return 'healthy';
+}
+
+function render(d, snap, prev, options) {
+  const diff = key => (prev ? snap.link[key] - prev.link[key] : 0);
+  const delta = {
+    timeouts: diff('timeouts'), usartErrors: diff('usartErrors') + (prev ? snap.slave.usartErrors - prev.slave.usartErrors : 0),
+    badReplies: diff('badReplies'), fallbacks: diff('fallbacks'),
+    slaveResets: prev ? snap.slave.resets - prev.slave.resets + snap.master.resets - prev.master.resets : 0,
+    roleChanges: prev ? snap.slave.roleChanges - prev.slave.roleChanges + snap.master.roleChanges - prev.master.roleChanges : 0,
+  };
+  const rttDelta = snap.rtt.buckets.map((n, i) => n - (prev ? prev.rtt.buckets[i] : 0));
+  const rtt = { total: rttDelta.reduce((a, b) => a + b, 0), slow: rttDelta.slice(-2).reduce((a, b) => a + b, 0) };
+
+  if (options.json) {
+    console.log(JSON.stringify({ ...snap, delta, diagnosis: diagnose(delta, rtt, d) }));
+    return;
+  }
+
+  const lines = [];
+  const row = (label, key) => lines.push(`  ${label.padEnd(16)} ${String(snap.link[key]).padStart(10)}  ${prev ? `+${diff(key)}` : ''}`);
+  lines.push(`Split link @ ${snap.link.baud} baud   master up ${snap.master.uptimeS}s, slave up ${snap.slave.uptimeS}s`);
+  lines.push('');
+  row('transactions', 'transactions');
+  row('timeouts', 'timeouts');
+  row('bad replies', 'badReplies');
+  row('usart errors', 'usartErrors');
+  row('retries', 'retries');
+  row('disconnects', 'disconnects');
+  row('rate fallbacks', 'fallbacks');
+  lines.push(`  ${'slave usart err'.padEnd(16)} ${String(snap.slave.usartErrors).padStart(10)}`);
+  lines.push('');
+  lines.push('  Round trip (all time)');
+  const max = Math.max(1, ...snap.rtt.buckets);
+  bucketLabels(d).forEach((label, i) => {
+    const n = snap.rtt.buckets[i];
+    lines.push(`  ${label.padStart(10)} ${String(n).padStart(10)} ${'#'.repeat(Math.round((n / max) * 40))}`);
+  });
+  lines.push(`  ${'max'.padStart(10)} ${String(snap.rtt.maxUs).padStart(8)}us`);
+  lines.push('');
+  lines.push('             boots  resets  role changes');
+  lines.push(`  master  ${String(snap.master.boots).padStart(7)} ${String(snap.master.resets).padStart(7)} ${String(snap.master.roleChanges).padStart(13)}`);
+  lines.push(`  slave   ${String(snap.slave.boots).padStart(7)} ${String(snap.slave.resets).padStart(7)} ${String(snap.slave.roleChanges).padStart(13)}`);
+  lines.push('');
+  lines.push(`  ${prev ? diagnose(delta, rtt, d) : options.once ? 'single snapshot: run without --once for a diagnosis' : 'collecting...'}`);
+
+  if (!options.once) process.stdout.write('\x1b[2J\x1b[H');
+  console.log(lines.join('\n'));
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = { transport: 'hid', interval: 1000, once: false, json: false, reset: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--transport': options.transport = value(); break;
+      case '--interval': options.interval = Number(value()); break;
+      case '--once': options.once = true; break;
+      case '--json': options.json = true; break;
+      case '--reset': options.reset = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  return options;
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const d = parseHeader();
+  const transport = openTransport(options.transport);
+  let prev = null;
+  let first = true;
+  for (;;) {
+    const snap = await snapshot(transport, d, first && options.reset);
+    first = false;
+    render(d, snap, prev, options);
+    if (options.once) break;
+    prev = snap;
+    await new Promise(resolve => setTimeout(resolve, options.interval));
+  }
+  await transport.close();
+}
+
+if (require.main === module) {
+  main().catch(err => {
+    console.error(`split-health: ${err.message}`);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseHeader, snapshot, diagnose };
@@ -0,0 +1,93 @@
+#!/bin/bash
+#
+# Benchmark the streaming SVG post-processor against the Python fallback
+#
+# Usage: scripts/svg-postprocess/bench.sh [svg_file] [runs]
+#   svg_file  SVG to process (default: j-custom combined diagram)
+#   runs      Iterations per implementation (default: 20)
+#
+# Reports mean wall time per run and peak RSS (when /usr/bin/time is available).
+# Both implementations work on copies; the input file is never modified.
+#
+
+set -e
+
+BENCH_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+REPO_DIR="$(cd "$BENCH_DIR/../.." && pwd)"
+
+SVG_FILE="${1:-$REPO_DIR/keymap-diagrams/keychron/q11/ansi_encoder/j-custom/both/keymap.svg}"
+RUNS="${2:-20}"
+INFO_JSON="$REPO_DIR/keychron/q11/info.json"
+SPLIT_GAP="60.0"
+
+# Reuse build_svg_postprocess / add_split_gap_to_svg_python from visualize.sh
+# shellcheck source=../../visualize.sh
+source "$REPO_DIR/visualize.sh"
+
+if [ ! -f "$SVG_FILE" ]; then
+    print_error "SVG not found: $SVG_FILE"
+    exit 1
+fi
+
+if ! build_svg_postprocess; then
+    print_error "Could not compile $SVG_POSTPROCESS_SRC (is a C compiler installed?)"
+    exit 1
+fi
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+now_ms() {
+    python3 -c 'import time; print(int(time.time() * 1000))'
+}
+
+# Peak RSS in KiB of one invocation of the given command
+peak_rss_kb() {
+    if [ -x /usr/bin/time ]; then
+        if /usr/bin/time -v true > /dev/null 2>&1; then
+            /usr/bin/time -v "$@" 2>&1 > /dev/null | awk '/Maximum resident set size/ { print $NF }'
+        else
+            # BSD/macOS time reports bytes
+            /usr/bin/time -l "$@" 2>&1 > /dev/null | awk '/maximum resident set size/ { print int($1 / 1024) }'
+        fi
+    else
+        echo "n/a"
+    fi
+}
+
+run_c() {
+    "$SVG_POSTPROCESS_BIN" -j "$INFO_JSON" -g "$SPLIT_GAP" "$SVG_FILE" "$WORK_DIR/c.svg"
+}
+
+run_python() {
+    cp "$SVG_FILE" "$WORK_DIR/py.svg"
+    add_split_gap_to_svg_python "$WORK_DIR/py.svg" "$INFO_JSON" "$SPLIT_GAP" > /dev/null
+}
+
+time_runs() {
+    local fn="$1"
+    local start end i
+    start=$(now_ms)
+    for ((i = 0; i < RUNS; i++)); do
+        "$fn"
+    done
+    end=$(now_ms)
+    echo $(( (end - start) / RUNS ))
+}
+
+print_header "SVG post-process benchmark"
+print_info "Input: $SVG_FILE ($(wc -c < "$SVG_FILE" | tr -d ' ') bytes), $RUNS runs"
+
+c_ms=$(time_runs run_c)
+py_ms=$(time_runs run_python)
+
+c_rss=$(peak_rss_kb "$SVG_POSTPROCESS_BIN" -j "$INFO_JSON" -g "$SPLIT_GAP" "$SVG_FILE" "$WORK_DIR/rss.svg")
+cp "$SVG_FILE" "$WORK_DIR/rss.svg"
+py_rss=$(peak_rss_kb bash -c "source '$REPO_DIR/visualize.sh'; add_split_gap_to_svg_python '$WORK_DIR/rss.svg' '$INFO_JSON' '$SPLIT_GAP'")
+
+echo ""
+printf "  %-10s %10s %14s\n" "impl" "ms/run" "peak RSS KiB"
+printf "  %-10s %10s %14s\n" "c" "$c_ms" "$c_rss"
+printf "  %-10s %10s %14s\n" "python" "$py_ms" "$py_rss"
+echo ""
+"$SVG_POSTPROCESS_BIN" -j "$INFO_JSON" -g "$SPLIT_GAP" --stats "$SVG_FILE" "$WORK_DIR/c.svg"
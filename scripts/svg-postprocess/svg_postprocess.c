@@ -0,0 +1,785 @@
+/* Streaming post-processor for keymap-drawer SVG output
+ *
+ * Replaces the regex pass that visualize.sh used to run over the whole SVG.
+ * The input is read once, tag by tag, and written straight to the output, so
+ * memory use is one tag buffer plus the stdio buffers regardless of SVG size.
+ *
+ * Transformations (all optional, applied in the same pass):
+ *   - Split gap: right-half keys (matrix row >= rows / 2 in info.json) and any
+ *     other group positioned right of the split are shifted by --gap pixels,
+ *     and the canvas width grows by the same amount.
+ *   - Layer filter: only the listed layer groups are kept; they are restacked
+ *     into the leading layer slots and the canvas height shrinks to match
+ *     (when the output is a seekable file).
+ *   - Minify: comments, whitespace between tags and CSS comments/whitespace
+ *     are dropped.
+ *
+ * Usage: svg_postprocess [options] [input.svg|- [output.svg|-]]
+ *   -j, --info-json FILE   Keyboard info.json (enables the split gap)
+ *   -l, --layout NAME      Layout in info.json (default: LAYOUT_91_ansi, else first)
+ *   -g, --gap PX           Split gap in pixels (default: 60)
+ *   -k, --keep-layers LIST Comma-separated layer names to keep (L0-MAC_BASE or L0)
+ *   -m, --minify           Minify the output
+ *   -s, --stats            Print processing statistics to stderr
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_TAG_SIZE 65536
+#define MAX_KEYS 512
+#define MAX_LAYER_SLOTS 64
+#define MAX_KEEP_LAYERS 32
+#define IO_BUFFER_SIZE 65536
+
+typedef struct {
+    const char *info_json;
+    const char *layout_name;
+    double      gap;
+    const char *keep_layers[MAX_KEEP_LAYERS];
+    int         keep_count;
+    bool        minify;
+    bool        stats;
+} options_t;
+
+typedef struct {
+    FILE *in;
+    FILE *out;
+
+    char   tag[MAX_TAG_SIZE];
+    size_t tag_len;
+
+    /* Split gap */
+    bool   split_enabled;
+    bool   right_half[MAX_KEYS];
+    double left_max_x;
+    double right_min_x;
+    bool   have_left;
+    bool   have_right;
+
+    /* Layer filter */
+    double slot_y[MAX_LAYER_SLOTS];
+    int    slot_count;
+    int    kept_count;
+    int    skip_depth;
+    long   height_offset;
+    long   viewbox_height_offset;
+    int    height_width;
+    int    viewbox_height_width;
+    double svg_height;
+    bool   seen_root;
+
+    /* Text state */
+    bool in_style;
+    bool pending_space;
+    char last_out;
+    int  css_comment; /* 0 none, 1 saw '/', 2 in comment, 3 in comment saw '*' */
+
+    /* Statistics */
+    unsigned long bytes_in;
+    unsigned long bytes_out;
+    unsigned long tags;
+    unsigned long keys_shifted;
+    unsigned long groups_shifted;
+    int           layers_dropped;
+} state_t;
+
+static options_t opts = {
+    .layout_name = "LAYOUT_91_ansi",
+    .gap         = 60.0,
+};
+
+static void die(const char *msg, const char *detail) {
+    fprintf(stderr, "svg_postprocess: %s%s%s\n", msg, detail ? ": " : "", detail ? detail : "");
+    exit(1);
+}
+
+// ============================================
+// Output helpers
+// ============================================
+
+static void out_char(state_t *st, char c) {
+    putc(c, st->out);
+    st->bytes_out++;
+    st->last_out = c;
+}
+
+static void out_mem(state_t *st, const char *s, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    fwrite(s, 1, len, st->out);
+    st->bytes_out += len;
+    st->last_out = s[len - 1];
+}
+
+/* Shortest fixed-point form: 550, 28.5, 1100.25 */
+static void format_number(char *buf, size_t size, double value) {
+    snprintf(buf, size, "%.2f", value);
+    char *dot = strchr(buf, '.');
+    if (dot) {
+        char *end = buf + strlen(buf) - 1;
+        while (end > dot && *end == '0') {
+            *end-- = '\0';
+        }
+        if (end == dot) {
+            *end = '\0';
+        }
+    }
+}
+
+// ============================================
+// info.json scanning (right-half key positions)
+// ============================================
+
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        die("cannot open", path);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc((size_t)size + 1);
+    if (!data || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        die("cannot read", path);
+    }
+    data[size] = '\0';
+    fclose(f);
+    return data;
+}
+
+/* Return the position just past the bracket matching the one at p ('[' or '{') */
+static const char *skip_json_block(const char *p) {
+    int  depth     = 0;
+    bool in_string = false;
+    for (; *p; p++) {
+        if (in_string) {
+            if (*p == '\\' && p[1]) {
+                p++;
+            } else if (*p == '"') {
+                in_string = false;
+            }
+        } else if (*p == '"') {
+            in_string = true;
+        } else if (*p == '[' || *p == '{') {
+            depth++;
+        } else if (*p == ']' || *p == '}') {
+            if (--depth == 0) {
+                return p + 1;
+            }
+        }
+    }
+    return p;
+}
+
+static void load_right_half(state_t *st, const char *path, const char *layout_name) {
+    char       *json    = read_file(path);
+    const char *layouts = strstr(json, "\"layouts\"");
+    if (!layouts) {
+        die("no layouts in", path);
+    }
+
+    char quoted[256];
+    snprintf(quoted, sizeof(quoted), "\"%s\"", layout_name);
+    const char *layout = strstr(layouts, quoted);
+    if (!layout) {
+        /* Fall back to the first layout */
+        layout = strchr(layouts + strlen("\"layouts\""), '{');
+        layout = layout ? strchr(layout, '"') : NULL;
+        if (!layout) {
+            die("no layouts in", path);
+        }
+    }
+
+    const char *list = strstr(layout, "\"layout\"");
+    list             = list ? strchr(list, '[') : NULL;
+    if (!list) {
+        die("no layout array in", path);
+    }
+    const char *list_end = skip_json_block(list);
+
+    int rows[MAX_KEYS];
+    int key_count = 0;
+    int max_row   = 0;
+    for (const char *p = strstr(list, "\"matrix\""); p && p < list_end; p = strstr(p + 1, "\"matrix\"")) {
+        const char *bracket = strchr(p, '[');
+        if (!bracket || key_count >= MAX_KEYS) {
+            break;
+        }
+        rows[key_count] = (int)strtol(bracket + 1, NULL, 10);
+        if (rows[key_count] > max_row) {
+            max_row = rows[key_count];
+        }
+        key_count++;
+    }
+
+    for (int i = 0; i < key_count; i++) {
+        st->right_half[i] = rows[i] >= (max_row + 1) / 2;
+    }
+    st->split_enabled = key_count > 0;
+    free(json);
+}
+
+// ============================================
+// Tag parsing helpers
+// ============================================
+
+/* Find attribute value span in the current tag; returns false if absent */
+static bool find_attr(const state_t *st, const char *name, size_t *start, size_t *len) {
+    size_t name_len = strlen(name);
+    bool   in_quote = false;
+    char   quote    = 0;
+    for (size_t i = 1; i + name_len + 2 < st->tag_len; i++) {
+        char c = st->tag[i];
+        if (in_quote) {
+            if (c == quote) {
+                in_quote = false;
+            }
+            continue;
+        }
+        if (c == '"' || c == '\'') {
+            in_quote = true;
+            quote    = c;
+            continue;
+        }
+        if (isspace((unsigned char)st->tag[i - 1]) && strncmp(st->tag + i, name, name_len) == 0 && st->tag[i + name_len] == '=') {
+            char q = st->tag[i + name_len + 1];
+            if (q != '"' && q != '\'') {
+                return false;
+            }
+            size_t value_start = i + name_len + 2;
+            size_t value_end   = value_start;
+            while (value_end < st->tag_len && st->tag[value_end] != q) {
+                value_end++;
+            }
+            *start = value_start;
+            *len   = value_end - value_start;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Copy an attribute value into buf (truncated to size) */
+static bool get_attr(const state_t *st, const char *name, char *buf, size_t size) {
+    size_t start, len;
+    if (!find_attr(st, name, &start, &len)) {
+        return false;
+    }
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(buf, st->tag + start, len);
+    buf[len] = '\0';
+    return true;
+}
+
+/* Replace an attribute value in the current tag buffer */
+static void set_attr(state_t *st, size_t start, size_t len, const char *value) {
+    size_t value_len = strlen(value);
+    if (st->tag_len - len + value_len >= MAX_TAG_SIZE) {
+        die("tag too large after rewrite", NULL);
+    }
+    memmove(st->tag + start + value_len, st->tag + start + len, st->tag_len - start - len);
+    memcpy(st->tag + start, value, value_len);
+    st->tag_len = st->tag_len - len + value_len;
+}
+
+static bool parse_translate(const char *transform, double *x, double *y) {
+    return sscanf(transform, "translate(%lf ,%lf)", x, y) == 2 || sscanf(transform, "translate(%lf %lf)", x, y) == 2;
+}
+
+static void set_translate(state_t *st, double x, double y) {
+    size_t start, len;
+    if (!find_attr(st, "transform", &start, &len)) {
+        return;
+    }
+    char xs[32], ys[32], value[80];
+    format_number(xs, sizeof(xs), x);
+    format_number(ys, sizeof(ys), y);
+    snprintf(value, sizeof(value), "translate(%s, %s)", xs, ys);
+    set_attr(st, start, len, value);
+}
+
+/* Find a whitespace-separated class token starting with prefix */
+static const char *find_class_token(const char *classes, const char *prefix) {
+    size_t prefix_len = strlen(prefix);
+    for (const char *p = classes; *p;) {
+        while (*p && isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (strncmp(p, prefix, prefix_len) == 0) {
+            return p + prefix_len;
+        }
+        while (*p && !isspace((unsigned char)*p)) {
+            p++;
+        }
+    }
+    return NULL;
+}
+
+static bool tag_is(const state_t *st, const char *name) {
+    size_t len = strlen(name);
+    return st->tag_len > len + 1 && strncmp(st->tag + 1, name, len) == 0 && (isspace((unsigned char)st->tag[len + 1]) || st->tag[len + 1] == '>' || st->tag[len + 1] == '/');
+}
+
+static bool tag_self_closing(const state_t *st) {
+    return st->tag_len >= 2 && st->tag[st->tag_len - 2] == '/';
+}
+
+static bool layer_is_kept(const char *layer_name) {
+    if (opts.keep_count == 0) {
+        return true;
+    }
+    size_t index_len = strcspn(layer_name, "-");
+    for (int i = 0; i < opts.keep_count; i++) {
+        const char *keep = opts.keep_layers[i];
+        if (strcmp(keep, layer_name) == 0 || (strlen(keep) == index_len && strncmp(keep, layer_name, index_len) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================
+// Tag emission
+// ============================================
+
+static void emit_tag(state_t *st) {
+    if (!opts.minify) {
+        out_mem(st, st->tag, st->tag_len);
+        return;
+    }
+    /* Collapse whitespace inside the tag (outside quotes) and drop it before '>' and '/>' */
+    bool in_quote = false;
+    char quote    = 0;
+    bool space    = false;
+    for (size_t i = 0; i < st->tag_len; i++) {
+        char c = st->tag[i];
+        if (in_quote) {
+            out_char(st, c);
+            if (c == quote) {
+                in_quote = false;
+            }
+            continue;
+        }
+        if (isspace((unsigned char)c)) {
+            space = true;
+            continue;
+        }
+        if (space && c != '>' && c != '/') {
+            out_char(st, ' ');
+        }
+        space = false;
+        if (c == '"' || c == '\'') {
+            in_quote = true;
+            quote    = c;
+        }
+        out_char(st, c);
+    }
+}
+
+static void handle_root(state_t *st) {
+    char   value[128];
+    char   height[32] = "";
+    size_t start, len;
+    double vb_x, vb_y, vb_w, vb_h;
+
+    st->seen_root = true;
+    if (find_attr(st, "height", &start, &len) && get_attr(st, "height", value, sizeof(value))) {
+        /* Normalised to one decimal so a shorter value can be patched in place later */
+        st->svg_height = strtod(value, NULL);
+        snprintf(height, sizeof(height), "%.1f", st->svg_height);
+        set_attr(st, start, len, height);
+    }
+    if (st->split_enabled && find_attr(st, "width", &start, &len) && get_attr(st, "width", value, sizeof(value))) {
+        format_number(value, sizeof(value), strtod(value, NULL) + opts.gap);
+        set_attr(st, start, len, value);
+    }
+    if (find_attr(st, "viewBox", &start, &len) && get_attr(st, "viewBox", value, sizeof(value)) && sscanf(value, "%lf %lf %lf %lf", &vb_x, &vb_y, &vb_w, &vb_h) == 4) {
+        char xs[32], ys[32], ws[32], hs[32];
+        format_number(xs, sizeof(xs), vb_x);
+        format_number(ys, sizeof(ys), vb_y);
+        format_number(ws, sizeof(ws), st->split_enabled ? vb_w + opts.gap : vb_w);
+        snprintf(hs, sizeof(hs), "%.1f", vb_h);
+        snprintf(value, sizeof(value), "%s %s %s %s", xs, ys, ws, hs);
+        set_attr(st, start, len, value);
+    }
+
+    /* Record absolute output offsets of both heights; only possible for a seekable, unminified output */
+    long base = ftell(st->out);
+    if (opts.keep_count > 0 && base >= 0 && !opts.minify) {
+        if (height[0] && find_attr(st, "height", &start, &len)) {
+            st->height_offset = base + (long)start;
+            st->height_width  = (int)len;
+        }
+        if (find_attr(st, "viewBox", &start, &len)) {
+            size_t hs_start = start + len;
+            while (hs_start > start && st->tag[hs_start - 1] != ' ') {
+                hs_start--;
+            }
+            if (hs_start > start) {
+                st->viewbox_height_offset = base + (long)hs_start;
+                st->viewbox_height_width  = (int)(start + len - hs_start);
+            }
+        }
+    }
+    emit_tag(st);
+}
+
+static void handle_group(state_t *st) {
+    char   classes[512] = "";
+    char   transform[128];
+    double x, y;
+    bool   has_translate = get_attr(st, "transform", transform, sizeof(transform)) && parse_translate(transform, &x, &y);
+    get_attr(st, "class", classes, sizeof(classes));
+
+    /* Layer group: filter and restack */
+    const char *layer_name = find_class_token(classes, "layer-");
+    if (layer_name && has_translate) {
+        char name[128];
+        size_t name_len = strcspn(layer_name, " \t\r\n");
+        if (name_len >= sizeof(name)) {
+            name_len = sizeof(name) - 1;
+        }
+        memcpy(name, layer_name, name_len);
+        name[name_len] = '\0';
+
+        if (st->slot_count < MAX_LAYER_SLOTS) {
+            st->slot_y[st->slot_count] = y;
+        }
+        st->slot_count++;
+
+        if (!layer_is_kept(name)) {
+            st->layers_dropped++;
+            if (!tag_self_closing(st)) {
+                st->skip_depth = 1;
+            }
+            return;
+        }
+        if (opts.keep_count > 0 && st->kept_count < MAX_LAYER_SLOTS) {
+            set_translate(st, x, st->slot_y[st->kept_count]);
+        }
+        st->kept_count++;
+        emit_tag(st);
+        return;
+    }
+
+    /* Key group: shift right-half keys */
+    const char *keypos = find_class_token(classes, "keypos-");
+    if (st->split_enabled && keypos && has_translate) {
+        long index = strtol(keypos, NULL, 10);
+        if (index >= 0 && index < MAX_KEYS && st->right_half[index]) {
+            if (!st->have_right || x < st->right_min_x) {
+                st->right_min_x = x;
+            }
+            st->have_right = true;
+            set_translate(st, x + opts.gap, y);
+            st->keys_shifted++;
+        } else {
+            if (!st->have_left || x > st->left_max_x) {
+                st->left_max_x = x;
+            }
+            st->have_left = true;
+        }
+        emit_tag(st);
+        return;
+    }
+
+    /* Any other group right of the split (combos, etc.), once keys have defined it */
+    if (st->split_enabled && has_translate && st->have_left && st->have_right) {
+        double threshold = (st->left_max_x + st->right_min_x) / 2;
+        if (x > threshold) {
+            set_translate(st, x + opts.gap, y);
+            st->groups_shifted++;
+        }
+    }
+    emit_tag(st);
+}
+
+static void handle_tag(state_t *st) {
+    st->tags++;
+    st->pending_space = false;
+
+    bool is_comment = st->tag_len >= 4 && strncmp(st->tag, "<!--", 4) == 0;
+    bool is_end     = st->tag_len >= 2 && st->tag[1] == '/';
+
+    if (st->skip_depth > 0) {
+        if (tag_is(st, "g") && !tag_self_closing(st)) {
+            st->skip_depth++;
+        } else if (is_end && strncmp(st->tag, "</g", 3) == 0) {
+            st->skip_depth--;
+        }
+        return;
+    }
+
+    if (is_comment) {
+        if (!opts.minify) {
+            emit_tag(st);
+        }
+        return;
+    }
+    if (is_end) {
+        if (strncmp(st->tag, "</style", 7) == 0) {
+            st->in_style = false;
+        }
+        emit_tag(st);
+        return;
+    }
+    if (!st->seen_root && tag_is(st, "svg")) {
+        handle_root(st);
+        return;
+    }
+    if (tag_is(st, "style") && !tag_self_closing(st)) {
+        st->in_style    = true;
+        st->css_comment = 0;
+        emit_tag(st);
+        return;
+    }
+    if (tag_is(st, "g")) {
+        handle_group(st);
+        return;
+    }
+    emit_tag(st);
+}
+
+// ============================================
+// Text handling
+// ============================================
+
+static bool css_tight(char c) {
+    return c == '{' || c == '}' || c == ';' || c == ',' || c == '>';
+}
+
+static void handle_text_char(state_t *st, char c) {
+    if (st->skip_depth > 0) {
+        return;
+    }
+    if (!opts.minify) {
+        out_char(st, c);
+        return;
+    }
+
+    if (st->in_style) {
+        /* Strip CSS comments */
+        switch (st->css_comment) {
+            case 0:
+                if (c == '/') {
+                    st->css_comment = 1;
+                    return;
+                }
+                break;
+            case 1:
+                if (c == '*') {
+                    st->css_comment = 2;
+                    return;
+                }
+                st->css_comment = 0;
+                out_char(st, '/');
+                break;
+            case 2:
+                if (c == '*') {
+                    st->css_comment = 3;
+                }
+                return;
+            case 3:
+                st->css_comment = (c == '/') ? 0 : (c == '*') ? 3 : 2;
+                return;
+        }
+    }
+
+    if (isspace((unsigned char)c)) {
+        st->pending_space = true;
+        return;
+    }
+    if (st->pending_space && st->last_out != '>' && st->last_out != '\0') {
+        if (!st->in_style || (!css_tight(st->last_out) && !css_tight(c))) {
+            out_char(st, ' ');
+        }
+    }
+    st->pending_space = false;
+    out_char(st, c);
+}
+
+// ============================================
+// Main loop
+// ============================================
+
+static void read_tag(state_t *st) {
+    st->tag_len           = 0;
+    st->tag[st->tag_len++] = '<';
+
+    bool in_quote = false;
+    char quote    = 0;
+    int  c;
+    while ((c = getc(st->in)) != EOF) {
+        st->bytes_in++;
+        if (st->tag_len >= MAX_TAG_SIZE - 1) {
+            die("tag exceeds buffer size", NULL);
+        }
+        st->tag[st->tag_len++] = (char)c;
+
+        /* Comments and CDATA end on their own terminators */
+        if (st->tag_len >= 4 && strncmp(st->tag, "<!--", 4) == 0) {
+            if (st->tag_len >= 7 && strncmp(st->tag + st->tag_len - 3, "-->", 3) == 0) {
+                return;
+            }
+            continue;
+        }
+        if (st->tag_len >= 9 && strncmp(st->tag, "<![CDATA[", 9) == 0) {
+            if (st->tag_len >= 12 && strncmp(st->tag + st->tag_len - 3, "]]>", 3) == 0) {
+                return;
+            }
+            continue;
+        }
+
+        if (in_quote) {
+            if (c == quote) {
+                in_quote = false;
+            }
+        } else if (c == '"' || c == '\'') {
+            in_quote = true;
+            quote    = (char)c;
+        } else if (c == '>') {
+            return;
+        }
+    }
+    die("unterminated tag at end of input", NULL);
+}
+
+static void patch_number(FILE *out, long offset, int width, double value) {
+    if (offset < 0) {
+        return;
+    }
+    char number[32];
+    snprintf(number, sizeof(number), "%0*.1f", width, value);
+    if ((int)strlen(number) != width) {
+        return;
+    }
+    fseek(out, offset, SEEK_SET);
+    fwrite(number, 1, (size_t)width, out);
+}
+
+static void process(state_t *st) {
+    int c;
+    while ((c = getc(st->in)) != EOF) {
+        st->bytes_in++;
+        if (c == '<') {
+            read_tag(st);
+            handle_tag(st);
+        } else {
+            handle_text_char(st, (char)c);
+        }
+    }
+    if (opts.minify) {
+        out_char(st, '\n');
+    }
+
+    /* Shrink the canvas by the layer slots that were dropped (uniform layer pitch) */
+    if (opts.keep_count > 0 && st->slot_count >= 2 && st->layers_dropped > 0) {
+        double pitch      = st->slot_y[1] - st->slot_y[0];
+        double new_height = st->svg_height - pitch * st->layers_dropped;
+        fflush(st->out);
+        patch_number(st->out, st->height_offset, st->height_width, new_height);
+        patch_number(st->out, st->viewbox_height_offset, st->viewbox_height_width, new_height);
+        fseek(st->out, 0, SEEK_END);
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "Usage: svg_postprocess [options] [input.svg|- [output.svg|-]]\n"
+            "  -j, --info-json FILE   Keyboard info.json (enables the split gap)\n"
+            "  -l, --layout NAME      Layout in info.json (default: LAYOUT_91_ansi, else first)\n"
+            "  -g, --gap PX           Split gap in pixels (default: 60)\n"
+            "  -k, --keep-layers LIST Comma-separated layer names to keep (L0-MAC_BASE or L0)\n"
+            "  -m, --minify           Minify the output\n"
+            "  -s, --stats            Print processing statistics to stderr\n");
+}
+
+int main(int argc, char **argv) {
+    static state_t st;
+    const char    *input  = "-";
+    const char    *output = "-";
+    int            positional = 0;
+    char          *keep_list  = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg       = argv[i];
+        bool        has_value = i + 1 < argc;
+        if ((!strcmp(arg, "-j") || !strcmp(arg, "--info-json")) && has_value) {
+            opts.info_json = argv[++i];
+        } else if ((!strcmp(arg, "-l") || !strcmp(arg, "--layout")) && has_value) {
+            opts.layout_name = argv[++i];
+        } else if ((!strcmp(arg, "-g") || !strcmp(arg, "--gap")) && has_value) {
+            opts.gap = strtod(argv[++i], NULL);
+        } else if ((!strcmp(arg, "-k") || !strcmp(arg, "--keep-layers")) && has_value) {
+            keep_list = argv[++i];
+        } else if (!strcmp(arg, "-m") || !strcmp(arg, "--minify")) {
+            opts.minify = true;
+        } else if (!strcmp(arg, "-s") || !strcmp(arg, "--stats")) {
+            opts.stats = true;
+        } else if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            usage();
+            return 0;
+        } else if (arg[0] != '-' || !strcmp(arg, "-")) {
+            if (positional == 0) {
+                input = arg;
+            } else if (positional == 1) {
+                output = arg;
+            } else {
+                usage();
+                return 1;
+            }
+            positional++;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    for (char *name = keep_list ? strtok(keep_list, ",") : NULL; name; name = strtok(NULL, ",")) {
+        if (opts.keep_count < MAX_KEEP_LAYERS) {
+            opts.keep_layers[opts.keep_count++] = name;
+        }
+    }
+
+    if (opts.info_json) {
+        load_right_half(&st, opts.info_json, opts.layout_name);
+    }
+
+    st.in  = strcmp(input, "-") ? fopen(input, "rb") : stdin;
+    st.out = strcmp(output, "-") ? fopen(output, "w+b") : stdout;
+    if (!st.in) {
+        die("cannot open input", strerror(errno));
+    }
+    if (!st.out) {
+        die("cannot open output", strerror(errno));
+    }
+    static char in_buffer[IO_BUFFER_SIZE], out_buffer[IO_BUFFER_SIZE];
+    setvbuf(st.in, in_buffer, _IOFBF, sizeof(in_buffer));
+    setvbuf(st.out, out_buffer, _IOFBF, sizeof(out_buffer));
+    st.height_offset = st.viewbox_height_offset = -1;
+
+    process(&st);
+
+    if (fflush(st.out) != 0 || ferror(st.out)) {
+        die("write failed", strerror(errno));
+    }
+    if (opts.stats) {
+        fprintf(stderr, "bytes_in=%lu bytes_out=%lu tags=%lu keys_shifted=%lu groups_shifted=%lu layers_kept=%d layers_dropped=%d buffer_bytes=%d\n",
+                st.bytes_in, st.bytes_out, st.tags, st.keys_shifted, st.groups_shifted, st.kept_count, st.layers_dropped, MAX_TAG_SIZE + 2 * IO_BUFFER_SIZE);
+    }
+    if (st.in != stdin) {
+        fclose(st.in);
+    }
+    if (st.out != stdout) {
+        fclose(st.out);
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+/* Minimal QMK environment for building tap_tune.c on the host
+ *
+ * Provides just enough of quantum.h (key records, timer, split role, console,
+ * EEPROM user datablock) for the trace replay (tap_tune.c and timer_wheel.c);
+ * the clock is virtual and advanced by the harness, the EEPROM is RAM.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef TAPPING_TERM
+#    define TAPPING_TERM 200  // QMK default: config.h does not set one
+#endif
+
+// EEPROM user datablock layout, as config.h
+#define KEY_STATS_DATA_SIZE 548
+#define TAP_TUNE_DATA_SIZE  36
+
+#define uprintf(...)        printf(__VA_ARGS__)
+#define IS_NOEVENT(event)   false  // The harness sends key events only
+
+typedef struct {
+    bool pressed;
+} keyevent_t;
+
+typedef struct {
+    keyevent_t event;
+} keyrecord_t;
+
+bool     is_keyboard_master(void);
+uint32_t timer_read32(void);
+void     eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length);
+void     eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length);
@@ -0,0 +1,143 @@
+/* Trace replay harness for the tap tune module
+ *
+ * Links the keymap's tap_tune.c on the host with one table entry per
+ * argument (p: TAP_TUNE_FROM_PRESS, r: TAP_TUNE_FROM_RELEASE) and replays key
+ * events from stdin, one command per line, at absolute times:
+ *   key <ms> <index> <0|1>   Table key release / press
+ *   other <ms>               Any other key's press
+ *   restart <ms>             Power cycle: init again from the saved terms
+ *   end <ms>                 Stop the run
+ * Output:
+ *   decide <ms> <index> <term>   before each table key press: the term in use
+ *   term <ms> <index> <term>     a retune changed the term
+ *   save <ms>                    the EEPROM datablock was written
+ *   restart <ms> <index> <term>  term loaded after a restart
+ *   stats <index> <term> <taps> <holds> <gaps> <tap_p50> <tap_p98> <hold_p50> <gap_p50> <gap_p98>
+ *                                at a restart (before it) and at the end
+ *
+ * The run steps a virtual 1 ms clock and runs timer_wheel_task() every tick,
+ * as housekeeping does once per scan.
+ *
+ * Usage: tap_tune_sim p|r...
+ * Build: cc -I<this dir> -DQMK_KEYBOARD_H='"qmk_stubs.h"' tap_tune_sim.c \
+ *           .../j-custom/tap_tune.c .../j-custom/timer_wheel.c
+ */
+#include <stdlib.h>
+
+#include "qmk_stubs.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/tap_tune.h"
+#include "../../../keychron/q11/ansi_encoder/keymaps/j-custom/timer_wheel.h"
+
+#define KEYCODE(index) (0x7E00 + (index))  // Any keycode outside the basic range
+
+static uint32_t       now_ms = 0;
+static uint8_t        eeprom[KEY_STATS_DATA_SIZE + TAP_TUNE_DATA_SIZE];
+static tap_tune_key_t table[TAP_TUNE_KEYS];
+static uint8_t        count = 0;
+static uint16_t       terms[TAP_TUNE_KEYS];
+
+// ============================================
+// QMK stubs
+// ============================================
+
+bool is_keyboard_master(void) {
+    return true;
+}
+
+uint32_t timer_read32(void) {
+    return now_ms;
+}
+
+void eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length) {
+    if (offset + length <= sizeof(eeprom)) {
+        memcpy(data, eeprom + offset, length);
+    }
+}
+
+// Counted only when the bytes change, as wear leveling writes only those
+void eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length) {
+    if (offset + length <= sizeof(eeprom) && memcmp(eeprom + offset, data, length) != 0) {
+        memcpy(eeprom + offset, data, length);
+        printf("save %u\n", now_ms);
+    }
+}
+
+// ============================================
+// Replay
+// ============================================
+
+// Run the clock up to t, a timer wheel pass per ms
+static void advance(uint32_t t) {
+    while (now_ms < t) {
+        now_ms++;
+        timer_wheel_task();
+    }
+}
+
+static void report_changes(void) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t term = tap_tune_term(KEYCODE(i));
+        if (term != terms[i]) {
+            printf("term %u %u %u\n", now_ms, i, term);
+            terms[i] = term;
+        }
+    }
+}
+
+static void print_stats(void) {
+    for (uint8_t i = 0; i < count; i++) {
+        const tap_tune_stats_t *s = tap_tune_stats(i);
+        printf("stats %u %u %u %u %u %u %u %u %u %u\n", i, s->term, s->taps, s->holds, s->gaps, s->tap_p50, s->tap_p98, s->hold_p50, s->gap_p50, s->gap_p98);
+    }
+}
+
+static void start(bool restart) {
+    tap_tune_init(table, count);
+    for (uint8_t i = 0; i < count; i++) {
+        terms[i] = tap_tune_term(KEYCODE(i));
+        if (restart) {
+            printf("restart %u %u %u\n", now_ms, i, terms[i]);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc - 1 > TAP_TUNE_KEYS) {
+        fprintf(stderr, "usage: %s p|r... (at most %d keys)\n", argv[0], TAP_TUNE_KEYS);
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) {
+        table[count] = (tap_tune_key_t){ KEYCODE(count), argv[i][0] == 'r' ? TAP_TUNE_FROM_RELEASE : TAP_TUNE_FROM_PRESS };
+        count++;
+    }
+    tap_tune_eeconfig_init();  // First boot
+    start(false);
+
+    char     line[64];
+    unsigned t, index;
+    int      pressed;
+    while (fgets(line, sizeof(line), stdin)) {
+        if (sscanf(line, "key %u %u %d", &t, &index, &pressed) == 3 && index < count) {
+            advance(t);
+            if (pressed) {
+                printf("decide %u %u %u\n", now_ms, index, tap_tune_term(KEYCODE(index)));
+            }
+            keyrecord_t record = { .event = { .pressed = pressed } };
+            tap_tune_record(KEYCODE(index), &record);
+            report_changes();
+        } else if (sscanf(line, "other %u", &t) == 1) {
+            advance(t);
+            keyrecord_t record = { .event = { .pressed = true } };
+            tap_tune_record(0x0004, &record);  // KC_A
+        } else if (sscanf(line, "restart %u", &t) == 1) {
+            advance(t);
+            print_stats();  // Learned before the power cycle clears them
+            start(true);
+        } else if (sscanf(line, "end %u", &t) == 1) {
+            advance(t);
+            break;
+        }
+    }
+    print_stats();
+    return 0;
+}
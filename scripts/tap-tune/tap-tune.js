@@ -0,0 +1,415 @@
+#!/usr/bin/env node
+
+//
+// Tap tune trace replay (j-custom/tap_tune.c)
+//
+// Compiles tap_tune.c for the host (sim/ harness) with keymap.c's
+// tap_tune_keys[] table and replays key traces through it:
+//   - synthetic sessions (default): each key pressed by the finger profile
+//     of PROFILES below, every press labelled with what was meant (second tap
+//     of a double tap or not). The terms learned on one session are checked
+//     on a second, unseen one against TAPPING_TERM with the previous firmware
+//     rules (the Spotlight double tap counted from any Cmd release): double
+//     taps missed, false double taps, and how long single taps of the tap
+//     dances wait to resolve after their release
+//   - a recording (--trace): console log of a TAP_TUNE_TRACE build ("TT <ms>
+//     <key> <pressed>" lines, see tap_tune.h). Without labels it reports the
+//     learned terms, the gaps within TAP_TUNE_GUARD_MS of each term and the
+//     presses the tuned term decides differently from TAPPING_TERM
+// Both report EEPROM saves and the terms loaded after a power cycle at the end.
+// Exits with 1 when a tuned term makes more mistakes than TAPPING_TERM on the
+// unseen session (beyond --tolerance).
+//
+// Usage: node scripts/tap-tune/tap-tune.js [options]
+//
+// Options:
+//   --trace <file>      Replay a console recording instead of synthetic sessions
+//   --minutes <n>       Length of each synthetic session (default: 120)
+//   --seed <n>          Seed of the first synthetic session (default: 1)
+//   --tolerance <pct>   Extra mistakes allowed to a tuned term, % of its presses (default: 0.5)
+//   --define <N=V>      Override a tap_tune.h setting for the run (repeatable), e.g. TAP_TUNE_VALLEY=16
+//   --json              Print the results as JSON instead of a table
+//
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const REPO_DIR = path.resolve(__dirname, '..', '..');
+const SIM_DIR = path.join(__dirname, 'sim');
+const BUILD_DIR = path.join(REPO_DIR, '.build');
+const KEYMAP_DIR = path.join(REPO_DIR, 'keychron/q11/ansi_encoder/keymaps/j-custom');
+const OTHER = -1;
+
+// How each table key is pressed, times in ms as [mean, sd]:
+//   tap: key down in a tap; gap: release to the next press inside a double tap
+//   double: share of actions that are double taps; hold: share used as a modifier
+//   (another key pressed meanwhile, then often again at once: Cmd+C, Cmd+V)
+//   repeat: share followed by a separate single tap of the same key, press to press
+//   weight: how often the key is used, relative to the others
+const PROFILES = {
+  KC_LGUI_SPOTLIGHT: { weight: 6, tap: [75, 20], gap: [95, 25], double: 0.15, hold: 0.6, holdMs: [260, 90], repeat: 0.05, repeatMs: [450, 90] },
+  'TD(TD_ENC_L)': { weight: 1, tap: [110, 20], gap: [90, 25], double: 0.3, repeat: 0.15, repeatMs: [520, 100] },
+  'TD(TD_ENC_R)': { weight: 1, tap: [115, 20], gap: [95, 25], double: 0.1, repeat: 0.15, repeatMs: [520, 100] },
+  'TD(TD_NUMPAD_SPACE)': { weight: 4, tap: [60, 15], gap: [70, 20], double: 0.1, repeat: 0.3, repeatMs: [340, 60] },
+  'TD(TD_SHADOWROCKET)': { weight: 0.5, tap: [90, 20], gap: [100, 30], double: 0.5, repeat: 0.05, repeatMs: [600, 120] },
+};
+
+// ============================================
+// Keymap
+// ============================================
+
+// tap_tune_keys[] of keymap.c: [{ name, from: 'press' | 'release' }]
+function readKeys() {
+  const keymap = fs.readFileSync(path.join(KEYMAP_DIR, 'keymap.c'), 'utf8');
+  const table = keymap.match(/tap_tune_keys\s*\[\s*\]\s*=\s*\{([\s\S]*?)\n\};/);
+  if (!table) throw new Error('no tap_tune_keys[] table in keymap.c');
+  const keys = [];
+  for (const m of table[1].matchAll(/\{\s*([\w()]+)\s*,\s*TAP_TUNE_FROM_(PRESS|RELEASE)\s*\}/g)) {
+    keys.push({ name: m[1], from: m[2].toLowerCase() });
+  }
+  if (keys.length === 0) throw new Error('keymap.c: tap_tune_keys[] is empty');
+  return keys;
+}
+
+// TAPPING_TERM (config.h, QMK's default otherwise) and TAP_TUNE_GUARD_MS (tap_tune.h or --define)
+function readConstants(defines) {
+  const config = fs.readFileSync(path.join(KEYMAP_DIR, 'config.h'), 'utf8');
+  const header = fs.readFileSync(path.join(KEYMAP_DIR, 'tap_tune.h'), 'utf8');
+  const term = config.match(/#\s*define\s+TAPPING_TERM\s+(\d+)/);
+  const guard = header.match(/#\s*define\s+TAP_TUNE_GUARD_MS\s+(\d+)/);
+  if (!guard) throw new Error('tap_tune.h: missing TAP_TUNE_GUARD_MS');
+  return { tappingTerm: term ? Number(term[1]) : 200, guard: Number(defines.TAP_TUNE_GUARD_MS ?? guard[1]) };
+}
+
+// ============================================
+// Traces
+// ============================================
+
+// Deterministic PRNG (mulberry32)
+function random(seed) {
+  let a = seed >>> 0;
+  return () => {
+    a = (a + 0x6D2B79F5) >>> 0;
+    let t = a;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+// A labelled session: [{ t, key, pressed, double }] (key: table index, or OTHER for a press elsewhere)
+function synthesize(keys, minutes, seed) {
+  const rng = random(seed);
+  const normal = ([mean, sd], min = 15) => {
+    const z = Math.sqrt(-2 * Math.log(1 - rng())) * Math.cos(2 * Math.PI * rng());
+    return Math.max(min, Math.round(mean + sd * z));
+  };
+  const profiles = keys.map(k => PROFILES[k.name]);
+  const total = profiles.reduce((a, p) => a + (p ? p.weight : 0), 0);
+  const events = [];
+  const end = minutes * 60000;
+  const tap = (key, t, profile, double = false) => {
+    const up = t + normal(profile.tap);
+    events.push({ t, key, pressed: true, double }, { t: up, key, pressed: false });
+    return up;
+  };
+
+  let t = 1000;
+  while (t < end) {
+    let pick = rng() * total;
+    const key = profiles.findIndex(p => p && (pick -= p.weight) < 0);
+    const p = profiles[key];
+    const roll = rng();
+    if (roll < (p.hold || 0)) {
+      // Modifier use, sometimes twice in a row (Cmd+C, then Cmd+V)
+      do {
+        events.push({ t, key, pressed: true, double: false });
+        events.push({ t: t + normal([90, 30], 20), key: OTHER, pressed: true });
+        const up = t + Math.max(normal(p.holdMs), 130);
+        events.push({ t: up, key, pressed: false });
+        t = up + normal([120, 40], 30);
+      } while (rng() < 0.4);
+    } else if (roll < (p.hold || 0) + p.double) {
+      t = tap(key, tap(key, t, p) + normal(p.gap, 20), p, true);
+    } else {
+      let down = t;
+      t = tap(key, down, p);
+      while (rng() < p.repeat) {
+        down += Math.max(normal(p.repeatMs), t - down + 40);
+        t = tap(key, down, p);
+      }
+    }
+    // Typing in between, then a pause
+    for (let n = Math.floor(-Math.log(1 - rng()) * 4); n > 0; n--) {
+      t += normal([160, 50], 40);
+      events.push({ t, key: OTHER, pressed: true });
+    }
+    t += Math.round(-Math.log(1 - rng()) * 2500) + 200;
+  }
+  events.sort((a, b) => a.t - b.t);
+  return { events, end: t + 1000 };
+}
+
+// Console capture of a TAP_TUNE_TRACE build: "TT <ms> <key> <pressed>", anything else skipped
+function readTrace(file, keys) {
+  const events = [];
+  let first = null;
+  for (const line of fs.readFileSync(file, 'utf8').split('\n')) {
+    const m = line.match(/\bTT (\d+) (-?\d+) ([01])\b/);
+    if (!m) continue;
+    const key = Number(m[2]);
+    if (key >= keys.length) throw new Error(`${file}: key ${key} is not in tap_tune_keys[] (${keys.length} keys)`);
+    if (first === null) first = Number(m[1]) - 1000;
+    const t = Number(m[1]) - first;
+    if (events.length > 0 && t < events[events.length - 1].t) throw new Error(`${file}: events out of order at "${line.trim()}"`);
+    events.push({ t, key: key < 0 ? OTHER : key, pressed: m[3] === '1' });
+  }
+  if (events.length === 0) throw new Error(`${file}: no "TT" lines (build with TAP_TUNE_TRACE and capture the console)`);
+  return { events, end: events[events.length - 1].t + 1000 };
+}
+
+// ============================================
+// Harness
+// ============================================
+
+function build(defines) {
+  const binary = path.join(BUILD_DIR, 'tap_tune_sim');
+  fs.mkdirSync(BUILD_DIR, { recursive: true });
+  execFileSync(process.env.CC || 'cc', ['-O2', '-std=gnu11', '-Wall', `-I${SIM_DIR}`, '-DQMK_KEYBOARD_H="qmk_stubs.h"',
+    ...Object.entries(defines).map(([name, value]) => `-D${name}=${value}`),
+    '-o', binary, path.join(SIM_DIR, 'tap_tune_sim.c'),
+    path.join(KEYMAP_DIR, 'tap_tune.c'), path.join(KEYMAP_DIR, 'timer_wheel.c')], { stdio: ['ignore', 'inherit', 'pipe'] });
+  return binary;
+}
+
+// Replays a trace, then a power cycle: the term in use at each table key press, term changes, saves, stats
+function replay(binary, keys, trace) {
+  const lines = trace.events.map(e => (e.key === OTHER ? `other ${e.t}` : `key ${e.t} ${e.key} ${e.pressed ? 1 : 0}`));
+  const input = `${lines.join('\n')}\nrestart ${trace.end}\nend ${trace.end + 1}\n`;
+  const output = execFileSync(binary, keys.map(k => k.from[0]), { input, maxBuffer: 1 << 28 }).toString().trim().split('\n');
+  const result = { decided: [], changes: keys.map(() => []), saves: [], loaded: [], stats: [] };
+  for (const line of output) {
+    const [kind, ...f] = line.split(' ');
+    const n = f.map(Number);
+    if (kind === 'decide') result.decided.push(n[2]);
+    else if (kind === 'term') result.changes[n[1]].push({ t: n[0], term: n[2] });
+    else if (kind === 'save' && n[0] > 0) result.saves.push(n[0]);  // Not the first boot's
+    else if (kind === 'restart') result.loaded[n[1]] = n[2];
+    else if (kind === 'stats' && !result.stats[n[0]]) {  // The ones before the power cycle
+      const [index, term, taps, holds, gaps, tapP50, tapP98, holdP50, gapP50, gapP98] = n;
+      result.stats[index] = { term, taps, holds, gaps, tapP50, tapP98, holdP50, gapP50, gapP98 };
+    }
+  }
+  return result;
+}
+
+// ============================================
+// Decisions
+// ============================================
+
+// Plays the firmware's double tap decision over a trace. termAt(key, n) is the
+// term at the key's nth press; previous: the rules before tap_tune (Spotlight
+// double tap from any Cmd release). Per key: presses, doubles meant, missed,
+// false doubles, single tap waits, gaps near the term, and each decision.
+function decide(keys, trace, termAt, previous, guard) {
+  const state = keys.map(() => ({ presses: 0, down: false, solo: false, tapped: false, pressedAt: null, releasedAt: null, pending: false, open: null }));
+  const out = keys.map(() => ({ presses: 0, doubles: 0, missed: 0, falseDoubles: 0, waits: [], near: 0, decisions: [] }));
+
+  // A single tap of a tap dance resolves at its term, or at once on the next press of any key
+  const settle = (t) => {
+    state.forEach((s, key) => {
+      if (s.open && (t === null || t >= s.open.resolve || s.open.interrupted)) {
+        const resolve = t === null ? s.open.resolve : Math.min(s.open.resolve, t);
+        if (s.open.releasedAt !== null) out[key].waits.push(Math.max(0, resolve - s.open.releasedAt));
+        s.open = null;
+      }
+    });
+  };
+
+  for (const e of trace.events) {
+    if (!e.pressed) {
+      const s = state[e.key];
+      s.tapped = s.solo;
+      if (!(previous && keys[e.key].from === 'release' && s.pending)) s.releasedAt = e.t;
+      s.down = false;
+      s.pending = false;
+      if (s.open && s.open.releasedAt === null) s.open.releasedAt = e.t;
+      continue;
+    }
+    state.forEach((s, key) => {
+      if (key !== e.key) {
+        s.solo = false;
+        s.tapped = false;
+        if (s.open) s.open.interrupted = true;
+      }
+    });
+    settle(e.t);
+    if (e.key === OTHER) continue;
+
+    const s = state[e.key];
+    const o = out[e.key];
+    const fromPress = keys[e.key].from === 'press';
+    const term = termAt(e.key, s.presses++);
+    const since = fromPress ? s.pressedAt : s.releasedAt;
+    const candidate = since !== null && (previous && !fromPress ? true : s.tapped);
+    const gap = candidate ? e.t - since : null;
+    const double = candidate && gap < term;
+    if (s.open && double) s.open = null;  // The first tap became a double
+    settle(e.t);
+
+    o.presses++;
+    if (e.double) o.doubles++;
+    if (e.double !== undefined) {
+      if (e.double && !double) o.missed++;
+      if (!e.double && double) o.falseDoubles++;
+    }
+    if (candidate && Math.abs(gap - term) < guard) o.near++;
+    o.decisions.push(double);
+
+    s.pending = double;
+    s.pressedAt = e.t;
+    s.down = true;
+    s.solo = true;
+    if (fromPress && !double) s.open = { resolve: e.t + term, releasedAt: null, interrupted: false };
+  }
+  settle(null);
+  return out.map(o => ({ ...o, wait: o.waits.length ? o.waits.reduce((a, b) => a + b, 0) / o.waits.length : null }));
+}
+
+// Term at each table key press, as the sim decided them
+function termsOf(keys, trace, decided) {
+  const byKey = keys.map(() => []);
+  let i = 0;
+  for (const e of trace.events) {
+    if (e.pressed && e.key !== OTHER) byKey[e.key].push(decided[i++]);
+  }
+  return (key, n) => byKey[key][n];
+}
+
+// ============================================
+// Main
+// ============================================
+
+function parseArgs(argv) {
+  const options = { trace: null, minutes: 120, seed: 1, tolerance: 0.5, defines: {}, json: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 >= argv.length) throw new Error(`${arg} requires a value`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--trace': options.trace = value(); break;
+      case '--minutes': options.minutes = Number(value()); break;
+      case '--seed': options.seed = Number(value()); break;
+      case '--tolerance': options.tolerance = Number(value()); break;
+      case '--define': {
+        const m = value().match(/^(TAP_TUNE_\w+)=(\d+)$/);
+        if (!m) throw new Error('--define expects TAP_TUNE_<NAME>=<number>');
+        options.defines[m[1]] = Number(m[2]);
+        break;
+      }
+      case '--json': options.json = true; break;
+      case '-h':
+      case '--help':
+        console.log(fs.readFileSync(__filename, 'utf8').split('\n')
+          .filter(l => l.startsWith('//')).map(l => l.replace(/^\/\/ ?/, '')).join('\n').trim());
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown option: ${arg}`);
+    }
+  }
+  if (!(options.minutes > 0)) throw new Error('--minutes must be positive');
+  return options;
+}
+
+// Learn on the trace; with labels, check the final terms on an unseen session
+function validate(binary, keys, options) {
+  const { tappingTerm, guard } = readConstants(options.defines);
+  const training = options.trace ? readTrace(options.trace, keys) : synthesize(keys, options.minutes, options.seed);
+  const learned = replay(binary, keys, training);
+  const final = learned.stats.map(s => s.term);
+  const online = decide(keys, training, termsOf(keys, training, learned.decided), false, guard);
+
+  const check = options.trace ? training : synthesize(keys, options.minutes, options.seed + 1);
+  const baseline = decide(keys, check, () => tappingTerm, true, guard);
+  const tuned = decide(keys, check, key => final[key], false, guard);
+
+  const results = keys.map((k, key) => {
+    const flips = tuned[key].decisions.filter((d, n) => d !== baseline[key].decisions[n]).length;
+    const mistakes = r => r.missed + r.falseDoubles;
+    const allowed = mistakes(baseline[key]) + Math.ceil((options.tolerance / 100) * tuned[key].presses);
+    const summary = r => ({ presses: r.presses, doubles: r.doubles, missed: r.missed, falseDoubles: r.falseDoubles, near: r.near,
+      wait: r.wait === null ? null : Math.round(r.wait) });
+    return {
+      key: k.name,
+      from: k.from,
+      term: final[key],
+      saved: learned.loaded[key],
+      changes: learned.changes[key],
+      stats: learned.stats[key],
+      online: summary(online[key]),
+      baseline: summary(baseline[key]),
+      tuned: summary(tuned[key]),
+      flips,
+      ok: options.trace ? null : mistakes(tuned[key]) <= allowed,
+    };
+  });
+  return { tappingTerm, labelled: !options.trace, minutes: Math.round(training.end / 60000), saves: learned.saves, results };
+}
+
+function print(run) {
+  const cell = (v, w = 8) => String(v ?? '-').padStart(w);
+  console.log(`${'key'.padEnd(22)}${cell('from')}${cell('term')}${cell('saved')}${cell('taps')}${cell('holds')}` +
+    `${cell('gaps')}${cell('tap p98')}${cell('gap p50')}${cell('gap p98')}`);
+  for (const r of run.results) {
+    console.log(`${r.key.padEnd(22)}${cell(r.from)}${cell(r.term)}${cell(r.saved)}${cell(r.stats.taps)}${cell(r.stats.holds)}` +
+      `${cell(r.stats.gaps)}${cell(r.stats.tapP98)}${cell(r.stats.gapP50)}${cell(r.stats.gapP98)}`);
+  }
+
+  const check = run.labelled ? 'unseen session' : 'trace';
+  console.log(`\n${check}: TAPPING_TERM ${run.tappingTerm} ms, previous rules → tuned terms`);
+  console.log(`${'key'.padEnd(22)}${cell('presses')}${run.labelled ? `${cell('doubles')}${cell('missed', 11)}${cell('false', 11)}` : ''}` +
+    `${cell('near', 11)}${cell('wait ms', 11)}${cell('flips')}${run.labelled ? cell('check') : ''}`);
+  for (const r of run.results) {
+    const pair = (field, w = 11) => cell(`${r.baseline[field] ?? '-'} → ${r.tuned[field] ?? '-'}`, w);
+    console.log(`${r.key.padEnd(22)}${cell(r.tuned.presses)}${run.labelled ? `${cell(r.tuned.doubles)}${pair('missed')}${pair('falseDoubles')}` : ''}` +
+      `${pair('near')}${pair('wait')}${cell(r.flips)}${run.labelled ? cell(r.ok ? 'ok' : 'FAIL') : ''}`);
+  }
+  const hours = run.minutes / 60;
+  console.log(`\nEEPROM saves: ${run.saves.length} in ${run.minutes} min (${(run.saves.length / hours).toFixed(2)}/h); ` +
+    'terms after a power cycle in "saved"');
+  if (run.labelled) {
+    console.log('missed / false: double taps meant but not made / made but not meant; near: gaps within the guard band of the term;');
+    console.log('wait: single tap of a tap dance, release to resolve; flips: presses decided differently');
+  }
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const keys = readKeys();
+  const missing = keys.filter(k => !PROFILES[k.name]).map(k => k.name);
+  if (!options.trace && missing.length === keys.length) throw new Error('no PROFILES entry for any tap_tune_keys[] key');
+  const run = validate(build(options.defines), keys, options);
+
+  if (options.json) {
+    console.log(JSON.stringify(run, null, 2));
+  } else {
+    print(run);
+    if (!options.trace && missing.length > 0) console.log(`No profile (not pressed in the sessions): ${missing.join(', ')}`);
+  }
+  if (run.results.some(r => r.ok === false)) process.exit(1);
+}
+
+if (require.main === module) {
+  try {
+    main();
+  } catch (err) {
+    console.error(`tap-tune: ${err.message}`);
+    process.exit(1);
+  }
+}
+
+module.exports = { readKeys, synthesize, readTrace, decide };
@@ -5,7 +5,31 @@
 # This script uses keymap-drawer to visualize QMK keymaps.
 # Workflow: keymap.c → qmk c2json → keymap parse → YAML → keymap draw → SVG
 #
-# Usage: ./visualize.sh
+# Renders are cached by a content hash of keymap.c, info.json and the render
+# options. Unchanged inputs skip the whole pipeline; otherwise only layers whose
+# keycodes changed are re-drawn and re-rasterized, in parallel worker processes.
+#
+# Usage: ./visualize.sh                      (interactive menus)
+#        ./visualize.sh -y [options]         (non-interactive, e.g. pre-commit hook)
+#
+# Options (selection options are used with -y; -j and --force always apply):
+#   -kb, --keyboard <path>   Keyboard path (e.g. keychron/q11/ansi_encoder)
+#   -km, --keymap <name>     Keymap name (default: j-custom)
+#   -f,  --format <fmt>      svg | png | both (default: svg)
+#   -c,  --columns <n|auto>  Columns parameter for keymap parse (default: 10)
+#   -o,  --output-dir <dir>  Output base directory (default: keymap-diagrams/)
+#   -j,  --jobs <n>          Parallel render workers (default: CPU count)
+#        --temp-yaml         Do not keep the intermediate YAML file
+#        --force             Ignore the render cache and redraw everything
+#   -y,  --non-interactive   Never prompt; use options and defaults
+#   -h,  --help              Show this help
+#
+# Environment:
+#   SVG_POSTPROCESS_FLAGS    Extra flags for scripts/svg-postprocess (e.g. "-m" to minify)
+#
+# Pre-commit hook example (.git/hooks/pre-commit):
+#   ./visualize.sh -y -kb keychron/q11/ansi_encoder -km j-custom -f both
+#   git add keymap-diagrams/
 #
 
 set -e  # Exit on error
@@ -18,6 +42,10 @@ SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 QMK_FIRMWARE_DIR="$HOME/qmk_firmware"
 DEFAULT_OUTPUT_DIR="$SCRIPT_DIR/keymap-diagrams"
 DEFAULT_COLUMNS=10
+DEFAULT_KEYMAP="j-custom"
+CACHE_DIR_NAME=".cache"
+SVG_POSTPROCESS_SRC="$SCRIPT_DIR/scripts/svg-postprocess/svg_postprocess.c"
+SVG_POSTPROCESS_BIN="$SCRIPT_DIR/.build/svg_postprocess"
 
 # =============================================================================
 # Colors for output
@@ -101,6 +129,10 @@ check_keymap_drawer() {
     fi
     
     print_warning "keymap-drawer not found."
+    if [ "$NON_INTERACTIVE" = true ]; then
+        print_error "keymap-drawer is required. Install it with: pipx install keymap-drawer"
+        exit 1
+    fi
     echo ""
     printf "Install keymap-drawer? (y/n): "
     read -r response
@@ -594,6 +626,55 @@ select_yaml_handling() {
     echo ""
 }
 
+# Resolve selections from command-line options instead of menus (-y mode)
+resolve_selections() {
+    print_header "Non-interactive Selection"
+    
+    if [ -z "$SELECTED_KEYBOARD" ]; then
+        SELECTED_KEYBOARD=$(discover_keyboards | head -1)
+        if [ -z "$SELECTED_KEYBOARD" ]; then
+            print_error "No keyboards found in workspace."
+            exit 1
+        fi
+    fi
+    if [ ! -d "$SCRIPT_DIR/$SELECTED_KEYBOARD/keymaps" ]; then
+        print_error "Keyboard not found: $SELECTED_KEYBOARD"
+        exit 1
+    fi
+    print_success "Keyboard: $SELECTED_KEYBOARD"
+    
+    if [ -z "$SELECTED_KEYMAP" ]; then
+        if [ -d "$SCRIPT_DIR/$SELECTED_KEYBOARD/keymaps/$DEFAULT_KEYMAP" ]; then
+            SELECTED_KEYMAP="$DEFAULT_KEYMAP"
+        else
+            SELECTED_KEYMAP=$(discover_keymaps "$SELECTED_KEYBOARD" | head -1)
+        fi
+    fi
+    if [ ! -f "$SCRIPT_DIR/$SELECTED_KEYBOARD/keymaps/$SELECTED_KEYMAP/keymap.c" ]; then
+        print_error "Keymap not found: $SELECTED_KEYBOARD/keymaps/$SELECTED_KEYMAP/keymap.c"
+        exit 1
+    fi
+    print_success "Keymap: $SELECTED_KEYMAP"
+    
+    case "$OUTPUT_FORMAT" in
+        svg) ;;
+        png|both)
+            if ! check_png_tools; then
+                print_warning "PNG tools not available. Will generate SVG only."
+                OUTPUT_FORMAT="svg"
+            fi
+            ;;
+        *)
+            print_error "Invalid format: $OUTPUT_FORMAT (expected svg, png or both)"
+            exit 1
+            ;;
+    esac
+    print_success "Output format: $OUTPUT_FORMAT"
+    print_success "Columns: $SELECTED_COLUMNS"
+    print_success "Output base directory: $OUTPUT_BASE_DIR"
+    echo ""
+}
+
 # =============================================================================
 # Layer name extraction functions
 # =============================================================================
@@ -863,9 +944,55 @@ EOF
     print_info "Created split keyboard config with gap: ${split_gap}px"
 }
 
+# Compile the streaming SVG post-processor on demand (rebuilt when the source changes)
+build_svg_postprocess() {
+    if [ ! -f "$SVG_POSTPROCESS_SRC" ]; then
+        return 1
+    fi
+    if [ -x "$SVG_POSTPROCESS_BIN" ] && [ ! "$SVG_POSTPROCESS_SRC" -nt "$SVG_POSTPROCESS_BIN" ]; then
+        return 0
+    fi
+    
+    local cc="${CC:-cc}"
+    if ! command -v "$cc" &> /dev/null; then
+        return 1
+    fi
+    
+    mkdir -p "$(dirname "$SVG_POSTPROCESS_BIN")"
+    "$cc" -O2 -std=c99 -o "$SVG_POSTPROCESS_BIN.tmp.$$" "$SVG_POSTPROCESS_SRC" 2>/dev/null || {
+        rm -f "$SVG_POSTPROCESS_BIN.tmp.$$"
+        return 1
+    }
+    mv -f "$SVG_POSTPROCESS_BIN.tmp.$$" "$SVG_POSTPROCESS_BIN"
+}
+
 # Post-process SVG to add visual gap for split keyboards
-# This shifts right half keys to the right by split_gap pixels
+# This shifts right half keys to the right by split_gap pixels.
+# Uses the single-pass C tool (scripts/svg-postprocess) when a C compiler is
+# available, otherwise falls back to the Python implementation below.
 add_split_gap_to_svg() {
+    local svg_file="$1"
+    local info_json="$2"
+    local split_gap="${3:-60.0}"
+    
+    if [ ! -f "$svg_file" ] || [ ! -f "$info_json" ]; then
+        return 1
+    fi
+    
+    if build_svg_postprocess; then
+        local tmp_file="$svg_file.tmp.$$"
+        if "$SVG_POSTPROCESS_BIN" -j "$info_json" -g "$split_gap" ${SVG_POSTPROCESS_FLAGS:-} "$svg_file" "$tmp_file"; then
+            mv -f "$tmp_file" "$svg_file"
+            return 0
+        fi
+        rm -f "$tmp_file"
+    fi
+    
+    add_split_gap_to_svg_python "$svg_file" "$info_json" "$split_gap"
+}
+
+# Python fallback for add_split_gap_to_svg (whole-file regex passes)
+add_split_gap_to_svg_python() {
     local svg_file="$1"
     local info_json="$2"
     local split_gap="${3:-60.0}"  # Default 60 pixels
@@ -1040,6 +1167,159 @@ PYEOF
     fi
 }
 
+# =============================================================================
+# Render cache and parallel job functions
+# =============================================================================
+
+# Print the SHA-256 of stdin (sha256sum on Linux, shasum on macOS)
+hash_stdin() {
+    if command -v sha256sum &> /dev/null; then
+        sha256sum | awk '{print $1}'
+    else
+        shasum -a 256 | awk '{print $1}'
+    fi
+}
+
+# Hash everything except keymap.c that affects the drawing: layout JSON,
+# this script and the selected render options
+compute_render_key() {
+    local info_json="$1"
+    local keyboard_json="$SCRIPT_DIR/$SELECTED_KEYBOARD/keyboard.json"
+    
+    {
+        if [ -n "$info_json" ] && [ -f "$info_json" ]; then
+            cat "$info_json"
+        fi
+        if [ -f "$keyboard_json" ]; then
+            cat "$keyboard_json"
+        fi
+        cat "$SCRIPT_DIR/visualize.sh"
+        echo "format=$OUTPUT_FORMAT columns=$SELECTED_COLUMNS"
+    } | hash_stdin
+}
+
+# Print "<index> <hash>" for every layer in the c2json output.
+# The render key is mixed in so layout or option changes invalidate all layers.
+compute_layer_hashes() {
+    local json_file="$1"
+    local render_key="$2"
+    
+    python3 - "$json_file" "$render_key" << 'PYEOF' 2>/dev/null
+import hashlib
+import json
+import sys
+
+with open(sys.argv[1], 'r') as f:
+    data = json.load(f)
+names = data.get('layer_names', [])
+for i, layer in enumerate(data.get('layers', [])):
+    name = names[i] if i < len(names) else ''
+    payload = sys.argv[2] + name + json.dumps(layer)
+    print(i, hashlib.sha256(payload.encode()).hexdigest())
+PYEOF
+}
+
+# Number of parallel render workers when --jobs is not given
+detect_cpu_count() {
+    getconf _NPROCESSORS_ONLN 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 2
+}
+
+# Run a command in the background, keeping at most $PARALLEL_JOBS running.
+# Waits on the oldest job when the pool is full (bash 3.2 has no wait -n).
+run_job() {
+    if [ ${#JOB_PIDS[@]} -ge "$PARALLEL_JOBS" ]; then
+        wait "${JOB_PIDS[0]}" || JOB_FAILURES=$((JOB_FAILURES + 1))
+        JOB_PIDS=("${JOB_PIDS[@]:1}")
+    fi
+    "$@" &
+    JOB_PIDS+=($!)
+}
+
+# Wait for all background jobs; failures are counted in $JOB_FAILURES
+wait_jobs() {
+    local pid
+    for pid in "${JOB_PIDS[@]}"; do
+        wait "$pid" || JOB_FAILURES=$((JOB_FAILURES + 1))
+    done
+    JOB_PIDS=()
+}
+
+# Convert an SVG to PNG with Inkscape (preferred) or CairoSVG
+convert_svg_to_png() {
+    local svg_file="$1"
+    local png_file="$2"
+    local error_output_png
+    error_output_png=$(mktemp /tmp/keymap_png_error_XXXXXX.txt)
+    local converted=false
+    
+    # Prefer Inkscape (more reliable, better quality, no rendering issues)
+    if command -v inkscape &> /dev/null; then
+        # Use high DPI for better quality (96 DPI default, 144 for high-res)
+        if inkscape "$svg_file" --export-type=png --export-filename="$png_file" --export-dpi=144 2> "$error_output_png"; then
+            converted=true
+        fi
+    # Fallback to CairoSVG (may have rendering issues)
+    elif command -v cairosvg &> /dev/null; then
+        if cairosvg "$svg_file" -o "$png_file" 2> "$error_output_png"; then
+            converted=true
+        fi
+    else
+        echo "No PNG conversion tool available (Inkscape or CairoSVG required)" > "$error_output_png"
+    fi
+    
+    if [ "$converted" = false ]; then
+        print_warning "PNG conversion failed: $svg_file"
+        if [ -s "$error_output_png" ]; then
+            cat "$error_output_png" | while IFS= read -r line; do
+                echo -e "  ${YELLOW}$line${NC}"
+            done
+        fi
+        rm -f "$error_output_png"
+        return 1
+    fi
+    
+    rm -f "$error_output_png"
+    return 0
+}
+
+# Worker: draw one SVG (all layers, or one layer when a layer id is given),
+# add the split gap and rasterize it. Uses DRAW_CMD_ARRAY, DRAW_YAML_FILE
+# and DRAW_SPLIT_INFO_JSON set up by generate_diagrams.
+# Usage: render_diagram_job <svg_file> <png_file or ""> <error_file> [layer_id]
+render_diagram_job() {
+    local svg_file="$1"
+    local png_file="$2"
+    local error_file="$3"
+    local layer_id="$4"
+    local label="${layer_id:-all layers}"
+    
+    local cmd=("${DRAW_CMD_ARRAY[@]}" "$DRAW_YAML_FILE")
+    if [ -n "$layer_id" ]; then
+        cmd+=("-s" "$layer_id")
+    fi
+    
+    if ! "${cmd[@]}" > "$svg_file" 2> "$error_file"; then
+        rm -f "$svg_file"
+        print_error "Failed to draw: $label"
+        return 1
+    fi
+    
+    if [ -n "$DRAW_SPLIT_INFO_JSON" ]; then
+        add_split_gap_to_svg "$svg_file" "$DRAW_SPLIT_INFO_JSON" "60.0" > /dev/null || \
+            print_warning "Failed to add split gap: $label (non-critical)"
+    fi
+    
+    if [ -n "$png_file" ]; then
+        if convert_svg_to_png "$svg_file" "$png_file"; then
+            print_success "Rendered $label: $(basename "$svg_file"), $(basename "$png_file")"
+            return 0
+        fi
+    fi
+    
+    print_success "Rendered $label: $(basename "$svg_file")"
+    return 0
+}
+
 # =============================================================================
 # Diagram generation functions
 # =============================================================================
@@ -1097,10 +1377,36 @@ generate_diagrams() {
     # Create output directory structure
     mkdir -p "$OUTPUT_DIR"
     print_success "Output directory: $OUTPUT_DIR"
-    
-    # Determine YAML file location
-    # YAML is saved in the parent directory (same level as format subdirectories)
+
+    # YAML, JSON and the render cache live in the parent directory (same level as format subdirectories)
     local yaml_base_dir="$OUTPUT_BASE_DIR/$SELECTED_KEYBOARD/$SELECTED_KEYMAP"
+    local cache_dir="$yaml_base_dir/$CACHE_DIR_NAME"
+
+    # Skip the whole pipeline when keymap.c, the layout and render options are unchanged
+    local info_json
+    info_json=$(find_info_json "$SELECTED_KEYBOARD") || true
+    local render_key
+    render_key=$(compute_render_key "$info_json")
+    local input_hash
+    input_hash=$({ echo "$render_key"; cat "$keymap_file"; } | hash_stdin)
+
+    local svg_file="$OUTPUT_DIR/keymap.svg"
+    local png_file=""
+    if [ "$OUTPUT_FORMAT" = "png" ] || [ "$OUTPUT_FORMAT" = "both" ]; then
+        png_file="$OUTPUT_DIR/keymap.png"
+    fi
+
+    if [ "$FORCE_RENDER" != true ] && [ -f "$cache_dir/inputs.sha256" ] && \
+       [ "$(cat "$cache_dir/inputs.sha256")" = "$input_hash" ] && \
+       [ -f "$svg_file" ] && { [ -z "$png_file" ] || [ -f "$png_file" ]; }; then
+        print_success "Diagrams are up to date (keymap.c and layout unchanged)"
+        print_info "Use --force to redraw anyway"
+        echo ""
+        return 0
+    fi
+    mkdir -p "$cache_dir"
+
+    # Determine YAML file location
     local yaml_file
     if [ "$SAVE_YAML" = true ]; then
         yaml_file="$yaml_base_dir/keymap.yaml"
@@ -1137,11 +1443,13 @@ generate_diagrams() {
         print_info "  2. Run './build.sh' first (it copies the keyboard to QMK)"
         print_info "  3. Ensure the keyboard exists at: $qmk_keyboard_path"
         echo ""
-        printf "Continue anyway? (y/n): "
-        read -r response
-        if [ "$response" != "y" ] && [ "$response" != "Y" ]; then
-            print_info "Exiting. Please ensure the keyboard is in the QMK firmware directory."
-            exit 1
+        if [ "$NON_INTERACTIVE" != true ]; then
+            printf "Continue anyway? (y/n): "
+            read -r response
+            if [ "$response" != "y" ] && [ "$response" != "Y" ]; then
+                print_info "Exiting. Please ensure the keyboard is in the QMK firmware directory."
+                exit 1
+            fi
         fi
         print_warning "Continuing, but conversion may fail..."
     else
@@ -1292,6 +1600,7 @@ PYEOF
     
     # Step 2.5: Update YAML and JSON with layer names
     print_info "Applying layer names to YAML and JSON..."
+    local yaml_names_applied=false
     
     # Re-extract layer names (in case they weren't extracted earlier)
     local layer_names=()
@@ -1316,6 +1625,7 @@ PYEOF
         done
         
         if update_yaml_layer_names "$yaml_file" "$keymap_file"; then
+            yaml_names_applied=true
             print_success "Layer names applied to YAML"
         else
             print_warning "Could not apply layer names to YAML (will use L0, L1, etc.)"
@@ -1333,18 +1643,12 @@ PYEOF
         fi
     fi
     
-    # Step 3: Generate SVG via keymap draw
-    print_step "5/6" "Generating SVG diagram..."
-    
-    local svg_file="$OUTPUT_DIR/keymap.svg"
-    
-    # Find info.json for layout information
-    local info_json
-    info_json=$(find_info_json "$SELECTED_KEYBOARD")
+    # Step 3: Generate SVGs via keymap draw (combined diagram + one per changed layer)
+    print_step "5/6" "Generating SVG diagrams..."
     
     # Check if keyboard is split and prepare config
     local config_file=""
-    local draw_args=""
+    DRAW_SPLIT_INFO_JSON=""
     
     if [ -n "$info_json" ] && is_split_keyboard "$info_json"; then
         print_info "Detected split keyboard layout"
@@ -1353,9 +1657,7 @@ PYEOF
         # Use a larger gap (60px) for better visibility of split
         config_file=$(mktemp /tmp/keymap_config_XXXXXX.yaml)
         create_split_config "$config_file" "60.0"
-        
-        # Add config file to draw args
-        draw_args="-c $config_file"
+        DRAW_SPLIT_INFO_JSON="$info_json"
         
         print_success "Using split keyboard visualization (gap: 60px)"
     fi
@@ -1388,131 +1690,155 @@ PYEOF
         fi
     fi
     
-    # Add info.json to draw args if found
     if [ -n "$info_json" ]; then
-        draw_args="$draw_args -j $info_json"
         print_info "Using layout from: $info_json"
-        # Explicitly specify layout name if found in YAML
         if [ -n "$layout_name" ]; then
-            draw_args="$draw_args -l $layout_name"
             print_info "Using layout name: $layout_name"
         fi
     fi
     
-    # Generate SVG with appropriate arguments
-    # Build command array for proper argument handling
+    # Build command array shared by all render workers (the YAML file is appended per job)
     # Note: -c (config) is a GLOBAL option and must come BEFORE the subcommand
-    local draw_cmd_array=("keymap")
+    DRAW_CMD_ARRAY=("keymap")
     if [ -n "$config_file" ]; then
-        draw_cmd_array+=("-c" "$config_file")
+        DRAW_CMD_ARRAY+=("-c" "$config_file")
     fi
-    draw_cmd_array+=("draw")
+    DRAW_CMD_ARRAY+=("draw")
     if [ -n "$info_json" ]; then
-        draw_cmd_array+=("-j" "$info_json")
+        DRAW_CMD_ARRAY+=("-j" "$info_json")
+        # Explicitly specify layout name if found in YAML
         if [ -n "$layout_name" ]; then
-            draw_cmd_array+=("-l" "$layout_name")
+            DRAW_CMD_ARRAY+=("-l" "$layout_name")
         fi
     fi
-    draw_cmd_array+=("$yaml_file")
+    DRAW_YAML_FILE="$yaml_file"
     
-    # Capture both stdout and stderr to see errors
-    local draw_error_output
-    draw_error_output=$(mktemp /tmp/keymap_draw_error_XXXXXX.txt)
+    # Work out which layers changed since the last render
+    local layers_dir="$OUTPUT_DIR/layers"
+    local layer_hash_file="$cache_dir/layers.sha256"
+    local layer_hashes
+    layer_hashes=$(compute_layer_hashes "$json_file" "$render_key") || true
+    local changed_layers=()
+    local current_layer_ids=()
+    mkdir -p "$layers_dir"
     
-    if ! "${draw_cmd_array[@]}" > "$svg_file" 2> "$draw_error_output"; then
-        print_error "Failed to generate SVG diagram"
-        echo ""
-        print_info "Command executed: ${draw_cmd_array[*]}"
-        echo ""
-        if [ -s "$draw_error_output" ]; then
-            print_info "Error details:"
-            cat "$draw_error_output" | while IFS= read -r line; do
-                echo -e "  ${RED}$line${NC}"
+    if [ -z "$layer_hashes" ]; then
+        print_warning "Could not hash layers from JSON; per-layer diagrams skipped"
+    else
+        local index hash layer_id old_hash
+        while read -r index hash; do
+            if [ -z "$index" ]; then
+                continue
+            fi
+            layer_id="L${index}"
+            if [ "$yaml_names_applied" = true ] && [ -n "${layer_names[index]}" ]; then
+                layer_id="L${index}-${layer_names[index]}"
+            fi
+            current_layer_ids+=("$layer_id")
+            
+            old_hash=""
+            if [ "$FORCE_RENDER" != true ] && [ -f "$layer_hash_file" ]; then
+                old_hash=$(awk -v i="$index" '$1 == i {print $2}' "$layer_hash_file")
+            fi
+            if [ "$hash" != "$old_hash" ] || [ ! -f "$layers_dir/$layer_id.svg" ] || \
+               { [ -n "$png_file" ] && [ ! -f "$layers_dir/$layer_id.png" ]; }; then
+                changed_layers+=("$layer_id")
+            fi
+        done <<< "$layer_hashes"
+        
+        # Remove diagrams of layers that no longer exist (renamed or deleted)
+        local stale_file stale_id known
+        for stale_file in "$layers_dir"/*.svg "$layers_dir"/*.png; do
+            if [ ! -f "$stale_file" ]; then
+                continue
+            fi
+            stale_id=$(basename "$stale_file")
+            stale_id="${stale_id%.*}"
+            known=false
+            for layer_id in "${current_layer_ids[@]}"; do
+                if [ "$layer_id" = "$stale_id" ]; then
+                    known=true
+                    break
+                fi
             done
-            echo ""
+            if [ "$known" = false ]; then
+                rm -f "$stale_file"
+            fi
+        done
+        
+        print_info "Layers changed: ${#changed_layers[@]} of ${#current_layer_ids[@]}"
+    fi
+    
+    # The combined diagram only needs redrawing when a layer changed (or it is missing)
+    local render_combined=true
+    if [ -n "$layer_hashes" ] && [ ${#changed_layers[@]} -eq 0 ] && [ -f "$svg_file" ] && \
+       { [ -z "$png_file" ] || [ -f "$png_file" ]; }; then
+        render_combined=false
+        print_success "Combined diagram unchanged"
+    fi
+    
+    # Render in parallel worker processes
+    local error_dir
+    error_dir=$(mktemp -d /tmp/keymap_draw_XXXXXX)
+    JOB_PIDS=()
+    JOB_FAILURES=0
+    print_info "Rendering with up to $PARALLEL_JOBS parallel worker(s)..."
+    
+    if [ "$render_combined" = true ]; then
+        run_job render_diagram_job "$svg_file" "$png_file" "$error_dir/combined.txt" ""
+    fi
+    for layer_id in "${changed_layers[@]}"; do
+        local layer_png=""
+        if [ -n "$png_file" ]; then
+            layer_png="$layers_dir/$layer_id.png"
         fi
+        run_job render_diagram_job "$layers_dir/$layer_id.svg" "$layer_png" "$error_dir/$layer_id.txt" "$layer_id"
+    done
+    wait_jobs
+    
+    # Cleanup config file
+    if [ -n "$config_file" ]; then
+        rm -f "$config_file"
+    fi
+    
+    if [ "$JOB_FAILURES" -gt 0 ]; then
+        print_error "Failed to generate $JOB_FAILURES SVG diagram(s)"
+        echo ""
+        print_info "Command executed: ${DRAW_CMD_ARRAY[*]} $yaml_file"
+        echo ""
+        local error_file
+        for error_file in "$error_dir"/*.txt; do
+            if [ -s "$error_file" ]; then
+                print_info "Error details ($(basename "$error_file" .txt)):"
+                cat "$error_file" | while IFS= read -r line; do
+                    echo -e "  ${RED}$line${NC}"
+                done
+                echo ""
+            fi
+        done
         print_info "This may indicate:"
         print_info "  - Invalid YAML structure"
         print_info "  - Layout detection issues"
         print_info "  - Missing keyboard layout definition"
         print_info "  - Config file format issues"
-        rm -f "$draw_error_output"
-        if [ -n "$config_file" ]; then
-            rm -f "$config_file"
-        fi
+        rm -rf "$error_dir"
+        # Force a full redraw next time
+        rm -f "$cache_dir/inputs.sha256" "$layer_hash_file"
         if [ "$SAVE_YAML" = false ]; then
             rm -f "$yaml_file"
         fi
         exit 1
     fi
-    
-    rm -f "$draw_error_output"
-    
-    # Cleanup config file
-    if [ -n "$config_file" ]; then
-        rm -f "$config_file"
-    fi
+    rm -rf "$error_dir"
     
     print_success "Generated SVG: $svg_file"
     
-    # Post-process SVG to add visual split gap if keyboard is split
-    if [ -n "$info_json" ] && is_split_keyboard "$info_json"; then
-        print_info "Post-processing SVG to add visual split gap..."
-        add_split_gap_to_svg "$svg_file" "$info_json" "60.0"
-    fi
-    
-    # Step 4: Convert to PNG if requested
-    if [ "$OUTPUT_FORMAT" = "png" ] || [ "$OUTPUT_FORMAT" = "both" ]; then
-        print_step "6/6" "Converting SVG to PNG..."
-        
-        local png_file="$OUTPUT_DIR/keymap.png"
-        local conversion_success=false
-        local error_output_png
-        error_output_png=$(mktemp /tmp/keymap_png_error_XXXXXX.txt)
-        
-        # Prefer Inkscape (more reliable, better quality, no rendering issues)
-        if command -v inkscape &> /dev/null; then
-            print_info "Using Inkscape for PNG conversion (recommended)"
-            # Use high DPI for better quality (96 DPI default, 144 for high-res)
-            # --export-type=png ensures PNG output
-            # --export-filename sets output file
-            # --export-dpi=144 for high quality
-            if inkscape "$svg_file" --export-type=png --export-filename="$png_file" --export-dpi=144 2> "$error_output_png"; then
-                print_success "Generated PNG via Inkscape: $png_file"
-                conversion_success=true
-            else
-                print_warning "Inkscape conversion failed"
-                if [ -s "$error_output_png" ]; then
-                    print_info "Error details:"
-                    cat "$error_output_png" | while IFS= read -r line; do
-                        echo -e "  ${YELLOW}$line${NC}"
-                    done
-                fi
-            fi
-        # Fallback to CairoSVG (may have rendering issues)
-        elif command -v cairosvg &> /dev/null; then
-            print_warning "Using CairoSVG (Inkscape recommended for better quality)"
-            # CairoSVG doesn't support DPI options well, but we can try
-            if cairosvg "$svg_file" -o "$png_file" 2> "$error_output_png"; then
-                print_success "Generated PNG via CairoSVG: $png_file"
-                print_warning "If you see rendering issues, try Inkscape instead: brew install inkscape"
-                conversion_success=true
-            else
-                print_warning "CairoSVG conversion failed"
-                if [ -s "$error_output_png" ]; then
-                    print_info "Error details:"
-                    cat "$error_output_png" | while IFS= read -r line; do
-                        echo -e "  ${YELLOW}$line${NC}"
-                    done
-                fi
-            fi
+    # Step 4: PNG conversion ran inside the workers; report the result
+    if [ -n "$png_file" ]; then
+        print_step "6/6" "Checking PNG output..."
+        if [ -f "$png_file" ]; then
+            print_success "Generated PNG: $png_file"
         else
-            print_warning "No PNG conversion tool available (Inkscape or CairoSVG required)"
-        fi
-        
-        rm -f "$error_output_png"
-        
-        if [ "$conversion_success" = false ]; then
             print_warning "PNG conversion failed. SVG file is available: $svg_file"
             if [ "$OUTPUT_FORMAT" = "png" ]; then
                 print_info "Install Inkscape (recommended): brew install inkscape"
@@ -1521,6 +1847,12 @@ PYEOF
         fi
     fi
     
+    # Record hashes so the next run only redraws what changed
+    if [ -n "$layer_hashes" ]; then
+        echo "$layer_hashes" > "$layer_hash_file"
+    fi
+    echo "$input_hash" > "$cache_dir/inputs.sha256"
+    
     # Cleanup temporary YAML if not saving
     if [ "$SAVE_YAML" = false ]; then
         rm -f "$yaml_file"
@@ -1530,13 +1862,94 @@ PYEOF
     echo ""
 }
 
+# =============================================================================
+# Command-line options
+# =============================================================================
+
+# Print the usage block from the header of this script
+usage() {
+    awk '/^# Usage:/ { p = 1 } p && !/^#/ { exit } p' "$SCRIPT_DIR/visualize.sh" | sed -E 's/^# ?//'
+}
+
+# Require a value for options that take one
+require_option_value() {
+    if [ -z "$2" ]; then
+        print_error "Option $1 requires a value"
+        exit 1
+    fi
+}
+
+parse_args() {
+    while [ $# -gt 0 ]; do
+        case "$1" in
+            -kb|--keyboard)
+                require_option_value "$1" "$2"
+                SELECTED_KEYBOARD="${2%/}"
+                shift 2
+                ;;
+            -km|--keymap)
+                require_option_value "$1" "$2"
+                SELECTED_KEYMAP="$2"
+                shift 2
+                ;;
+            -f|--format)
+                require_option_value "$1" "$2"
+                OUTPUT_FORMAT="$2"
+                shift 2
+                ;;
+            -c|--columns)
+                require_option_value "$1" "$2"
+                if [ "$2" != "auto" ] && ! echo "$2" | grep -qE '^[0-9]+$'; then
+                    print_error "Invalid columns: $2 (expected a number or 'auto')"
+                    exit 1
+                fi
+                SELECTED_COLUMNS="$2"
+                shift 2
+                ;;
+            -o|--output-dir)
+                require_option_value "$1" "$2"
+                OUTPUT_BASE_DIR="$2"
+                shift 2
+                ;;
+            -j|--jobs)
+                require_option_value "$1" "$2"
+                if ! echo "$2" | grep -qE '^[1-9][0-9]*$'; then
+                    print_error "Invalid job count: $2"
+                    exit 1
+                fi
+                PARALLEL_JOBS="$2"
+                shift 2
+                ;;
+            --temp-yaml)
+                SAVE_YAML=false
+                shift
+                ;;
+            --force)
+                FORCE_RENDER=true
+                shift
+                ;;
+            -y|--non-interactive)
+                NON_INTERACTIVE=true
+                shift
+                ;;
+            -h|--help)
+                usage
+                exit 0
+                ;;
+            *)
+                print_error "Unknown option: $1"
+                usage
+                exit 1
+                ;;
+        esac
+    done
+}
+
 # =============================================================================
 # Main
 # =============================================================================
 
 main() {
-    print_header "QMK Keymap Visualizer"
-    
     # Initialize global variables
     keyboards=()
     SELECTED_KEYBOARD=""
@@ -1546,15 +1959,26 @@ main() {
     OUTPUT_BASE_DIR="$DEFAULT_OUTPUT_DIR"
     OUTPUT_DIR=""
     SAVE_YAML=true
+    NON_INTERACTIVE=false
+    FORCE_RENDER=false
+    PARALLEL_JOBS=$(detect_cpu_count)
+    
+    parse_args "$@"
+    
+    print_header "QMK Keymap Visualizer"
     
     # Run workflow
     check_prerequisites
-    select_keyboard
-    select_keymap
-    select_columns
-    select_output_format
-    select_output_dir
-    select_yaml_handling
+    if [ "$NON_INTERACTIVE" = true ]; then
+        resolve_selections
+    else
+        select_keyboard
+        select_keymap
+        select_columns
+        select_output_format
+        select_output_dir
+        select_yaml_handling
+    fi
     generate_diagrams
     
     # Final summary
@@ -1580,6 +2004,9 @@ main() {
     if [ -f "$OUTPUT_DIR/keymap.png" ]; then
         echo -e "  ${GREEN}✓${NC} $OUTPUT_DIR/keymap.png"
     fi
+    if [ -d "$OUTPUT_DIR/layers" ]; then
+        echo -e "  ${GREEN}✓${NC} $OUTPUT_DIR/layers/ (one diagram per layer)"
+    fi
     local json_path="$OUTPUT_BASE_DIR/$SELECTED_KEYBOARD/$SELECTED_KEYMAP/keymap.json"
     if [ -f "$json_path" ]; then
         echo -e "  ${GREEN}✓${NC} $json_path"
@@ -1597,4 +2024,7 @@ main() {
 }
 
 # Run main function
-main "$@"
+# Allow sourcing (e.g. from scripts/svg-postprocess/bench.sh) without running the menus
+if [ "${BASH_SOURCE[0]}" = "$0" ]; then
+    main "$@"
+fi